@@ -5,6 +5,8 @@
 #include <signal.h>
 #include <sys/time.h>
 #include <time.h>
+#include <dirent.h>
+#include <errno.h>
 #ifdef _WIN32
 # include <windows.h>
 #endif
@@ -43,7 +45,9 @@
 
 typedef struct _Img Img;
 typedef struct _Lopt Lopt;
-typedef struct _Load_Inf Load_Inf;
+typedef struct _Decode_Job Decode_Job;
+typedef struct _Disk_Header Disk_Header;
+typedef struct _Disk_Entry Disk_Entry;
 
 struct _Lopt
 {
@@ -62,6 +66,7 @@ struct _Img
    int dref;
    int usage;
    Mem *mem;
+   Mem *mem_named; // named copy of anonymous mem for old protocol clients
    const char *key;
    time_t cached;
    struct {
@@ -86,12 +91,35 @@ struct _Img
    Eina_Bool active : 1;
    Eina_Bool useless : 1;
    Eina_Bool killme : 1;
+   Eina_Bool disk : 1; // mem is mapped from the disk cache
 };
 
-struct _Load_Inf
+struct _Disk_Header
+{
+   char magic[8];
+   int w, h;
+   int alpha;
+   int key_len; // the key itself follows the header
+   long long src_mtime;
+   long long src_size;
+};
+
+struct _Disk_Entry
+{
+   EINA_INLIST;
+   char name[20];
+   long long size;
+   time_t used; // only valid while the directory is scanned
+};
+
+struct _Decode_Job
 {
    Img *img;
-   Client *c;
+   Client *c; // the reply goes here
+   Client *owner; // main channel of the client that asked
+   double queued;
+   int unloaddata; // clients that let go of img while it decoded
+   Eina_Bool orphaned : 1; // c or owner went away - drop the result
 };
 
 // config
@@ -121,6 +149,13 @@ static Mem *stat_mem = NULL;
 static int _evas_cserve_bin_log_dom = -1;
 static Eina_List *stat_mems = NULL;
 
+static char *disk_dir = NULL;
+static int disk_max_usage = 256 * 1024;
+LK(disk_lock);
+static Eina_Inlist *disk_lru = NULL; // least recently used first
+static Eina_Hash *disk_entries = NULL;
+static long long disk_usage = 0;
+
 static void cache_clean(void);
 
 #ifndef _WIN32
@@ -330,17 +365,355 @@ _img_dealloc(Image_Entry *ie)
    free(img);
 }
 
+static void
+img_mem_free(Img *img)
+{
+   if (img->mem_named)
+     {
+        stat_mems = eina_list_remove(stat_mems, img->mem_named);
+        evas_cserve_mem_free(img->mem_named);
+        img->mem_named = NULL;
+     }
+   if (img->mem->name)
+     stat_mems = eina_list_remove(stat_mems, img->mem);
+   evas_cserve_mem_free(img->mem);
+   img->mem = NULL;
+   img->disk = 0;
+}
+
+// clients speaking the old protocol can only open memory by name, so give
+// them a named copy of anonymous memory. call with cache_lock held
+static Mem *
+img_mem_named_get(Img *img)
+{
+   if (!img->mem) return NULL;
+   if (img->mem->name) return img->mem;
+   if (img->mem_named) return img->mem_named;
+   img->mem_named = evas_cserve_mem_new(img->mem->size, NULL);
+   if (!img->mem_named) return NULL;
+   memcpy(img->mem_named->data, img->mem->data, img->mem->size);
+   msync(img->mem_named->data, img->mem_named->size, MS_SYNC | MS_INVALIDATE);
+   stat_mems = eina_list_append(stat_mems, img->mem_named);
+   stat_update(stat_mem);
+   return img->mem_named;
+}
+
+// persistent cache of decoded images. with -dcache DIR every image that is
+// decoded is also written to DIR as one header page followed by its ARGB
+// pixels. a later OP_LOAD of the same file, key and load options - even
+// from a new server after a reboot - takes the header from the entry
+// without running a loader, and OP_LOADDATA maps the entry's pixels
+// instead of decoding. entries are named by a hash of the file, key and
+// load options and hold the source's mtime and size, so an entry whose
+// source has changed is removed the next time it is looked up. the whole
+// directory is kept under -dcachesize Kb by removing the least recently
+// used entries
+#define DISK_MAGIC "EvCsDsk1"
+#define DISK_HEADER_SIZE 4096
+
+// call with disk_lock held
+static void
+disk_entry_del(const char *name, Eina_Bool unlink_file)
+{
+   Disk_Entry *de;
+   char path[PATH_MAX];
+   
+   if (unlink_file)
+     {
+        snprintf(path, sizeof(path), "%s/%s", disk_dir, name);
+        unlink(path);
+     }
+   de = eina_hash_find(disk_entries, name);
+   if (!de) return;
+   eina_hash_del(disk_entries, de->name, de);
+   disk_lru = eina_inlist_remove(disk_lru, EINA_INLIST_GET(de));
+   disk_usage -= de->size;
+   free(de);
+}
+
+// call with disk_lock held
+static void
+disk_entry_add(const char *name, long long size)
+{
+   Disk_Entry *de;
+   
+   disk_entry_del(name, 0);
+   de = calloc(1, sizeof(Disk_Entry));
+   if (!de) return;
+   strncpy(de->name, name, sizeof(de->name) - 1);
+   de->size = size;
+   eina_hash_add(disk_entries, de->name, de);
+   disk_lru = eina_inlist_append(disk_lru, EINA_INLIST_GET(de));
+   disk_usage += size;
+}
+
+// call with disk_lock held
+static void
+disk_clean(void)
+{
+   while ((disk_lru) && (disk_usage > ((long long)disk_max_usage * 1024)))
+     {
+        Disk_Entry *de = EINA_INLIST_CONTAINER_GET(disk_lru, Disk_Entry);
+        
+        DBG("... disk cache drop %s", de->name);
+        disk_entry_del(de->name, 1);
+     }
+}
+
+static int
+disk_entry_time_cmp(const void *d1, const void *d2)
+{
+   const Disk_Entry *de1 = d1, *de2 = d2;
+   
+   if (de1->used < de2->used) return -1;
+   if (de1->used > de2->used) return 1;
+   return 0;
+}
+
+static void
+disk_init(void)
+{
+   DIR *dir;
+   struct dirent *dp;
+   struct stat st;
+   char path[PATH_MAX];
+   Eina_List *found = NULL;
+   Disk_Entry *de;
+   
+   LKI(disk_lock);
+   if (!disk_dir) return;
+   if ((mkdir(disk_dir, S_IRWXU) < 0) && (errno != EEXIST))
+     {
+        ERR("cannot create disk cache dir '%s'", disk_dir);
+        free(disk_dir);
+        disk_dir = NULL;
+        return;
+     }
+   disk_entries = eina_hash_string_superfast_new(NULL);
+   dir = opendir(disk_dir);
+   if (!dir) return;
+   while ((dp = readdir(dir)))
+     {
+        if (dp->d_name[0] == '.')
+          {
+             // a store that never finished
+             if (!strncmp(dp->d_name, ".tmp-", 5))
+               {
+                  snprintf(path, sizeof(path), "%s/%s", disk_dir, dp->d_name);
+                  unlink(path);
+               }
+             continue;
+          }
+        if (strlen(dp->d_name) != 16) continue;
+        snprintf(path, sizeof(path), "%s/%s", disk_dir, dp->d_name);
+        if (stat(path, &st) < 0) continue;
+        de = calloc(1, sizeof(Disk_Entry));
+        if (!de) continue;
+        strncpy(de->name, dp->d_name, sizeof(de->name) - 1);
+        de->size = st.st_size;
+        // entries are touched when used, so mtime is the last use
+        de->used = st.st_mtime;
+        found = eina_list_append(found, de);
+     }
+   closedir(dir);
+   found = eina_list_sort(found, 0, disk_entry_time_cmp);
+   EINA_LIST_FREE(found, de)
+     {
+        eina_hash_add(disk_entries, de->name, de);
+        disk_lru = eina_inlist_append(disk_lru, EINA_INLIST_GET(de));
+        disk_usage += de->size;
+     }
+   DBG("... disk cache '%s' %lli Kb", disk_dir, disk_usage / 1024);
+   disk_clean();
+}
+
+static void
+disk_shutdown(void)
+{
+   while (disk_lru)
+     {
+        Disk_Entry *de = EINA_INLIST_CONTAINER_GET(disk_lru, Disk_Entry);
+        
+        disk_lru = eina_inlist_remove(disk_lru, disk_lru);
+        free(de);
+     }
+   if (disk_entries) eina_hash_free(disk_entries);
+   disk_entries = NULL;
+   disk_usage = 0;
+   free(disk_dir);
+   disk_dir = NULL;
+   LKD(disk_lock);
+}
+
+// the key is everything that changes the decoded pixels except the source
+// contents, which the header checks instead. the entry name is a 64bit
+// fnv-1a hash of the key
+static int
+disk_key_get(Image_Entry *ie, char *buf, int size, char *name)
+{
+   unsigned long long h = 14695981039346656037ULL;
+   int len, i;
+   
+   len = snprintf(buf, size, "%s\n%s\n%i/%1.8f/%ix%i/%i,%i+%ix%i",
+                  ie->file, ie->key ? ie->key : "",
+                  ie->load_opts.scale_down_by, ie->load_opts.dpi,
+                  ie->load_opts.w, ie->load_opts.h,
+                  ie->load_opts.region.x, ie->load_opts.region.y,
+                  ie->load_opts.region.w, ie->load_opts.region.h);
+   if ((len < 0) || (len >= size) ||
+       ((int)sizeof(Disk_Header) + len > DISK_HEADER_SIZE)) return -1;
+   for (i = 0; i < len; i++)
+     {
+        h ^= (unsigned char)buf[i];
+        h *= 1099511628211ULL;
+     }
+   snprintf(name, 20, "%016llx", h);
+   return len;
+}
+
+// find a valid entry for ie. returns an fd for it with the header in hdr,
+// or -1
+static int
+disk_open(Image_Entry *ie, Disk_Header *hdr)
+{
+   unsigned char head[DISK_HEADER_SIZE];
+   char key[PATH_MAX * 2], name[20], path[PATH_MAX];
+   struct stat st, sst;
+   int fd, len;
+   
+   if ((!disk_dir) || (!ie->file)) return -1;
+   len = disk_key_get(ie, key, sizeof(key), name);
+   if (len < 0) return -1;
+   if (stat(ie->file, &sst) < 0) return -1;
+   snprintf(path, sizeof(path), "%s/%s", disk_dir, name);
+   fd = open(path, O_RDONLY);
+   if (fd < 0) return -1;
+   if ((fstat(fd, &st) < 0) ||
+       (read(fd, head, sizeof(head)) != sizeof(head)))
+     goto bad;
+   memcpy(hdr, head, sizeof(Disk_Header));
+   if ((memcmp(hdr->magic, DISK_MAGIC, sizeof(hdr->magic))) ||
+       (hdr->w <= 0) || (hdr->h <= 0) ||
+       (((long long)hdr->w * hdr->h) > ((INT_MAX - DISK_HEADER_SIZE) / (int)sizeof(DATA32))) ||
+       (st.st_size != (DISK_HEADER_SIZE + ((off_t)hdr->w * hdr->h * sizeof(DATA32)))))
+     goto bad;
+   if ((hdr->key_len != len) ||
+       (memcmp(head + sizeof(Disk_Header), key, len)))
+     {
+        // hash collision - leave the other image's entry alone
+        close(fd);
+        return -1;
+     }
+   if ((hdr->src_mtime != (long long)sst.st_mtime) ||
+       (hdr->src_size != (long long)sst.st_size))
+     {
+        DBG("... disk cache %s stale", name);
+        goto bad;
+     }
+   utimes(path, NULL);
+   LKL(disk_lock);
+   disk_entry_add(name, st.st_size);
+   LKU(disk_lock);
+   return fd;
+bad:
+   close(fd);
+   LKL(disk_lock);
+   disk_entry_del(name, 1);
+   LKU(disk_lock);
+   return -1;
+}
+
+static Eina_Bool
+disk_write(int fd, const void *data, size_t size)
+{
+   const unsigned char *p = data;
+   ssize_t n;
+   
+   while (size > 0)
+     {
+        n = write(fd, p, size);
+        if (n < 0)
+          {
+             if (errno == EINTR) continue;
+             return 0;
+          }
+        p += n;
+        size -= n;
+     }
+   return 1;
+}
+
+// write a freshly decoded image out. it goes to a temporary file first so
+// a crash never leaves a partial entry under a real name
+static void
+disk_store(Img *img)
+{
+   Image_Entry *ie = (Image_Entry *)img;
+   unsigned char head[DISK_HEADER_SIZE];
+   char key[PATH_MAX * 2], name[20], path[PATH_MAX], tmp[PATH_MAX];
+   Disk_Header hdr;
+   struct stat sst;
+   size_t size;
+   int fd, len;
+   
+   if ((!disk_dir) || (img->disk) || (!img->image.data)) return;
+   if ((ie->w <= 0) || (ie->h <= 0)) return;
+   size = (size_t)ie->w * ie->h * sizeof(DATA32);
+   if (((DISK_HEADER_SIZE + size) / 1024) > (size_t)disk_max_usage) return;
+   len = disk_key_get(ie, key, sizeof(key), name);
+   if (len < 0) return;
+   // don't store pixels of a source that changed since we loaded it
+   if ((stat(ie->file, &sst) < 0) || (sst.st_mtime != img->file.modtime))
+     return;
+   memset(head, 0, sizeof(head));
+   memset(&hdr, 0, sizeof(hdr));
+   memcpy(hdr.magic, DISK_MAGIC, sizeof(hdr.magic));
+   hdr.w = ie->w;
+   hdr.h = ie->h;
+   hdr.alpha = ie->flags.alpha;
+   hdr.key_len = len;
+   hdr.src_mtime = sst.st_mtime;
+   hdr.src_size = sst.st_size;
+   memcpy(head, &hdr, sizeof(hdr));
+   memcpy(head + sizeof(hdr), key, len);
+   snprintf(tmp, sizeof(tmp), "%s/.tmp-XXXXXX", disk_dir);
+   fd = mkstemp(tmp);
+   if (fd < 0) return;
+   if ((!disk_write(fd, head, sizeof(head))) ||
+       (!disk_write(fd, img->image.data, size)))
+     {
+        close(fd);
+        unlink(tmp);
+        return;
+     }
+   close(fd);
+   snprintf(path, sizeof(path), "%s/%s", disk_dir, name);
+   if (rename(tmp, path) < 0)
+     {
+        unlink(tmp);
+        return;
+     }
+   DBG("... disk cache store %s '%s'", name, ie->file);
+   LKL(disk_lock);
+   disk_entry_add(name, DISK_HEADER_SIZE + size);
+   disk_clean();
+   LKU(disk_lock);
+}
+
 static int
 _img_surface_alloc(Image_Entry *ie, int w, int h)
 {
    Img *img = (Img *)ie;
 
-   img->mem = evas_cserve_mem_new(w * h * sizeof(DATA32), NULL);
-   if (!img->mem) return -1;
+   img->mem = evas_cserve_mem_anon_new(w * h * sizeof(DATA32));
+   if (!img->mem)
+     {
+        img->mem = evas_cserve_mem_new(w * h * sizeof(DATA32), NULL);
+        if (!img->mem) return -1;
+        stat_mems = eina_list_append(stat_mems, img->mem);
+        stat_update(stat_mem);
+     }
    img->image.data = img->mem->data + img->mem->offset;
-   
-   stat_mems = eina_list_append(stat_mems, img->mem);
-   stat_update(stat_mem);
    return 0;
 }
 
@@ -351,11 +724,8 @@ _img_surface_delete(Image_Entry *ie)
 
    if (!img->mem) return;
    
-   stat_mems = eina_list_remove(stat_mems, img->mem);
+   img_mem_free(img);
    stat_update(stat_mem);
-   
-   evas_cserve_mem_free(img->mem);
-   img->mem = NULL;
    img->image.data = NULL;
 }
 
@@ -370,6 +740,18 @@ _img_surface_pixels(Image_Entry *ie)
 static int
 _img_load(Image_Entry *ie)
 {
+   Disk_Header hdr;
+   int fd;
+   
+   fd = disk_open(ie, &hdr);
+   if (fd >= 0)
+     {
+        close(fd);
+        ie->w = hdr.w;
+        ie->h = hdr.h;
+        ie->flags.alpha = hdr.alpha;
+        return EVAS_LOAD_ERROR_NONE;
+     }
    return evas_common_load_rgba_image_module_from_file(ie);
 }
 
@@ -416,6 +798,35 @@ _img_color_space(Image_Entry *ie, int cspace)
 static int
 _img_load_data(Image_Entry *ie)
 {
+   Img *img = (Img *)ie;
+   Disk_Header hdr;
+   int fd, err;
+   
+   fd = disk_open(ie, &hdr);
+   if (fd >= 0)
+     {
+        if ((hdr.w == ie->w) && (hdr.h == ie->h))
+          {
+             img->mem = evas_cserve_mem_fd_open(fd, DISK_HEADER_SIZE,
+                                                DISK_HEADER_SIZE + (ie->w * ie->h * sizeof(DATA32)));
+             if (img->mem)
+               {
+                  img->disk = 1;
+                  img->image.data = img->mem->data + img->mem->offset;
+                  ie->allocated.w = ie->w;
+                  ie->allocated.h = ie->h;
+                  return EVAS_LOAD_ERROR_NONE;
+               }
+          }
+        else
+          close(fd);
+     }
+   // the header came from the disk cache but the entry is gone now
+   if (!ie->info.module)
+     {
+        err = evas_common_load_rgba_image_module_from_file(ie);
+        if (err != EVAS_LOAD_ERROR_NONE) return err;
+     }
    return evas_common_load_rgba_image_data_from_file(ie);
 }
 
@@ -529,12 +940,14 @@ img_loaddata(Img *img)
    img->stats.load2 = t;
    if (img->image.data)
      msync(img->image.data, img->image.w * img->image.h * sizeof(DATA32), MS_SYNC | MS_INVALIDATE);
+   if (img->mem) evas_cserve_mem_seal(img->mem);
    if (!img->active) cache_usage -= img->usage;
    img->usage += 
      (4096 * (((img->image.w * img->image.h * sizeof(DATA32)) + 4095) / 4096)) +
      sizeof(Mem);
    if (!img->active) cache_usage += img->usage;
    LKU(cache_lock);
+   disk_store(img);
    cache_clean();
 }
 
@@ -847,9 +1260,7 @@ img_unloaddata(Img *img)
           (4096 * (((img->image.w * img->image.h * sizeof(DATA32)) + 4095) / 4096)) +
           sizeof(Mem);
         if (!img->active) cache_usage += img->usage;
-        evas_cserve_mem_free(img->mem);
-        stat_mems = eina_list_remove(stat_mems, img->mem);
-        img->mem = NULL;
+        img_mem_free(img);
         img->image.data = NULL;
         img->dref = 0;
         DBG("... done");
@@ -882,6 +1293,11 @@ img_preload(Img *img)
    DBG("img_preload() %p", img);
 }
 
+#ifdef BUILD_PTHREAD
+static void decode_client_del(Client *c);
+static void decode_img_unloaddata(Img *img);
+#endif
+
 static void
 client_del(void *data, Client *c)
 {
@@ -890,10 +1306,17 @@ client_del(void *data, Client *c)
    
    images = data;
    DBG("... CLIENT DEL %i", c->pid);
+#ifdef BUILD_PTHREAD
+   decode_client_del(c);
+#endif
    EINA_LIST_FREE(images, img)
      {
         DBG("... unloaddata img %p", img);
+#ifdef BUILD_PTHREAD
+        decode_img_unloaddata(img);
+#else
         img_unloaddata(img);
+#endif
         DBG("... unload img %p", img);
         img_unload(img);
      }
@@ -911,46 +1334,393 @@ getinfo_hash_image_cb(const Eina_Hash *hash __UNUSED__,
    return 1;
 }
 
-#ifdef BUILD_PTHREAD
-static void *
-load_data_thread(void *data)
+// reply to OP_LOADDATA. clients that speak the fd protocol get the memory
+// fd passed along with the reply, others get a named segment to open
+static void
+loaddata_reply(Client *c, Img *img)
 {
-   Load_Inf *li = data;
-   Img *img = li->img;
-   Client *c = li->c;
    Op_Loaddata_Reply msg;
-
-   free(li);
-   LKL(img->lock);
-   if (img->mem)
+   Mem *m = NULL;
+   
+   memset(&msg, 0, sizeof(msg));
+   if (img) m = img->mem;
+   if ((m) && (c->proto >= EVAS_CSERVE_PROTO_FD))
      {
-        memset(&msg, 0, sizeof(msg));
-        msg.mem.id = img->mem->id;
-        msg.mem.offset = img->mem->offset;
-        msg.mem.size = img->mem->size;
-        DBG("... reply");
-        evas_cserve_client_send(c, OP_LOADDATA, sizeof(msg), (unsigned char *)(&msg));
-        LKU(c->lock);
-        return NULL;
+        msg.mem.id = m->id;
+        msg.mem.offset = m->offset;
+        msg.mem.size = m->size;
+        DBG("... reply with fd %i", m->fd);
+        if (evas_cserve_client_send_fd(c, OP_LOADDATA, sizeof(msg), (unsigned char *)(&msg), m->fd))
+          return;
      }
-   img_loaddata(img);
-   memset(&msg, 0, sizeof(msg));
-   if (img->mem)
+   if (m)
      {
-        msg.mem.id = img->mem->id;
-        msg.mem.offset = img->mem->offset;
-        msg.mem.size = img->mem->size;
+        LKL(cache_lock);
+        m = img_mem_named_get(img);
+        LKU(cache_lock);
+     }
+   if (m)
+     {
+        msg.mem.id = m->id;
+        msg.mem.offset = m->offset;
+        msg.mem.size = m->size;
      }
    else
      msg.mem.id = msg.mem.offset = msg.mem.size = 0;
-   LKU(img->lock);
    DBG("... reply");
    evas_cserve_client_send(c, OP_LOADDATA, sizeof(msg), (unsigned char *)(&msg));
-   LKU(c->lock);
+}
+
+#ifdef BUILD_PTHREAD
+// decode pool. OP_LOADDATA requests that need an image decoded are queued
+// here and handled by a fixed set of threads, so one slow image doesn't
+// hold up other clients. requests from the main channel of a client
+// (images it wants to draw now) go before those from its 2nd channel
+// (preloads), and within each queue a client that already has a decode
+// running waits behind clients that don't. a job holds a ref on its image
+// that only the main loop drops (see decode_reap()), and a client that goes
+// away mid-decode just has its jobs orphaned - nothing waits on it.
+// OP_LOADDATA replies all go out under decode_lock (REPLY_LOCK()), so a
+// thread never needs c->lock, which the server holds while it deletes c.
+#define DECODE_THREADS_MAX 16
+
+static int decode_threads = 0; // 0 = one per cpu
+static int decode_threads_running = 0;
+static pthread_t decode_tid[DECODE_THREADS_MAX];
+static pthread_mutex_t decode_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t decode_cond = PTHREAD_COND_INITIALIZER;
+static Eina_List *decode_queue[2] = { NULL, NULL }; // now, preload
+static Eina_List *decode_running = NULL;
+static Eina_List *decode_done = NULL; // finished, img ref still to drop
+static int decode_exit = 0;
+static Op_Getstats_Decode decode_stats;
+
+// call with decode_lock held
+static Decode_Job *
+decode_job_get(void)
+{
+   Eina_List *l;
+   Decode_Job *job;
+   int i;
+   
+   for (i = 0; i < 2; i++)
+     {
+        if (!decode_queue[i]) continue;
+        EINA_LIST_FOREACH(decode_queue[i], l, job)
+          {
+             if (job->owner->decoding == 0) break;
+          }
+        if (!l) l = decode_queue[i];
+        job = l->data;
+        decode_queue[i] = eina_list_remove_list(decode_queue[i], l);
+        decode_stats.queued--;
+        return job;
+     }
    return NULL;
 }
+
+static void *
+decode_thread(void *data __UNUSED__)
+{
+   Decode_Job *job = NULL;
+   double t;
+   
+   pthread_mutex_lock(&decode_lock);
+   for (;;)
+     {
+        while ((!decode_exit) && (!(job = decode_job_get())))
+          pthread_cond_wait(&decode_cond, &decode_lock);
+        if (decode_exit) break;
+        t = get_time();
+        decode_stats.wait_time += t - job->queued;
+        decode_stats.running++;
+        job->owner->decoding++;
+        decode_running = eina_list_append(decode_running, job);
+        pthread_mutex_unlock(&decode_lock);
+        
+        DBG("... decode %p", job->img);
+        LKL(job->img->lock);
+        img_loaddata(job->img);
+        LKU(job->img->lock);
+        
+        pthread_mutex_lock(&decode_lock);
+        if (!job->orphaned)
+          {
+             loaddata_reply(job->c, job->img);
+             job->owner->decoding--;
+          }
+        decode_running = eina_list_remove(decode_running, job);
+        decode_done = eina_list_append(decode_done, job);
+        decode_stats.running--;
+        decode_stats.decoded++;
+        decode_stats.decode_time += get_time() - t;
+     }
+   pthread_mutex_unlock(&decode_lock);
+   return NULL;
+}
+
+static void
+decode_job_free(Decode_Job *job)
+{
+   Img *img = job->img;
+   int doflush = 0;
+   
+   LKL(img->lock);
+   for (; job->unloaddata > 0; job->unloaddata--) img_unloaddata(img);
+   img->ref--;
+   if (img->ref == 0) doflush = 1;
+   LKU(img->lock);
+   if (doflush) img_cache(img);
+   free(job);
+}
+
+// main loop only - drop what finished decodes still hold
+static void
+decode_reap(void)
+{
+   Eina_List *done;
+   Decode_Job *job;
+   
+   pthread_mutex_lock(&decode_lock);
+   done = decode_done;
+   decode_done = NULL;
+   pthread_mutex_unlock(&decode_lock);
+   EINA_LIST_FREE(done, job) decode_job_free(job);
+}
+
+static void
+decode_init(void)
+{
+   int i;
+   
+   if (decode_threads <= 0)
+     decode_threads = sysconf(_SC_NPROCESSORS_ONLN);
+   if (decode_threads < 1) decode_threads = 1;
+   if (decode_threads > DECODE_THREADS_MAX) decode_threads = DECODE_THREADS_MAX;
+   memset(&decode_stats, 0, sizeof(decode_stats));
+   for (i = 0; i < decode_threads; i++)
+     {
+        if (pthread_create(&(decode_tid[i]), NULL, decode_thread, NULL))
+          {
+             perror("pthread_create()");
+             break;
+          }
+     }
+   decode_threads_running = i;
+   decode_stats.threads = i;
+}
+
+static void
+decode_shutdown(void)
+{
+   Decode_Job *job;
+   int i;
+   
+   pthread_mutex_lock(&decode_lock);
+   decode_exit = 1;
+   pthread_cond_broadcast(&decode_cond);
+   pthread_mutex_unlock(&decode_lock);
+   for (i = 0; i < decode_threads_running; i++)
+     pthread_join(decode_tid[i], NULL);
+   decode_threads_running = 0;
+   for (i = 0; i < 2; i++)
+     {
+        EINA_LIST_FREE(decode_queue[i], job) decode_job_free(job);
+     }
+   decode_reap();
+}
+
+// queue a decode of img for c. the reply is sent from the decode thread
+static Eina_Bool
+decode_job_add(Client *c, Img *img)
+{
+   Decode_Job *job;
+   int pri = 0;
+   
+   if (decode_threads_running <= 0) return 0;
+   job = calloc(1, sizeof(Decode_Job));
+   if (!job) return 0;
+   job->img = img;
+   job->c = c;
+   job->owner = c;
+   if (c->client_main)
+     {
+        job->owner = c->client_main;
+        pri = 1;
+     }
+   job->queued = get_time();
+   LKL(img->lock);
+   img->ref++;
+   LKU(img->lock);
+   pthread_mutex_lock(&decode_lock);
+   decode_queue[pri] = eina_list_append(decode_queue[pri], job);
+   decode_stats.queued++;
+   if (decode_stats.queued > decode_stats.queued_peak)
+     decode_stats.queued_peak = decode_stats.queued;
+   pthread_cond_signal(&decode_cond);
+   pthread_mutex_unlock(&decode_lock);
+   return 1;
+}
+
+// c is done with img, so drop any of its decodes of img that have not
+// started yet. whoever waits for them gets an empty reply
+static void
+decode_job_cancel(Client *c, Img *img)
+{
+   Eina_List *l, *l_next, *cancelled = NULL;
+   Decode_Job *job;
+   Client *owner;
+   int i;
+   
+   owner = c->client_main ? c->client_main : c;
+   pthread_mutex_lock(&decode_lock);
+   for (i = 0; i < 2; i++)
+     {
+        EINA_LIST_FOREACH_SAFE(decode_queue[i], l, l_next, job)
+          {
+             if ((job->img != img) || (job->owner != owner)) continue;
+             decode_queue[i] = eina_list_remove_list(decode_queue[i], l);
+             decode_stats.queued--;
+             decode_stats.cancelled++;
+             cancelled = eina_list_append(cancelled, job);
+          }
+     }
+   EINA_LIST_FOREACH(cancelled, l, job)
+     {
+        DBG("... cancel decode %p", job->img);
+        loaddata_reply(job->c, NULL);
+     }
+   pthread_mutex_unlock(&decode_lock);
+   EINA_LIST_FREE(cancelled, job) decode_job_free(job);
+}
+
+// c is going away. its queued decodes are dropped unanswered and running
+// ones orphaned, so the threads never touch c again
+static void
+decode_client_del(Client *c)
+{
+   Eina_List *l, *l_next, *dropped = NULL;
+   Decode_Job *job;
+   int i;
+   
+   pthread_mutex_lock(&decode_lock);
+   for (i = 0; i < 2; i++)
+     {
+        EINA_LIST_FOREACH_SAFE(decode_queue[i], l, l_next, job)
+          {
+             if ((job->c != c) && (job->owner != c)) continue;
+             decode_queue[i] = eina_list_remove_list(decode_queue[i], l);
+             decode_stats.queued--;
+             decode_stats.cancelled++;
+             dropped = eina_list_append(dropped, job);
+          }
+     }
+   EINA_LIST_FOREACH(decode_running, l, job)
+     {
+        if ((job->orphaned) || ((job->c != c) && (job->owner != c))) continue;
+        // the thread won't get to this once orphaned, so do it here
+        if (job->owner != c) job->owner->decoding--;
+        job->orphaned = 1;
+     }
+   pthread_mutex_unlock(&decode_lock);
+   EINA_LIST_FREE(dropped, job) decode_job_free(job);
+}
+
+// a client is done with img. if a decode of img holds its lock, leave the
+// unloaddata to decode_reap() once it is through rather than skip it
+static void
+decode_img_unloaddata(Img *img)
+{
+   Eina_List *l;
+   Decode_Job *job;
+   
+   if (!pthread_mutex_trylock(&(img->lock)))
+     {
+        img_unloaddata(img);
+        LKU(img->lock);
+        return;
+     }
+   pthread_mutex_lock(&decode_lock);
+   EINA_LIST_FOREACH(decode_running, l, job)
+     {
+        if (job->img == img) break;
+     }
+   if (!l)
+     {
+        EINA_LIST_FOREACH(decode_done, l, job)
+          {
+             if (job->img == img) break;
+          }
+     }
+   if (l) job->unloaddata++;
+   pthread_mutex_unlock(&decode_lock);
+   if (l) return;
+   // not a decode holding it, so it won't be long
+   LKL(img->lock);
+   img_unloaddata(img);
+   LKU(img->lock);
+}
+
+# define REPLY_LOCK() pthread_mutex_lock(&decode_lock)
+# define REPLY_UNLOCK() pthread_mutex_unlock(&decode_lock)
+#else
+# define REPLY_LOCK()
+# define REPLY_UNLOCK()
 #endif
 
+// load the image header for client c. msg gets the reply for it
+static Img *
+client_img_load(Client *c, Op_Load *rep, const char *file, const char *key, Op_Load_Reply *msg)
+{
+   Img *img;
+   RGBA_Image_Loadopts lopt = {0, 0.0, 0, 0, {0, 0, 0, 0}};
+   
+   if (key[0] == 0) key = NULL;
+   lopt.scale_down_by = rep->lopt.scale_down_by;
+   lopt.dpi = rep->lopt.dpi;
+   lopt.w = rep->lopt.w;
+   lopt.h = rep->lopt.h;
+   lopt.region.x = rep->lopt.region.x;
+   lopt.region.y = rep->lopt.region.y;
+   lopt.region.w = rep->lopt.region.w;
+   lopt.region.h = rep->lopt.region.h;
+   DBG("... img_load '%s'", file);
+   if (key) DBG("'%s'", (char *)key);
+   else DBG("   '%s'", "");
+   DBG("   lopt { %i %1.1f %i %i { %i %i %i %i}}",
+     lopt.scale_down_by, lopt.dpi, lopt.w, lopt.h, 
+     lopt.region.x, lopt.region.y, lopt.region.w, lopt.region.h);
+   img = img_load(file, key, &lopt);
+   DBG("... img_load = %p", img);
+   if (img)
+     {
+        DBG("... add image to client list");
+        if (c->client_main)
+          c->client_main->data = eina_list_append(c->client_main->data, img);
+        else
+          c->data = eina_list_append(c->data, img);
+     }
+   memset(msg, 0, sizeof(Op_Load_Reply));
+   msg->handle = img;
+   if ((img) && (img->mem))
+     {
+        msg->mem.id = img->mem->id;
+        msg->mem.offset = img->mem->offset;
+        msg->mem.size = img->mem->size;
+        img->stats.load2saved++;
+        stats_update();
+     }
+   else
+     msg->mem.id = msg->mem.offset = msg->mem.size = 0;
+   if (img)
+     {
+        msg->image.w = img->image.w;
+        msg->image.h = img->image.h;
+        msg->image.alpha = img->image.alpha;
+     }
+   return img;
+}
+
 static int
 message(void *fdata, Server *s, Client *c, int opcode, int size, unsigned char *data)
 {
@@ -965,80 +1735,50 @@ message(void *fdata, Server *s, Client *c, int opcode, int size, unsigned char *
      case OP_INIT:
           {
              Op_Init *rep;
-             Op_Init msg;
+             Op_Init_Proto msg;
              
              memset(&msg, 0, sizeof(msg));
-             msg.pid = getpid();
-             msg.server_id = server_id;
-             msg.handle = c;
+             msg.init.pid = getpid();
+             msg.init.server_id = server_id;
+             msg.init.handle = c;
              rep = (Op_Init *)tdata;
              c->pid = rep->pid;
+             // newer clients append the protocol they would like to speak
+             c->proto = EVAS_CSERVE_PROTO_NAMED;
+             if (size >= (int)sizeof(Op_Init_Proto))
+               {
+                  c->proto = ((Op_Init_Proto *)tdata)->proto;
+                  if (c->proto > EVAS_CSERVE_PROTO_LATEST)
+                    c->proto = EVAS_CSERVE_PROTO_LATEST;
+                  if (c->proto < EVAS_CSERVE_PROTO_NAMED)
+                    c->proto = EVAS_CSERVE_PROTO_NAMED;
+               }
+             msg.proto = c->proto;
              if (rep->server_id == 1) // 2nd channel conn
                {
                   c->client_main = rep->handle;
                }
              c->func = client_del;
              c->data = NULL;
-             DBG("OP_INIT %i", c->pid);
+             DBG("OP_INIT %i (proto %i)", c->pid, c->proto);
              DBG("... reply");
-             evas_cserve_client_send(c, OP_INIT, sizeof(msg), (unsigned char *)(&msg));
+             if (size >= (int)sizeof(Op_Init_Proto))
+               evas_cserve_client_send(c, OP_INIT, sizeof(msg), (unsigned char *)(&msg));
+             else
+               evas_cserve_client_send(c, OP_INIT, sizeof(Op_Init), (unsigned char *)(&(msg.init)));
           }
         break;
      case OP_LOAD:
           {
              Op_Load *rep;
              Op_Load_Reply msg;
-             Img *img;
-             RGBA_Image_Loadopts lopt = {0, 0.0, 0, 0, {0, 0, 0, 0}};
              char *file = NULL, *key = NULL;
              
              DBG("OP_LOAD %i", c->pid);
              rep = (Op_Load *)tdata;
              file = (char*) (data + sizeof(Op_Load));
              key = file + strlen(file) + 1;
-             if (key[0] == 0) key = NULL;
-             lopt.scale_down_by = rep->lopt.scale_down_by;
-             lopt.dpi = rep->lopt.dpi;
-             lopt.w = rep->lopt.w;
-             lopt.h = rep->lopt.h;
-             lopt.region.x = rep->lopt.region.x;
-             lopt.region.y = rep->lopt.region.y;
-             lopt.region.w = rep->lopt.region.w;
-             lopt.region.h = rep->lopt.region.h;
-             DBG("... img_load '%s'", file);
-             if (key) DBG("'%s'", (char *)key);
-             else DBG("   '%s'", "");
-             DBG("   lopt { %i %1.1f %i %i { %i %i %i %i}}",
-               lopt.scale_down_by, lopt.dpi, lopt.w, lopt.h, 
-               lopt.region.x, lopt.region.y, lopt.region.w, lopt.region.h);
-             img = img_load(file, key, &lopt);
-             DBG("... img_load = %p", img);
-             if (img)
-               {
-                  DBG("... add image to client list");
-                  if (c->client_main)
-                    c->client_main->data = eina_list_append(c->client_main->data, img);
-                  else
-                    c->data = eina_list_append(c->data, img);
-               }
-             memset(&msg, 0, sizeof(msg));
-             msg.handle = img;
-             if ((img) && (img->mem))
-               {
-                  msg.mem.id = img->mem->id;
-                  msg.mem.offset = img->mem->offset;
-                  msg.mem.size = img->mem->size;
-                  img->stats.load2saved++;
-                  stats_update();
-               }
-             else
-               msg.mem.id = msg.mem.offset = msg.mem.size = 0;
-             if (img)
-               {
-                  msg.image.w = img->image.w;
-                  msg.image.h = img->image.h;
-                  msg.image.alpha = img->image.alpha;
-               }
+             client_img_load(c, rep, file, key, &msg);
              DBG("... reply");
              evas_cserve_client_send(c, OP_LOAD, sizeof(msg), (unsigned char *)(&msg)); 
          } 
@@ -1055,6 +1795,9 @@ message(void *fdata, Server *s, Client *c, int opcode, int size, unsigned char *
                {
                   Eina_Bool doflush = 0;
                   
+#ifdef BUILD_PTHREAD
+                  decode_job_cancel(c, img);
+#endif
                   DBG("... remove %p from list", img);
                   if (c->client_main)
                     c->client_main->data = eina_list_remove(c->client_main->data, img);
@@ -1076,7 +1819,6 @@ message(void *fdata, Server *s, Client *c, int opcode, int size, unsigned char *
      case OP_LOADDATA:
           {
              Op_Loaddata *rep;
-             Op_Loaddata_Reply msg;
              Img *img;
              
              DBG("OP_LOADDATA %i", c->pid);
@@ -1089,61 +1831,29 @@ message(void *fdata, Server *s, Client *c, int opcode, int size, unsigned char *
                        DBG("... load saved - cached %p", img);
                        img->stats.load2saved++;
                        stats_update();
-                       memset(&msg, 0, sizeof(msg));
-                       if (img->mem)
-                         {
-                            msg.mem.id = img->mem->id;
-                            msg.mem.offset = img->mem->offset;
-                            msg.mem.size = img->mem->size;
-                         }
-                       else
-                         msg.mem.id = msg.mem.offset = msg.mem.size = 0;
-                       DBG("... reply");
-                       evas_cserve_client_send(c, OP_LOADDATA, sizeof(msg), (unsigned char *)(&msg));
+                       REPLY_LOCK();
+                       loaddata_reply(c, img);
+                       REPLY_UNLOCK();
                     }
                   else
                     {
 #ifdef BUILD_PTHREAD
-                       pthread_t tid;
-                       pthread_attr_t attr;
-                       Load_Inf *li;
-                       
-                       DBG("... load data %p", img);
-                       pthread_attr_init(&attr);
-                       li = calloc(1, sizeof(Load_Inf));
-                       if (li)
-                         {
-                            li->img= img;
-                            li->c = c;
-                            LKL(c->lock);
-                            if (pthread_create(&tid, &attr, load_data_thread, li))
-                              {
-                                 perror("pthread_create()");
-                              }
-                            else
-                              pthread_detach(tid);
-                         }
-                       pthread_attr_destroy(&attr);
-#else
-                       img_loaddata(img);
-                       memset(&msg, 0, sizeof(msg));
-                       if (img->mem)
-                         {
-                            msg.mem.id = img->mem->id;
-                            msg.mem.offset = img->mem->offset;
-                            msg.mem.size = img->mem->size;
-                         }
-                       else
-                         msg.mem.id = msg.mem.offset = msg.mem.size = 0;
-                       DBG("... reply");
-                       evas_cserve_client_send(c, OP_LOADDATA, sizeof(msg), (unsigned char *)(&msg));
+                       DBG("... queue decode %p", img);
+                       if (decode_job_add(c, img)) break;
 #endif
+                       LKL(img->lock);
+                       img_loaddata(img);
+                       LKU(img->lock);
+                       REPLY_LOCK();
+                       loaddata_reply(c, img);
+                       REPLY_UNLOCK();
                     }
                }
              else
                {
-                  msg.mem.id = msg.mem.offset = msg.mem.size = 0;
-                  evas_cserve_client_send(c, OP_LOADDATA, sizeof(msg), (unsigned char *)(&msg));
+                  REPLY_LOCK();
+                  loaddata_reply(c, NULL);
+                  REPLY_UNLOCK();
                }
           }
         break;
@@ -1219,6 +1929,9 @@ message(void *fdata, Server *s, Client *c, int opcode, int size, unsigned char *
                {
                   Eina_Bool doflush = 0;
                   
+#ifdef BUILD_PTHREAD
+                  decode_job_cancel(c, img);
+#endif
                   LKL(img->lock);
                   DBG("remove %p from list", img);
                   if (c->client_main)
@@ -1267,6 +1980,8 @@ message(void *fdata, Server *s, Client *c, int opcode, int size, unsigned char *
      case OP_GETSTATS:
           {
              Op_Getstats_Reply msg;
+             Op_Getstats_Decode dmsg;
+             unsigned char buf[sizeof(Op_Getstats_Reply) + sizeof(Op_Getstats_Decode)];
 
              DBG("OP_GETSTATS %i", c->pid);
              stats_calc();
@@ -1277,7 +1992,20 @@ message(void *fdata, Server *s, Client *c, int opcode, int size, unsigned char *
              msg.saved_time_image_header_load = saved_load_lifetime + saved_load_time;
              msg.saved_time_image_data_load = saved_loaddata_lifetime + saved_loaddata_time;
              DBG("... reply");
-             evas_cserve_client_send(c, OP_GETSTATS, sizeof(msg), (unsigned char *)(&msg));
+             if (c->proto < EVAS_CSERVE_PROTO_STATS)
+               {
+                  evas_cserve_client_send(c, OP_GETSTATS, sizeof(msg), (unsigned char *)(&msg));
+                  break;
+               }
+             memset(&dmsg, 0, sizeof(dmsg));
+#ifdef BUILD_PTHREAD
+             pthread_mutex_lock(&decode_lock);
+             dmsg = decode_stats;
+             pthread_mutex_unlock(&decode_lock);
+#endif
+             memcpy(buf, &msg, sizeof(msg));
+             memcpy(buf + sizeof(msg), &dmsg, sizeof(dmsg));
+             evas_cserve_client_send(c, OP_GETSTATS, sizeof(buf), buf);
           } 
         break;
      case OP_GETINFO:
@@ -1425,6 +2153,9 @@ parse_args(int argc, char **argv)
                     "\t-csize      Size of speculative cache (Kb)\n"
                     "\t-ctime      Maximum life of a cached image (seconds)\n"
                     "\t-ctimecheck Time between checking the cache for timeouts (seconds)\n"
+                    "\t-dthreads   Number of image decode threads (default: one per cpu)\n"
+                    "\t-dcache     Directory to keep decoded images in across restarts\n"
+                    "\t-dcachesize Size limit of the -dcache directory (Kb)\n"
                     "\t-debug      Enable debug logging\n"
                     "\n");
              exit(0);
@@ -1444,6 +2175,24 @@ parse_args(int argc, char **argv)
              i++;
              cache_item_timeout_check = atoi(argv[i]);
           }
+        else if ((!strcmp(argv[i], "-dcache")) && (i < (argc - 1)))
+          {
+             i++;
+             free(disk_dir);
+             disk_dir = strdup(argv[i]);
+          }
+        else if ((!strcmp(argv[i], "-dcachesize")) && (i < (argc - 1)))
+          {
+             i++;
+             disk_max_usage = atoi(argv[i]);
+          }
+#ifdef BUILD_PTHREAD
+        else if ((!strcmp(argv[i], "-dthreads")) && (i < (argc - 1)))
+          {
+             i++;
+             decode_threads = atoi(argv[i]);
+          }
+#endif
         else if (!strcmp(argv[i], "-debug"))
           {
 	     eina_log_level_set(EINA_LOG_LEVEL_DBG);
@@ -1541,6 +2290,8 @@ main(int argc, char **argv)
    evas_init();
    DBG("img init...");
    img_init();
+   DBG("disk cache init...");
+   disk_init();
    DBG("signal init...");
    signal_init();
    DBG("cserve add...");
@@ -1575,6 +2326,10 @@ main(int argc, char **argv)
         goto error;
      }
    
+#ifdef BUILD_PTHREAD
+   DBG("decode pool init...");
+   decode_init();
+#endif
    DBG("cset server message handler...");
    evas_cserve_server_message_handler_set(s, message, NULL);
    last_check = time(NULL);
@@ -1620,6 +2375,9 @@ main(int argc, char **argv)
           }
         LKU(strshr_freeme_lock);
         
+#ifdef BUILD_PTHREAD
+        decode_reap();
+#endif
         LKL(cache_lock);
         if (cache_cleanme)
           {
@@ -1650,6 +2408,10 @@ main(int argc, char **argv)
         LKU(cache_lock);
      }
    DBG("end loop...");
+#ifdef BUILD_PTHREAD
+   DBG("decode pool shutdown...");
+   decode_shutdown();
+#endif
    error:
    DBG("cleanup...");
    if (stat_mem)
@@ -1661,6 +2423,7 @@ main(int argc, char **argv)
    signal_shutdown();
    DBG("img shutdown...");
    img_shutdown();
+   disk_shutdown();
    if (stat_mem)
      {
         DBG("free stat mem...");
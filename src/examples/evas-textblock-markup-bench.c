@@ -0,0 +1,219 @@
+/**
+ * Times setting a big marked up document into a textblock.
+ *
+ * The same document is built twice: once as markup, set with
+ * evas_object_textblock_text_markup_set(), and once with cursor appends,
+ * one per text run, tag and escape - which is how the markup was parsed
+ * before it built the nodes itself. Both end up with the same text.
+ *
+ * You must have Evas compiled with the buffer engine, and have the
+ * evas-software-buffer pkg-config files installed.
+ *
+ * Compile with:
+ *
+ * @verbatim
+ * gcc -o evas-textblock-markup-bench evas-textblock-markup-bench.c `pkg-config --libs --cflags evas evas-software-buffer`
+ * @endverbatim
+ *
+ * Run with the document size in kilobytes (default 1024).
+ */
+#include <Evas.h>
+#include <Evas_Engine_Buffer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#define WIDTH (320)
+#define HEIGHT (240)
+#define LOOPS (5)
+
+typedef struct _Piece Piece;
+
+struct _Piece
+{
+   const char *markup; // what goes in the markup
+   const char *text;   // what gets appended with the cursor
+   Eina_Bool   format; // appended as a format, not text
+};
+
+static const Piece pieces[] =
+{
+     { "12:00:01 ", "12:00:01 ", EINA_FALSE },
+     { "some log text ", "some log text ", EINA_FALSE },
+     { "<b>", "+ font_size=12", EINA_TRUE },
+     { "</b>", "- ", EINA_TRUE },
+     { "<br>", "\n", EINA_TRUE },
+     { "&lt;", "<", EINA_FALSE },
+     { "&gt;", ">", EINA_FALSE },
+     { "&amp;", "&", EINA_FALSE },
+     { "caf&eacute; ", "café ", EINA_FALSE },
+     { "&bull; ", "• ", EINA_FALSE },
+     { "<em>", "+ style=underline", EINA_TRUE },
+     { "</em>", "- ", EINA_TRUE }
+};
+
+static const char style[] =
+   "DEFAULT='font=Sans font_size=10 color=#000 wrap=word'"
+   "br='\\n'"
+   "b='+ font_size=12'"
+   "/b='- '"
+   "em='+ style=underline'"
+   "/em='- '";
+
+static Evas *create_canvas(int width, int height);
+static void destroy_canvas(Evas *canvas);
+
+static double
+now(void)
+{
+   struct timeval tv;
+
+   gettimeofday(&tv, NULL);
+   return tv.tv_sec + (tv.tv_usec / 1000000.0);
+}
+
+int main(int argc, char **argv)
+{
+   Evas *canvas;
+   Evas_Object *tb;
+   Evas_Textblock_Style *st;
+   Evas_Textblock_Cursor *cur;
+   int *order, count = 0, size, i, j;
+   char *markup, *p;
+   double t, t_markup, t_cursor;
+
+   size = 1024 * ((argc > 1) ? atoi(argv[1]) : 1024);
+   if (size <= 0) size = 1024 * 1024;
+
+   evas_init();
+   canvas = create_canvas(WIDTH, HEIGHT);
+   if (!canvas)
+     return -1;
+
+   st = evas_textblock_style_new();
+   evas_textblock_style_set(st, style);
+   tb = evas_object_textblock_add(canvas);
+   evas_object_textblock_style_set(tb, st);
+   evas_object_resize(tb, WIDTH, HEIGHT);
+
+   // the pieces, picked at random, that make up the document
+   order = malloc((size + 1) * sizeof(int));
+   markup = malloc(size + 64);
+   if ((!order) || (!markup))
+     {
+	fputs("ERROR: could not allocate the document!\n", stderr);
+	return -1;
+     }
+   srand(1);
+   for (p = markup; p - markup < size; count++)
+     {
+	order[count] = rand() % (sizeof(pieces) / sizeof(pieces[0]));
+	strcpy(p, pieces[order[count]].markup);
+	p += strlen(p);
+     }
+
+   t = now();
+   for (i = 0; i < LOOPS; i++)
+     evas_object_textblock_text_markup_set(tb, markup);
+   t_markup = (now() - t) / LOOPS;
+
+   t = now();
+   for (i = 0; i < LOOPS; i++)
+     {
+	evas_object_textblock_clear(tb);
+	cur = evas_object_textblock_cursor_new(tb);
+	evas_textblock_cursor_node_first(cur);
+	for (j = 0; j < count; j++)
+	  {
+	     if (pieces[order[j]].format)
+	       evas_textblock_cursor_format_append(cur, pieces[order[j]].text);
+	     else
+	       evas_textblock_cursor_text_append(cur, pieces[order[j]].text);
+	  }
+	evas_textblock_cursor_free(cur);
+     }
+   t_cursor = (now() - t) / LOOPS;
+
+   printf("%i KB of markup, %i runs, tags and escapes\n", size / 1024, count);
+   printf("markup set:     %8.2f ms\n", t_markup * 1000.0);
+   printf("cursor appends: %8.2f ms\n", t_cursor * 1000.0);
+
+   free(order);
+   free(markup);
+   evas_object_del(tb);
+   evas_textblock_style_free(st);
+   destroy_canvas(canvas);
+   evas_shutdown();
+
+   return 0;
+}
+
+static Evas *create_canvas(int width, int height)
+{
+   Evas *canvas;
+   Evas_Engine_Info_Buffer *einfo;
+   int method;
+   void *pixels;
+
+   method = evas_render_method_lookup("buffer");
+   if (method <= 0)
+     {
+	fputs("ERROR: evas was not compiled with 'buffer' engine!\n", stderr);
+	return NULL;
+     }
+
+   canvas = evas_new();
+   if (!canvas)
+     {
+	fputs("ERROR: could not instantiate new evas canvas.\n", stderr);
+	return NULL;
+     }
+
+   evas_output_method_set(canvas, method);
+   evas_output_size_set(canvas, width, height);
+   evas_output_viewport_set(canvas, 0, 0, width, height);
+
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(canvas);
+   if (!einfo)
+     {
+	fputs("ERROR: could not get evas engine info!\n", stderr);
+	evas_free(canvas);
+	return NULL;
+     }
+
+   pixels = malloc(width * height * sizeof(int));
+   if (!pixels)
+     {
+	fputs("ERROR: could not allocate canvas pixels!\n", stderr);
+	evas_free(canvas);
+	return NULL;
+     }
+
+   einfo->info.depth_type = EVAS_ENGINE_BUFFER_DEPTH_ARGB32;
+   einfo->info.dest_buffer = pixels;
+   einfo->info.dest_buffer_row_bytes = width * sizeof(int);
+   einfo->info.use_color_key = 0;
+   einfo->info.alpha_threshold = 0;
+   einfo->info.func.new_update_region = NULL;
+   einfo->info.func.free_update_region = NULL;
+   evas_engine_info_set(canvas, (Evas_Engine_Info *)einfo);
+
+   return canvas;
+}
+
+static void destroy_canvas(Evas *canvas)
+{
+   Evas_Engine_Info_Buffer *einfo;
+
+   einfo = (Evas_Engine_Info_Buffer *)evas_engine_info_get(canvas);
+   if (!einfo)
+     {
+	fputs("ERROR: could not get evas engine info!\n", stderr);
+	evas_free(canvas);
+	return;
+     }
+
+   free(einfo->info.dest_buffer);
+   evas_free(canvas);
+}
@@ -403,6 +403,20 @@ typedef enum _Evas_Image_Content_Hint
    EVAS_IMAGE_CONTENT_HINT_STATIC = 2
 } Evas_Image_Content_Hint;
 
+typedef enum _Evas_Image_Smooth_Scale_Mode
+{
+   EVAS_IMAGE_SMOOTH_SCALE_MODE_DEFAULT = 0, /**< Scale down from the full size image */
+   EVAS_IMAGE_SMOOTH_SCALE_MODE_MIPMAP = 1 /**< Scale down from the nearest level of a mipmap chain kept with the image */
+} Evas_Image_Smooth_Scale_Mode;
+
+typedef enum _Evas_Image_Preload_Priority
+{
+   EVAS_IMAGE_PRELOAD_PRIORITY_AUTO = 0, /**< High while the object is visible on the canvas, low otherwise */
+   EVAS_IMAGE_PRELOAD_PRIORITY_LOW = 1, /**< Loaded after everything else queued */
+   EVAS_IMAGE_PRELOAD_PRIORITY_NORMAL = 2, /**< Loaded in the order requested */
+   EVAS_IMAGE_PRELOAD_PRIORITY_HIGH = 3 /**< Loaded before anything else queued */
+} Evas_Image_Preload_Priority;
+
 struct _Evas_Engine_Info /** Generic engine information. Generic info is useless */
 {
    int magic; /**< Magic number */
@@ -615,6 +629,7 @@ typedef enum _Evas_Object_Pointer_Mode
 } Evas_Object_Pointer_Mode; /**< How mouse pointer should be handled by Evas. */
 
 typedef void      (*Evas_Smart_Cb) (void *data, Evas_Object *obj, void *event_info);
+typedef unsigned int Evas_Smart_Event_Id; /**< An interned smart event name, see evas_smart_event_id_get(). 0 is never a valid id */
 typedef void      (*Evas_Event_Cb) (void *data, Evas *e, void *event_info);
 typedef Eina_Bool (*Evas_Object_Event_Post_Cb) (void *data, Evas *e);
 typedef void      (*Evas_Object_Event_Cb) (void *data, Evas *e, Evas_Object *obj, void *event_info);
@@ -1223,7 +1238,11 @@ typedef void      (*Evas_Object_Event_Cb) (void *data, Evas *e, Evas_Object *obj
    EAPI Eina_Bool         evas_object_image_alpha_get       (const Evas_Object *obj) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_PURE;
    EAPI void              evas_object_image_smooth_scale_set(Evas_Object *obj, Eina_Bool smooth_scale) EINA_ARG_NONNULL(1);
    EAPI Eina_Bool         evas_object_image_smooth_scale_get(const Evas_Object *obj) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_PURE;
+   EAPI void              evas_object_image_smooth_scale_mode_set(Evas_Object *obj, Evas_Image_Smooth_Scale_Mode mode) EINA_ARG_NONNULL(1);
+   EAPI Evas_Image_Smooth_Scale_Mode evas_object_image_smooth_scale_mode_get(const Evas_Object *obj) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_PURE;
    EAPI void              evas_object_image_preload         (Evas_Object *obj, Eina_Bool cancel) EINA_ARG_NONNULL(1);
+   EAPI void              evas_object_image_preload_priority_set(Evas_Object *obj, Evas_Image_Preload_Priority priority) EINA_ARG_NONNULL(1);
+   EAPI Evas_Image_Preload_Priority evas_object_image_preload_priority_get(const Evas_Object *obj) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_PURE;
    EAPI void              evas_object_image_reload          (Evas_Object *obj) EINA_ARG_NONNULL(1);
    EAPI Eina_Bool         evas_object_image_save            (const Evas_Object *obj, const char *file, const char *key, const char *flags)  EINA_ARG_NONNULL(1, 2);
    EAPI Eina_Bool         evas_object_image_pixels_import          (Evas_Object *obj, Evas_Pixel_Import_Source *pixels) EINA_ARG_NONNULL(1, 2);
@@ -1344,6 +1363,8 @@ typedef void      (*Evas_Object_Event_Cb) (void *data, Evas *e, Evas_Object *obj
    EAPI const Evas_Textblock_Style  *evas_object_textblock_style_get(const Evas_Object *obj) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_PURE;
    EAPI void                         evas_object_textblock_replace_char_set(Evas_Object *obj, const char *ch) EINA_ARG_NONNULL(1);
    EAPI const char                  *evas_object_textblock_replace_char_get(Evas_Object *obj) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_PURE;
+   EAPI void                         evas_object_textblock_lazy_layout_set(Evas_Object *obj, Eina_Bool lazy) EINA_ARG_NONNULL(1);
+   EAPI Eina_Bool                    evas_object_textblock_lazy_layout_get(const Evas_Object *obj) EINA_WARN_UNUSED_RESULT EINA_ARG_NONNULL(1) EINA_PURE;
 
    EAPI void                         evas_object_textblock_text_markup_set(Evas_Object *obj, const char *text) EINA_ARG_NONNULL(1);
    EAPI void                         evas_object_textblock_text_markup_prepend(Evas_Textblock_Cursor *cur, const char *text) EINA_ARG_NONNULL(1, 2);
@@ -1799,6 +1820,12 @@ struct _Evas_Smart_Cb_Description
    EAPI void             *evas_object_smart_callback_del    (Evas_Object *obj, const char *event, Evas_Smart_Cb func) EINA_ARG_NONNULL(1, 2, 3);
    EAPI void              evas_object_smart_callback_call   (Evas_Object *obj, const char *event, void *event_info) EINA_ARG_NONNULL(1, 2);
 
+   EAPI Evas_Smart_Event_Id evas_smart_event_id_get         (const char *event) EINA_ARG_NONNULL(1);
+   EAPI const char       *evas_smart_event_id_name_get      (Evas_Smart_Event_Id id) EINA_PURE;
+   EAPI void              evas_object_smart_callback_id_add (Evas_Object *obj, Evas_Smart_Event_Id id, Evas_Smart_Cb func, const void *data) EINA_ARG_NONNULL(1, 3);
+   EAPI void             *evas_object_smart_callback_id_del (Evas_Object *obj, Evas_Smart_Event_Id id, Evas_Smart_Cb func) EINA_ARG_NONNULL(1, 3);
+   EAPI void              evas_object_smart_callback_id_call(Evas_Object *obj, Evas_Smart_Event_Id id, void *event_info) EINA_ARG_NONNULL(1);
+
    EAPI Eina_Bool         evas_object_smart_callbacks_descriptions_set(Evas_Object *obj, const Evas_Smart_Cb_Description *descriptions) EINA_ARG_NONNULL(1);
    EAPI void              evas_object_smart_callbacks_descriptions_get(const Evas_Object *obj, const Evas_Smart_Cb_Description ***class_descriptions, unsigned int *class_count, const Evas_Smart_Cb_Description ***instance_descriptions, unsigned int *instance_count) EINA_ARG_NONNULL(1);
    EAPI void             evas_object_smart_callback_description_find(const Evas_Object *obj, const char *name, const Evas_Smart_Cb_Description **class_description, const Evas_Smart_Cb_Description **instance_description) EINA_ARG_NONNULL(1, 2);
@@ -470,6 +470,7 @@ _evas_cache_image_entry_preload_add(Image_Entry *ie,
 				    const void *target)
 {
    Evas_Cache_Target *tg;
+   int priority;
 
    if (ie->flags.preload_done) return 0;
 
@@ -480,6 +481,7 @@ _evas_cache_image_entry_preload_add(Image_Entry *ie,
 
    ie->targets = (Evas_Cache_Target*) eina_inlist_append(EINA_INLIST_GET(ie->targets), EINA_INLIST_GET(tg));
 
+   priority = _evas_object_image_preload_priority_get((Evas_Object *) target);
    if (!ie->preload)
      {
         ie->cache->preload = eina_list_append(ie->cache->preload, ie);
@@ -488,8 +490,12 @@ _evas_cache_image_entry_preload_add(Image_Entry *ie,
         ie->preload = evas_preload_thread_run(_evas_cache_image_async_heavy,
                                               _evas_cache_image_async_end,
                                               _evas_cache_image_async_cancel,
-                                              ie);
+                                              ie,
+                                              priority);
      }
+   else if (!ie->flags.pending)
+     /* another target wants it, maybe sooner */
+     evas_preload_thread_priority_raise(ie->preload, priority);
 
    return 1;
 }
@@ -22,13 +22,18 @@ typedef void (*_evas_preload_pthread_func)(void *data);
 
 struct _Evas_Preload_Pthread_Worker
 {
+   EINA_INLIST;
+
    _evas_preload_pthread_func func_heavy;
    _evas_preload_pthread_func func_end;
    _evas_preload_pthread_func func_cancel;
 
    const void *data;
 
+   int priority;
+
    Eina_Bool cancel : 1;
+   Eina_Bool queued : 1;
 };
 
 struct _Evas_Preload_Pthread_Data
@@ -40,25 +45,77 @@ struct _Evas_Preload_Pthread_Data
 static int _evas_preload_thread_count_max = 0;
 
 #ifdef BUILD_ASYNC_PRELOAD
+/* the workers are started on demand, up to one per cpu, and then stay
+ * around waiting for more work until shutdown - preloads come in bursts
+ * (a list being scrolled) and starting a thread for each burst cost more
+ * than the wait. queued work is kept in one fifo per priority, the
+ * workers always take from the highest one first. a work item knows
+ * which queue it's in, so cancelling or re-prioritizing it doesn't walk
+ * anything. */
+#define PRELOAD_PRIORITIES \
+   (EVAS_IMAGE_PRELOAD_PRIORITY_HIGH - EVAS_IMAGE_PRELOAD_PRIORITY_LOW + 1)
+
 static int _evas_preload_thread_count = 0;
-static Eina_List *_evas_preload_thread_data = NULL;
+static int _evas_preload_thread_idle = 0;
+static Eina_Bool _evas_preload_thread_quit = EINA_FALSE;
+static Eina_Inlist *_evas_preload_thread_data[PRELOAD_PRIORITIES];
 static Eina_List *_evas_preload_thread = NULL;
 
 static LK(_mutex) = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _cond = PTHREAD_COND_INITIALIZER;
+
+static int
+_evas_preload_queue_get(int priority)
+{
+   if (priority < EVAS_IMAGE_PRELOAD_PRIORITY_LOW)
+     priority = EVAS_IMAGE_PRELOAD_PRIORITY_NORMAL;
+   if (priority > EVAS_IMAGE_PRELOAD_PRIORITY_HIGH)
+     priority = EVAS_IMAGE_PRELOAD_PRIORITY_HIGH;
+   return priority - EVAS_IMAGE_PRELOAD_PRIORITY_LOW;
+}
+
+/* _mutex must be held */
+static void
+_evas_preload_queue_add(Evas_Preload_Pthread_Worker *work)
+{
+   int q = _evas_preload_queue_get(work->priority);
+
+   _evas_preload_thread_data[q] = eina_inlist_append(_evas_preload_thread_data[q],
+                                                     EINA_INLIST_GET(work));
+   work->queued = EINA_TRUE;
+}
 
+/* _mutex must be held */
 static void
-_evas_preload_thread_end(Evas_Preload_Pthread_Data *pth)
+_evas_preload_queue_del(Evas_Preload_Pthread_Worker *work)
 {
-   Evas_Preload_Pthread_Data *p;
+   int q = _evas_preload_queue_get(work->priority);
+
+   _evas_preload_thread_data[q] = eina_inlist_remove(_evas_preload_thread_data[q],
+                                                     EINA_INLIST_GET(work));
+   work->queued = EINA_FALSE;
+}
 
-   if (pthread_join(pth->thread, (void **) &p) != 0)
-     return ;
+/* _mutex must be held */
+static Evas_Preload_Pthread_Worker *
+_evas_preload_queue_pop(void)
+{
+   Evas_Preload_Pthread_Worker *work;
+   int q;
 
-   _evas_preload_thread = eina_list_remove(_evas_preload_thread, pth);
+   for (q = PRELOAD_PRIORITIES - 1; q >= 0; q--)
+     {
+        if (!_evas_preload_thread_data[q]) continue;
+        work = EINA_INLIST_CONTAINER_GET(_evas_preload_thread_data[q],
+                                         Evas_Preload_Pthread_Worker);
+        _evas_preload_queue_del(work);
+        return work;
+     }
+   return NULL;
 }
 
 static void
-_evas_preload_thread_done(void *target, Evas_Callback_Type type, void *event_info)
+_evas_preload_thread_done(void *target __UNUSED__, Evas_Callback_Type type __UNUSED__, void *event_info)
 {
    Evas_Preload_Pthread_Worker *work;
 
@@ -82,52 +139,29 @@ _evas_preload_thread_worker(Evas_Preload_Pthread_Data *pth)
 {
    Evas_Preload_Pthread_Worker *work;
 
-   pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
-   pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, NULL);
-
- on_error:
-
-   while (_evas_preload_thread_data)
+   LKL(_mutex);
+   for (;;)
      {
-	LKL(_mutex);
-
-	if (!_evas_preload_thread_data)
-	  {
-	     LKU(_mutex);
-	     break;
-	  }
-
-	work = eina_list_data_get(_evas_preload_thread_data);
-	_evas_preload_thread_data = eina_list_remove_list(_evas_preload_thread_data, _evas_preload_thread_data);
+        while ((!_evas_preload_thread_quit) &&
+               (!(work = _evas_preload_queue_pop())))
+          {
+             _evas_preload_thread_idle++;
+             pthread_cond_wait(&_cond, &_mutex);
+             _evas_preload_thread_idle--;
+          }
+        if (_evas_preload_thread_quit) break;
 
 	LKU(_mutex);
 
 	work->func_heavy((void *) work->data);
 
 	evas_async_events_put(pth, 0, work, _evas_preload_thread_done);
-     }
 
-   LKL(_mutex);
-   if (_evas_preload_thread_data)
-     {
-	LKU(_mutex);
-	goto on_error;
+        LKL(_mutex);
      }
    _evas_preload_thread_count--;
-
    LKU(_mutex);
 
-   work = malloc(sizeof (Evas_Preload_Pthread_Worker));
-   if (!work) return NULL;
-
-   work->data = pth;
-   work->func_heavy = NULL;
-   work->func_end = (_evas_preload_pthread_func) _evas_preload_thread_end;
-   work->func_cancel = NULL;
-   work->cancel = EINA_FALSE;
-
-   evas_async_events_put(pth, 0, work, _evas_preload_thread_done);
-
    return pth;
 }
 #endif
@@ -138,6 +172,9 @@ _evas_preload_thread_init(void)
    _evas_preload_thread_count_max = eina_cpu_count();
    if (_evas_preload_thread_count_max <= 0)
      _evas_preload_thread_count_max = 1;
+#ifdef BUILD_ASYNC_PRELOAD
+   _evas_preload_thread_quit = EINA_FALSE;
+#endif
 }
 
 void
@@ -153,22 +190,29 @@ _evas_preload_thread_shutdown(void)
 
    LKL(_mutex);
 
-   EINA_LIST_FREE(_evas_preload_thread_data, work)
+   while ((work = _evas_preload_queue_pop()))
      {
 	if (work->func_cancel)
 	  work->func_cancel((void *)work->data);
 	free(work);
      }
 
+   /* the workers finish what they are running, then see this and exit */
+   _evas_preload_thread_quit = EINA_TRUE;
+   pthread_cond_broadcast(&_cond);
+
    LKU(_mutex);
 
    EINA_LIST_FREE(_evas_preload_thread, pth)
      {
 	Evas_Preload_Pthread_Data *p;
 
-	pthread_cancel(pth->thread);
 	pthread_join(pth->thread, (void **) &p);
+	free(pth);
      }
+
+   /* and deliver what they finished meanwhile */
+   evas_async_events_process();
 #endif
 }
 
@@ -176,7 +220,8 @@ Evas_Preload_Pthread *
 evas_preload_thread_run(void (*func_heavy) (void *data),
 			void (*func_end) (void *data),
 			void (*func_cancel) (void *data),
-			const void *data)
+			const void *data,
+			int priority)
 {
 #ifdef BUILD_ASYNC_PRELOAD
    Evas_Preload_Pthread_Worker *work;
@@ -194,44 +239,48 @@ evas_preload_thread_run(void (*func_heavy) (void *data),
    work->func_cancel = func_cancel;
    work->cancel = EINA_FALSE;
    work->data = data;
+   work->priority = priority;
 
    LKL(_mutex);
-   _evas_preload_thread_data = eina_list_append(_evas_preload_thread_data, work);
+   _evas_preload_queue_add(work);
 
-   if (_evas_preload_thread_count == _evas_preload_thread_count_max)
+   if ((_evas_preload_thread_idle > 0) ||
+       (_evas_preload_thread_count >= _evas_preload_thread_count_max))
      {
-	pthread_mutex_unlock(&_mutex);
+        pthread_cond_signal(&_cond);
+	LKU(_mutex);
 	return (Evas_Preload_Pthread*) work;
      }
 
-   LKU(_mutex);
-
    /* One more thread could be created. */
    pth = malloc(sizeof (Evas_Preload_Pthread_Data));
-   if (!pth)
-     goto on_error;
-
-   if (pthread_create(&pth->thread, NULL, (void *) _evas_preload_thread_worker, pth) == 0)
+   if ((pth) &&
+       (pthread_create(&pth->thread, NULL, (void *) _evas_preload_thread_worker, pth) == 0))
      {
-	LKL(_mutex);
 	_evas_preload_thread_count++;
+        _evas_preload_thread = eina_list_append(_evas_preload_thread, pth);
 	LKU(_mutex);
 	return (Evas_Preload_Pthread*) work;
      }
+   free(pth);
 
- on_error:
    if (_evas_preload_thread_count == 0)
      {
+        _evas_preload_queue_del(work);
+	LKU(_mutex);
 	if (work->func_cancel)
 	  work->func_cancel((void *) work->data);
 	free(work);
+        return NULL;
      }
-   return NULL;
+   LKU(_mutex);
+   return (Evas_Preload_Pthread*) work;
 #else
    /*
      If no thread and as we don't want to break app that rely on this
      facility, we will lock the interface until we are done.
     */
+   (void)priority;
    func_heavy((void *) data);
    func_end((void *) data);
 
@@ -243,32 +292,52 @@ Eina_Bool
 evas_preload_thread_cancel(Evas_Preload_Pthread *thread)
 {
 #ifdef BUILD_ASYNC_PRELOAD
-   Evas_Preload_Pthread_Worker *work;
-   Eina_List *l;
+   Evas_Preload_Pthread_Worker *work = (Evas_Preload_Pthread_Worker *) thread;
 
    LKL(_mutex);
 
-   EINA_LIST_FOREACH(_evas_preload_thread_data, l, work)
-     if ((void *) work == (void *) thread)
-       {
-	  _evas_preload_thread_data = eina_list_remove_list(_evas_preload_thread_data, l);
-
-	  LKU(_mutex);
+   if (work->queued)
+     {
+        _evas_preload_queue_del(work);
 
-	  if (work->func_cancel)
-	    work->func_cancel((void *) work->data);
-	  free(work);
+        LKU(_mutex);
 
-	  return EINA_TRUE;
-       }
+        if (work->func_cancel)
+          work->func_cancel((void *) work->data);
+        free(work);
 
-   LKU(_mutex);
+        return EINA_TRUE;
+     }
 
    /* Delay the destruction */
-   work = (Evas_Preload_Pthread_Worker *) thread;
    work->cancel = EINA_TRUE;
+
+   LKU(_mutex);
    return EINA_FALSE;
 #else
    return EINA_TRUE;
 #endif
 }
+
+/* move a queued work up to priority, if it's lower. running or done work
+ * is left alone */
+void
+evas_preload_thread_priority_raise(Evas_Preload_Pthread *thread, int priority)
+{
+#ifdef BUILD_ASYNC_PRELOAD
+   Evas_Preload_Pthread_Worker *work = (Evas_Preload_Pthread_Worker *) thread;
+
+   LKL(_mutex);
+   if ((work->queued) &&
+       (_evas_preload_queue_get(priority) > _evas_preload_queue_get(work->priority)))
+     {
+        _evas_preload_queue_del(work);
+        work->priority = priority;
+        _evas_preload_queue_add(work);
+     }
+   LKU(_mutex);
+#else
+   (void)thread;
+   (void)priority;
+#endif
+}
@@ -13,6 +13,7 @@ static int _fd_read = -1;
 static int _init_evas_event = 0;
 
 typedef struct _Evas_Event_Async	Evas_Event_Async;
+typedef struct _Evas_Event_Async_Slot	Evas_Event_Async_Slot;
 
 struct _Evas_Event_Async
 {
@@ -22,16 +23,67 @@ struct _Evas_Event_Async
    Evas_Callback_Type	  type;
 };
 
+/* events are queued in a ring of preallocated slots that any thread can
+ * put into without a lock, and only the main loop takes from. each slot
+ * carries a sequence number saying whose turn it is: a putter owns slot
+ * pos once it has moved _ring_tail past it, fills it and sets seq to
+ * pos + 1, which is what the taker waits for before reading it; the
+ * taker hands it back for the next lap with pos + ASYNC_RING_SIZE.
+ *
+ * the pipe is only written to wake the main loop up - one byte per
+ * batch, by whoever puts first after the last process, not one pointer
+ * per event. if the ring fills up, events go to an overflow list behind
+ * a spinlock, and keep going there until it has been processed, so that
+ * a thread's events are still processed in the order it put them. */
+#define ASYNC_RING_SIZE 1024
+#define ASYNC_RING_MASK (ASYNC_RING_SIZE - 1)
+
+struct _Evas_Event_Async_Slot
+{
+   volatile unsigned int seq;
+   Evas_Event_Async	 ev;
+};
+
+static Evas_Event_Async_Slot *_ring = NULL;
+static volatile unsigned int _ring_tail = 0;
+static unsigned int _ring_head = 0;
+static volatile int _wakeup_pending = 0;
+
+static Eina_List *_overflow = NULL;
+static volatile int _overflow_lock = 0;
+static volatile int _overflowing = 0;
+
+#define OVERFLOW_LOCK() \
+   while (__sync_lock_test_and_set(&_overflow_lock, 1)) ;
+#define OVERFLOW_UNLOCK() \
+   __sync_lock_release(&_overflow_lock);
+
 int
 evas_async_events_init(void)
 {
    int filedes[2];
+   unsigned int i;
 
    _init_evas_event++;
    if (_init_evas_event > 1) return _init_evas_event;
 
+   _ring = malloc(ASYNC_RING_SIZE * sizeof (Evas_Event_Async_Slot));
+   if (!_ring)
+     {
+	_init_evas_event = 0;
+	return 0;
+     }
+   for (i = 0; i < ASYNC_RING_SIZE; i++)
+     _ring[i].seq = i;
+   _ring_tail = 0;
+   _ring_head = 0;
+   _wakeup_pending = 0;
+   _overflowing = 0;
+
    if (pipe(filedes) == -1)
      {
+	free(_ring);
+	_ring = NULL;
 	_init_evas_event = 0;
 	return 0;
      }
@@ -40,6 +92,7 @@ evas_async_events_init(void)
    _fd_write = filedes[1];
 
    fcntl(_fd_read, F_SETFL, O_NONBLOCK);
+   fcntl(_fd_write, F_SETFL, O_NONBLOCK);
 
    return _init_evas_event;
 }
@@ -47,6 +100,8 @@ evas_async_events_init(void)
 int
 evas_async_events_shutdown(void)
 {
+   Evas_Event_Async *ev;
+
    _init_evas_event--;
    if (_init_evas_event > 0) return _init_evas_event;
 
@@ -55,9 +110,78 @@ evas_async_events_shutdown(void)
    _fd_read = -1;
    _fd_write = -1;
 
+   free(_ring);
+   _ring = NULL;
+   EINA_LIST_FREE(_overflow, ev)
+     free(ev);
+   _overflowing = 0;
+
    return _init_evas_event;
 }
 
+static Eina_Bool
+_evas_async_events_ring_put(const Evas_Event_Async *ev)
+{
+   Evas_Event_Async_Slot *slot;
+   unsigned int pos;
+   int dif;
+
+   pos = _ring_tail;
+   for (;;)
+     {
+	slot = _ring + (pos & ASYNC_RING_MASK);
+	dif = (int)(slot->seq - pos);
+	if (dif == 0)
+	  {
+	     if (__sync_bool_compare_and_swap(&_ring_tail, pos, pos + 1))
+	       break;
+	     pos = _ring_tail;
+	  }
+	else if (dif < 0)
+	  return EINA_FALSE; /* full */
+	else
+	  pos = _ring_tail;
+     }
+
+   slot->ev = *ev;
+   __sync_synchronize();
+   slot->seq = pos + 1;
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_evas_async_events_ring_take(Evas_Event_Async *ev)
+{
+   Evas_Event_Async_Slot *slot;
+
+   slot = _ring + (_ring_head & ASYNC_RING_MASK);
+   /* empty, or the next putter hasn't finished filling it - it will
+    * wake us up again once it has */
+   if (slot->seq != _ring_head + 1) return EINA_FALSE;
+   __sync_synchronize();
+   *ev = slot->ev;
+   __sync_synchronize();
+   slot->seq = _ring_head + ASYNC_RING_SIZE;
+   _ring_head++;
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_evas_async_events_overflow_put(const Evas_Event_Async *ev)
+{
+   Evas_Event_Async *copy;
+
+   copy = malloc(sizeof (Evas_Event_Async));
+   if (!copy) return EINA_FALSE;
+   *copy = *ev;
+
+   OVERFLOW_LOCK();
+   _overflow = eina_list_append(_overflow, copy);
+   _overflowing = 1;
+   OVERFLOW_UNLOCK();
+   return EINA_TRUE;
+}
+
 #endif
 
 /**
@@ -110,24 +234,21 @@ EAPI int
 evas_async_events_process(void)
 {
 #ifdef BUILD_ASYNC_EVENTS
-   Evas_Event_Async *ev;
+   Evas_Event_Async ev, *oev;
+   Eina_List *overflow;
+   char buf[64];
    int check;
    int count = 0;
 
    if (_fd_read == -1) return 0;
 
    do {
-	check = read(_fd_read, &ev, sizeof (Evas_Event_Async *));
-
-	if (check == sizeof (Evas_Event_Async *))
-	  {
-             if (ev->func) ev->func((void *)ev->target, ev->type, ev->event_info);
-	     free(ev);
-	     count++;
-	  }
+	check = read(_fd_read, buf, sizeof (buf));
    } while (check > 0);
-
-   evas_cache_image_wakeup();
+   /* from here on a put has to wake us up again - anything put before
+    * is already in the ring or the overflow */
+   __sync_lock_test_and_set(&_wakeup_pending, 0);
+   __sync_synchronize();
 
    if (check < 0)
      switch (errno)
@@ -139,6 +260,30 @@ evas_async_events_process(void)
           _fd_read = -1;
        }
 
+   while (_evas_async_events_ring_take(&ev))
+     {
+	ev.func((void *)ev.target, ev.type, ev.event_info);
+	count++;
+     }
+
+   if (_overflowing)
+     {
+	OVERFLOW_LOCK();
+	overflow = _overflow;
+	_overflow = NULL;
+	_overflowing = 0;
+	OVERFLOW_UNLOCK();
+
+	EINA_LIST_FREE(overflow, oev)
+	  {
+	     oev->func((void *)oev->target, oev->type, oev->event_info);
+	     free(oev);
+	     count++;
+	  }
+     }
+
+   evas_cache_image_wakeup();
+
    return count;
 #else
    return 0;
@@ -164,40 +309,46 @@ EAPI Eina_Bool
 evas_async_events_put(const void *target, Evas_Callback_Type type, void *event_info, void (*func)(void *target, Evas_Callback_Type type, void *event_info))
 {
 #ifdef BUILD_ASYNC_EVENTS
-   Evas_Event_Async *ev;
+   Evas_Event_Async ev;
    ssize_t check;
-   Eina_Bool result = EINA_FALSE;
+   char c = 0;
 
    if (!func) return 0;
    if (_fd_write == -1) return 0;
 
-   ev = calloc(1, sizeof (Evas_Event_Async));
-   if (!ev) return 0;
+   ev.func = func;
+   ev.target = target;
+   ev.type = type;
+   ev.event_info = event_info;
 
-   ev->func = func;
-   ev->target = target;
-   ev->type = type;
-   ev->event_info = event_info;
+   if ((_overflowing) || (!_evas_async_events_ring_put(&ev)))
+     {
+	if (!_evas_async_events_overflow_put(&ev))
+	  return EINA_FALSE;
+     }
 
-   do {
-      check = write(_fd_write, &ev, sizeof (Evas_Event_Async*));
-   } while ((check != sizeof (Evas_Event_Async*)) && ((errno == EINTR) || (errno == EAGAIN)));
+   if (__sync_bool_compare_and_swap(&_wakeup_pending, 0, 1))
+     {
+	do {
+	   check = write(_fd_write, &c, 1);
+	} while ((check != 1) && (errno == EINTR));
+
+	/* EAGAIN: the pipe is full of wake ups already */
+	if ((check != 1) && (errno != EAGAIN))
+	  switch (errno)
+	    {
+	    case EBADF:
+	    case EINVAL:
+	    case EIO:
+	    case EPIPE:
+	       _fd_write = -1;
+	       return EINA_FALSE;
+	    }
+     }
 
    evas_cache_image_wakeup();
 
-   if (check == sizeof (Evas_Event_Async*))
-     result = EINA_TRUE;
-   else
-     switch (errno)
-       {
-       case EBADF:
-       case EINVAL:
-       case EIO:
-       case EPIPE:
-          _fd_write = -1;
-       }
-
-   return result;
+   return EINA_TRUE;
 #else
    func(target, type, event_info);
    return EINA_TRUE;
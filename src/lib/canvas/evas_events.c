@@ -129,13 +129,57 @@ _evas_event_object_list_in_get(Evas *e, Eina_List *in,
    return in;
 }
 
+static Eina_Bool
+_evas_event_object_reachable(Evas_Object *obj)
+{
+   /* same visibility rules the list walk applies to an object and every
+    * smart parent it has to descend through to get to it */
+   if (evas_event_passes_through(obj)) return EINA_FALSE;
+   for (; obj; obj = obj->smart.parent)
+     {
+        if ((!obj->cur.visible) || (obj->delete_me) ||
+            (obj->clip.clipees) ||
+            (!evas_object_clippers_is_visible(obj)))
+          return EINA_FALSE;
+     }
+   return EINA_TRUE;
+}
+
+static Eina_List *
+_evas_event_object_spatial_in_get(Evas_Object **objs, int num, int x, int y)
+{
+   Eina_List *in = NULL;
+   int i;
+
+   for (i = 0; i < num; i++)
+     {
+        Evas_Object *obj;
+
+        obj = objs[i];
+        if (obj->smart.smart) continue;
+        obj->havemap_parent = 0;
+        if (!_evas_event_object_reachable(obj)) continue;
+        if ((evas_object_is_in_output_rect(obj, x, y, 1, 1)) &&
+            ((!obj->precise_is_inside) || (evas_object_is_inside(obj, x, y))))
+          {
+             in = eina_list_append(in, obj);
+             if (!obj->repeat_events) return in;
+          }
+     }
+   return in;
+}
+
 Eina_List *
 evas_event_objects_event_list(Evas *e, Evas_Object *stop, int x, int y)
 {
    Evas_Layer *lay;
    Eina_List *in = NULL;
+   Evas_Object **objs;
+   int num;
 
    if (!e->layers) return NULL;
+   if ((!stop) && (evas_spatial_objects_at_xy_get(e, x, y, &objs, &num)))
+     return _evas_event_object_spatial_in_get(objs, num, x, y);
    EINA_INLIST_REVERSE_FOREACH((EINA_INLIST_GET(e->layers)), lay)
      {
 	int norep;
@@ -20,12 +20,14 @@ evas_object_inject(Evas_Object *obj, Evas *e)
    lay->usage++;
    obj->layer = lay;
    obj->in_layer = 1;
+   e->spatial.order_dirty = 1;
 }
 
 void
 evas_object_release(Evas_Object *obj, int clean_layer)
 {
    if (!obj->in_layer) return;
+   obj->layer->evas->spatial.order_dirty = 1;
    obj->layer->objects = (Evas_Object *)eina_inlist_remove(EINA_INLIST_GET(obj->layer->objects), EINA_INLIST_GET(obj));
    obj->layer->usage--;
    if (clean_layer)
@@ -104,6 +104,7 @@ evas_shutdown(void)
    evas_async_events_shutdown();
 #endif
    evas_font_dir_cache_free();
+   evas_smart_event_ids_shutdown();
    evas_common_shutdown();
    evas_module_shutdown();
    eina_log_domain_unregister(_evas_log_dom_global);
@@ -165,6 +166,8 @@ evas_new(void)
    eina_array_step_set(&e->calculate_objects, 256);
    eina_array_step_set(&e->clip_changes, 256);
 
+   evas_spatial_init(e);
+
    return e;
 }
 
@@ -254,7 +257,9 @@ evas_free(Evas *e)
      eina_rectangle_free(r);
 
    evas_fonts_zero_free(e);
-   
+
+   evas_spatial_shutdown(e);
+
    evas_event_callback_all_del(e);
    evas_event_callback_cleanup(e);
 
@@ -448,6 +453,7 @@ evas_output_size_set(Evas *e, int w, int h)
    e->output.changed = 1;
    e->output_validity++;
    e->changed = 1;
+   e->spatial.dirty = 1;
    evas_render_invalidate(e);
 }
 
@@ -518,6 +524,7 @@ evas_output_viewport_set(Evas *e, Evas_Coord x, Evas_Coord y, Evas_Coord w, Evas
    e->viewport.w = w;
    e->viewport.h = h;
    e->viewport.changed = 1;
+   e->spatial.dirty = 1;
    e->output_validity++;
    e->changed = 1;
 }
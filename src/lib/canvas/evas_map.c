@@ -118,6 +118,9 @@ _evas_map_free(Evas_Object *obj, Evas_Map *m)
         if (m->surface)
           obj->layer->evas->engine.func->image_map_surface_free
           (obj->layer->evas->engine.data.output, m->surface);
+        if (m->cache.surface)
+          obj->layer->evas->engine.func->image_map_surface_free
+          (obj->layer->evas->engine.data.output, m->cache.surface);
      }
    free(m);
 }
@@ -304,6 +307,7 @@ evas_object_map_enable_set(Evas_Object *obj, Eina_Bool enabled)
           }
      }
    _evas_map_calc_map_geometry(obj);
+   evas_object_spatial_map_update(obj);
    /* This is a bit heavy handed, but it fixes the case of same geometry, but
     * changed colour or UV settings. */
    evas_object_change(obj);
@@ -426,10 +430,12 @@ evas_object_map_set(Evas_Object *obj, const Evas_Map *map)
                {
 		  _evas_map_free(obj, obj->cur.map);
                   obj->cur.map = NULL;
+                  evas_object_spatial_map_update(obj);
                   return;
                }
              _evas_map_free(obj, obj->cur.map);
              obj->cur.map = NULL;
+             evas_object_spatial_map_update(obj);
              if (!obj->cur.usemap) _evas_map_calc_geom_change(obj);
              else _evas_map_calc_map_geometry(obj);
           }
@@ -445,6 +451,7 @@ evas_object_map_set(Evas_Object *obj, const Evas_Map *map)
 	_evas_map_copy(obj->cur.map, map);
         obj->prev.map = NULL;
      }
+   evas_object_spatial_map_update(obj);
    _evas_map_calc_map_geometry(obj);
 }
 
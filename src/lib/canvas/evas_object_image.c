@@ -36,6 +36,7 @@ struct _Evas_Object_Image
       int            cspace;
 
       unsigned char  smooth_scale : 1;
+      unsigned char  smooth_scale_mode : 1;
       unsigned char  has_alpha :1;
    } cur, prev;
 
@@ -59,6 +60,7 @@ struct _Evas_Object_Image
 
    Evas_Image_Scale_Hint   scale_hint;
    Evas_Image_Content_Hint content_hint;
+   Evas_Image_Preload_Priority preload_priority;
 
    void             *engine_data;
 
@@ -1064,6 +1066,11 @@ evas_object_image_data_get(const Evas_Object *obj, Eina_Bool for_writing)
  *
  * If cancel is set, it will remove the image from the workqueue.
  *
+ * Queued work is loaded highest priority first, see
+ * @ref evas_object_image_preload_priority_set. Asking again for an image
+ * that is still waiting in the queue moves it up to the new priority if
+ * that's higher.
+ *
  * @param obj The given image object.
  * @param cancel 0 means add to the workqueue, 1 remove it.
  */
@@ -1094,6 +1101,82 @@ evas_object_image_preload(Evas_Object *obj, Eina_Bool cancel)
 							       obj);
 }
 
+/**
+ * Sets the priority the given image object's preloads are queued with.
+ *
+ * Preloads waiting in the workqueue are started highest priority first,
+ * and in the order they were asked for within a priority. The default,
+ * EVAS_IMAGE_PRELOAD_PRIORITY_AUTO, queues the preload at high priority
+ * if the object is visible on the canvas when it's asked for, and at low
+ * priority otherwise - so images scrolled into view load before the ones
+ * prefetched beyond it.
+ *
+ * This applies to the next call to @ref evas_object_image_preload.
+ *
+ * @param obj The given image object.
+ * @param priority The preload priority.
+ */
+EAPI void
+evas_object_image_preload_priority_set(Evas_Object *obj, Evas_Image_Preload_Priority priority)
+{
+   Evas_Object_Image *o;
+
+   MAGIC_CHECK(obj, Evas_Object, MAGIC_OBJ);
+   return;
+   MAGIC_CHECK_END();
+   o = (Evas_Object_Image *)(obj->object_data);
+   MAGIC_CHECK(o, Evas_Object_Image, MAGIC_OBJ_IMAGE);
+   return;
+   MAGIC_CHECK_END();
+   o->preload_priority = priority;
+}
+
+/**
+ * Retrieves the priority the given image object's preloads are queued with.
+ *
+ * See @ref evas_object_image_preload_priority_set for more details.
+ *
+ * @param obj The given image object.
+ * @return The preload priority.
+ */
+EAPI Evas_Image_Preload_Priority
+evas_object_image_preload_priority_get(const Evas_Object *obj)
+{
+   Evas_Object_Image *o;
+
+   MAGIC_CHECK(obj, Evas_Object, MAGIC_OBJ);
+   return EVAS_IMAGE_PRELOAD_PRIORITY_AUTO;
+   MAGIC_CHECK_END();
+   o = (Evas_Object_Image *)(obj->object_data);
+   MAGIC_CHECK(o, Evas_Object_Image, MAGIC_OBJ_IMAGE);
+   return EVAS_IMAGE_PRELOAD_PRIORITY_AUTO;
+   MAGIC_CHECK_END();
+   return o->preload_priority;
+}
+
+/* the priority a preload for obj is queued with right now - auto resolved
+ * against where the object is. obj is a preload target, anything that
+ * isn't an image gets the normal priority */
+int
+_evas_object_image_preload_priority_get(Evas_Object *obj)
+{
+   Evas_Object_Image *o;
+
+   if ((!obj) || (obj->magic != MAGIC_OBJ) || (obj->delete_me))
+     return EVAS_IMAGE_PRELOAD_PRIORITY_NORMAL;
+   o = (Evas_Object_Image *)(obj->object_data);
+   if ((!o) || (o->magic != MAGIC_OBJ_IMAGE))
+     return EVAS_IMAGE_PRELOAD_PRIORITY_NORMAL;
+   if (o->preload_priority != EVAS_IMAGE_PRELOAD_PRIORITY_AUTO)
+     return o->preload_priority;
+   evas_object_clip_recalc(obj);
+   if ((evas_object_is_visible(obj)) &&
+       (evas_object_is_in_output_rect(obj, 0, 0, obj->layer->evas->output.w,
+                                      obj->layer->evas->output.h)))
+     return EVAS_IMAGE_PRELOAD_PRIORITY_HIGH;
+   return EVAS_IMAGE_PRELOAD_PRIORITY_LOW;
+}
+
 /**
  * Replaces the raw image data of the given image object.
  *
@@ -1304,6 +1387,66 @@ evas_object_image_smooth_scale_get(const Evas_Object *obj)
    return o->cur.smooth_scale;
 }
 
+/**
+ * Sets how the given image object scales down when smooth scaling.
+ *
+ * With EVAS_IMAGE_SMOOTH_SCALE_MODE_MIPMAP the engine keeps a chain of
+ * half size copies of the image, made on first use, and scales down from
+ * the smallest one still larger than the destination. A large photo shown
+ * small then costs a pass over a small copy rather than the whole image,
+ * at the price of about a third more memory for the image. That memory
+ * counts against the engine's scale cache budget, so it may push scaled
+ * copies of other images out.
+ *
+ * This only has an effect when smooth scaling is on. Values outside
+ * Evas_Image_Smooth_Scale_Mode are ignored.
+ *
+ * @param obj The given image object.
+ * @param mode The smooth scale mode.
+ */
+EAPI void
+evas_object_image_smooth_scale_mode_set(Evas_Object *obj, Evas_Image_Smooth_Scale_Mode mode)
+{
+   Evas_Object_Image *o;
+
+   MAGIC_CHECK(obj, Evas_Object, MAGIC_OBJ);
+   return;
+   MAGIC_CHECK_END();
+   o = (Evas_Object_Image *)(obj->object_data);
+   MAGIC_CHECK(o, Evas_Object_Image, MAGIC_OBJ_IMAGE);
+   return;
+   MAGIC_CHECK_END();
+   if ((mode != EVAS_IMAGE_SMOOTH_SCALE_MODE_DEFAULT) &&
+       (mode != EVAS_IMAGE_SMOOTH_SCALE_MODE_MIPMAP)) return;
+   if (o->cur.smooth_scale_mode == mode) return;
+   o->cur.smooth_scale_mode = mode;
+   o->changed = 1;
+   evas_object_change(obj);
+}
+
+/**
+ * Retrieves how the given image object scales down when smooth scaling.
+ *
+ * See @ref evas_object_image_smooth_scale_mode_set for more details.
+ *
+ * @param obj The given image object.
+ * @return The smooth scale mode.
+ */
+EAPI Evas_Image_Smooth_Scale_Mode
+evas_object_image_smooth_scale_mode_get(const Evas_Object *obj)
+{
+   Evas_Object_Image *o;
+
+   MAGIC_CHECK(obj, Evas_Object, MAGIC_OBJ);
+   return EVAS_IMAGE_SMOOTH_SCALE_MODE_DEFAULT;
+   MAGIC_CHECK_END();
+   o = (Evas_Object_Image *)(obj->object_data);
+   MAGIC_CHECK(o, Evas_Object_Image, MAGIC_OBJ_IMAGE);
+   return EVAS_IMAGE_SMOOTH_SCALE_MODE_DEFAULT;
+   MAGIC_CHECK_END();
+   return o->cur.smooth_scale_mode;
+}
+
 /**
  * Reload a image of the canvas.
  *
@@ -2338,6 +2481,7 @@ static void
 evas_object_image_render(Evas_Object *obj, void *output, void *context, void *surface, int x, int y)
 {
    Evas_Object_Image *o;
+   int smooth;
 
    /* render object to surface with context, and offset by x,y */
    o = (Evas_Object_Image *)(obj->object_data);
@@ -2345,6 +2489,11 @@ evas_object_image_render(Evas_Object *obj, void *output, void *context, void *su
    if ((o->cur.fill.w < 1) || (o->cur.fill.h < 1))
      return; /* no error message, already printed in pre_render */
 
+   smooth = o->cur.smooth_scale;
+   if ((smooth) &&
+       (o->cur.smooth_scale_mode == EVAS_IMAGE_SMOOTH_SCALE_MODE_MIPMAP))
+     smooth = EVAS_SMOOTH_SCALE_MIPMAP;
+
    obj->layer->evas->engine.func->context_color_set(output,
 						    context,
 						    255, 255, 255, 255);
@@ -2418,6 +2567,44 @@ evas_object_image_render(Evas_Object *obj, void *output, void *context, void *su
              if (idh < 1) idh = 1;
              if (idx > 0) idx -= idw;
              if (idy > 0) idy -= idh;
+             if ((obj->layer->evas->engine.func->image_tile_draw) &&
+                 (o->cur.border.l == 0) &&
+                 (o->cur.border.r == 0) &&
+                 (o->cur.border.t == 0) &&
+                 (o->cur.border.b == 0) &&
+                 (o->cur.border.fill != 0))
+               {
+                  int tw, th, nx, ny;
+
+                  /* the same tiles as the loop below, in one call */
+                  tw = idw;  th = idh;
+                  if ((o->cur.fill.w == obj->cur.geometry.w) &&
+                      (o->cur.fill.x == 0))
+                    {
+                       tw = obj->cur.geometry.w;
+                       nx = 1;
+                    }
+                  else
+                    nx = (obj->cur.geometry.w - idx + idw - 1) / idw;
+                  if ((o->cur.fill.h == obj->cur.geometry.h) &&
+                      (o->cur.fill.y == 0))
+                    {
+                       th = obj->cur.geometry.h;
+                       ny = 1;
+                    }
+                  else
+                    ny = (obj->cur.geometry.h - idy + idh - 1) / idh;
+                  if ((nx * ny) > 1)
+                    {
+                       obj->layer->evas->engine.func->image_tile_draw(output, context, surface, o->engine_data,
+                                                                      tw, th,
+                                                                      obj->cur.geometry.x + idx + x,
+                                                                      obj->cur.geometry.y + idy + y,
+                                                                      nx * tw, ny * th,
+                                                                      smooth);
+                       return;
+                    }
+               }
              while ((int)idx < obj->cur.geometry.w)
                {
                   Evas_Coord ydy;
@@ -2461,7 +2648,7 @@ evas_object_image_render(Evas_Object *obj, void *output, void *context, void *su
                                                                    obj->cur.geometry.x + ix + x,
                                                                    obj->cur.geometry.y + iy + y,
                                                                    iw, ih,
-                                                                   o->cur.smooth_scale);
+                                                                   smooth);
                        else
                          {
                             int inx, iny, inw, inh, outx, outy, outw, outh;
@@ -2507,34 +2694,48 @@ evas_object_image_render(Evas_Object *obj, void *output, void *context, void *su
                               {
                                   bsl = bl; bsr = br; bst = bt; bsb = bb;
                               }
+                            if (obj->layer->evas->engine.func->image_border_draw)
+                              {
+                                 int fill = o->cur.border.fill;
+
+                                 if ((fill == EVAS_BORDER_FILL_SOLID) &&
+                                     ((obj->cur.cache.clip.a != 255) ||
+                                      (obj->cur.render_op != EVAS_RENDER_BLEND)))
+                                   fill = EVAS_BORDER_FILL_DEFAULT;
+                                 obj->layer->evas->engine.func->image_border_draw(output, context, surface, o->engine_data,
+                                                                                  bl, br, bt, bb,
+                                                                                  bsl, bsr, bst, bsb, fill,
+                                                                                  ox, oy, iw, ih, smooth);
+                                 goto border_done;
+                              }
                             // #--
                             // |
                             inx = 0; iny = 0;
                             inw = bl; inh = bt;
                             outx = ox; outy = oy;
                             outw = bsl; outh = bst;
-                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, o->cur.smooth_scale);
+                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, smooth);
                             // .##
                             // |
                             inx = bl; iny = 0;
                             inw = imw - bl - br; inh = bt;
                             outx = ox + bsl; outy = oy;
                             outw = iw - bsl - bsr; outh = bst;
-                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, o->cur.smooth_scale);
+                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, smooth);
                             // --#
                             //   |
                             inx = imw - br; iny = 0;
                             inw = br; inh = bt;
                             outx = ox + iw - bsr; outy = oy;
                             outw = bsr; outh = bst;
-                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, o->cur.smooth_scale);
+                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, smooth);
                             // .--
                             // #  
                             inx = 0; iny = bt;
                             inw = bl; inh = imh - bt - bb;
                             outx = ox; outy = oy + bst;
                             outw = bsl; outh = ih - bst - bsb;
-                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, o->cur.smooth_scale);
+                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, smooth);
                             // .--.
                             // |##|
                             if (o->cur.border.fill > EVAS_BORDER_FILL_NONE)
@@ -2549,12 +2750,12 @@ evas_object_image_render(Evas_Object *obj, void *output, void *context, void *su
                                    {
                                       obj->layer->evas->engine.func->context_render_op_set(output, context,
                                                                                            EVAS_RENDER_COPY);
-                                      obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, o->cur.smooth_scale);
+                                      obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, smooth);
                                       obj->layer->evas->engine.func->context_render_op_set(output, context,
                                                                                            obj->cur.render_op);
                                    }
                                  else
-                                   obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, o->cur.smooth_scale);
+                                   obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, smooth);
                               }
                             // --.
                             //   #
@@ -2562,29 +2763,30 @@ evas_object_image_render(Evas_Object *obj, void *output, void *context, void *su
                             inw = br; inh = imh - bt - bb;
                             outx = ox + iw - bsr; outy = oy + bst;
                             outw = bsr; outh = ih - bst - bsb;
-                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, o->cur.smooth_scale);
+                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, smooth);
                             // |
                             // #--
                             inx = 0; iny = imh - bb;
                             inw = bl; inh = bb;
                             outx = ox; outy = oy + ih - bsb;
                             outw = bsl; outh = bsb;
-                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, o->cur.smooth_scale);
+                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, smooth);
                             // |
                             // .## 
                             inx = bl; iny = imh - bb;
                             inw = imw - bl - br; inh = bb;
                             outx = ox + bsl; outy = oy + ih - bsb;
                             outw = iw - bsl - bsr; outh = bsb;
-                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, o->cur.smooth_scale);
+                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, smooth);
                             //   |
                             // --#
                             inx = imw - br; iny = imh - bb;
                             inw = br; inh = bb;
                             outx = ox + iw - bsr; outy = oy + ih - bsb;
                             outw = bsr; outh = bsb;
-                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, o->cur.smooth_scale);
+                            obj->layer->evas->engine.func->image_draw(output, context, surface, o->engine_data, inx, iny, inw, inh, outx, outy, outw, outh, smooth);
                          }
+border_done:
                        idy += idh;
                        if (dobreak_h) break;
                     }
@@ -2687,7 +2889,8 @@ evas_object_image_render_pre(Evas_Object *obj)
 	    (o->cur.image.h != o->prev.image.h) ||
 	    (o->cur.has_alpha != o->prev.has_alpha) ||
 	    (o->cur.cspace != o->prev.cspace) ||
-	    (o->cur.smooth_scale != o->prev.smooth_scale))
+	    (o->cur.smooth_scale != o->prev.smooth_scale) ||
+	    (o->cur.smooth_scale_mode != o->prev.smooth_scale_mode))
 	  {
 	     evas_object_render_pre_prev_cur_add(&obj->layer->evas->clip_changes, obj);
 	     if (!o->pixel_updates) goto done;
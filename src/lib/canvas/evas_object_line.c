@@ -152,6 +152,7 @@ evas_object_line_xy_set(Evas_Object *obj, Evas_Coord x1, Evas_Coord y1, Evas_Coo
    obj->cur.geometry.y = min_y;
    obj->cur.geometry.w = max_x - min_x + 2;
    obj->cur.geometry.h = max_y - min_y + 2;
+   evas_object_spatial_update(obj);
 ////   obj->cur.cache.geometry.validity = 0;
    o->cur.x1 = x1 - min_x;
    o->cur.y1 = y1 - min_y;
@@ -55,6 +55,7 @@ evas_object_free(Evas_Object *obj, int clean_layer)
    int was_smart_child = 0;
 
    evas_object_map_set(obj, NULL);
+   evas_object_spatial_del(obj);
    evas_object_grabs_cleanup(obj);
    evas_object_intercept_cleanup(obj);
    if (obj->smart.parent) was_smart_child = 1;
@@ -455,6 +456,7 @@ evas_object_move(Evas_Object *obj, Evas_Coord x, Evas_Coord y)
      }
    obj->cur.geometry.x = x;
    obj->cur.geometry.y = y;
+   evas_object_spatial_update(obj);
 ////   obj->cur.cache.geometry.validity = 0;
    evas_object_change(obj);
    evas_object_clip_dirty(obj);
@@ -548,6 +550,7 @@ evas_object_resize(Evas_Object *obj, Evas_Coord w, Evas_Coord h)
 
    obj->cur.geometry.w = w;
    obj->cur.geometry.h = h;
+   evas_object_spatial_update(obj);
 ////   obj->cur.cache.geometry.validity = 0;
    evas_object_change(obj);
    evas_object_clip_dirty(obj);
@@ -1471,7 +1474,8 @@ EAPI Evas_Object *
 evas_object_top_at_xy_get(const Evas *e, Evas_Coord x, Evas_Coord y, Eina_Bool include_pass_events_objects, Eina_Bool include_hidden_objects)
 {
    Evas_Layer *lay;
-   int xx, yy;
+   Evas_Object **objs;
+   int xx, yy, num, i;
 
    MAGIC_CHECK(e, Evas, MAGIC_EVAS);
    return NULL;
@@ -1480,6 +1484,25 @@ evas_object_top_at_xy_get(const Evas *e, Evas_Coord x, Evas_Coord y, Eina_Bool i
    yy = y;
 ////   xx = evas_coord_world_x_to_screen(e, x);
 ////   yy = evas_coord_world_y_to_screen(e, y);
+   if (evas_spatial_objects_at_xy_get((Evas *)e, xx, yy, &objs, &num))
+     {
+        for (i = 0; i < num; i++)
+          {
+             Evas_Object *obj;
+
+             obj = objs[i];
+             /* only top level objects, like the layer walk below */
+             if (obj->smart.parent) continue;
+             if (obj->delete_me) continue;
+             if ((!include_pass_events_objects) && (evas_event_passes_through(obj))) continue;
+             if ((!include_hidden_objects) && (!obj->cur.visible)) continue;
+             evas_object_clip_recalc(obj);
+             if ((evas_object_is_in_output_rect(obj, xx, yy, 1, 1)) &&
+                 (!obj->clip.clipees))
+               return obj;
+          }
+        return NULL;
+     }
    EINA_INLIST_REVERSE_FOREACH((EINA_INLIST_GET(e->layers)), lay)
      {
 	Evas_Object *obj;
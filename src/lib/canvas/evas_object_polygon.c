@@ -173,6 +173,7 @@ evas_object_polygon_point_add(Evas_Object *obj, Evas_Coord x, Evas_Coord y)
 	obj->cur.geometry.w = max_x - min_x + 2;
 	obj->cur.geometry.h = max_y - min_y + 2;
      }
+   evas_object_spatial_update(obj);
    o->points = eina_list_append(o->points, p);
 
    o->geometry = obj->cur.geometry;
@@ -230,6 +231,7 @@ evas_object_polygon_points_clear(Evas_Object *obj)
      }
    obj->cur.geometry.w = 0;
    obj->cur.geometry.h = 0;
+   evas_object_spatial_update(obj);
 ////   obj->cur.cache.geometry.validity = 0;
    o->changed = 1;
    evas_object_change(obj);
@@ -3,13 +3,21 @@
 
 typedef struct _Evas_Object_Smart      Evas_Object_Smart;
 typedef struct _Evas_Smart_Callback    Evas_Smart_Callback;
+typedef struct _Evas_Smart_Callback_Bucket Evas_Smart_Callback_Bucket;
+
+struct _Evas_Smart_Callback_Bucket
+{
+   Evas_Smart_Event_Id  id;
+   Eina_List           *callbacks;
+};
 
 struct _Evas_Object_Smart
 {
    DATA32            magic;
    void             *engine_data;
    void             *data;
-   Eina_List        *callbacks;
+   Evas_Smart_Callback_Bucket *buckets; /* one per event id with callbacks */
+   unsigned int      buckets_count;
    Eina_Inlist *contained;
    Evas_Smart_Cb_Description_Array callbacks_descriptions;
    int               walking_list;
@@ -19,12 +27,17 @@ struct _Evas_Object_Smart
 
 struct _Evas_Smart_Callback
 {
-   const char *event;
+   Evas_Smart_Event_Id id;
    void (*func) (void *data, Evas_Object *obj, void *event_info);
    void *func_data;
    char  delete_me : 1;
 };
 
+/* interned event names - id N is _evas_smart_event_names[N - 1] */
+static Eina_Hash   *_evas_smart_event_ids = NULL;
+static const char **_evas_smart_event_names = NULL;
+static unsigned int _evas_smart_event_names_count = 0;
+
 /* private methods for smart objects */
 static void evas_object_smart_callbacks_clear(Evas_Object *obj);
 static void evas_object_smart_init(Evas_Object *obj);
@@ -198,6 +211,7 @@ evas_object_smart_member_add(Evas_Object *obj, Evas_Object *smart_obj)
    obj->layer->usage++;
    obj->smart.parent = smart_obj;
    o->contained = eina_inlist_append(o->contained, EINA_INLIST_GET(obj));
+   obj->layer->evas->spatial.order_dirty = 1;
    evas_object_smart_member_cache_invalidate(obj);
    obj->restack = 1;
    evas_object_change(obj);
@@ -234,6 +248,7 @@ evas_object_smart_member_del(Evas_Object *obj)
 
    o = (Evas_Object_Smart *)(obj->smart.parent->object_data);
    o->contained = eina_inlist_remove(o->contained, EINA_INLIST_GET(obj));
+   obj->layer->evas->spatial.order_dirty = 1;
    obj->smart.parent = NULL;
    evas_object_smart_member_cache_invalidate(obj);
    obj->layer->usage--;
@@ -394,6 +409,82 @@ evas_object_smart_add(Evas *e, Evas_Smart *s)
    return obj;
 }
 
+static Evas_Smart_Event_Id
+_evas_smart_event_id_find(const char *event)
+{
+   if (!_evas_smart_event_ids) return 0;
+   return (Evas_Smart_Event_Id)(unsigned long)eina_hash_find(_evas_smart_event_ids, event);
+}
+
+static Evas_Smart_Callback_Bucket *
+_evas_object_smart_bucket_find(Evas_Object_Smart *o, Evas_Smart_Event_Id id)
+{
+   unsigned int i;
+
+   for (i = 0; i < o->buckets_count; i++)
+     {
+        if (o->buckets[i].id == id) return &(o->buckets[i]);
+     }
+   return NULL;
+}
+
+/**
+ * Intern a smart event name.
+ *
+ * @param event the event name
+ * @return the id of @p event, or 0 on failure
+ * @ingroup Evas_Smart_Object_Group
+ *
+ * The same name always maps to the same id for the lifetime of the
+ * library (until the last evas_shutdown()). Smart objects that emit events
+ * often should look their ids up once and use
+ * evas_object_smart_callback_id_call(), which does no string handling.
+ */
+EAPI Evas_Smart_Event_Id
+evas_smart_event_id_get(const char *event)
+{
+   Evas_Smart_Event_Id id;
+   const char **names;
+   const char *name;
+
+   if (!event) return 0;
+   id = _evas_smart_event_id_find(event);
+   if (id) return id;
+   if (!_evas_smart_event_ids)
+     {
+        _evas_smart_event_ids = eina_hash_string_superfast_new(NULL);
+        if (!_evas_smart_event_ids) return 0;
+     }
+   names = realloc(_evas_smart_event_names,
+                   (_evas_smart_event_names_count + 1) * sizeof(const char *));
+   if (!names) return 0;
+   _evas_smart_event_names = names;
+   name = eina_stringshare_add(event);
+   id = _evas_smart_event_names_count + 1;
+   if (!eina_hash_direct_add(_evas_smart_event_ids, name,
+                             (void *)(unsigned long)id))
+     {
+        eina_stringshare_del(name);
+        return 0;
+     }
+   _evas_smart_event_names[_evas_smart_event_names_count++] = name;
+   return id;
+}
+
+/**
+ * Get the event name an id was interned from.
+ *
+ * @param id an id returned by evas_smart_event_id_get()
+ * @return the event name, or NULL if @p id is not valid
+ * @ingroup Evas_Smart_Object_Group
+ */
+EAPI const char *
+evas_smart_event_id_name_get(Evas_Smart_Event_Id id)
+{
+   if ((id < 1) || (id > _evas_smart_event_names_count)) return NULL;
+   return _evas_smart_event_names[id - 1];
+}
+
 /**
  * Add a callback for the smart event specified by @p event.
  *
@@ -405,8 +496,26 @@ evas_object_smart_add(Evas *e, Evas_Smart *s)
  */
 EAPI void
 evas_object_smart_callback_add(Evas_Object *obj, const char *event, void (*func) (void *data, Evas_Object *obj, void *event_info), const void *data)
+{
+   if (!event) return;
+   evas_object_smart_callback_id_add(obj, evas_smart_event_id_get(event),
+                                     func, data);
+}
+
+/**
+ * Add a callback for the smart event with id @p id.
+ *
+ * @param obj a smart object
+ * @param id the event id, see evas_smart_event_id_get()
+ * @param func the callback function
+ * @param data user data to be passed to the callback function
+ * @ingroup Evas_Smart_Object_Group
+ */
+EAPI void
+evas_object_smart_callback_id_add(Evas_Object *obj, Evas_Smart_Event_Id id, void (*func) (void *data, Evas_Object *obj, void *event_info), const void *data)
 {
    Evas_Object_Smart *o;
+   Evas_Smart_Callback_Bucket *bucket;
    Evas_Smart_Callback *cb;
 
    MAGIC_CHECK(obj, Evas_Object, MAGIC_OBJ);
@@ -416,13 +525,27 @@ evas_object_smart_callback_add(Evas_Object *obj, const char *event, void (*func)
    MAGIC_CHECK(o, Evas_Object_Smart, MAGIC_OBJ_SMART);
    return;
    MAGIC_CHECK_END();
-   if (!event) return;
+   if (!id) return;
    if (!func) return;
+   bucket = _evas_object_smart_bucket_find(o, id);
+   if (!bucket)
+     {
+        Evas_Smart_Callback_Bucket *buckets;
+
+        buckets = realloc(o->buckets, (o->buckets_count + 1) *
+                          sizeof(Evas_Smart_Callback_Bucket));
+        if (!buckets) return;
+        o->buckets = buckets;
+        bucket = &(o->buckets[o->buckets_count++]);
+        bucket->id = id;
+        bucket->callbacks = NULL;
+     }
    cb = calloc(1, sizeof(Evas_Smart_Callback));
-   cb->event = eina_stringshare_add(event);
+   if (!cb) return;
+   cb->id = id;
    cb->func = func;
    cb->func_data = (void *)data;
-   o->callbacks = eina_list_prepend(o->callbacks, cb);
+   bucket->callbacks = eina_list_prepend(bucket->callbacks, cb);
 }
 
 /**
@@ -438,8 +561,29 @@ evas_object_smart_callback_add(Evas_Object *obj, const char *event, void (*func)
  */
 EAPI void *
 evas_object_smart_callback_del(Evas_Object *obj, const char *event, void (*func) (void *data, Evas_Object *obj, void *event_info))
+{
+   Evas_Smart_Event_Id id;
+
+   if (!event) return NULL;
+   id = _evas_smart_event_id_find(event);
+   if (!id) return NULL;
+   return evas_object_smart_callback_id_del(obj, id, func);
+}
+
+/**
+ * Remove a smart callback added for an event id
+ *
+ * @param obj a smart object
+ * @param id the event id
+ * @param func the callback function
+ * @return the data pointer
+ * @ingroup Evas_Smart_Object_Group
+ */
+EAPI void *
+evas_object_smart_callback_id_del(Evas_Object *obj, Evas_Smart_Event_Id id, void (*func) (void *data, Evas_Object *obj, void *event_info))
 {
    Evas_Object_Smart *o;
+   Evas_Smart_Callback_Bucket *bucket;
    Eina_List *l;
    Evas_Smart_Callback *cb;
 
@@ -450,10 +594,11 @@ evas_object_smart_callback_del(Evas_Object *obj, const char *event, void (*func)
    MAGIC_CHECK(o, Evas_Object_Smart, MAGIC_OBJ_SMART);
    return NULL;
    MAGIC_CHECK_END();
-   if (!event) return NULL;
-   EINA_LIST_FOREACH(o->callbacks, l, cb)
+   bucket = _evas_object_smart_bucket_find(o, id);
+   if (!bucket) return NULL;
+   EINA_LIST_FOREACH(bucket->callbacks, l, cb)
      {
-	if ((!strcmp(cb->event, event)) && (cb->func == func))
+	if ((cb->func == func) && (!cb->delete_me))
 	  {
 	     void *data;
 
@@ -482,11 +627,35 @@ evas_object_smart_callback_del(Evas_Object *obj, const char *event, void (*func)
  */
 EAPI void
 evas_object_smart_callback_call(Evas_Object *obj, const char *event, void *event_info)
+{
+   Evas_Smart_Event_Id id;
+
+   if (!event) return;
+   /* no one ever listened for this name, so no one can be listening now */
+   id = _evas_smart_event_id_find(event);
+   if (!id) return;
+   evas_object_smart_callback_id_call(obj, id, event_info);
+}
+
+/**
+ * Call any smart callbacks on @p obj for the event with id @p id.
+ *
+ * @param obj the smart object
+ * @param id the event id, see evas_smart_event_id_get()
+ * @param event_info an event specific struct of info to pass to the callback
+ *
+ * Same as evas_object_smart_callback_call() without any lookup of the
+ * event name.
+ *
+ * @ingroup Evas_Smart_Object_Group
+ */
+EAPI void
+evas_object_smart_callback_id_call(Evas_Object *obj, Evas_Smart_Event_Id id, void *event_info)
 {
    Evas_Object_Smart *o;
+   Evas_Smart_Callback_Bucket *bucket;
    Eina_List *l;
    Evas_Smart_Callback *cb;
-   const char *strshare;
 
    MAGIC_CHECK(obj, Evas_Object, MAGIC_OBJ);
    return;
@@ -495,21 +664,19 @@ evas_object_smart_callback_call(Evas_Object *obj, const char *event, void *event
    MAGIC_CHECK(o, Evas_Object_Smart, MAGIC_OBJ_SMART);
    return;
    MAGIC_CHECK_END();
-   if (!event) return;
    if (obj->delete_me) return;
+   bucket = _evas_object_smart_bucket_find(o, id);
+   if (!bucket) return;
    o->walking_list++;
-   strshare = eina_stringshare_add(event);
-   EINA_LIST_FOREACH(o->callbacks, l, cb)
+   /* callbacks added while walking are prepended and buckets may be
+    * reallocated, so only hold on to the list as it was when we started */
+   EINA_LIST_FOREACH(bucket->callbacks, l, cb)
      {
 	if (!cb->delete_me)
-	  {
-	     if (cb->event == strshare)
-	       cb->func(cb->func_data, obj, event_info);
-	  }
+	  cb->func(cb->func_data, obj, event_info);
 	if (obj->delete_me)
 	  break;
      }
-   eina_stringshare_del(strshare);
    o->walking_list--;
    evas_object_smart_callbacks_clear(obj);
 }
@@ -864,22 +1031,43 @@ evas_object_smart_callbacks_clear(Evas_Object *obj)
    Evas_Object_Smart *o;
    Eina_List *l;
    Evas_Smart_Callback *cb;
+   unsigned int i;
 
    o = (Evas_Object_Smart *)(obj->object_data);
 
    if (o->walking_list) return;
    if (!o->deletions_waiting) return;
-   for (l = o->callbacks; l;)
+   for (i = 0; i < o->buckets_count; i++)
      {
-	cb = eina_list_data_get(l);
-	l = eina_list_next(l);
-	if (cb->delete_me)
-	  {
-	     o->callbacks = eina_list_remove(o->callbacks, cb);
-	     if (cb->event) eina_stringshare_del(cb->event);
-	     free(cb);
-	  }
+        Evas_Smart_Callback_Bucket *bucket;
+
+        bucket = &(o->buckets[i]);
+        for (l = bucket->callbacks; l;)
+          {
+             cb = eina_list_data_get(l);
+             l = eina_list_next(l);
+             if (cb->delete_me)
+               {
+                  bucket->callbacks = eina_list_remove(bucket->callbacks, cb);
+                  free(cb);
+               }
+          }
      }
+   o->deletions_waiting = 0;
+}
+
+void
+evas_smart_event_ids_shutdown(void)
+{
+   unsigned int i;
+
+   if (_evas_smart_event_ids) eina_hash_free(_evas_smart_event_ids);
+   _evas_smart_event_ids = NULL;
+   for (i = 0; i < _evas_smart_event_names_count; i++)
+     eina_stringshare_del(_evas_smart_event_names[i]);
+   free(_evas_smart_event_names);
+   _evas_smart_event_names = NULL;
+   _evas_smart_event_names_count = 0;
 }
 
 void
@@ -908,15 +1096,16 @@ evas_object_smart_cleanup(Evas_Object *obj)
 	while (o->contained)
 	  evas_object_smart_member_del((Evas_Object *)o->contained);
 
-	while (o->callbacks)
+	while (o->buckets_count > 0)
 	  {
 	     Evas_Smart_Callback *cb;
 
-	     cb = o->callbacks->data;
-	     o->callbacks = eina_list_remove(o->callbacks, cb);
-	     if (cb->event) eina_stringshare_del(cb->event);
-	     free(cb);
+	     o->buckets_count--;
+	     EINA_LIST_FREE(o->buckets[o->buckets_count].callbacks, cb)
+	       free(cb);
 	  }
+	free(o->buckets);
+	o->buckets = NULL;
 
 	evas_smart_cb_descriptions_resize(&o->callbacks_descriptions, 0);
 	o->data = NULL;
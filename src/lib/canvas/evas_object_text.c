@@ -180,6 +180,7 @@ _evas_object_foo(Evas_Object *obj, Evas_Object_Text *o)
 	obj->cur.geometry.w = 0;
 	obj->cur.geometry.h = o->max_ascent + o->max_descent + t + b;
      }
+   evas_object_spatial_update(obj);
 
    o->changed = 1;
    evas_object_change(obj);
@@ -720,6 +721,7 @@ evas_object_text_style_set(Evas_Object *obj, Evas_Text_Style_Type style)
    else
      obj->cur.geometry.w = 0;
    obj->cur.geometry.h += (t - pt) + (b - pb);
+   evas_object_spatial_update(obj);
    evas_object_change(obj);
    evas_object_clip_dirty(obj);
 }
@@ -1889,6 +1891,7 @@ _evas_object_text_rehint(Evas_Object *obj)
 	obj->cur.geometry.h = o->max_ascent + o->max_descent + t + b;
 ////	obj->cur.cache.geometry.validity = 0;
      }
+   evas_object_spatial_update(obj);
    o->changed = 1;
    evas_object_change(obj);
    evas_object_clip_dirty(obj);
@@ -20,6 +20,7 @@ typedef struct _Evas_Object_Textblock_Line        Evas_Object_Textblock_Line;
 typedef struct _Evas_Object_Textblock_Item        Evas_Object_Textblock_Item;
 typedef struct _Evas_Object_Textblock_Format_Item Evas_Object_Textblock_Format_Item;
 typedef struct _Evas_Object_Textblock_Format      Evas_Object_Textblock_Format;
+typedef struct _Evas_Object_Textblock_Paragraph   Evas_Object_Textblock_Paragraph;
 
 /* the current state of the formatting */
 
@@ -40,6 +41,8 @@ struct _Evas_Object_Textblock_Node
    EINA_INLIST;
    Eina_Strbuf *text;
    int          type;
+   /* changed since the last layout */
+   unsigned char dirty : 1;
 };
 
 struct _Evas_Object_Textblock_Line
@@ -47,9 +50,11 @@ struct _Evas_Object_Textblock_Line
    EINA_INLIST;
    Evas_Object_Textblock_Item        *items;
    Evas_Object_Textblock_Format_Item *format_items;
+   Evas_Object_Textblock_Paragraph   *par;
    int                                x, y, w, h;
    int                                baseline;
    int                                line_no;
+   int                                marginl, marginr;
 };
 
 struct _Evas_Object_Textblock_Item
@@ -112,14 +117,33 @@ struct _Evas_Object_Textblock_Format
    unsigned char        backing : 1;
    unsigned char        ellipsis_left : 1;
    unsigned char        ellipsis_right : 1;
+   unsigned char        snapped : 1; // a paragraph holds a ref to it
    const char          *ellipsis_symbol;
 };
 
+/* the layout state at the start of a line that is still empty when node
+ * is reached - usually the first line of a paragraph. a relayout after an
+ * edit restarts from the last of these before the edit, and stops as soon
+ * as it gets to one after it with the same state as last time */
+struct _Evas_Object_Textblock_Paragraph
+{
+   Evas_Object_Textblock_Node  *node;
+   Eina_List                   *format_stack;
+   struct {
+      int                       l, r, t, b;
+   } style_pad;
+   int                          marginl, marginr;
+   int                          underline_extend;
+   int                          have_underline, have_underline2;
+   double                       align;
+};
+
 struct _Evas_Textblock_Style
 {
    char                  *style_text;
    char                  *default_tag;
    Evas_Object_Style_Tag *tags;
+   Eina_Hash             *tags_hash;
    Eina_List             *objects;
    unsigned char          delete_me : 1;
 };
@@ -160,6 +184,15 @@ struct _Evas_Object_Textblock
    } formatted, native;
    unsigned char                redraw : 1;
    unsigned char                changed : 1;
+   /* something other than the nodes changed, so no line can be reused */
+   unsigned char                relayout_all : 1;
+   /* lazy layout only goes down to limit (-1 is all the way). pending is
+    * the paragraph line it stopped at, kept out of lines to carry on from */
+   struct {
+      Evas_Object_Textblock_Line *pending;
+      int                       limit;
+      unsigned char             on : 1;
+   } lazy;
 };
 
 /* private methods for textblock objects */
@@ -251,6 +284,8 @@ _style_clear(Evas_Textblock_Style *ts)
 	free(tag->replace);
 	free(tag);
      }
+   if (ts->tags_hash) eina_hash_free(ts->tags_hash);
+   ts->tags_hash = NULL;
    ts->style_text = NULL;
    ts->default_tag = NULL;
    ts->tags = NULL;
@@ -279,6 +314,17 @@ _style_match_tag(Evas_Textblock_Style *ts, const char *s, size_t tag_len, size_t
 {
    Evas_Object_Style_Tag *tag;
 
+   if (ts->tags_hash)
+     {
+	tag = eina_hash_find(ts->tags_hash, s);
+	if (tag)
+	  {
+	     *replace_len = tag->replace_len;
+	     return tag->replace;
+	  }
+	*replace_len = 0;
+	return NULL;
+     }
    EINA_INLIST_FOREACH(ts->tags, tag)
      {
 	if (tag->tag_len != tag_len) continue;
@@ -307,6 +353,22 @@ _nodes_clear(const Evas_Object *obj)
 	if (n->text) eina_strbuf_free(n->text);
 	free(n);
      }
+   o->relayout_all = 1;
+}
+
+/* unlink and free a node. the one before it (or after it, if it was the
+ * first) is marked dirty, so lines are never reused across the gap */
+static void
+_nodes_node_del(Evas_Object_Textblock *o, Evas_Object_Textblock_Node *n)
+{
+   Evas_Object_Textblock_Node *nn;
+
+   nn = (Evas_Object_Textblock_Node *)(EINA_INLIST_GET(n))->prev;
+   if (!nn) nn = (Evas_Object_Textblock_Node *)(EINA_INLIST_GET(n))->next;
+   if (nn) nn->dirty = 1;
+   o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_remove(EINA_INLIST_GET(o->nodes), EINA_INLIST_GET(n));
+   if (n->text) eina_strbuf_free(n->text);
+   free(n);
 }
 
 static void
@@ -322,6 +384,16 @@ _format_free(const Evas_Object *obj, Evas_Object_Textblock_Format *fmt)
    free(fmt);
 }
 
+static void
+_paragraph_free(const Evas_Object *obj, Evas_Object_Textblock_Paragraph *par)
+{
+   Evas_Object_Textblock_Format *fmt;
+
+   EINA_LIST_FREE(par->format_stack, fmt)
+     _format_free(obj, fmt);
+   free(par);
+}
+
 static void
 _line_free(const Evas_Object *obj, Evas_Object_Textblock_Line *ln)
 {
@@ -345,6 +417,7 @@ _line_free(const Evas_Object *obj, Evas_Object_Textblock_Line *ln)
 	if (fi->item) eina_stringshare_del(fi->item);
 	free(fi);
      }
+   if (ln->par) _paragraph_free(obj, ln->par);
    if (ln) free(ln);
 }
 
@@ -383,6 +456,8 @@ _nodes_next_merge(const Evas_Object *obj, Evas_Object_Textblock_Node *cur)
     eina_strbuf_append_length(cur->text, eina_strbuf_string_get(next->text),
             eina_strbuf_length_get(next->text));
 
+    cur->dirty = 1;
+
     /* Remove "next" from list */
     o = obj->object_data;
     o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_remove
@@ -1311,6 +1386,7 @@ _format_dup(Evas_Object *obj, Evas_Object_Textblock_Format *fmt)
    fmt2 = calloc(1, sizeof(Evas_Object_Textblock_Format));
    memcpy(fmt2, fmt, sizeof(Evas_Object_Textblock_Format));
    fmt2->ref = 1;
+   fmt2->snapped = 0;
    if (fmt->font.name) fmt2->font.name = eina_stringshare_add(fmt->font.name);
    if (fmt->font.fallbacks) fmt2->font.fallbacks = eina_stringshare_add(fmt->font.fallbacks);
    if (fmt->font.source) fmt2->font.source = eina_stringshare_add(fmt->font.source);
@@ -1361,6 +1437,9 @@ struct _Ctxt
    int underline_extend;
    int have_underline, have_underline2;
    double align;
+   struct {
+      int l, r, t, b;
+   } style_pad;
 };
 
 static void
@@ -1440,11 +1519,35 @@ _layout_format_pop(Ctxt *c, Evas_Object_Textblock_Format *fmt)
    return fmt;
 }
 
+/* paragraphs started while fmt was on the stack share it. they are the
+ * last ones laid out, and get a copy before fmt is changed in place */
+static void
+_layout_format_unshare(Ctxt *c, Evas_Object_Textblock_Format *fmt)
+{
+   Evas_Object_Textblock_Line *ln;
+   Eina_List *l;
+
+   if (!fmt->snapped) return;
+   fmt->snapped = 0;
+   if (!c->lines) return;
+   ln = (Evas_Object_Textblock_Line *)(EINA_INLIST_GET(c->lines))->last;
+   for (; ln; ln = (Evas_Object_Textblock_Line *)(EINA_INLIST_GET(ln))->prev)
+     {
+	if (!ln->par) continue;
+	for (l = ln->par->format_stack; l; l = l->next)
+	  if (l->data == fmt) break;
+	if (!l) break;
+	l->data = _format_dup(c->obj, fmt);
+	_format_free(c->obj, fmt);
+     }
+}
+
 static void
 _layout_format_value_handle(Ctxt *c, Evas_Object_Textblock_Format *fmt, char *item)
 {
    const char *key = NULL, *val = NULL;
 
+   _layout_format_unshare(c, fmt);
    _format_param_parse(item, &key, &val);
    if ((key) && (val)) _format_command(c->obj, fmt, key, val);
    if (key) eina_stringshare_del(key);
@@ -1461,6 +1564,13 @@ _layout_format_value_handle(Ctxt *c, Evas_Object_Textblock_Format *fmt, char *it
 #define SIZE_ABS 1
 #define SIZE_REL 2
 
+static void
+_layout_line_wmax_adjust(Ctxt *c, Evas_Object_Textblock_Line *line)
+{
+   if ((line->x + line->w + line->marginr - c->o->style_pad.l) > c->wmax)
+      c->wmax = line->x + line->w + line->marginl + line->marginr - c->o->style_pad.l;
+}
+
 static void
 _layout_line_finish(Ctxt* c, Evas_Object_Textblock_Format *fmt)
 {
@@ -1584,8 +1694,9 @@ _layout_line_finish(Ctxt* c, Evas_Object_Textblock_Format *fmt)
       ((c->w - line->w -
         c->o->style_pad.l - c->o->style_pad.r -
         c->marginl - c->marginr) * c->align);
-   if ((line->x + line->w + c->marginr - c->o->style_pad.l) > c->wmax)
-      c->wmax = line->x + line->w + c->marginl + c->marginr - c->o->style_pad.l;
+   line->marginl = c->marginl;
+   line->marginr = c->marginr;
+   _layout_line_wmax_adjust(c, line);
 }
 
 
@@ -2225,16 +2336,244 @@ _layout_format_item_add(Ctxt *c, Evas_Object_Textblock_Node *n, char *item)
    return fi;
 }
 
+static Eina_Bool
+_format_equal(const Evas_Object_Textblock_Format *a, const Evas_Object_Textblock_Format *b)
+{
+   if (a == b) return EINA_TRUE;
+   return ((a->halign == b->halign) && (a->valign == b->valign) &&
+	   (a->font.name == b->font.name) &&
+	   (a->font.source == b->font.source) &&
+	   (a->font.fallbacks == b->font.fallbacks) &&
+	   (a->font.size == b->font.size) &&
+	   (!memcmp(&a->color, &b->color, sizeof(a->color))) &&
+	   (a->margin.l == b->margin.l) && (a->margin.r == b->margin.r) &&
+	   (a->tabstops == b->tabstops) &&
+	   (a->linesize == b->linesize) && (a->linerelsize == b->linerelsize) &&
+	   (a->linegap == b->linegap) && (a->linerelgap == b->linerelgap) &&
+	   (a->linefill == b->linefill) && (a->style == b->style) &&
+	   (a->wrap_word == b->wrap_word) && (a->wrap_char == b->wrap_char) &&
+	   (a->underline == b->underline) && (a->underline2 == b->underline2) &&
+	   (a->strikethrough == b->strikethrough) &&
+	   (a->backing == b->backing) &&
+	   (a->ellipsis_left == b->ellipsis_left) &&
+	   (a->ellipsis_right == b->ellipsis_right) &&
+	   (a->ellipsis_symbol == b->ellipsis_symbol));
+}
+
+static Evas_Object_Textblock_Paragraph *
+_layout_paragraph_new(Ctxt *c, Evas_Object_Textblock_Node *n)
+{
+   Evas_Object_Textblock_Paragraph *par;
+   Evas_Object_Textblock_Format *fmt;
+   Eina_List *l;
+
+   par = calloc(1, sizeof(Evas_Object_Textblock_Paragraph));
+   if (!par) return NULL;
+   par->node = n;
+   /* refs, not copies - see _layout_format_unshare() */
+   EINA_LIST_FOREACH(c->format_stack, l, fmt)
+     {
+	fmt->ref++;
+	fmt->snapped = 1;
+	par->format_stack = eina_list_append(par->format_stack, fmt);
+     }
+   par->style_pad.l = c->style_pad.l;
+   par->style_pad.r = c->style_pad.r;
+   par->style_pad.t = c->style_pad.t;
+   par->style_pad.b = c->style_pad.b;
+   par->marginl = c->marginl;
+   par->marginr = c->marginr;
+   par->underline_extend = c->underline_extend;
+   par->have_underline = c->have_underline;
+   par->have_underline2 = c->have_underline2;
+   par->align = c->align;
+   return par;
+}
+
+static Evas_Object_Textblock_Line *
+_layout_paragraph_next(Evas_Object_Textblock_Line *ln)
+{
+   for (; ln; ln = (Evas_Object_Textblock_Line *)(EINA_INLIST_GET(ln))->next)
+     if (ln->par) return ln;
+   return NULL;
+}
+
+/* the last paragraph line of the old layout that starts before the first
+ * dirty node, so everything before it can be kept. nodes are only matched
+ * up to there: new nodes are dirty, and may have taken over the address of
+ * a freed one */
+static Evas_Object_Textblock_Line *
+_layout_restart_find(Evas_Object_Textblock *o, Evas_Object_Textblock_Line *lines,
+		     Evas_Object_Textblock_Node **last_dirty)
+{
+   Evas_Object_Textblock_Line *ln, *start = NULL;
+   Evas_Object_Textblock_Node *n, *dirty = NULL;
+
+   ln = _layout_paragraph_next(lines);
+   EINA_INLIST_FOREACH(o->nodes, n)
+     {
+	if (n->dirty) dirty = n;
+	if ((!dirty) && (ln) && (ln->par->node == n))
+	  {
+	     start = ln;
+	     ln = _layout_paragraph_next((Evas_Object_Textblock_Line *)(EINA_INLIST_GET(ln))->next);
+	  }
+     }
+   *last_dirty = dirty;
+   return start;
+}
+
+/* the first paragraph line of the old layout that starts after the last
+ * dirty node. nothing changed from there on in either list, so they are
+ * walked back from the end together */
+static Evas_Object_Textblock_Line *
+_layout_paragraph_tail_find(Evas_Object_Textblock *o, Evas_Object_Textblock_Line *lines,
+			    Evas_Object_Textblock_Node *last_dirty)
+{
+   Evas_Object_Textblock_Line *ln, *tail = NULL;
+   Evas_Object_Textblock_Node *n;
+
+   if ((!lines) || (!o->nodes)) return NULL;
+   n = (Evas_Object_Textblock_Node *)(EINA_INLIST_GET(o->nodes))->last;
+   ln = (Evas_Object_Textblock_Line *)(EINA_INLIST_GET(lines))->last;
+   for (; ln; ln = (Evas_Object_Textblock_Line *)(EINA_INLIST_GET(ln))->prev)
+     {
+	if (!ln->par) continue;
+	while ((n) && (n != last_dirty) && (n != ln->par->node))
+	  n = (Evas_Object_Textblock_Node *)(EINA_INLIST_GET(n))->prev;
+	if ((!n) || (n == last_dirty)) break;
+	tail = ln;
+     }
+   return tail;
+}
+
+/* picks the layout back up where the paragraph line ln of the old layout
+ * started */
+static Evas_Object_Textblock_Format *
+_layout_paragraph_restore(Ctxt *c, Evas_Object_Textblock_Line *ln)
+{
+   Evas_Object_Textblock_Paragraph *par = ln->par;
+   Evas_Object_Textblock_Format *fmt;
+   Eina_List *l;
+
+   EINA_LIST_FREE(c->format_stack, fmt)
+     _format_free(c->obj, fmt);
+   /* the old paragraphs after this one may share these too, so the layout
+    * works on copies. this is once per relayout */
+   EINA_LIST_FOREACH(par->format_stack, l, fmt)
+     c->format_stack = eina_list_append(c->format_stack, _format_dup(c->obj, fmt));
+   fmt = c->format_stack->data;
+   c->y = ln->y - c->o->style_pad.t;
+   c->line_no = ln->line_no;
+   _layout_line_new(c, fmt);
+   c->style_pad.l = par->style_pad.l;
+   c->style_pad.r = par->style_pad.r;
+   c->style_pad.t = par->style_pad.t;
+   c->style_pad.b = par->style_pad.b;
+   c->marginl = par->marginl;
+   c->marginr = par->marginr;
+   c->underline_extend = par->underline_extend;
+   c->have_underline = par->have_underline;
+   c->have_underline2 = par->have_underline2;
+   c->align = par->align;
+   return fmt;
+}
+
+/* if the layout got to the start of the old paragraph line ln in the same
+ * state as last time, the rest would come out the same: move the old lines
+ * over, just shifted down or up */
+static Eina_Bool
+_layout_paragraph_reuse(Ctxt *c, Evas_Object_Textblock_Line **lines, Evas_Object_Textblock_Line *ln)
+{
+   Evas_Object_Textblock_Paragraph *par = ln->par;
+   Evas_Object_Textblock_Line *next;
+   Eina_List *l, *l2;
+   int dy, dl;
+
+   if ((par->style_pad.l != c->style_pad.l) || (par->style_pad.r != c->style_pad.r) ||
+       (par->style_pad.t != c->style_pad.t) || (par->style_pad.b != c->style_pad.b) ||
+       (par->marginl != c->marginl) || (par->marginr != c->marginr) ||
+       (par->underline_extend != c->underline_extend) ||
+       (par->have_underline != c->have_underline) ||
+       (par->have_underline2 != c->have_underline2) ||
+       (par->align != c->align))
+     return EINA_FALSE;
+   if (eina_list_count(par->format_stack) != eina_list_count(c->format_stack))
+     return EINA_FALSE;
+   for (l = par->format_stack, l2 = c->format_stack; l; l = l->next, l2 = l2->next)
+     if (!_format_equal(l->data, l2->data)) return EINA_FALSE;
+
+   dy = c->y + c->o->style_pad.t - ln->y;
+   dl = c->line_no - ln->line_no;
+   c->lines = (Evas_Object_Textblock_Line *)eina_inlist_remove(EINA_INLIST_GET(c->lines), EINA_INLIST_GET(c->ln));
+   _line_free(c->obj, c->ln);
+   c->ln = NULL;
+   for (; ln; ln = next)
+     {
+	next = (Evas_Object_Textblock_Line *)(EINA_INLIST_GET(ln))->next;
+	*lines = (Evas_Object_Textblock_Line *)eina_inlist_remove(EINA_INLIST_GET(*lines), EINA_INLIST_GET(ln));
+	ln->y += dy;
+	ln->line_no += dl;
+	_layout_line_wmax_adjust(c, ln);
+	c->lines = (Evas_Object_Textblock_Line *)eina_inlist_append(EINA_INLIST_GET(c->lines), EINA_INLIST_GET(ln));
+     }
+   /* the old layout ran to the end from the same state, so it finished
+    * with the style padding it was laid out with */
+   c->style_pad.l = c->o->style_pad.l;
+   c->style_pad.r = c->o->style_pad.r;
+   c->style_pad.t = c->o->style_pad.t;
+   c->style_pad.b = c->o->style_pad.b;
+   return EINA_TRUE;
+}
+
+/* with lazy layout on, the layout stops at the first paragraph start it
+ * gets to past the limit */
+static Eina_Bool
+_layout_lazy_stop(Ctxt *c)
+{
+   if ((c->o->lazy.limit < 0) || (c->y <= c->o->lazy.limit)) return EINA_FALSE;
+   c->lines = (Evas_Object_Textblock_Line *)eina_inlist_remove(EINA_INLIST_GET(c->lines), EINA_INLIST_GET(c->ln));
+   c->ln->y = c->y + c->o->style_pad.t;
+   c->ln->line_no = c->line_no;
+   c->o->lazy.pending = c->ln;
+   c->ln = NULL;
+   return EINA_TRUE;
+}
+
+/* the height of a layout that stopped at pending, with the text not laid
+ * out yet taken to be as high per byte as the text that is */
+static int
+_layout_lazy_height_get(Evas_Object_Textblock *o, int h)
+{
+   Evas_Object_Textblock_Node *n;
+   long long done = 0, left = 0;
+   int past = 0;
+
+   EINA_INLIST_FOREACH(o->nodes, n)
+     {
+	if (n == o->lazy.pending->par->node) past = 1;
+	if (!n->text) continue;
+	if (past) left += eina_strbuf_length_get(n->text);
+	else done += eina_strbuf_length_get(n->text);
+     }
+   if (done <= 0) return h;
+   return h + ((h * left) / done);
+}
+
+/* lays out all the nodes. lines, if given, is the previous layout at the
+ * same width and style, which is taken over: the lines before the first
+ * node changed since are kept, and so are the ones after the last changed
+ * node once the layout gets back in step with them */
 static void
-_layout(const Evas_Object *obj, int calc_only, int w, int h, int *w_ret, int *h_ret)
+_layout(const Evas_Object *obj, int calc_only, int w, int h, int *w_ret, int *h_ret,
+	Evas_Object_Textblock_Line *lines)
 {
    Evas_Object_Textblock *o;
    Ctxt ctxt, *c;
-   Evas_Object_Textblock_Line *ln;
-   Evas_Object_Textblock_Node *n;
+   Evas_Object_Textblock_Line *ln, *tail = NULL, *pending;
+   Evas_Object_Textblock_Node *n = NULL, *last_dirty = NULL;
    Eina_List *removes = NULL;
    Evas_Object_Textblock_Format *fmt = NULL;
-   int style_pad_l = 0, style_pad_r = 0, style_pad_t = 0, style_pad_b = 0;
 
    /* setup context */
    o = (Evas_Object_Textblock *)(obj->object_data);
@@ -2253,6 +2592,15 @@ _layout(const Evas_Object *obj, int calc_only, int w, int h, int *w_ret, int *h_
    c->underline_extend = 0;
    c->line_no = 0;
    c->align = 0.0;
+   c->style_pad.l = c->style_pad.r = c->style_pad.t = c->style_pad.b = 0;
+   /* the line a lazy layout stopped at is the last of lines, if they're
+    * given */
+   pending = NULL;
+   if (lines)
+     {
+	pending = o->lazy.pending;
+	o->lazy.pending = NULL;
+     }
 
    /* Calculate maxascent, maxdescent for current line */
    int maxascent = 0;
@@ -2268,6 +2616,7 @@ _layout(const Evas_Object *obj, int calc_only, int w, int h, int *w_ret, int *h_
    if (!fmt)
      {
 	_format_command_shutdown();
+	if (lines) _lines_clear(obj, lines);
 	if (w_ret) *w_ret = 0;
 	if (h_ret) *h_ret = 0;
 	return;
@@ -2300,9 +2649,45 @@ _layout(const Evas_Object *obj, int calc_only, int w, int h, int *w_ret, int *h_
 
    _layout_format_ascent_descent_adjust(c, fmt, &maxascent, &maxdescent);
 
-   EINA_INLIST_FOREACH(c->o->nodes, n)
+   if ((lines) && (c->o->nodes))
+     {
+	ln = _layout_restart_find(o, lines, &last_dirty);
+	if (ln)
+	  {
+	     while (lines != ln)
+	       {
+		  Evas_Object_Textblock_Line *ln2 = lines;
+
+		  lines = (Evas_Object_Textblock_Line *)eina_inlist_remove(EINA_INLIST_GET(lines), EINA_INLIST_GET(ln2));
+		  _layout_line_wmax_adjust(c, ln2);
+		  c->lines = (Evas_Object_Textblock_Line *)eina_inlist_append(EINA_INLIST_GET(c->lines), EINA_INLIST_GET(ln2));
+	       }
+	     fmt = _layout_paragraph_restore(c, ln);
+	     n = ln->par->node;
+	  }
+	tail = _layout_paragraph_tail_find(o, lines, last_dirty);
+     }
+   if (!n) n = c->o->nodes;
+
+   more:
+   for (; n; n = (Evas_Object_Textblock_Node *)(EINA_INLIST_GET(n))->next)
      {
 	if (!c->ln) _layout_line_new(c, fmt);
+	if ((!calc_only) && (!c->ln->items) && (!c->ln->format_items) && (!c->ln->par))
+	  {
+	     /* where a lazy layout stopped is only kept if it's still past
+	      * the limit */
+	     if ((tail) && (tail->par->node == n) &&
+		 ((tail != pending) ||
+		  ((o->lazy.limit >= 0) && (c->y > o->lazy.limit))) &&
+		 (_layout_paragraph_reuse(c, &lines, tail)))
+	       break;
+	     c->ln->par = _layout_paragraph_new(c, n);
+	     if (_layout_lazy_stop(c)) break;
+	  }
+	if ((tail) && (tail->par->node == n))
+	  tail = _layout_paragraph_next((Evas_Object_Textblock_Line *)(EINA_INLIST_GET(tail))->next);
+	if (!calc_only) n->dirty = 0;
 	if ((n->type == NODE_FORMAT) && eina_strbuf_length_get(n->text))
 	  {
 	     char *s;
@@ -2474,7 +2859,7 @@ _layout(const Evas_Object *obj, int calc_only, int w, int h, int *w_ret, int *h_
                     }
                }
              
-	     evas_text_style_pad_get(fmt->style, &style_pad_l, &style_pad_r, &style_pad_t, &style_pad_b);
+	     evas_text_style_pad_get(fmt->style, &c->style_pad.l, &c->style_pad.r, &c->style_pad.t, &c->style_pad.b);
 
 	     if (fmt->underline2)
 	       c->have_underline2 = 1;
@@ -2486,14 +2871,33 @@ _layout(const Evas_Object *obj, int calc_only, int w, int h, int *w_ret, int *h_
 	     _layout_text_append(c, fmt, n, o->repch);
 	     if ((c->have_underline2) || (c->have_underline))
 	       {
-		  if (style_pad_b < c->underline_extend)
-		    style_pad_b = c->underline_extend;
+		  if (c->style_pad.b < c->underline_extend)
+		    c->style_pad.b = c->underline_extend;
 		  c->have_underline = 0;
 		  c->have_underline2 = 0;
 		  c->underline_extend = 0;
 	       }
 	  }
      }
+   /* the old layout stopped further down, and still does. if the lines
+    * moved over took it back up to the limit, carry on from there */
+   if ((pending) && (c->lines) &&
+       ((Evas_Object_Textblock_Line *)(EINA_INLIST_GET(c->lines))->last == pending))
+     {
+	c->lines = (Evas_Object_Textblock_Line *)eina_inlist_remove(EINA_INLIST_GET(c->lines), EINA_INLIST_GET(pending));
+	if ((o->lazy.limit >= 0) && (pending->y - o->style_pad.t > o->lazy.limit))
+	  o->lazy.pending = pending;
+	else
+	  {
+	     fmt = _layout_paragraph_restore(c, pending);
+	     n = pending->par->node;
+	     lines = (Evas_Object_Textblock_Line *)eina_inlist_append(EINA_INLIST_GET(lines), EINA_INLIST_GET(pending));
+	     pending = NULL;
+	     tail = NULL;
+	     goto more;
+	  }
+     }
+   if (lines) _lines_clear(obj, lines);
    if ((c->ln) && (c->ln->items) && (fmt))
      _layout_line_advance(c, fmt);
    while (c->format_stack)
@@ -2521,20 +2925,28 @@ _layout(const Evas_Object *obj, int calc_only, int w, int h, int *w_ret, int *h_
 	_line_free(obj, ln);
      }
 
+   if ((!calc_only) && (o->lazy.pending))
+     c->hmax = _layout_lazy_height_get(o, c->hmax);
+
    if (w_ret) *w_ret = c->wmax;
    if (h_ret) *h_ret = c->hmax;
-   if ((o->style_pad.l != style_pad_l) || (o->style_pad.r != style_pad_r) ||
-       (o->style_pad.t != style_pad_t) || (o->style_pad.b != style_pad_b))
+   if ((o->style_pad.l != c->style_pad.l) || (o->style_pad.r != c->style_pad.r) ||
+       (o->style_pad.t != c->style_pad.t) || (o->style_pad.b != c->style_pad.b))
      {
-	Evas_Object_Textblock_Line *lines;
-
 	lines = c->lines;
 	c->lines = NULL;
-	o->style_pad.l = style_pad_l;
-	o->style_pad.r = style_pad_r;
-	o->style_pad.t = style_pad_t;
-	o->style_pad.b = style_pad_b;
-	_layout(obj, calc_only, w, h, w_ret, h_ret);
+	o->style_pad.l = c->style_pad.l;
+	o->style_pad.r = c->style_pad.r;
+	o->style_pad.t = c->style_pad.t;
+	o->style_pad.b = c->style_pad.b;
+	/* the lines we have were laid out with the old padding */
+	o->relayout_all = 1;
+	if ((!calc_only) && (o->lazy.pending))
+	  {
+	     _line_free(obj, o->lazy.pending);
+	     o->lazy.pending = NULL;
+	  }
+	_layout(obj, calc_only, w, h, w_ret, h_ret, NULL);
         _lines_clear(obj, lines);
 	_format_command_shutdown();
 	return;
@@ -2549,8 +2961,37 @@ _layout(const Evas_Object *obj, int calc_only, int w, int h, int *w_ret, int *h_
    _format_command_shutdown();
 }
 
+/* the bottom of the part of obj that can be seen (clip and viewport), in
+ * object coords, with its height in view_h. -1 if it all has to be laid
+ * out */
+static int
+_layout_lazy_view_get(const Evas_Object *obj, int *view_h)
+{
+   Evas_Object_Textblock *o;
+   Evas *e;
+   int cx, cy, cw, ch;
+
+   o = (Evas_Object_Textblock *)(obj->object_data);
+   *view_h = 0;
+   /* a map can put any of it anywhere */
+   if ((!o->lazy.on) || (obj->cur.usemap)) return -1;
+   e = obj->layer->evas;
+   evas_object_clip_recalc((Evas_Object *)obj);
+   cx = obj->cur.cache.clip.x;
+   cy = obj->cur.cache.clip.y;
+   cw = obj->cur.cache.clip.w;
+   ch = obj->cur.cache.clip.h;
+   RECTS_CLIP_TO_RECT(cx, cy, cw, ch,
+		      e->viewport.x, e->viewport.y, e->viewport.w, e->viewport.h);
+   if (ch < 0) ch = 0;
+   *view_h = ch;
+   cy += ch - obj->cur.geometry.y;
+   return (cy > 0) ? cy : 0;
+}
+
+/* lays out down to limit, or all of it if it's -1 */
 static void
-_relayout(const Evas_Object *obj)
+_relayout_to(const Evas_Object *obj, int limit)
 {
    Evas_Object_Textblock *o;
    Evas_Object_Textblock_Line *lines;
@@ -2558,19 +2999,51 @@ _relayout(const Evas_Object *obj)
    o = (Evas_Object_Textblock *)(obj->object_data);
    lines = o->lines;
    o->lines = NULL;
+   if (o->lazy.pending)
+     lines = (Evas_Object_Textblock_Line *)eina_inlist_append(EINA_INLIST_GET(lines), EINA_INLIST_GET(o->lazy.pending));
    o->formatted.valid = 0;
    o->native.valid = 0;
+   /* the old lines go to _layout() to keep what the edits since didn't
+    * touch, unless the width or something else they all depend on changed */
+   if ((lines) && ((o->relayout_all) || (o->last_w != obj->cur.geometry.w)))
+     {
+	_lines_clear(obj, lines);
+	lines = NULL;
+	o->lazy.pending = NULL;
+     }
+   o->lazy.limit = limit;
    _layout(obj,
 	   0,
 	   obj->cur.geometry.w, obj->cur.geometry.h,
-	   &o->formatted.w, &o->formatted.h);
+	   &o->formatted.w, &o->formatted.h, lines);
    o->formatted.valid = 1;
-   if (lines) _lines_clear(obj, lines);
    o->last_w = obj->cur.geometry.w;
+   o->relayout_all = 0;
    o->changed = 0;
    o->redraw = 1;
 }
 
+/* lazy layout goes a screen past what can be seen, so scrolling doesn't
+ * need more every frame */
+static void
+_relayout(const Evas_Object *obj)
+{
+   int bottom, view_h;
+
+   bottom = _layout_lazy_view_get(obj, &view_h);
+   _relayout_to(obj, (bottom < 0) ? -1 : bottom + view_h);
+}
+
+/* for anything that looks up lines, which may not be laid out yet */
+static void
+_relayout_complete(const Evas_Object *obj)
+{
+   Evas_Object_Textblock *o;
+
+   o = (Evas_Object_Textblock *)(obj->object_data);
+   if ((!o->formatted.valid) || (o->lazy.pending)) _relayout_to(obj, -1);
+}
+
 static void
 _find_layout_item_line_match(Evas_Object *obj, Evas_Object_Textblock_Node *n, int pos, int eol, Evas_Object_Textblock_Line **lnr, Evas_Object_Textblock_Item **itr)
 {
@@ -2829,6 +3302,19 @@ evas_textblock_style_set(Evas_Textblock_Style *ts, const char *text)
 	     p++;
 	  }
      }
+   /* markup looks tags up by name, the first one of a name wins */
+   if (ts->tags)
+     {
+	Evas_Object_Style_Tag *tag;
+
+	ts->tags_hash = eina_hash_string_superfast_new(NULL);
+	if (ts->tags_hash)
+	  {
+	     EINA_INLIST_FOREACH(ts->tags, tag)
+	       if (!eina_hash_find(ts->tags_hash, tag->tag))
+		 eina_hash_direct_add(ts->tags_hash, tag->tag, tag);
+	  }
+     }
 
    EINA_LIST_FOREACH(ts->objects, l, obj)
      {
@@ -2905,6 +3391,7 @@ evas_object_textblock_style_set(Evas_Object *obj, Evas_Textblock_Style *ts)
    o->formatted.valid = 0;
    o->native.valid = 0;
    o->changed = 1;
+   o->relayout_all = 1;
    if (o->markup_text)
      {
 	free(o->markup_text);
@@ -2941,6 +3428,7 @@ evas_object_textblock_replace_char_set(Evas_Object *obj, const char *ch)
    o->formatted.valid = 0;
    o->native.valid = 0;
    o->changed = 1;
+   o->relayout_all = 1;
    if (o->markup_text)
      {
 	free(o->markup_text);
@@ -2963,6 +3451,43 @@ evas_object_textblock_replace_char_get(Evas_Object *obj)
    return o->repch;
 }
 
+/**
+ * @brief Set if the textblock object only lays out what can be seen.
+ *
+ * When on, the layout stops a screen below the part of the object that
+ * can be seen (its clip and the canvas viewport) and goes on when that
+ * is scrolled into view, or when a cursor or line query needs the lines.
+ * The formatted size of the rest is estimated from the text laid out so
+ * far. Meant for very long text that is only ever seen a bit at a time.
+ *
+ * @param obj The given textblock object.
+ * @param lazy EINA_TRUE to lay out lazily, EINA_FALSE to lay out all of it.
+ */
+EAPI void
+evas_object_textblock_lazy_layout_set(Evas_Object *obj, Eina_Bool lazy)
+{
+   TB_HEAD();
+   lazy = !!lazy;
+   if (o->lazy.on == lazy) return;
+   o->lazy.on = lazy;
+   o->formatted.valid = 0;
+   o->changed = 1;
+   evas_object_change(obj);
+}
+
+/**
+ * @brief Get if the textblock object only lays out what can be seen.
+ *
+ * @param obj The given textblock object.
+ * @return EINA_TRUE if it lays out lazily.
+ */
+EAPI Eina_Bool
+evas_object_textblock_lazy_layout_get(const Evas_Object *obj)
+{
+   TB_HEAD_RETURN(EINA_FALSE);
+   return o->lazy.on;
+}
+
 
 static inline void
 _advance_after_end_of_string(const char **p_buf)
@@ -3027,11 +3552,63 @@ _escaped_char_match(const char *s, int *adv)
    return NULL;
 }
 
+/* the escapes without their ';', hashed to their chars. it's built on first
+ * use and kept, like the format command strings */
+static Eina_Hash *escape_hash = NULL;
+static size_t escape_len_max = 0;
+
+static void
+_escape_hash_init(void)
+{
+   const char *map_itr, *map_end;
+   char buf[32];
+   size_t len;
+
+   escape_hash = eina_hash_string_superfast_new(NULL);
+   if (!escape_hash) return;
+   map_itr = escape_strings;
+   map_end = map_itr + sizeof(escape_strings);
+   while (map_itr < map_end)
+     {
+	const char *escape;
+
+	escape = map_itr;
+	_advance_after_end_of_string(&map_itr);
+	if (map_itr >= map_end) break;
+	len = strlen(escape);
+	if ((len > 1) && (escape[len - 1] == ';')) len--;
+	if (len < sizeof(buf))
+	  {
+	     memcpy(buf, escape, len);
+	     buf[len] = 0;
+	     if (len > escape_len_max) escape_len_max = len;
+	     /* some are in twice, the first one is the one that's used */
+	     if (!eina_hash_find(escape_hash, buf))
+	       eina_hash_add(escape_hash, buf, map_itr);
+	  }
+	_advance_after_end_of_string(&map_itr);
+     }
+}
+
 static inline const char *
 _escaped_char_get(const char *s, const char *s_end)
 {
    const char *map_itr, *map_end;
+   size_t len;
 
+   if (!escape_hash) _escape_hash_init();
+   len = s_end - s;
+   if ((len > 1) && (s[len - 1] == ';')) len--;
+   if ((escape_hash) && (len <= escape_len_max))
+     {
+	char buf[32];
+
+	memcpy(buf, s, len);
+	buf[len] = 0;
+	map_itr = eina_hash_find(escape_hash, buf);
+	if (map_itr) return map_itr;
+     }
+   /* not a whole escape, so the first one it's the start of */
    map_itr = escape_strings;
    map_end = map_itr + sizeof(escape_strings);
 
@@ -3104,6 +3681,73 @@ _prepend_escaped_char(Evas_Textblock_Cursor *cur, const char *s,
      evas_textblock_cursor_text_prepend(cur, escape);
 }
 
+/* markup is set into a cleared textblock, so the nodes are built straight
+ * onto the end of the list, without going through the cursor */
+static Evas_Object_Textblock_Node *
+_markup_node_add(Evas_Object_Textblock *o, int type)
+{
+   Evas_Object_Textblock_Node *n;
+
+   n = calloc(1, sizeof(Evas_Object_Textblock_Node));
+   if (!n) return NULL;
+   n->type = type;
+   n->text = eina_strbuf_new();
+   n->dirty = 1;
+   o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_append(EINA_INLIST_GET(o->nodes), EINA_INLIST_GET(n));
+   return n;
+}
+
+static void
+_markup_text_add(Evas_Object_Textblock *o, const char *s, size_t len)
+{
+   Evas_Object_Textblock_Node *n = NULL;
+
+   if (!len) return;
+   if (o->nodes)
+     n = (Evas_Object_Textblock_Node *)(EINA_INLIST_GET(o->nodes))->last;
+   if ((!n) || (n->type != NODE_TEXT))
+     n = _markup_node_add(o, NODE_TEXT);
+   if (n) eina_strbuf_append_length(n->text, s, len);
+}
+
+/* s is the tag without the <> */
+static void
+_markup_tag_add(Evas_Object_Textblock *o, const char *s, size_t len)
+{
+   Evas_Object_Textblock_Node *n;
+   const char *match;
+   char buf[64], *tag = buf;
+   size_t replace_len;
+
+   if (len >= sizeof(buf))
+     {
+	tag = malloc(len + 1);
+	if (!tag) return;
+     }
+   memcpy(tag, s, len);
+   tag[len] = 0;
+   match = _style_match_tag(o->style, tag, len, &replace_len);
+   if (match)
+     {
+	if ((replace_len > 0) && ((n = _markup_node_add(o, NODE_FORMAT))))
+	  eina_strbuf_append_length(n->text, match, replace_len);
+     }
+   else if ((n = _markup_node_add(o, NODE_FORMAT)))
+     {
+	if (tag[0] == '/')
+	  {
+	     eina_strbuf_append_length(n->text, "- ", 2);
+	     eina_strbuf_append_length(n->text, tag + 1, len - 1);
+	  }
+	else
+	  {
+	     eina_strbuf_append_length(n->text, "+ ", 2);
+	     eina_strbuf_append_length(n->text, tag, len);
+	  }
+     }
+   if (tag != buf) free(tag);
+}
+
 /**
  * to be documented.
  * @param obj  to be documented.
@@ -3132,90 +3776,32 @@ evas_object_textblock_text_markup_set(Evas_Object *obj, const char *text)
 	  }
 	return;
      }
-   evas_textblock_cursor_node_first(o->cursor);
    if (text)
      {
-	char *s, *p;
-	char *tag_start, *tag_end, *esc_start, *esc_end;
+	const char *s, *p, *tag_start, *esc_start;
 
-	tag_start = tag_end = esc_start = esc_end = NULL;
-	p = (char *)text;
-	s = p;
-	for (;;)
+	/* a tag runs from < to >, an escape from & to ;. a < in an escape
+	 * or & in a tag is just text, an unfinished tag or escape is left
+	 * out */
+	tag_start = esc_start = NULL;
+	s = text;
+	for (p = text; *p; p++)
 	  {
-	     if ((*p == 0) ||
-		 (tag_end) || (esc_end) ||
-		 (tag_start) || (esc_start))
-	       {
-		  if (tag_end)
-		    {
-		       char *ttag;
-		       size_t ttag_len = tag_end - tag_start -1;
-
-		       ttag = malloc(ttag_len + 1);
-		       if (ttag)
-			 {
-			    const char *match;
-			    size_t replace_len;
-
-			    memcpy(ttag, tag_start + 1, ttag_len);
-			    ttag[ttag_len] = 0;
-			    match = _style_match_tag(o->style, ttag, ttag_len, &replace_len);
-			    if (match)
-			      evas_textblock_cursor_format_append(o->cursor, match);
-			    else
-			      {
-				 char *ttag2;
-
-				 ttag2 = malloc(ttag_len + 2 + 1);
-				 if (ttag2)
-				   {
-				      if (ttag[0] == '/')
-					{
-					   strcpy(ttag2, "- ");
-					   strcat(ttag2, ttag + 1);
-					}
-				      else
-					{
-					   strcpy(ttag2, "+ ");
-					   strcat(ttag2, ttag);
-					}
-				      evas_textblock_cursor_format_append(o->cursor, ttag2);
-				      free(ttag2);
-				   }
-			      }
-			    free(ttag);
-			 }
-		       tag_start = tag_end = NULL;
-		    }
-		  else if (esc_end)
-		    {
-		       _append_escaped_char(o->cursor, esc_start, esc_end);
-		       esc_start = esc_end = NULL;
-		    }
-		  else if (*p == 0)
-		    {
-		       _append_text_run(o, s, p);
-		       s = NULL;
-		    }
-		  if (*p == 0)
-		    break;
-	       }
 	     if (*p == '<')
 	       {
 		  if (!esc_start)
 		    {
-		       tag_start = p;
-		       tag_end = NULL;
-		       _append_text_run(o, s, p);
+		       if (s) _markup_text_add(o, s, p - s);
 		       s = NULL;
+		       tag_start = p;
 		    }
 	       }
 	     else if (*p == '>')
 	       {
 		  if (tag_start)
 		    {
-		       tag_end = p;
+		       _markup_tag_add(o, tag_start + 1, p - tag_start - 1);
+		       tag_start = NULL;
 		       s = p + 1;
 		    }
 	       }
@@ -3223,22 +3809,30 @@ evas_object_textblock_text_markup_set(Evas_Object *obj, const char *text)
 	       {
 		  if (!tag_start)
 		    {
-		       esc_start = p;
-		       esc_end = NULL;
-		       _append_text_run(o, s, p);
+		       if (s) _markup_text_add(o, s, p - s);
 		       s = NULL;
+		       esc_start = p;
 		    }
 	       }
 	     else if (*p == ';')
 	       {
 		  if (esc_start)
 		    {
-		       esc_end = p;
+		       const char *escape;
+
+		       escape = _escaped_char_get(esc_start, p);
+		       if (escape) _markup_text_add(o, escape, strlen(escape));
+		       esc_start = NULL;
 		       s = p + 1;
 		    }
 	       }
-	     p++;
 	  }
+	if (s) _markup_text_add(o, s, p - s);
+     }
+   if ((text) && (text == o->markup_text))
+     {
+	free(o->markup_text);
+	o->markup_text = NULL;
      }
      {
 	Eina_List *l;
@@ -3737,7 +4331,7 @@ evas_textblock_cursor_line_first(Evas_Textblock_Cursor *cur)
    if (!cur) return;
    if (!cur->node) return;
    o = (Evas_Object_Textblock *)(cur->obj->object_data);
-   if (!o->formatted.valid) _relayout(cur->obj);
+   _relayout_complete(cur->obj);
    if (cur->node->type == NODE_FORMAT)
      _find_layout_format_item_line_match(cur->obj, cur->node, &ln, &fi);
    else
@@ -3779,7 +4373,7 @@ evas_textblock_cursor_line_last(Evas_Textblock_Cursor *cur)
    if (!cur) return;
    if (!cur->node) return;
    o = (Evas_Object_Textblock *)(cur->obj->object_data);
-   if (!o->formatted.valid) _relayout(cur->obj);
+   _relayout_complete(cur->obj);
 // kills "click below text" and up/downm arrow. disable   
 //   cur->eol = 1;
    if (cur->node->type == NODE_FORMAT)
@@ -3867,7 +4461,7 @@ evas_textblock_cursor_line_set(Evas_Textblock_Cursor *cur, int line)
 
    if (!cur) return EINA_FALSE;
    o = (Evas_Object_Textblock *)(cur->obj->object_data);
-   if (!o->formatted.valid) _relayout(cur->obj);
+   _relayout_complete(cur->obj);
 
    ln = _find_layout_line_num(cur->obj, line);
    if (!ln) return EINA_FALSE;
@@ -4029,6 +4623,7 @@ evas_textblock_cursor_text_append(Evas_Textblock_Cursor *cur, const char *text)
      eina_strbuf_append(n->text, (char *)text);
    else
      eina_strbuf_insert(n->text, (char *)text, cur->pos);
+   n->dirty = 1;
 // XXX: This makes no sense?
    if (text)
      {
@@ -4121,6 +4716,7 @@ evas_textblock_cursor_text_prepend(Evas_Textblock_Cursor *cur, const char *text)
           }
         cur->pos += strlen(text);
      }
+   n->dirty = 1;
    o->formatted.valid = 0;
    o->native.valid = 0;
    o->changed = 1;
@@ -4153,6 +4749,7 @@ evas_textblock_cursor_format_append(Evas_Textblock_Cursor *cur, const char *form
    n->type = NODE_FORMAT;
    n->text = eina_strbuf_new();
    eina_strbuf_append(n->text, format);
+   n->dirty = 1;
    if (!nc)
      {
         o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_append(EINA_INLIST_GET(o->nodes), EINA_INLIST_GET(n));
@@ -4181,6 +4778,7 @@ evas_textblock_cursor_format_append(Evas_Textblock_Cursor *cur, const char *form
 	  {
 	     n2 = calloc(1, sizeof(Evas_Object_Textblock_Node));
 	     n2->type = NODE_TEXT;
+	     n2->dirty = 1;
 	     n2->text = eina_strbuf_new();
 	     eina_strbuf_append(n2->text, (eina_strbuf_string_get(nc->text) + cur->pos));
 	     o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_append_relative(EINA_INLIST_GET(o->nodes),
@@ -4188,6 +4786,7 @@ evas_textblock_cursor_format_append(Evas_Textblock_Cursor *cur, const char *form
 										  EINA_INLIST_GET(n));
 
 	     eina_strbuf_remove(nc->text, cur->pos, eina_strbuf_length_get(nc->text));
+	     nc->dirty = 1;
 	  }
      }
    cur->node = n;
@@ -4224,6 +4823,7 @@ evas_textblock_cursor_format_prepend(Evas_Textblock_Cursor *cur, const char *for
    n->type = NODE_FORMAT;
    n->text = eina_strbuf_new();
    eina_strbuf_append(n->text, format);
+   n->dirty = 1;
    if (!nc)
      {
 	o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_prepend(EINA_INLIST_GET(o->nodes), EINA_INLIST_GET(n));
@@ -4255,6 +4855,7 @@ evas_textblock_cursor_format_prepend(Evas_Textblock_Cursor *cur, const char *for
 	  {
 	     n2 = calloc(1, sizeof(Evas_Object_Textblock_Node));
 	     n2->type = NODE_TEXT;
+	     n2->dirty = 1;
 	     n2->text = eina_strbuf_new();
 	     eina_strbuf_append(n2->text, 
                                 (eina_strbuf_string_get(nc->text) + cur->pos));
@@ -4262,6 +4863,7 @@ evas_textblock_cursor_format_prepend(Evas_Textblock_Cursor *cur, const char *for
 										  EINA_INLIST_GET(n2),
 										  EINA_INLIST_GET(n));
 	     eina_strbuf_remove(nc->text, cur->pos, eina_strbuf_length_get(nc->text));
+	     nc->dirty = 1;
 	     cur->node = n2;
 	     cur->pos = 0;
 //             cur->eol = 0;
@@ -4341,9 +4943,7 @@ evas_textblock_cursor_node_delete(Evas_Textblock_Cursor *cur)
 	  }
      }
 
-   o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_remove(EINA_INLIST_GET(o->nodes), EINA_INLIST_GET(n));
-   if (n->text) eina_strbuf_free(n->text);
-   free(n);
+   _nodes_node_del(o, n);
 
    if (n2) _nodes_adjacent_merge(cur->obj, n2);
 
@@ -4383,6 +4983,7 @@ evas_textblock_cursor_char_delete(Evas_Textblock_Cursor *cur)
    if (chr == 0) return;
    ppos = cur->pos;
    eina_strbuf_remove(n->text, cur->pos, index);
+   n->dirty = 1;
    if (!eina_strbuf_length_get(n->text))
      {
 	evas_textblock_cursor_node_delete(cur);
@@ -4474,6 +5075,7 @@ evas_textblock_cursor_range_delete(Evas_Textblock_Cursor *cur1, Evas_Textblock_C
 		  return;
 	       }
 	     eina_strbuf_remove(n1->text, cur1->pos, index);
+	     n1->dirty = 1;
 	     if (!eina_strbuf_length_get(n1->text))
 	       {
 		  evas_textblock_cursor_node_delete(cur1);
@@ -4533,6 +5135,7 @@ evas_textblock_cursor_range_delete(Evas_Textblock_Cursor *cur1, Evas_Textblock_C
 	       }
 	  }
 	eina_strbuf_remove(n1->text, cur1->pos, eina_strbuf_length_get(n1->text));
+	n1->dirty = 1;
 	removes = NULL;
 	for (l = (EINA_INLIST_GET(n1))->next; l != EINA_INLIST_GET(n2); l = l->next)
 	  removes = eina_list_append(removes, l);
@@ -4548,9 +5151,7 @@ evas_textblock_cursor_range_delete(Evas_Textblock_Cursor *cur1, Evas_Textblock_C
 	       format_hump = eina_list_append(format_hump, n1);
 	     else
 	       {
-                  o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_remove(EINA_INLIST_GET(o->nodes), EINA_INLIST_GET(n1));
-		  if (n1->text) eina_strbuf_free(n1->text);
-		  free(n1);
+                  _nodes_node_del(o, n1);
 	       }
 	  }
 	while (removes)
@@ -4558,9 +5159,7 @@ evas_textblock_cursor_range_delete(Evas_Textblock_Cursor *cur1, Evas_Textblock_C
 	     n = removes->data;
 	     if (n->type == NODE_TEXT)
 	       {
-		  o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_remove(EINA_INLIST_GET(o->nodes), EINA_INLIST_GET(n));
-		  if (n->text) eina_strbuf_free(n->text);
-		  free(n);
+		  _nodes_node_del(o, n);
 	       }
 	     else
 	       {
@@ -4574,22 +5173,13 @@ evas_textblock_cursor_range_delete(Evas_Textblock_Cursor *cur1, Evas_Textblock_C
 		       if (tn)
 			 {
 			    format_hump = eina_list_remove_list(format_hump, eina_list_last(format_hump));
-			    o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_remove(EINA_INLIST_GET(o->nodes),
-											EINA_INLIST_GET(tn));
-			    if (tn->text) eina_strbuf_free(tn->text);
-			    free(tn);
-			    o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_remove(EINA_INLIST_GET(o->nodes),
-											EINA_INLIST_GET(n));
-			    if (n->text) eina_strbuf_free(n->text);
-			    free(n);
+			    _nodes_node_del(o, tn);
+			    _nodes_node_del(o, n);
 			 }
 		    }
 		  else
 		    {
-		       o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_remove(EINA_INLIST_GET(o->nodes),
-										   EINA_INLIST_GET(n));
-		       if (n->text) eina_strbuf_free(n->text);
-		       free(n);
+		       _nodes_node_del(o, n);
 		    }
 	       }
 	     removes = eina_list_remove_list(removes, removes);
@@ -4597,6 +5187,7 @@ evas_textblock_cursor_range_delete(Evas_Textblock_Cursor *cur1, Evas_Textblock_C
         if (n2->type == NODE_TEXT)
 	  {
 	     eina_strbuf_remove(n2->text, 0, index);
+	     n2->dirty = 1;
 	     if (!eina_strbuf_length_get(n2->text))
 	       evas_textblock_cursor_node_delete(cur2);
 	  }
@@ -4623,10 +5214,7 @@ evas_textblock_cursor_range_delete(Evas_Textblock_Cursor *cur1, Evas_Textblock_C
 	       }
 	     if (eina_strbuf_string_get(n2->text)[0] == '-')
 	       {
-		  o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_remove(EINA_INLIST_GET(o->nodes),
-									      EINA_INLIST_GET(n2));
-		  if (n2->text) eina_strbuf_free(n2->text);
-		  free(n2);
+		  _nodes_node_del(o, n2);
 		  n = eina_list_data_get(eina_list_last(format_hump));
 		  if (n)
 		    {
@@ -4649,18 +5237,12 @@ evas_textblock_cursor_range_delete(Evas_Textblock_Cursor *cur1, Evas_Textblock_C
 				   }
 			      }
 			 }
-		       o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_remove(EINA_INLIST_GET(o->nodes),
-										   EINA_INLIST_GET(n));
-		       if (n->text) eina_strbuf_free(n->text);
-		       free(n);
+		       _nodes_node_del(o, n);
 		    }
 	       }
 	     else
 	       {
-		  o->nodes = (Evas_Object_Textblock_Node *)eina_inlist_remove(EINA_INLIST_GET(o->nodes),
-									      EINA_INLIST_GET(n2));
-		  if (n2->text) eina_strbuf_free(n2->text);
-		  free(n2);
+		  _nodes_node_del(o, n2);
 	       }
 	  }
 	if (format_hump) eina_list_free(format_hump);
@@ -4984,7 +5566,7 @@ evas_textblock_cursor_char_geometry_get(const Evas_Textblock_Cursor *cur, Evas_C
         else
           return -1;
      }
-   if (!o->formatted.valid) _relayout(cur->obj);
+   _relayout_complete(cur->obj);
    if (cur->node->type == NODE_FORMAT)
      {
 	_find_layout_format_item_line_match(cur->obj, cur->node, &ln, &fi);
@@ -5071,7 +5653,7 @@ evas_textblock_cursor_line_geometry_get(const Evas_Textblock_Cursor *cur, Evas_C
 
    if (!cur) return -1;
    o = (Evas_Object_Textblock *)(cur->obj->object_data);
-   if (!o->formatted.valid) _relayout(cur->obj);
+   _relayout_complete(cur->obj);
    if (!cur->node)
      {
         ln = o->lines;
@@ -5112,7 +5694,7 @@ evas_textblock_cursor_char_coord_set(Evas_Textblock_Cursor *cur, Evas_Coord x, E
 
    if (!cur) return EINA_FALSE;
    o = (Evas_Object_Textblock *)(cur->obj->object_data);
-   if (!o->formatted.valid) _relayout(cur->obj);
+   _relayout_complete(cur->obj);
    x += o->style_pad.l;
    y += o->style_pad.t;
    EINA_INLIST_FOREACH(o->lines, ln)
@@ -5184,7 +5766,7 @@ evas_textblock_cursor_line_coord_set(Evas_Textblock_Cursor *cur, Evas_Coord y)
 
    if (!cur) return -1;
    o = (Evas_Object_Textblock *)(cur->obj->object_data);
-   if (!o->formatted.valid) _relayout(cur->obj);
+   _relayout_complete(cur->obj);
    y += o->style_pad.t;
    EINA_INLIST_FOREACH(o->lines, ln)
      {
@@ -5315,7 +5897,7 @@ evas_textblock_cursor_format_item_geometry_get(const Evas_Textblock_Cursor *cur,
 
    if (!cur) return 0;
    o = (Evas_Object_Textblock *)(cur->obj->object_data);
-   if (!o->formatted.valid) _relayout(cur->obj);
+   _relayout_complete(cur->obj);
    _find_layout_format_item_line_match(cur->obj, cur->node, &ln, &fi);
    if ((!ln) || (!fi)) return 0;
    x = ln->x + fi->x;
@@ -5374,6 +5956,7 @@ evas_object_textblock_line_number_geometry_get(const Evas_Object *obj, int line,
    Evas_Object_Textblock_Line *ln;
 
    TB_HEAD_RETURN(0);
+   if (o->lazy.pending) _relayout_to(obj, -1);
    ln = _find_layout_line_num(obj, line);
    if (!ln) return EINA_FALSE;
    if (cx) *cx = ln->x;
@@ -5407,6 +5990,11 @@ evas_object_textblock_clear(Evas_Object *obj)
 	_lines_clear(obj, o->lines);
 	o->lines = NULL;
      }
+   if (o->lazy.pending)
+     {
+	_line_free(obj, o->lazy.pending);
+	o->lazy.pending = NULL;
+     }
    o->formatted.valid = 0;
    o->native.valid = 0;
    o->changed = 1;
@@ -5451,7 +6039,7 @@ evas_object_textblock_size_native_get(const Evas_Object *obj, Evas_Coord *w, Eva
 	_layout(obj,
 		1,
 		-1, -1,
-		&o->native.w, &o->native.h);
+		&o->native.w, &o->native.h, NULL);
 	o->native.valid = 1;
      }
    if (w) *w = o->native.w;
@@ -5520,6 +6108,7 @@ evas_object_textblock_new(void)
    o->magic = MAGIC_OBJ_TEXTBLOCK;
    o->cursor = calloc(1, sizeof(Evas_Textblock_Cursor));
    o->cursors = eina_list_append(NULL, o->cursor);
+   o->lazy.limit = -1;
    return o;
 }
 
@@ -5547,7 +6136,7 @@ evas_object_textblock_free(Evas_Object *obj)
 static void
 evas_object_textblock_render(Evas_Object *obj, void *output, void *context, void *surface, int x, int y)
 {
-   Evas_Object_Textblock_Line *ln;
+   Evas_Object_Textblock_Line *ln, *start;
    Evas_Object_Textblock *o;
    int i, j;
    int pback = 0, backx = 0;
@@ -5573,8 +6162,16 @@ evas_object_textblock_render(Evas_Object *obj, void *output, void *context, void
    obj->layer->evas->engine.func->context_multiplier_unset(output,
 							   context);
    clip = ENFN->context_clip_get(output, context, &cx, &cy, &cw, &ch);
+   /* skip the lines above the clip once, not in every pass below */
+   start = o->lines;
+   if (clip)
+     {
+	while ((start) &&
+	       ((obj->cur.geometry.y + y + start->y + start->h) < (cy - 20)))
+	  start = (Evas_Object_Textblock_Line *)(EINA_INLIST_GET(start))->next;
+     }
 #define ITEM_WALK() \
-   EINA_INLIST_FOREACH(o->lines, ln) \
+   for (ln = start; ln; ln = (Evas_Object_Textblock_Line *)(EINA_INLIST_GET(ln))->next) \
      { \
 	Evas_Object_Textblock_Item *it; \
 	\
@@ -6012,22 +6609,21 @@ evas_object_textblock_render_pre(Evas_Object *obj)
    /* then when this is done the object needs to figure if it changed and */
    /* if so what and where and add the appropriate redraw textblocks */
    o = (Evas_Object_Textblock *)(obj->object_data);
+   /* a lazy layout goes on once what it stopped at can be seen, or is
+    * finished off if the view can't tell (a map, or lazy layout got
+    * turned off since) */
+   if ((!o->changed) && (o->lazy.pending))
+     {
+	int bottom, view_h;
+
+	bottom = _layout_lazy_view_get(obj, &view_h);
+	if ((bottom < 0) || (o->lazy.pending->y <= bottom))
+	  o->changed = 1;
+     }
    if ((o->changed) ||
        (o->last_w != obj->cur.geometry.w))
      {
-	Evas_Object_Textblock_Line *lines;
-
-	lines = o->lines;
-	o->lines = NULL;
-	o->formatted.valid = 0;
-	o->native.valid = 0;
-	_layout(obj,
-		0,
-		obj->cur.geometry.w, obj->cur.geometry.h,
-		&o->formatted.w, &o->formatted.h);
-	o->formatted.valid = 1;
-	if (lines) _lines_clear(obj, lines);
-	o->last_w = obj->cur.geometry.w;
+	_relayout(obj);
 	o->redraw = 0;
 	evas_object_render_pre_prev_cur_add(&obj->layer->evas->clip_changes, obj);
 	o->changed = 0;
@@ -6182,6 +6778,10 @@ evas_object_textblock_coords_recalc(Evas_Object *obj)
 static void
 evas_object_textblock_scale_update(Evas_Object *obj)
 {
+   Evas_Object_Textblock *o;
+
+   o = (Evas_Object_Textblock *)(obj->object_data);
+   o->relayout_all = 1;
    _relayout(obj);
 }
 
@@ -6212,5 +6812,6 @@ _evas_object_textblock_rehint(Evas_Object *obj)
    o->formatted.valid = 0;
    o->native.valid = 0;
    o->changed = 1;
+   o->relayout_all = 1;
    evas_object_change(obj);
 }
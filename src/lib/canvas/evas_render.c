@@ -38,6 +38,35 @@ rend_dbg(const char *txt)
 #define RDI(x)
 #endif
 
+/* the part of an obscuring object that is opaque, in canvas coords. w and
+ * h are 0 if there is none */
+static void
+_evas_render_opaque_rect_get(Evas_Object *obj, Eina_Rectangle *r)
+{
+   Evas_Coord obx, oby, obw, obh;
+
+   if (evas_object_is_opaque(obj))
+     {
+        r->x = obj->cur.cache.clip.x;
+        r->y = obj->cur.cache.clip.y;
+        r->w = obj->cur.cache.clip.w;
+        r->h = obj->cur.cache.clip.h;
+        return;
+     }
+   r->w = 0;
+   r->h = 0;
+   if (!obj->func->get_opaque_rect) return;
+   obj->func->get_opaque_rect(obj, &obx, &oby, &obw, &obh);
+   if ((obw <= 0) || (obh <= 0)) return;
+   RECTS_CLIP_TO_RECT(obx, oby, obw, obh,
+                      obj->cur.cache.clip.x, obj->cur.cache.clip.y,
+                      obj->cur.cache.clip.w, obj->cur.cache.clip.h);
+   r->x = obx;
+   r->y = oby;
+   r->w = obw;
+   r->h = obh;
+}
+
 static Eina_List *
 evas_render_updates_internal(Evas *e, unsigned char make_updates, unsigned char do_draw);
 
@@ -573,6 +602,112 @@ pending_change(void *data, void *gdata __UNUSED__)
    return obj->changed ? EINA_TRUE : EINA_FALSE;
 }
 
+/* maps that didn't move since the last frame and whose surface wasn't
+ * re-rendered keep their transformed output in an alpha surface the size
+ * of the map on screen, so redrawing them (because something over or under
+ * them changed) is a plain 1:1 image draw instead of a map4 rasterize. the
+ * cache is only made once the points have stayed put across a frame, so
+ * maps that animate don't pay for it */
+static Eina_Bool
+_evas_render_mapped_cache_draw(Evas *e, Evas_Object *obj, void *context,
+                               void *surface, int off_x, int off_y,
+                               Eina_Bool rendered)
+{
+   Evas_Map *m = obj->cur.map;
+   const Evas_Map_Point *p;
+   RGBA_Map_Point pts[4];
+   void *ctx;
+   int i, x, y, w, h;
+
+   if ((rendered) || (m->cache.alpha != m->alpha) ||
+       (m->cache.smooth != m->smooth) ||
+       (memcmp(m->cache.points, m->points, sizeof(m->cache.points))))
+     {
+        memcpy(m->cache.points, m->points, sizeof(m->cache.points));
+        m->cache.alpha = m->alpha;
+        m->cache.smooth = m->smooth;
+        m->cache.frame = e->render_frame;
+        m->cache.valid = 0;
+        return EINA_FALSE;
+     }
+   x = m->normal_geometry.x;
+   y = m->normal_geometry.y;
+   w = m->normal_geometry.w + 1;
+   h = m->normal_geometry.h + 1;
+   RECTS_CLIP_TO_RECT(x, y, w, h, 0, 0, e->output.w, e->output.h);
+   if ((w <= 0) || (h <= 0)) return EINA_FALSE;
+   /* the output was resized */
+   if ((m->cache.x != x) || (m->cache.y != y) ||
+       (m->cache.w != w) || (m->cache.h != h))
+     m->cache.valid = 0;
+   if (!m->cache.valid)
+     {
+        if (m->cache.frame == e->render_frame) return EINA_FALSE;
+        p = m->points;
+        /* an unrotated map of the whole surface is drawn with image_draw
+         * by the engines already */
+        if ((p[0].x == p[3].x) && (p[1].x == p[2].x) &&
+            (p[0].y == p[1].y) && (p[3].y == p[2].y) &&
+            (p[0].u == 0.0) && (p[0].v == 0.0) &&
+            (p[2].u == m->surface_w) && (p[2].v == m->surface_h) &&
+            (p[1].u == p[2].u) && (p[1].v == 0.0) &&
+            (p[3].u == 0.0) && (p[3].v == p[2].v) &&
+            (ARGB_JOIN(p[0].a, p[0].r, p[0].g, p[0].b) == 0xffffffff) &&
+            (ARGB_JOIN(p[1].a, p[1].r, p[1].g, p[1].b) == 0xffffffff) &&
+            (ARGB_JOIN(p[2].a, p[2].r, p[2].g, p[2].b) == 0xffffffff) &&
+            (ARGB_JOIN(p[3].a, p[3].r, p[3].g, p[3].b) == 0xffffffff))
+          return EINA_FALSE;
+        if ((m->cache.surface) &&
+            ((m->cache.w != w) || (m->cache.h != h)))
+          {
+             e->engine.func->image_map_surface_free(e->engine.data.output,
+                                                    m->cache.surface);
+             m->cache.surface = NULL;
+          }
+        if (!m->cache.surface)
+          m->cache.surface = e->engine.func->image_map_surface_new
+            (e->engine.data.output, w, h, 1);
+        if (!m->cache.surface) return EINA_FALSE;
+        m->cache.x = x;
+        m->cache.y = y;
+        m->cache.w = w;
+        m->cache.h = h;
+
+        ctx = e->engine.func->context_new(e->engine.data.output);
+        e->engine.func->context_color_set
+          (e->engine.data.output, ctx, 0, 0, 0, 0);
+        e->engine.func->context_render_op_set
+          (e->engine.data.output, ctx, EVAS_RENDER_COPY);
+        e->engine.func->rectangle_draw(e->engine.data.output, ctx,
+                                       m->cache.surface, 0, 0, w, h);
+        e->engine.func->context_free(e->engine.data.output, ctx);
+
+        for (i = 0; i < 4; i++, p++)
+          {
+             pts[i].x = (p->x - x) << FP;
+             pts[i].y = (p->y - y) << FP;
+             pts[i].z = (p->z)     << FP;
+             pts[i].u = p->u * FP1;
+             pts[i].v = p->v * FP1;
+             pts[i].col = ARGB_JOIN(p->a, p->r, p->g, p->b);
+          }
+        ctx = e->engine.func->context_new(e->engine.data.output);
+        e->engine.func->image_map4_draw
+          (e->engine.data.output, ctx, m->cache.surface, m->surface,
+           pts, m->smooth, 0);
+        e->engine.func->context_free(e->engine.data.output, ctx);
+        m->cache.surface = e->engine.func->image_dirty_region
+          (e->engine.data.output, m->cache.surface, 0, 0, w, h);
+        m->cache.valid = 1;
+     }
+   e->engine.func->image_draw(e->engine.data.output, context, surface,
+                              m->cache.surface, 0, 0,
+                              m->cache.w, m->cache.h,
+                              m->cache.x + off_x, m->cache.y + off_y,
+                              m->cache.w, m->cache.h, 0);
+   return EINA_TRUE;
+}
+
 static Eina_Bool
 evas_render_mapped(Evas *e, Evas_Object *obj, void *context, void *surface,
                    int off_x, int off_y, int mapped
@@ -752,23 +887,28 @@ evas_render_mapped(Evas *e, Evas_Object *obj, void *context, void *surface,
              rendered = 1;
           }
 
-        RDI(level);
-        RD("        draw map4\n");
-
         if (rendered)
           {
              obj->cur.map->surface = e->engine.func->image_dirty_region
                (e->engine.data.output, obj->cur.map->surface,
                 0, 0, obj->cur.map->surface_w, obj->cur.map->surface_h);
           }
-        obj->layer->evas->engine.func->image_map4_draw
-          (e->engine.data.output, e->engine.data.context, surface,
-           obj->cur.map->surface, pts, obj->cur.map->smooth, 0);
-        // FIXME: needs to cache these maps and
-        // keep them only rendering updates
-//        obj->layer->evas->engine.func->image_map_surface_free
-//          (e->engine.data.output, obj->cur.map->surface);
-//        obj->cur.map->surface = NULL;
+        /* maps inside a mapped object end up cached in its surface */
+        if ((!mapped) &&
+            (_evas_render_mapped_cache_draw(e, obj, e->engine.data.context,
+                                            surface, off_x, off_y, rendered)))
+          {
+             RDI(level);
+             RD("        draw cached map\n");
+          }
+        else
+          {
+             RDI(level);
+             RD("        draw map4\n");
+             obj->layer->evas->engine.func->image_map4_draw
+               (e->engine.data.output, e->engine.data.context, surface,
+                obj->cur.map->surface, pts, obj->cur.map->smooth, 0);
+          }
      }
    else
      {
@@ -831,6 +971,7 @@ evas_render_updates_internal(Evas *e,
    MAGIC_CHECK_END();
    if (!e->changed) return NULL;
 
+   e->render_frame++;
    evas_call_smarts_calculate(e);
 
    RD("[--- RENDER EVAS (size: %ix%i)\n", e->viewport.w, e->viewport.h);
@@ -911,6 +1052,8 @@ evas_render_updates_internal(Evas *e,
    /* phase 6. go thru each update rect and render objects in it*/
    if (do_draw)
      {
+	Eina_Rectangle *opaques = NULL;
+	unsigned int opaques_max = 0;
 	unsigned int offset = 0;
 
 	alpha = e->engine.func->canvas_alpha_get(e->engine.data.output, e->engine.data.context);
@@ -921,6 +1064,7 @@ evas_render_updates_internal(Evas *e,
 							       &cx, &cy, &cw, &ch)))
 	  {
 	     int off_x, off_y;
+	     unsigned int opaques_num = 0;
 
              RD("  [--- UPDATE %i %i %ix%i\n", ux, uy, uw, uh);
 	     if (make_updates)
@@ -938,46 +1082,33 @@ evas_render_updates_internal(Evas *e,
 	     for (i = 0; i < e->obscuring_objects.count; ++i)
 	       {
 		  Evas_Object *obj;
+		  Eina_Rectangle *o;
 
 		  obj = (Evas_Object *) eina_array_data_get(&e->obscuring_objects, i);
 		  if (evas_object_is_in_output_rect(obj, ux, uy, uw, uh))
 		    {
 		       eina_array_push(&e->temporary_objects, obj);
-
-		       /* reset the background of the area if needed (using cutout and engine alpha flag to help) */
-		       if (alpha)
+		       /* opaques[j] goes with temporary_objects[j]. once one
+			* can't be noted, the rest just don't occlude */
+		       if (opaques_num != (e->temporary_objects.count - 1))
+			 continue;
+		       if (opaques_num >= opaques_max)
 			 {
-			    if (evas_object_is_opaque(obj))
-			      e->engine.func->context_cutout_add(e->engine.data.output,
-								 e->engine.data.context,
-								 obj->cur.cache.clip.x + off_x,
-								 obj->cur.cache.clip.y + off_y,
-								 obj->cur.cache.clip.w,
-								 obj->cur.cache.clip.h);
-			    else
-			      {
-				 if (obj->func->get_opaque_rect)
-				   {
-				      Evas_Coord obx, oby, obw, obh;
-
-				      obj->func->get_opaque_rect(obj, &obx, &oby, &obw, &obh);
-				      if ((obw > 0) && (obh > 0))
-					{
-					   obx += off_x;
-					   oby += off_y;
-					   RECTS_CLIP_TO_RECT(obx, oby, obw, obh,
-							      obj->cur.cache.clip.x + off_x,
-							      obj->cur.cache.clip.y + off_y,
-							      obj->cur.cache.clip.w,
-							      obj->cur.cache.clip.h);
-					   e->engine.func->context_cutout_add(e->engine.data.output,
-									      e->engine.data.context,
-									      obx, oby,
-									      obw, obh);
-					}
-				   }
-			      }
+			    o = realloc(opaques, (opaques_max + 32) * sizeof(Eina_Rectangle));
+			    if (!o) continue;
+			    opaques = o;
+			    opaques_max += 32;
 			 }
+		       o = opaques + opaques_num;
+		       opaques_num++;
+		       _evas_render_opaque_rect_get(obj, o);
+
+		       /* reset the background of the area if needed (using cutout and engine alpha flag to help) */
+		       if ((alpha) && (o->w > 0) && (o->h > 0))
+			 e->engine.func->context_cutout_add(e->engine.data.output,
+							    e->engine.data.context,
+							    o->x + off_x, o->y + off_y,
+							    o->w, o->h);
 		    }
 	       }
 	     if (alpha)
@@ -1015,7 +1146,7 @@ evas_render_updates_internal(Evas *e,
 //		      (!obj->smart.smart) &&
 		      (obj->cur.color.a > 0))
 		    {
-		       int x, y, w, h;
+		       int x, y, w, h, hidden;
 
                        RD("      DRAW (vis: %i, a: %i, clipees: %p\n", obj->cur.visible, obj->cur.color.a, obj->clip.clipees);
 		       if ((e->temporary_objects.count > offset) &&
@@ -1055,51 +1186,42 @@ evas_render_updates_internal(Evas *e,
 			    e->engine.func->context_clip_set(e->engine.data.output,
 							     e->engine.data.context,
 							     x, y, w, h);
-#if 1 /* FIXME: this can slow things down... figure out optimum... coverage */
-			    for (j = offset; j < e->temporary_objects.count; ++j)
+			    /* cut out what opaque objects above cover. if one of
+			     * them covers all of this object that is in the
+			     * update, it needn't be drawn at all */
+			    hidden = 0;
+			    for (j = offset; j < opaques_num; ++j)
 			      {
-				 Evas_Object *obj2;
-
-				 obj2 = (Evas_Object *) eina_array_data_get(&e->temporary_objects, j);
-                                 if (evas_object_is_opaque(obj2))
-                                   e->engine.func->context_cutout_add(e->engine.data.output,
-                                                                      e->engine.data.context,
-                                                                      obj2->cur.cache.clip.x + off_x,
-                                                                      obj2->cur.cache.clip.y + off_y,
-                                                                      obj2->cur.cache.clip.w,
-                                                                      obj2->cur.cache.clip.h);
-                                 else
-                                   {
-                                      if (obj2->func->get_opaque_rect)
-                                        {
-                                           Evas_Coord obx, oby, obw, obh;
-
-                                           obj2->func->get_opaque_rect
-                                             (obj2, &obx, &oby, &obw, &obh);
-                                           if ((obw > 0) && (obh > 0))
-                                             {
-                                                obx += off_x;
-                                                oby += off_y;
-                                                RECTS_CLIP_TO_RECT(obx, oby, obw, obh,
-                                                                   obj2->cur.cache.clip.x + off_x,
-                                                                   obj2->cur.cache.clip.y + off_y,
-                                                                   obj2->cur.cache.clip.w,
-                                                                   obj2->cur.cache.clip.h);
-                                                e->engine.func->context_cutout_add(e->engine.data.output,
-                                                                                   e->engine.data.context,
-                                                                                   obx, oby,
-                                                                                   obw, obh);
-                                             }
-                                        }
-                                   }
+				 Eina_Rectangle *o = opaques + j;
+
+				 if ((o->w <= 0) || (o->h <= 0)) continue;
+				 if ((!obj->smart.smart) &&
+				     (!_evas_render_has_map(obj)) &&
+				     ((o->x + off_x) <= x) &&
+				     ((o->y + off_y) <= y) &&
+				     ((o->x + off_x + o->w) >= (x + w)) &&
+				     ((o->y + off_y + o->h) >= (y + h)))
+				   {
+				      hidden = 1;
+				      break;
+				   }
+				 e->engine.func->context_cutout_add(e->engine.data.output,
+								    e->engine.data.context,
+								    o->x + off_x,
+								    o->y + off_y,
+								    o->w, o->h);
 			      }
-#endif
-                            clean_them |= evas_render_mapped(e, obj, e->engine.data.context,
-							     surface, off_x, off_y, 0
+			    if (hidden)
+			      {
+				 RD("      HIDDEN\n");
+			      }
+			    else
+			      clean_them |= evas_render_mapped(e, obj, e->engine.data.context,
+							       surface, off_x, off_y, 0
 #ifdef REND_DGB
-							     , 1
+							       , 1
 #endif
-							     );
+							       );
 			    e->engine.func->context_cutout_clear(e->engine.data.output,
 								 e->engine.data.context);
 			 }
@@ -1113,6 +1235,7 @@ evas_render_updates_internal(Evas *e,
 	     eina_array_clean(&e->temporary_objects);
              RD("  ---]\n");
 	  }
+	if (opaques) free(opaques);
 	/* flush redraws */
         if (haveup)
           {
@@ -1364,6 +1487,13 @@ _evas_render_dump_map_surfaces(Evas_Object *obj)
           (obj->layer->evas->engine.data.output, obj->cur.map->surface);
         obj->cur.map->surface = NULL;
      }
+   if ((obj->cur.map) && obj->cur.map->cache.surface)
+     {
+        obj->layer->evas->engine.func->image_map_surface_free
+          (obj->layer->evas->engine.data.output, obj->cur.map->cache.surface);
+        obj->cur.map->cache.surface = NULL;
+        obj->cur.map->cache.valid = 0;
+     }
 
    if (obj->smart.smart)
      {
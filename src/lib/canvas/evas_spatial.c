@@ -0,0 +1,318 @@
+#include "evas_common.h"
+#include "evas_private.h"
+
+/* spatial index of objects used to speed up hit testing.
+ *
+ * the canvas viewport is covered by a uniform grid of cells and every object
+ * is listed in the cells its geometry touches. the index is updated wherever
+ * an object's geometry is set (move, resize and the object types that size
+ * themselves), so it never lags behind the object. the geometry is a superset
+ * of the clipped output rect hit testing checks, so clip changes need no
+ * update. objects covering more than EVAS_SPATIAL_BIG_CELLS cells (backgrounds,
+ * full screen overlays) are kept on a separate big list instead, so moving
+ * them doesn't touch hundreds of cells. queries return the objects of a
+ * single cell plus the big objects over it, sorted top-most first by stacking
+ * order. stacking order is numbered lazily - any restack just flags it and
+ * the next query renumbers the canvas once.
+ *
+ * the grid only answers for points inside the viewport and is disabled
+ * while any object on the canvas has a map enabled, as mapped objects (and
+ * their smart members) are hit in transformed coordinates. in those cases
+ * callers fall back to walking the object lists.
+ */
+
+#define EVAS_SPATIAL_CELL_SIZE 64
+#define EVAS_SPATIAL_CELLS_MAX 256
+#define EVAS_SPATIAL_BIG_CELLS 16
+
+static void
+_evas_spatial_object_cells_del(Evas *e, Evas_Object *obj)
+{
+   int x, y;
+
+   if (!obj->spatial.indexed) return;
+   obj->spatial.indexed = 0;
+   if (obj->spatial.big)
+     {
+        e->spatial.big = eina_list_remove(e->spatial.big, obj);
+        obj->spatial.big = 0;
+        return;
+     }
+   for (y = obj->spatial.y1; y <= obj->spatial.y2; y++)
+     {
+        for (x = obj->spatial.x1; x <= obj->spatial.x2; x++)
+          {
+             Eina_List **cell;
+
+             cell = &(e->spatial.cells[(y * e->spatial.cells_w) + x]);
+             *cell = eina_list_remove(*cell, obj);
+          }
+     }
+}
+
+static Eina_Bool
+_evas_spatial_object_cells_calc(Evas *e, Evas_Object *obj, int *x1, int *y1, int *x2, int *y2)
+{
+   Evas_Coord cx, cy, cw, ch;
+
+   cx = obj->cur.geometry.x;
+   cy = obj->cur.geometry.y;
+   cw = obj->cur.geometry.w;
+   ch = obj->cur.geometry.h;
+   RECTS_CLIP_TO_RECT(cx, cy, cw, ch,
+                      e->spatial.x, e->spatial.y, e->spatial.w, e->spatial.h);
+   if ((cw <= 0) || (ch <= 0)) return EINA_FALSE;
+   *x1 = (cx - e->spatial.x) / e->spatial.cell_w;
+   *y1 = (cy - e->spatial.y) / e->spatial.cell_h;
+   *x2 = (cx + cw - 1 - e->spatial.x) / e->spatial.cell_w;
+   *y2 = (cy + ch - 1 - e->spatial.y) / e->spatial.cell_h;
+   if (*x2 >= e->spatial.cells_w) *x2 = e->spatial.cells_w - 1;
+   if (*y2 >= e->spatial.cells_h) *y2 = e->spatial.cells_h - 1;
+   return EINA_TRUE;
+}
+
+static void
+_evas_spatial_object_cells_add(Evas *e, Evas_Object *obj)
+{
+   int x1, y1, x2, y2, x, y;
+
+   if (!_evas_spatial_object_cells_calc(e, obj, &x1, &y1, &x2, &y2)) return;
+   obj->spatial.x1 = x1;
+   obj->spatial.y1 = y1;
+   obj->spatial.x2 = x2;
+   obj->spatial.y2 = y2;
+   obj->spatial.indexed = 1;
+   if (((x2 - x1 + 1) * (y2 - y1 + 1)) > EVAS_SPATIAL_BIG_CELLS)
+     {
+        e->spatial.big = eina_list_prepend(e->spatial.big, obj);
+        obj->spatial.big = 1;
+        return;
+     }
+   for (y = y1; y <= y2; y++)
+     {
+        for (x = x1; x <= x2; x++)
+          {
+             Eina_List **cell;
+
+             cell = &(e->spatial.cells[(y * e->spatial.cells_w) + x]);
+             *cell = eina_list_prepend(*cell, obj);
+          }
+     }
+}
+
+static void
+_evas_spatial_cells_clear(Evas *e)
+{
+   int i;
+
+   e->spatial.big = eina_list_free(e->spatial.big);
+   if (!e->spatial.cells) return;
+   for (i = 0; i < (e->spatial.cells_w * e->spatial.cells_h); i++)
+     e->spatial.cells[i] = eina_list_free(e->spatial.cells[i]);
+}
+
+static void
+_evas_spatial_rebuild_walk(Evas *e, const Eina_Inlist *list)
+{
+   Evas_Object *obj;
+
+   EINA_INLIST_FOREACH(list, obj)
+     {
+        obj->spatial.indexed = 0;
+        obj->spatial.big = 0;
+        _evas_spatial_object_cells_add(e, obj);
+        if (obj->smart.smart)
+          _evas_spatial_rebuild_walk(e, evas_object_smart_members_get_direct(obj));
+     }
+}
+
+static Eina_Bool
+_evas_spatial_rebuild(Evas *e)
+{
+   Evas_Layer *lay;
+   int cells_w, cells_h;
+
+   _evas_spatial_cells_clear(e);
+   cells_w = (e->output.w + EVAS_SPATIAL_CELL_SIZE - 1) / EVAS_SPATIAL_CELL_SIZE;
+   cells_h = (e->output.h + EVAS_SPATIAL_CELL_SIZE - 1) / EVAS_SPATIAL_CELL_SIZE;
+   if (cells_w < 1) cells_w = 1;
+   if (cells_h < 1) cells_h = 1;
+   if (cells_w > EVAS_SPATIAL_CELLS_MAX) cells_w = EVAS_SPATIAL_CELLS_MAX;
+   if (cells_h > EVAS_SPATIAL_CELLS_MAX) cells_h = EVAS_SPATIAL_CELLS_MAX;
+   if ((cells_w != e->spatial.cells_w) || (cells_h != e->spatial.cells_h) ||
+       (!e->spatial.cells))
+     {
+        free(e->spatial.cells);
+        e->spatial.cells = calloc(cells_w * cells_h, sizeof(Eina_List *));
+        if (!e->spatial.cells)
+          {
+             e->spatial.cells_w = 0;
+             e->spatial.cells_h = 0;
+             return EINA_FALSE;
+          }
+        e->spatial.cells_w = cells_w;
+        e->spatial.cells_h = cells_h;
+     }
+   e->spatial.x = e->viewport.x;
+   e->spatial.y = e->viewport.y;
+   e->spatial.w = e->viewport.w;
+   e->spatial.h = e->viewport.h;
+   e->spatial.cell_w = (e->spatial.w + cells_w - 1) / cells_w;
+   e->spatial.cell_h = (e->spatial.h + cells_h - 1) / cells_h;
+   if (e->spatial.cell_w < 1) e->spatial.cell_w = 1;
+   if (e->spatial.cell_h < 1) e->spatial.cell_h = 1;
+   EINA_INLIST_FOREACH(e->layers, lay)
+     _evas_spatial_rebuild_walk(e, EINA_INLIST_GET(lay->objects));
+   e->spatial.dirty = 0;
+   return EINA_TRUE;
+}
+
+static void
+_evas_spatial_order_walk(const Eina_Inlist *list, int *n)
+{
+   Evas_Object *obj;
+
+   EINA_INLIST_FOREACH(list, obj)
+     {
+        obj->spatial.order = (*n)++;
+        if (obj->smart.smart)
+          _evas_spatial_order_walk(evas_object_smart_members_get_direct(obj), n);
+     }
+}
+
+static int
+_evas_spatial_order_cmp(const void *a, const void *b)
+{
+   const Evas_Object *o1 = *((const Evas_Object **)a);
+   const Evas_Object *o2 = *((const Evas_Object **)b);
+
+   /* top-most first */
+   return o2->spatial.order - o1->spatial.order;
+}
+
+void
+evas_spatial_init(Evas *e)
+{
+   e->spatial.dirty = 1;
+   e->spatial.order_dirty = 1;
+}
+
+void
+evas_spatial_shutdown(Evas *e)
+{
+   _evas_spatial_cells_clear(e);
+   free(e->spatial.cells);
+   e->spatial.cells = NULL;
+   e->spatial.cells_w = 0;
+   e->spatial.cells_h = 0;
+   free(e->spatial.found);
+   e->spatial.found = NULL;
+   e->spatial.found_max = 0;
+}
+
+void
+evas_object_spatial_update(Evas_Object *obj)
+{
+   Evas *e;
+   int x1, y1, x2, y2;
+
+   if (!obj->layer) return;
+   e = obj->layer->evas;
+   if ((e->spatial.dirty) || (!e->spatial.cells)) return;
+   if (!_evas_spatial_object_cells_calc(e, obj, &x1, &y1, &x2, &y2))
+     {
+        _evas_spatial_object_cells_del(e, obj);
+        return;
+     }
+   if ((obj->spatial.indexed) &&
+       (obj->spatial.x1 == x1) && (obj->spatial.y1 == y1) &&
+       (obj->spatial.x2 == x2) && (obj->spatial.y2 == y2))
+     return;
+   _evas_spatial_object_cells_del(e, obj);
+   _evas_spatial_object_cells_add(e, obj);
+}
+
+void
+evas_object_spatial_map_update(Evas_Object *obj)
+{
+   Eina_Bool mapped;
+
+   if (!obj->layer) return;
+   mapped = ((obj->cur.map) && (obj->cur.usemap));
+   if (mapped == obj->spatial.mapped) return;
+   obj->spatial.mapped = mapped;
+   if (mapped) obj->layer->evas->spatial.maps++;
+   else obj->layer->evas->spatial.maps--;
+}
+
+void
+evas_object_spatial_del(Evas_Object *obj)
+{
+   Evas *e;
+
+   if (!obj->layer) return;
+   e = obj->layer->evas;
+   if (obj->spatial.mapped)
+     {
+        obj->spatial.mapped = 0;
+        e->spatial.maps--;
+     }
+   if (e->spatial.cells) _evas_spatial_object_cells_del(e, obj);
+   e->spatial.order_dirty = 1;
+}
+
+Eina_Bool
+evas_spatial_objects_at_xy_get(Evas *e, Evas_Coord x, Evas_Coord y, Evas_Object ***objs, int *num)
+{
+   Eina_List *l;
+   Evas_Object *obj;
+   Eina_List *cell;
+   int n, cx, cy;
+
+   if (e->spatial.maps > 0) return EINA_FALSE;
+   if (e->spatial.dirty)
+     {
+        if (!_evas_spatial_rebuild(e)) return EINA_FALSE;
+     }
+   if (!RECTS_INTERSECT(x, y, 1, 1,
+                        e->spatial.x, e->spatial.y,
+                        e->spatial.w, e->spatial.h))
+     return EINA_FALSE;
+   if (e->spatial.order_dirty)
+     {
+        Evas_Layer *lay;
+
+        n = 0;
+        EINA_INLIST_FOREACH(e->layers, lay)
+          _evas_spatial_order_walk(EINA_INLIST_GET(lay->objects), &n);
+        e->spatial.order_dirty = 0;
+     }
+   cx = (x - e->spatial.x) / e->spatial.cell_w;
+   cy = (y - e->spatial.y) / e->spatial.cell_h;
+   cell = e->spatial.cells[(cy * e->spatial.cells_w) + cx];
+   n = eina_list_count(cell) + eina_list_count(e->spatial.big);
+   if (n > e->spatial.found_max)
+     {
+        Evas_Object **found;
+
+        found = realloc(e->spatial.found, n * sizeof(Evas_Object *));
+        if (!found) return EINA_FALSE;
+        e->spatial.found = found;
+        e->spatial.found_max = n;
+     }
+   n = 0;
+   EINA_LIST_FOREACH(cell, l, obj)
+     e->spatial.found[n++] = obj;
+   EINA_LIST_FOREACH(e->spatial.big, l, obj)
+     {
+        if ((cx < obj->spatial.x1) || (cx > obj->spatial.x2) ||
+            (cy < obj->spatial.y1) || (cy > obj->spatial.y2))
+          continue;
+        e->spatial.found[n++] = obj;
+     }
+   if (n > 1)
+     qsort(e->spatial.found, n, sizeof(Evas_Object *), _evas_spatial_order_cmp);
+   *objs = e->spatial.found;
+   *num = n;
+   return EINA_TRUE;
+}
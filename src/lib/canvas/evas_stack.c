@@ -67,6 +67,7 @@ evas_object_raise(Evas_Object *obj)
 	  obj->layer->objects = (Evas_Object *)eina_inlist_demote(EINA_INLIST_GET(obj->layer->objects),
 								  EINA_INLIST_GET(obj));
      }
+   if (obj->layer) obj->layer->evas->spatial.order_dirty = 1;
    if (obj->clip.clipees)
      {
 	evas_object_inform_call_restack(obj);
@@ -121,6 +122,7 @@ evas_object_lower(Evas_Object *obj)
 	  obj->layer->objects = (Evas_Object *)eina_inlist_promote(EINA_INLIST_GET(obj->layer->objects),
 								   EINA_INLIST_GET(obj));
      }
+   if (obj->layer) obj->layer->evas->spatial.order_dirty = 1;
    if (obj->clip.clipees)
      {
 	evas_object_inform_call_restack(obj);
@@ -213,6 +215,7 @@ evas_object_stack_above(Evas_Object *obj, Evas_Object *above)
 									      EINA_INLIST_GET(above));
 	  }
      }
+   if (obj->layer) obj->layer->evas->spatial.order_dirty = 1;
    if (obj->clip.clipees)
      {
 	evas_object_inform_call_restack(obj);
@@ -305,6 +308,7 @@ evas_object_stack_below(Evas_Object *obj, Evas_Object *below)
 									       EINA_INLIST_GET(below));
 	  }
      }
+   if (obj->layer) obj->layer->evas->spatial.order_dirty = 1;
    if (obj->clip.clipees)
      {
 	evas_object_inform_call_restack(obj);
@@ -67,6 +67,7 @@ struct _Server
    struct {
       int fd;
       int req_from, req_to;
+      int proto;
    } ch[2];
    void *main_handle;
 };
@@ -85,13 +86,15 @@ struct _Client
    void *data;
    pid_t pid;
    int req_from, req_to;
+   int proto;
+   int decoding; // decode jobs for this client in progress (server)
    LK(lock);
 };
 
 struct _Mem
 {
    unsigned char *data;
-   char *name;
+   char *name; // NULL for anonymous (memfd) memory
    int fd;
    int id;
    int offset;
@@ -122,6 +125,12 @@ enum
    OP_INVALID // 13
 };
 
+// protocol revisions a client can ask for with Op_Init_Proto
+#define EVAS_CSERVE_PROTO_NAMED 0 // pixel memory is shm_open()ed by name
+#define EVAS_CSERVE_PROTO_FD    1 // pixel memory fd is passed with the reply
+#define EVAS_CSERVE_PROTO_STATS 2 // as above plus Op_Getstats_Decode
+#define EVAS_CSERVE_PROTO_LATEST EVAS_CSERVE_PROTO_STATS
+
 typedef struct
 {
    pid_t pid;
@@ -129,6 +138,13 @@ typedef struct
    void *handle;
 } Op_Init;
 typedef struct
+{
+   Op_Init init;
+   int proto;
+} Op_Init_Proto; // OP_INIT from newer clients. older servers just read the
+                 // Op_Init part and reply with a plain Op_Init, newer ones
+                 // reply with the proto they will speak
+typedef struct
 {
    struct {
       int    scale_down_by;
@@ -217,6 +233,15 @@ typedef struct
    double saved_time_image_data_load;
 } Op_Getstats_Reply;
 typedef struct
+{
+   int threads;
+   int queued, queued_peak; // jobs waiting for a decode thread
+   int running;
+   int decoded, cancelled;
+   double wait_time; // seconds jobs spent queued, all jobs together
+   double decode_time; // seconds spent decoding, all jobs together
+} Op_Getstats_Decode; // follows Op_Getstats_Reply for clients of proto 3+
+typedef struct
 {
    struct {
       int mem_total;
@@ -257,22 +282,27 @@ EAPI void      evas_cserve_image_free(Image_Entry *ie);
 EAPI Eina_Bool evas_cserve_raw_config_get(Op_Getconfig_Reply *config);
 EAPI Eina_Bool evas_cserve_raw_config_set(Op_Setconfig *config);
 EAPI Eina_Bool evas_cserve_raw_stats_get(Op_Getstats_Reply *stats);
+EAPI Eina_Bool evas_cserve_raw_decode_stats_get(Op_Getstats_Decode *stats);
 EAPI Op_Getinfo_Reply *evas_cserve_raw_info_get(void);
     
 // for the server
 EAPI Server *evas_cserve_server_add(void);
 EAPI void evas_cserve_server_del(Server *s);
 EAPI void evas_cserve_client_send(Client *c, int opcode, int size, unsigned char *data);
+EAPI Eina_Bool evas_cserve_client_send_fd(Client *c, int opcode, int size, unsigned char *data, int fd);
 EAPI void evas_cserve_server_message_handler_set(Server *s, int (*func) (void *fdata, Server *s, Client *c, int opcode, int size, unsigned char *data), void *data);
 EAPI void evas_cserve_server_wait(Server *s, int timeout);
     
 //// for memory
 // for server
 EAPI Mem *evas_cserve_mem_new(int size, const char *name);
+EAPI Mem *evas_cserve_mem_anon_new(int size);
+EAPI void evas_cserve_mem_seal(Mem *m);
 EAPI void evas_cserve_mem_free(Mem *m);
     
 // for client
 EAPI Mem *evas_cserve_mem_open(int pid, int id, const char *name, int size, int write);
+EAPI Mem *evas_cserve_mem_fd_open(int fd, int offset, int size);
 EAPI void evas_cserve_mem_close(Mem *m);
 
 // for both
@@ -127,38 +127,66 @@ server_send(Server *s, int channel, int opcode, int size, unsigned char *data)
    return 1;
 }
 
+/* the header is read with recvmsg() so an fd the server passed along with
+ * the message is picked up. if fd is NULL any such fd is just closed */
 static unsigned char *
-server_read(Server *s, int channel, int *opcode, int *size)
+server_read_fd(Server *s, int channel, int *opcode, int *size, int *fd)
 {
    int ints[3], num, left;
    unsigned char *data;
+   struct msghdr msg;
+   struct iovec iov;
+   struct cmsghdr *cmsg;
+   char cbuf[CMSG_SPACE(sizeof(int))];
+   int rfd = -1;
    
-   num = read(s->ch[channel].fd, ints, sizeof(int) * 3);
+   if (fd) *fd = -1;
+   iov.iov_base = ints;
+   iov.iov_len = sizeof(int) * 3;
+   memset(&msg, 0, sizeof(msg));
+   msg.msg_iov = &iov;
+   msg.msg_iovlen = 1;
+   msg.msg_control = cbuf;
+   msg.msg_controllen = sizeof(cbuf);
+   num = recvmsg(s->ch[channel].fd, &msg, MSG_WAITALL);
+   for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+     {
+        if ((cmsg->cmsg_level == SOL_SOCKET) &&
+            (cmsg->cmsg_type == SCM_RIGHTS) &&
+            (cmsg->cmsg_len == CMSG_LEN(sizeof(int))))
+          memcpy(&rfd, CMSG_DATA(cmsg), sizeof(int));
+     }
+   if (rfd >= 0)
+     {
+        fcntl(rfd, F_SETFD, FD_CLOEXEC);
+        if (fd) *fd = rfd;
+        else close(rfd);
+     }
    if (num != (sizeof(int) * 3))
      {
         if (cserve) server_disconnect(cserve);
         cserve = NULL;
-        return NULL;
+        goto error;
      }
    *size = ints[0];
    *opcode = ints[1];
-   if ((*size < 0) || (*size > (1024 * 1024))) return NULL;
+   if ((*size < 0) || (*size > (1024 * 1024))) goto error;
    if (ints[2] != (s->ch[channel].req_from + 1))
      {
         ERR("EEK! sequence number mismatch from serer with pid: %i\n"
                "---- num %i is not 1 more than %i"
                ,
                s->pid, ints[2], s->ch[channel].req_from);
-        return NULL;
+        goto error;
      }
    s->ch[channel].req_from++;
    data = malloc(*size);
-   if (!data) return NULL;
+   if (!data) goto error;
    num = read(s->ch[channel].fd, data, *size);
    if (num < 0)
      {
         free(data);
-        return NULL;
+        goto error;
      }
    left = *size - num;
    while (left > 0)
@@ -167,41 +195,78 @@ server_read(Server *s, int channel, int *opcode, int *size)
         if (num < 0)
           {
              free(data);
-             return NULL;
+             goto error;
           }
         left -= num;
      }
    return data;
+   error:
+   if ((fd) && (*fd >= 0))
+     {
+        close(*fd);
+        *fd = -1;
+     }
+   return NULL;
+}
+
+static unsigned char *
+server_read(Server *s, int channel, int *opcode, int *size)
+{
+   return server_read_fd(s, channel, opcode, size, NULL);
+}
+
+/* an older server replies with a plain Op_Init and only knows the named
+ * shm protocol */
+static int
+server_init_proto_get(Op_Init *rep, int size)
+{
+   if (size == sizeof(Op_Init)) return EVAS_CSERVE_PROTO_NAMED;
+   if (size == sizeof(Op_Init_Proto))
+     {
+        int proto = ((Op_Init_Proto *)rep)->proto;
+        
+        if ((proto >= EVAS_CSERVE_PROTO_NAMED) && (proto <= EVAS_CSERVE_PROTO_LATEST))
+          return proto;
+     }
+   return -1;
 }
 
 static int
 server_init(Server *s)
 {
-   Op_Init msg, *rep;
+   Op_Init_Proto msg;
+   Op_Init *rep;
    int opcode;
    int size;
+   int proto;
    
-   msg.pid = getpid();
-   msg.server_id = 0;
-   msg.handle = NULL;
+   memset(&msg, 0, sizeof(msg));
+   msg.init.pid = getpid();
+   msg.init.server_id = 0;
+   msg.init.handle = NULL;
+   msg.proto = EVAS_CSERVE_PROTO_LATEST;
    if (!server_send(s, 0, OP_INIT, sizeof(msg), (unsigned char *)(&msg)))
      return 0;
    rep = (Op_Init *)server_read(s, 0, &opcode, &size);
-   if ((rep) && (opcode == OP_INIT) && (size == sizeof(Op_Init)))
+   if ((rep) && (opcode == OP_INIT) &&
+       ((proto = server_init_proto_get(rep, size)) >= 0))
      {
         s->pid = rep->pid;
         s->server_id = rep->server_id;
         s->main_handle = rep->handle;
+        s->ch[0].proto = proto;
         connect_num++;
-        msg.pid = getpid();
-        msg.server_id = 1;
-        msg.handle = rep->handle;
+        msg.init.pid = getpid();
+        msg.init.server_id = 1;
+        msg.init.handle = rep->handle;
         free(rep);
         if (!server_send(s, 1, OP_INIT, sizeof(msg), (unsigned char *)(&msg)))
           return 0;
         rep = (Op_Init *)server_read(s, 1, &opcode, &size);
-        if ((rep) && (opcode == OP_INIT) && (size == sizeof(Op_Init)))
+        if ((rep) && (opcode == OP_INIT) &&
+            ((proto = server_init_proto_get(rep, size)) >= 0))
           {
+             s->ch[1].proto = proto;
              free(rep);
              return 1;
           }
@@ -278,6 +343,37 @@ server_reinit(void)
      }
 }
 
+static void
+load_msg_fill(Op_Load *msg, RGBA_Image_Loadopts *lopt)
+{
+   memset(msg, 0, sizeof(Op_Load));
+   if (!lopt) return;
+   msg->lopt.scale_down_by = lopt->scale_down_by;
+   msg->lopt.dpi = lopt->dpi;
+   msg->lopt.w = lopt->w;
+   msg->lopt.h = lopt->h;
+   msg->lopt.region.x = lopt->region.x;
+   msg->lopt.region.y = lopt->region.y;
+   msg->lopt.region.w = lopt->region.w;
+   msg->lopt.region.h = lopt->region.h;
+}
+
+// the server wants absolute paths. fbuf and wdb must be PATH_MAX long
+static const char *
+load_file_path(const char *file, char *fbuf, char *wdb)
+{
+   if (file[0] != '/')
+     {
+        if (getcwd(wdb, PATH_MAX))
+          {
+             snprintf(fbuf, PATH_MAX, "%s/%s", wdb, file);
+             file = fbuf;
+          }
+     }
+   if (realpath(file, wdb)) file = wdb;
+   return file;
+}
+
 EAPI Eina_Bool
 evas_cserve_image_load(Image_Entry *ie, const char *file, const char *key, RGBA_Image_Loadopts *lopt)
 {
@@ -293,31 +389,15 @@ evas_cserve_image_load(Image_Entry *ie, const char *file, const char *key, RGBA_
    else return 0;
    if (!cserve) return 0;
    if (!key) key = "";
-   memset(&msg, 0, sizeof(msg));
-   msg.lopt.scale_down_by = lopt->scale_down_by;
-   msg.lopt.dpi = lopt->dpi;
-   msg.lopt.w = lopt->w;
-   msg.lopt.h = lopt->h;
-   msg.lopt.region.x = lopt->region.x;
-   msg.lopt.region.y = lopt->region.y;
-   msg.lopt.region.w = lopt->region.w;
-   msg.lopt.region.h = lopt->region.h;
-   if (file[0] != '/')
-     {
-        if (getcwd(wdb, sizeof(wdb)))
-          {
-             snprintf(fbuf, sizeof(buf), "%s/%s", wdb, file);
-             file = fbuf;
-          }
-     }
-   if (!realpath(file, wdb)) file = wdb;
+   load_msg_fill(&msg, lopt);
+   file = load_file_path(file, fbuf, wdb);
    flen = strlen(file) + 1;
    klen = strlen(key) + 1;
    buf = malloc(sizeof(msg) + flen + klen);
+   if (!buf) return 0;
    memcpy(buf, &msg, sizeof(msg));
    memcpy(buf + sizeof(msg), file, flen);
    memcpy(buf + sizeof(msg) + flen, key, klen);
-   if (!buf) return 0;
    if (!server_send(cserve, ie->channel, OP_LOAD, 
                     sizeof(msg) + flen + klen,
                     buf))
@@ -350,6 +430,7 @@ evas_cserve_image_data_load(Image_Entry *ie)
    Op_Loaddata_Reply *rep;
    int opcode;
    int size;
+   int fd = -1;
    if (csrve_init > 0) server_reinit();
    else return 0;
    if (!cserve) return 0;
@@ -367,18 +448,24 @@ evas_cserve_image_data_load(Image_Entry *ie)
    if (!server_send(cserve, ie->channel, OP_LOADDATA, sizeof(msg), (unsigned char *)(&msg)))
      return 0;
    if (!cserve) return 0;
-   rep = (Op_Loaddata_Reply *)server_read(cserve, ie->channel, &opcode, &size);
+   rep = (Op_Loaddata_Reply *)server_read_fd(cserve, ie->channel, &opcode, &size, &fd);
    if ((rep) && (opcode == OP_LOADDATA) && (size == sizeof(Op_Loaddata_Reply)))
      {
         if (rep->mem.size <= 0)
           {
+             if (fd >= 0) close(fd);
              free(rep);
              return 0;
           }
-        ie->data2 = evas_cserve_mem_open(cserve->pid, rep->mem.id, NULL, rep->mem.size, 0);
+        // the server passed us the memory itself - no need to look it up
+        if (fd >= 0)
+          ie->data2 = evas_cserve_mem_fd_open(fd, rep->mem.offset, rep->mem.size);
+        else
+          ie->data2 = evas_cserve_mem_open(cserve->pid, rep->mem.id, NULL, rep->mem.size, 0);
         free(rep);
         return 1;
      }
+   if (fd >= 0) close(fd);
    if (rep) free(rep);
    return 0;
 }
@@ -483,8 +570,8 @@ evas_cserve_raw_config_set(Op_Setconfig *config)
    return 1;
 }
 
-EAPI Eina_Bool
-evas_cserve_raw_stats_get(Op_Getstats_Reply *stats)
+static Eina_Bool
+server_stats_get(Op_Getstats_Reply *stats, Op_Getstats_Decode *decode)
 {
    Op_Getstats_Reply *rep;
    int opcode;
@@ -492,11 +579,24 @@ evas_cserve_raw_stats_get(Op_Getstats_Reply *stats)
    if (csrve_init > 0) server_reinit();
    else return 0;
    if (!cserve) return 0;
+   if ((decode) && (cserve->ch[0].proto < EVAS_CSERVE_PROTO_STATS)) return 0;
    if (!server_send(cserve, 0, OP_GETSTATS, 0, NULL)) return 0;
    rep = (Op_Getstats_Reply *)server_read(cserve, 0, &opcode, &size);
-   if ((rep) && (opcode == OP_GETSTATS) && (size == sizeof(Op_Getstats_Reply)))
+   if ((rep) && (opcode == OP_GETSTATS) &&
+       ((size == sizeof(Op_Getstats_Reply)) ||
+        (size == (sizeof(Op_Getstats_Reply) + sizeof(Op_Getstats_Decode)))))
      {
-        memcpy(stats, rep, sizeof(Op_Getstats_Reply));
+        if (stats) memcpy(stats, rep, sizeof(Op_Getstats_Reply));
+        if (decode)
+          {
+             if (size == sizeof(Op_Getstats_Reply))
+               {
+                  free(rep);
+                  return 0;
+               }
+             memcpy(decode, ((unsigned char *)rep) + sizeof(Op_Getstats_Reply),
+                    sizeof(Op_Getstats_Decode));
+          }
         free(rep);
         return 1;
      }
@@ -504,6 +604,18 @@ evas_cserve_raw_stats_get(Op_Getstats_Reply *stats)
    return 0;
 }
 
+EAPI Eina_Bool
+evas_cserve_raw_stats_get(Op_Getstats_Reply *stats)
+{
+   return server_stats_get(stats, NULL);
+}
+
+EAPI Eina_Bool
+evas_cserve_raw_decode_stats_get(Op_Getstats_Decode *stats)
+{
+   return server_stats_get(NULL, stats);
+}
+
 EAPI Op_Getinfo_Reply *
 evas_cserve_raw_info_get(void)
 {
@@ -6,6 +6,19 @@
 
 #ifdef EVAS_CSERVE
 
+#ifdef __linux__
+# include <sys/syscall.h>
+#endif
+
+#ifdef SYS_memfd_create
+# ifndef MFD_CLOEXEC
+#  define MFD_CLOEXEC 0x0001U
+# endif
+# ifndef MFD_ALLOW_SEALING
+#  define MFD_ALLOW_SEALING 0x0002U
+# endif
+#endif
+
 EAPI Mem *
 evas_cserve_mem_new(int size, const char *name)
 {
@@ -60,10 +73,69 @@ evas_cserve_mem_new(int size, const char *name)
    return m;
 }
 
+/* anonymous memory has no name in /dev/shm - clients can only get at it
+ * through an fd passed to them over the socket */
+EAPI Mem *
+evas_cserve_mem_anon_new(int size)
+{
+#ifdef SYS_memfd_create
+   Mem *m;
+   
+   m = calloc(1, sizeof(Mem));
+   if (!m) return NULL;
+   m->size = size;
+   m->fd = syscall(SYS_memfd_create, "evas-cserve",
+                   MFD_CLOEXEC | MFD_ALLOW_SEALING);
+   if (m->fd < 0)
+     {
+        free(m);
+        return NULL;
+     }
+   if (ftruncate(m->fd, m->size) < 0)
+     {
+        close(m->fd);
+        free(m);
+        return NULL;
+     }
+   m->data = mmap(NULL, m->size, PROT_READ | PROT_WRITE, MAP_SHARED, m->fd, 0);
+   if (m->data == MAP_FAILED)
+     {
+        close(m->fd);
+        free(m);
+        return NULL;
+     }
+   m->ref = 1;
+   m->write = 1;
+   return m;
+#else
+   return NULL;
+   size = 0;
+#endif
+}
+
+/* make anonymous memory read-only for good once it is filled in. our own
+ * mapping is replaced by a read-only one at the same address so pointers
+ * into it stay valid, then the size and contents are sealed so no client
+ * given the fd can change them */
+EAPI void
+evas_cserve_mem_seal(Mem *m)
+{
+   void *data;
+   
+   if ((m->name) || (!m->write)) return;
+   data = mmap(m->data, m->size, PROT_READ, MAP_SHARED | MAP_FIXED, m->fd, 0);
+   if (data == MAP_FAILED) return;
+   m->write = 0;
+#ifdef F_ADD_SEALS
+   fcntl(m->fd, F_ADD_SEALS,
+         F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+#endif
+}
+
 EAPI void
 evas_cserve_mem_free(Mem *m)
 {
-   shm_unlink(m->name);
+   if (m->name) shm_unlink(m->name);
    munmap(m->data, m->size);
    close(m->fd);
    free(m->name);
@@ -115,6 +187,32 @@ evas_cserve_mem_open(int pid, int id, const char *name, int size, int write)
    return m;
 }
 
+/* takes over fd, which was passed to us by the server */
+EAPI Mem *
+evas_cserve_mem_fd_open(int fd, int offset, int size)
+{
+   Mem *m;
+   
+   m = calloc(1, sizeof(Mem));
+   if (!m)
+     {
+        close(fd);
+        return NULL;
+     }
+   m->fd = fd;
+   m->offset = offset;
+   m->size = size;
+   m->data = mmap(NULL, m->size, PROT_READ, MAP_SHARED, m->fd, 0);
+   if (m->data == MAP_FAILED)
+     {
+        close(m->fd);
+        free(m);
+        return NULL;
+     }
+   m->ref = 1;
+   return m;
+}
+
 EAPI void
 evas_cserve_mem_close(Mem *m)
 {
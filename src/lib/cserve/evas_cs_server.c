@@ -195,6 +195,55 @@ evas_cserve_client_send(Client *c, int opcode, int size, unsigned char *data)
    free(data2);
 }
 
+/* send a message with fd attached (SCM_RIGHTS). the fd goes with the first
+ * bytes of the message, so this fails if anything is still queued ahead of
+ * it - the caller then has to reply the old way */
+EAPI Eina_Bool
+evas_cserve_client_send_fd(Client *c, int opcode, int size, unsigned char *data, int fd)
+{
+   struct msghdr msg;
+   struct iovec iov[2];
+   struct cmsghdr *cmsg;
+   char cbuf[CMSG_SPACE(sizeof(int))];
+   int ints[3];
+   int num;
+   
+   if ((c->buf) || (c->dead)) return 0;
+   ints[0] = size;
+   ints[1] = opcode;
+   ints[2] = c->req_to + 1;
+   iov[0].iov_base = ints;
+   iov[0].iov_len = sizeof(int) * 3;
+   iov[1].iov_base = data;
+   iov[1].iov_len = size;
+   memset(&msg, 0, sizeof(msg));
+   msg.msg_iov = iov;
+   msg.msg_iovlen = 2;
+   msg.msg_control = cbuf;
+   msg.msg_controllen = sizeof(cbuf);
+   cmsg = CMSG_FIRSTHDR(&msg);
+   cmsg->cmsg_level = SOL_SOCKET;
+   cmsg->cmsg_type = SCM_RIGHTS;
+   cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+   memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+   num = sendmsg(c->fd, &msg, 0);
+   if (num <= 0) return 0;
+   c->req_to++;
+   if (num < (int)(size + (sizeof(int) * 3)))
+     {
+        if (num < (int)(sizeof(int) * 3))
+          {
+             client_buf_add(c, ((unsigned char *)ints) + num,
+                            (sizeof(int) * 3) - num);
+             client_buf_add(c, data, size);
+          }
+        else
+          client_buf_add(c, data + (num - (sizeof(int) * 3)),
+                         size - (num - (sizeof(int) * 3)));
+     }
+   return 1;
+}
+
 static void
 server_message_handle(Server *s, Client *c, int opcode, int size, unsigned char *data)
 {
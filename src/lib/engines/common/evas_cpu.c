@@ -64,6 +64,29 @@ evas_common_cpu_sse_test(void)
 #endif
 }
 
+void
+evas_common_cpu_sse2_test(void)
+{
+#ifdef BUILD_SSE2
+   asm volatile (
+                 "pxor %xmm0, %xmm0\n"
+                 );
+#endif
+}
+
+void
+evas_common_cpu_avx2_test(void)
+{
+#ifdef BUILD_AVX2
+   /* integer ops on ymm are avx2 only, and fault if the os didn't turn on
+    * ymm state saving either */
+   asm volatile (
+                 "vpaddd %ymm0, %ymm0, %ymm0\n"
+                 "vzeroupper\n"
+                 );
+#endif
+}
+
 void
 evas_common_cpu_altivec_test(void)
 {
@@ -155,6 +178,18 @@ evas_common_cpu_init(void)
      cpu_feature_mask &= ~CPU_FEATURE_SSE;
 #endif /* BUILD_SSE */
 #endif /* BUILD_MMX */
+#ifdef BUILD_SSE2
+   cpu_feature_mask |= CPU_FEATURE_SSE2 *
+     evas_common_cpu_feature_test(evas_common_cpu_sse2_test);
+   if (getenv("EVAS_CPU_NO_SSE2"))
+     cpu_feature_mask &= ~CPU_FEATURE_SSE2;
+#endif /* BUILD_SSE2 */
+#ifdef BUILD_AVX2
+   cpu_feature_mask |= CPU_FEATURE_AVX2 *
+     evas_common_cpu_feature_test(evas_common_cpu_avx2_test);
+   if (getenv("EVAS_CPU_NO_AVX2"))
+     cpu_feature_mask &= ~CPU_FEATURE_AVX2;
+#endif /* BUILD_AVX2 */
 #ifdef __POWERPC__
 #ifdef __VEC__
    cpu_feature_mask |= CPU_FEATURE_ALTIVEC *
@@ -220,6 +255,7 @@ evas_common_cpu_can_do(int *mmx, int *sse, int *sse2)
 	if (cpu_feature_mask & CPU_FEATURE_MMX) do_mmx = 1;
 	if (cpu_feature_mask & CPU_FEATURE_MMX2) do_sse = 1;
 	if (cpu_feature_mask & CPU_FEATURE_SSE) do_sse = 1;
+	if (cpu_feature_mask & CPU_FEATURE_SSE2) do_sse2 = 1;
      }
 //   INF("%i %i %i", do_mmx, do_sse, do_sse2);
    *mmx = do_mmx;
@@ -6,6 +6,62 @@
 #include "evas_convert_main.h"
 #include "evas_private.h"
 
+/* what the cutouts leave visible, as bands down the whole plane, each a
+ * row of spans across. it's built once for a set of cutouts and then cut
+ * down to the clip of each draw, so consecutive draws with the same
+ * cutouts - every object drawn under the same opaque ones - don't redo
+ * the work. building it is at worst bands x cutouts, where splitting the
+ * clip by each cutout in turn grew with every rect the ones before had
+ * split it into. bands with the same spans as the one above are merged
+ * into it */
+#define CUTOUT_REGION_BIG 0x3fffffff
+
+typedef struct _Cutout_Band Cutout_Band;
+
+struct _Cutout_Band
+{
+   int y1, y2;
+   int span, spans_num;
+};
+
+struct _Cutout_Region
+{
+   Cutout_Band *bands;
+   int         *spans; /* x1, x2 pairs, band by band */
+   int          bands_num;
+};
+
+static void
+_evas_common_draw_context_region_free(Cutout_Region *reg)
+{
+   if (!reg) return;
+   free(reg->bands);
+   free(reg->spans);
+   free(reg);
+}
+
+static void
+_evas_common_draw_context_region_dirty(RGBA_Draw_Context *dc)
+{
+   if (dc->cutout_cache.owner != dc) return;
+   _evas_common_draw_context_region_free(dc->cutout_cache.region);
+   dc->cutout_cache.region = NULL;
+}
+
+static int
+_evas_common_draw_context_cutout_x_cmp(const void *a, const void *b)
+{
+   return ((const Cutout_Rect *)a)->x - ((const Cutout_Rect *)b)->x;
+}
+
+static int
+_evas_common_draw_context_int_cmp(const void *a, const void *b)
+{
+   const int *ia = a, *ib = b;
+
+   return (*ia > *ib) - (*ia < *ib);
+}
+
 EAPI Cutout_Rects*
 evas_common_draw_context_cutouts_new(void)
 {
@@ -73,6 +129,7 @@ evas_common_draw_context_new(void)
 
    dc = calloc(1, sizeof(RGBA_Draw_Context));
    dc->sli.h = 1;
+   dc->cutout_cache.owner = dc;
    return dc;
 }
 
@@ -81,6 +138,7 @@ evas_common_draw_context_free(RGBA_Draw_Context *dc)
 {
    if (!dc) return;
 
+   _evas_common_draw_context_region_dirty(dc);
    evas_common_draw_context_apply_clean_cutouts(&dc->cutout);
    free(dc);
 }
@@ -88,6 +146,7 @@ evas_common_draw_context_free(RGBA_Draw_Context *dc)
 EAPI void
 evas_common_draw_context_clear_cutouts(RGBA_Draw_Context *dc)
 {
+   _evas_common_draw_context_region_dirty(dc);
    evas_common_draw_context_apply_clean_cutouts(&dc->cutout);
 }
 
@@ -192,329 +251,233 @@ evas_common_draw_context_add_cutout(RGBA_Draw_Context *dc, int x, int y, int w,
 #endif        
 	if ((w < 1) || (h < 1)) return;
      }
+   _evas_common_draw_context_region_dirty(dc);
    evas_common_draw_context_cutouts_add(&dc->cutout, x, y, w, h);
 }
 
-int
-evas_common_draw_context_cutout_split(Cutout_Rects* res, int index, Cutout_Rect *split)
-{
-   /* 1 input rect, multiple out */
-   Cutout_Rect  in = res->rects[index];
-
-   /* this is to save me a LOT of typing */
-#define INX1 (in.x)
-#define INX2 (in.x + in.w)
-#define SPX1 (split->x)
-#define SPX2 (split->x + split->w)
-#define INY1 (in.y)
-#define INY2 (in.y + in.h)
-#define SPY1 (split->y)
-#define SPY2 (split->y + split->h)
-#define X1_IN (in.x < split->x)
-#define X2_IN ((in.x + in.w) > (split->x + split->w))
-#define Y1_IN (in.y < split->y)
-#define Y2_IN ((in.y + in.h) > (split->y + split->h))
-#define R_NEW(_r, _x, _y, _w, _h) { evas_common_draw_context_cutouts_add(_r, _x, _y, _w, _h); }
-   if (!RECTS_INTERSECT(in.x, in.y, in.w, in.h,
-			split->x, split->y, split->w, split->h))
+/* the region left by cutout - only as far as it's needed inside clip, if
+ * there is one */
+static Cutout_Region *
+_evas_common_draw_context_region_new(const Cutout_Rects *cutout,
+				     const struct RGBA_Draw_Context_clip *clip)
+{
+   Cutout_Region *reg;
+   Cutout_Band *band;
+   Cutout_Rect *cuts;
+   int *ys, *spans;
+   int i, j, k, n, ny, nspans, spans_max, x, y1, y2;
+
+   n = cutout->active;
+   reg = calloc(1, sizeof(Cutout_Region));
+   if (!reg) return NULL;
+   cuts = malloc((n + 1) * sizeof(Cutout_Rect));
+   if (!cuts)
      {
-        /* No colision => no clipping, don't touch it. */
-	return 1;
+	free(reg);
+	return NULL;
      }
 
-   /* S    = split (ie cut out rect) */
-   /* +--+ = in (rect to be cut) */
-
-   /*
-    *  +---+
-    *  |   |
-    *  | S |
-    *  |   |
-    *  +---+
-    *
-    */
-   if (X1_IN && X2_IN && Y1_IN && Y2_IN)
-     {
-        R_NEW(res, in.x, in.y, in.w, SPY1 - in.y);
-	R_NEW(res, in.x, SPY1, SPX1 - in.x, SPY2 - SPY1);
-	R_NEW(res, SPX2, SPY1, INX2 - SPX2, SPY2 - SPY1);
-        /* out => (in.x, SPY2, in.w, INY2 - SPY2) */
-        res->rects[index].h = INY2 - SPY2;
-        res->rects[index].y = SPY2;
-	return 1;
-     }
-   /* SSSSSSS
-    * S+---+S
-    * S|SSS|S
-    * S|SSS|S
-    * S|SSS|S
-    * S+---+S
-    * SSSSSSS
-    */
-   if (!X1_IN && !X2_IN && !Y1_IN && !Y2_IN)
-     {
-        evas_common_draw_context_cutouts_del(res, index);
-	return 0;
-     }
-   /* SSS
-    * S+---+
-    * S|S  |
-    * S|S  |
-    * S|S  |
-    * S+---+
-    * SSS
-    */
-   if (!X1_IN && X2_IN && !Y1_IN && !Y2_IN)
+   if (clip)
      {
-        /* in => (SPX2, in.y, INX2 - SPX2, in.h) */
-        res->rects[index].w = INX2 - SPX2;
-        res->rects[index].x = SPX2;
-	return 1;
+	for (i = 0, j = 0; i < n; i++)
+	  {
+	     if (RECTS_INTERSECT(cutout->rects[i].x, cutout->rects[i].y,
+				 cutout->rects[i].w, cutout->rects[i].h,
+				 clip->x, clip->y, clip->w, clip->h))
+	       cuts[j++] = cutout->rects[i];
+	  }
+	n = j;
      }
-   /*    S
-    *  +---+
-    *  | S |
-    *  | S |
-    *  | S |
-    *  +---+
-    *    S
-    */
-   if (X1_IN && X2_IN && !Y1_IN && !Y2_IN)
-     {
-        R_NEW(res, in.x, in.y, SPX1 - in.x, in.h);
-        /* in => (SPX2, in.y, INX2 - SPX2, in.h) */
-        res->rects[index].w = INX2 - SPX2;
-        res->rects[index].x = SPX2;
-	return 1;
-     }
-   /*     SSS
-    *  +---+S
-    *  |  S|S
-    *  |  S|S
-    *  |  S|S
-    *  +---+S
-    *     SSS
-    */
-   if (X1_IN && !X2_IN && !Y1_IN && !Y2_IN)
-     {
-        /* in => (in.x, in.y, SPX1 - in.x, in.h) */
-        res->rects[index].w = SPX1 - in.x;
-	return 1;
-     }
-   /* SSSSSSS
-    * S+---+S
-    * S|SSS|S
-    *  |   |
-    *  |   |
-    *  +---+
-    *
-    */
-   if (!X1_IN && !X2_IN && !Y1_IN && Y2_IN)
-     {
-        /* in => (in.x, SPY2, in.w, INY2 - SPY2) */
-        res->rects[index].h = INY2 - SPY2;
-        res->rects[index].y = SPY2;
-	return 1;
-     }
-   /*
-    *  +---+
-    *  |   |
-    * S|SSS|S
-    *  |   |
-    *  +---+
-    *
-    */
-   if (!X1_IN && !X2_IN && Y1_IN && Y2_IN)
-     {
-        R_NEW(res, in.x, SPY2, in.w, INY2 - SPY2);
-        /* in => (in.x, in.y, in.w, SPY1 - in.y) */
-        res->rects[index].h = SPY1 - in.y;
-	return 1;
-     }
-   /*
-    *  +---+
-    *  |   |
-    *  |   |
-    * S|SSS|S
-    * S+---+S
-    * SSSSSSS
-    */
-   if (!X1_IN && !X2_IN && Y1_IN && !Y2_IN)
-     {
-        /* in => (in.x, in.y, in.w, SPY1 - in.y) */
-        res->rects[index].h = SPY1 - in.y;
-	return 1;
-     }
-   /* SSS
-    * S+---+
-    * S|S  |
-    *  |   |
-    *  |   |
-    *  +---+
-    *
-    */
-   if (!X1_IN && X2_IN && !Y1_IN && Y2_IN)
-     {
-	R_NEW(res, SPX2, in.y, INX2 - SPX2, SPY2 - in.y);
-        /* in => (in.x, SPY2, in.w, INY2 - SPY2) */
-        res->rects[index].h = INY2 - SPY2;
-        res->rects[index].y = SPY2;
-	return 1;
-     }
-   /*    S
-    *  +---+
-    *  | S |
-    *  |   |
-    *  |   |
-    *  +---+
-    *
-    */
-   if (X1_IN && X2_IN && !Y1_IN && Y2_IN)
-     {
-	R_NEW(res, in.x, in.y, SPX1 - in.x, SPY2 - in.y);
-	R_NEW(res, SPX2, in.y, INX2 - SPX2, SPY2 - in.y);
-        /* in => (in.x, SPY2, in.w, INY2 - SPY2) */
-        res->rects[index].h = INY2 - SPY2;
-        res->rects[index].y = SPY2;
-	return 1;
-     }
-   /*     SSS
-    *  +---+S
-    *  |  S|S
-    *  |   |
-    *  |   |
-    *  +---+
-    *
-    */
-   if (X1_IN && !X2_IN && !Y1_IN && Y2_IN)
-     {
-	R_NEW(res, in.x, in.y, SPX1 - in.x, SPY2 - in.y);
-        /* in => (in.x, SPY2, in.w, INY2 - SPY2) */
-        res->rects[index].h = INY2 - SPY2;
-        res->rects[index].y = SPY2;
-	return 1;
-     }
-   /*
-    *  +---+
-    *  |   |
-    * S|S  |
-    *  |   |
-    *  +---+
-    *
-    */
-   if (!X1_IN && X2_IN && Y1_IN && Y2_IN)
+   else
+     memcpy(cuts, cutout->rects, n * sizeof(Cutout_Rect));
+   ys = malloc(((2 * n) + 1) * sizeof(int));
+   reg->bands = malloc(((2 * n) + 1) * sizeof(Cutout_Band));
+   /* spans grow as bands need them. a band has at most n + 1, but most
+    * have a few */
+   spans_max = 4 * (n + 1);
+   reg->spans = malloc(spans_max * 2 * sizeof(int));
+   if ((!ys) || (!reg->bands) || (!reg->spans))
      {
-	R_NEW(res, in.x, SPY2, in.w, INY2 - SPY2);
-	R_NEW(res, SPX2, SPY1, INX2 - SPX2, SPY2 - SPY1);
-        /* in => (in.x, SPY2, in.w, INY2 - SPY2) */
-        res->rects[index].h = SPY1 - in.y;
-	return 1;
+	free(cuts);
+	free(ys);
+	_evas_common_draw_context_region_free(reg);
+	return NULL;
      }
-   /*
-    *  +---+
-    *  |   |
-    *  |  S|S
-    *  |   |
-    *  +---+
-    *
-    */
-   if (X1_IN && !X2_IN && Y1_IN && Y2_IN)
+   qsort(cuts, n, sizeof(Cutout_Rect), _evas_common_draw_context_cutout_x_cmp);
+   for (i = 0; i < n; i++)
      {
-	R_NEW(res, in.x, SPY2, in.w, INY2 - SPY2);
-	R_NEW(res, in.x, SPY1, SPX1 - in.x, SPY2 - SPY1);
-        /* in => (in.x, in.y, in.w, SPY1 - in.y) */
-        res->rects[index].h = SPY1 - in.y;
-	return 1;
+	ys[(i * 2) + 0] = cuts[i].y;
+	ys[(i * 2) + 1] = cuts[i].y + cuts[i].h;
      }
-   /*
-    *  +---+
-    *  |   |
-    *  |   |
-    * S|S  |
-    * S+---+
-    * SSS
-    */
-   if (!X1_IN && X2_IN && Y1_IN && !Y2_IN)
+   qsort(ys, 2 * n, sizeof(int), _evas_common_draw_context_int_cmp);
+   ny = (n > 0) ? 1 : 0;
+   for (i = 1; i < (2 * n); i++)
+     if (ys[i] != ys[ny - 1]) ys[ny++] = ys[i];
+
+   /* one band from each y edge to the next, plus the open ones above the
+    * first and below the last. cutouts either cover all of a band or
+    * none of it, so a band's spans are what's left between the cutouts
+    * covering it, left to right */
+   nspans = 0;
+   for (k = -1; k < ny; k++)
      {
-        R_NEW(res, SPX2, SPY1, INX2 - SPX2, INY2 - SPY1);
-        /* in => (in.x, in.y, in.w, SPY1 - in.y) */
-        res->rects[index].h = SPY1 - in.y;
-	return 1;
+	y1 = (k < 0) ? -CUTOUT_REGION_BIG : ys[k];
+	y2 = (k == (ny - 1)) ? CUTOUT_REGION_BIG : ys[k + 1];
+	if ((nspans + n + 1) > spans_max)
+	  {
+	     int *tmp;
+
+	     spans_max *= 2;
+	     if (spans_max < (nspans + n + 1)) spans_max = nspans + n + 1;
+	     tmp = realloc(reg->spans, spans_max * 2 * sizeof(int));
+	     if (!tmp)
+	       {
+		  free(cuts);
+		  free(ys);
+		  _evas_common_draw_context_region_free(reg);
+		  return NULL;
+	       }
+	     reg->spans = tmp;
+	  }
+	spans = reg->spans + (nspans * 2);
+	j = 0;
+	x = -CUTOUT_REGION_BIG;
+	if ((k >= 0) && (k < (ny - 1)))
+	  {
+	     for (i = 0; i < n; i++)
+	       {
+		  if ((cuts[i].y > y1) || ((cuts[i].y + cuts[i].h) < y2))
+		    continue;
+		  if (cuts[i].x > x)
+		    {
+		       spans[j++] = x;
+		       spans[j++] = cuts[i].x;
+		    }
+		  if ((cuts[i].x + cuts[i].w) > x) x = cuts[i].x + cuts[i].w;
+	       }
+	  }
+	if (x < CUTOUT_REGION_BIG)
+	  {
+	     spans[j++] = x;
+	     spans[j++] = CUTOUT_REGION_BIG;
+	  }
+	j /= 2;
+	/* the same spans as the band above - make that one taller */
+	if (reg->bands_num > 0)
+	  {
+	     band = reg->bands + reg->bands_num - 1;
+	     if ((band->spans_num == j) &&
+		 (!memcmp(reg->spans + (band->span * 2), spans, j * 2 * sizeof(int))))
+	       {
+		  band->y2 = y2;
+		  continue;
+	       }
+	  }
+	band = reg->bands + reg->bands_num++;
+	band->y1 = y1;
+	band->y2 = y2;
+	band->span = nspans;
+	band->spans_num = j;
+	nspans += j;
      }
-   /*
-    *  +---+
-    *  |   |
-    *  |   |
-    *  | S |
-    *  +---+
-    *    S
-    */
-   if (X1_IN && X2_IN && Y1_IN && !Y2_IN)
+
+   free(cuts);
+   free(ys);
+   return reg;
+}
+
+/* the visible parts of the x, y, w, h rect, as rects, into res */
+static void
+_evas_common_draw_context_region_rects_get(const Cutout_Region *reg, Cutout_Rects *res,
+					   int x, int y, int w, int h)
+{
+   const Cutout_Band *band;
+   const int *spans;
+   int lo, hi, mid, i, y1, y2, x1, x2, first, num, prev_first, prev_num;
+
+   /* first band that ends below y */
+   lo = 0;
+   hi = reg->bands_num - 1;
+   while (lo < hi)
      {
-	R_NEW(res, in.x, SPY1, SPX1 - in.x, INY2 - SPY1);
-        R_NEW(res, SPX2, SPY1, INX2 - SPX2, INY2 - SPY1);
-        /* in => (in.x, in.y, in.w, SPY1 - in.y) */
-        res->rects[index].h = SPY1 - in.y;
-	return 1;
+	mid = (lo + hi) / 2;
+	if (reg->bands[mid].y2 <= y) lo = mid + 1;
+	else hi = mid;
      }
-   /*
-    *  +---+
-    *  |   |
-    *  |   |
-    *  |  S|S
-    *  +---+S
-    *     SSS
-    */
-   if (X1_IN && !X2_IN && Y1_IN && !Y2_IN)
+
+   prev_first = prev_num = 0;
+   for (band = reg->bands + lo;
+	(band < (reg->bands + reg->bands_num)) && (band->y1 < (y + h));
+	band++)
      {
-        R_NEW(res, in.x, SPY1, SPX1 - in.x, INY2 - SPY1);
-        /* in => (in.x, in.y, in.w, SPY1 - in.y) */
-        res->rects[index].h = SPY1 - in.y;
-	return 1;
+	y1 = (band->y1 > y) ? band->y1 : y;
+	y2 = (band->y2 < (y + h)) ? band->y2 : (y + h);
+	first = res->active;
+	spans = reg->spans + (band->span * 2);
+	for (i = 0; i < band->spans_num; i++, spans += 2)
+	  {
+	     x1 = (spans[0] > x) ? spans[0] : x;
+	     x2 = (spans[1] < (x + w)) ? spans[1] : (x + w);
+	     if (x1 < x2)
+	       evas_common_draw_context_cutouts_add(res, x1, y1, x2 - x1, y2 - y1);
+	  }
+	num = res->active - first;
+	/* bands that only differ outside x, w come out the same - make the
+	 * rects above taller instead */
+	if ((num > 0) && (num == prev_num))
+	  {
+	     for (i = 0; i < num; i++)
+	       {
+		  if ((res->rects[prev_first + i].x != res->rects[first + i].x) ||
+		      (res->rects[prev_first + i].w != res->rects[first + i].w))
+		    break;
+	       }
+	     if (i == num)
+	       {
+		  for (i = 0; i < num; i++)
+		    res->rects[prev_first + i].h += y2 - y1;
+		  res->active = first;
+		  continue;
+	       }
+	  }
+	prev_first = first;
+	prev_num = num;
      }
-   evas_common_draw_context_cutouts_del(res, index);
-   return 0;
-#undef INX1
-#undef INX2
-#undef SPX1
-#undef SPX2
-#undef INY1
-#undef INY2
-#undef SPY1
-#undef SPY2
-#undef X1_IN
-#undef X2_IN
-#undef Y1_IN
-#undef Y2_IN
-#undef R_NEW
 }
 
 EAPI Cutout_Rects*
 evas_common_draw_context_apply_cutouts(RGBA_Draw_Context *dc)
 {
+   Cutout_Region       *reg;
    Cutout_Rects*        res;
-   int                  i;
-   int                  j;
 
    if (!dc->clip.use) return NULL;
    if ((dc->clip.w <= 0) || (dc->clip.h <= 0)) return NULL;
 
    res = evas_common_draw_context_cutouts_new();
-   evas_common_draw_context_cutouts_add(res, dc->clip.x, dc->clip.y, dc->clip.w, dc->clip.h);
+   if (dc->cutout.active <= 0)
+     {
+	evas_common_draw_context_cutouts_add(res, dc->clip.x, dc->clip.y, dc->clip.w, dc->clip.h);
+	return res;
+     }
 
-   for (i = 0; i < dc->cutout.active; ++i)
+   /* a copy of the context (the pipe makes them) can't tell if the region
+    * still matches its cutouts, so it builds its own and throws it away */
+   if (dc->cutout_cache.owner == dc)
      {
-        /* Don't loop on the element just added to the list as they are already correctly clipped. */
-        int active = res->active;
-
-        for (j = 0; j < active; )
-          {
-             if (evas_common_draw_context_cutout_split(res, j, dc->cutout.rects + i))
-               ++j;
-             else
-               active--;
-          }
+	if (!dc->cutout_cache.region)
+	  dc->cutout_cache.region = _evas_common_draw_context_region_new(&dc->cutout, NULL);
+	reg = dc->cutout_cache.region;
      }
+   else
+     reg = _evas_common_draw_context_region_new(&dc->cutout, &dc->clip);
+   if (!reg) return res;
+
+   _evas_common_draw_context_region_rects_get(reg, res, dc->clip.x, dc->clip.y,
+					      dc->clip.w, dc->clip.h);
+
+   if (reg != dc->cutout_cache.region)
+     _evas_common_draw_context_region_free(reg);
    return res;
 }
 
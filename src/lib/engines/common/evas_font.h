@@ -28,6 +28,19 @@ EAPI int               evas_common_font_utf8_get_len         (const unsigned cha
 EAPI void              evas_common_font_draw                 (RGBA_Image *dst, RGBA_Draw_Context *dc, RGBA_Font *fn, int x, int y, const char *text);
 EAPI int               evas_common_font_glyph_search         (RGBA_Font *fn, RGBA_Font_Int **fi_ret, int gl);
 EAPI RGBA_Font_Glyph  *evas_common_font_int_cache_glyph_get  (RGBA_Font_Int *fi, FT_UInt index);
+EAPI void              evas_common_font_int_glyphs_retire    (RGBA_Font_Int *fi);
+EAPI void              evas_common_font_glyph_retired_flush  (void);
+
+/* run */
+
+typedef struct _Font_Run Font_Run;
+
+EAPI void              evas_common_font_run_cache_init       (void);
+EAPI void              evas_common_font_run_cache_shutdown   (void);
+EAPI void              evas_common_font_run_cache_flush      (RGBA_Font *fn);
+EAPI Font_Run         *evas_common_font_run_get              (RGBA_Font *fn, const char *text);
+EAPI void              evas_common_font_run_release          (Font_Run *run);
+EAPI void              evas_common_font_run_draw             (Font_Run *run, RGBA_Image *dst, RGBA_Draw_Context *dc, RGBA_Gfx_Func func, int x, int y, int ext_x, int ext_y, int ext_w, int ext_h);
 
 /* load */
 EAPI void              evas_common_font_dpi_set              (int dpi);
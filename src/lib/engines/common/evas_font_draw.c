@@ -9,45 +9,6 @@
 #include "evas_intl_utils.h" /*defines INTERNATIONAL_SUPPORT if possible */
 #include "evas_font_private.h" /* for Frame-Queuing support */
 
-#define WORD_CACHE_MAXLEN	50
-/* How many to cache */
-#define WORD_CACHE_NWORDS	20
-
-struct prword {
-	EINA_INLIST;
-	/* FIXME: Need to save font/size et al */
-	int size;
-	struct cinfo *cinfo;
-	RGBA_Font *font;
-	const char *str;
-	int len;
-	DATA8 *im;
-	int roww;
-	int width;
-	int height;
-	int baseline;
-};
-
-struct cinfo {
-	int gl;
-	FT_UInt index;
-	struct { int x, y; } pos;
-	int posx;
-	char chr;
-	RGBA_Font_Glyph *fg;
-	struct {
-		int w,h;
-		int rows;
-		unsigned char *data;
-	} bm;
-};
-
-
-
-
-static Eina_Inlist *words = NULL;
-static struct prword *evas_font_word_prerender(RGBA_Draw_Context *dc, const char *text, int len, RGBA_Font *fn, RGBA_Font_Int *fi,int use_kerning);
-
 #ifdef EVAS_FRAME_QUEUING
 EAPI void
 evas_common_font_draw_init(void)
@@ -102,7 +63,13 @@ _fash_int_add(Fash_Int *fash, int item, RGBA_Font_Int *fint, int index)
    maj = (item >> 8) & 0xff;
    min = item & 0xff;
    if (!fash->bucket[maj])
-     fash->bucket[maj] = calloc(1, sizeof(Fash_Int_Map));
+     {
+        Fash_Int_Map *fmap = calloc(1, sizeof(Fash_Int_Map));
+        
+        if (!fmap) return;
+        FASH_PUBLISH();
+        fash->bucket[maj] = fmap;
+     }
    fash->bucket[maj]->item[min].fint = fint;
    fash->bucket[maj]->item[min].index = index;
 }
@@ -124,6 +91,7 @@ static Fash_Glyph *
 _fash_gl_new(void)
 {
    Fash_Glyph *fash = calloc(1, sizeof(Fash_Glyph));
+   if (!fash) return NULL;
    fash->freeme = _fash_gl_free;
    return fash;
 }
@@ -149,20 +117,147 @@ _fash_gl_add(Fash_Glyph *fash, int item, RGBA_Font_Glyph *glyph)
    maj = (item >> 8) & 0xff;
    min = item & 0xff;
    if (!fash->bucket[maj])
-     fash->bucket[maj] = calloc(1, sizeof(Fash_Int_Map));
+     {
+        Fash_Glyph_Map *fmap = calloc(1, sizeof(Fash_Glyph_Map));
+        
+        if (!fmap) return;
+        FASH_PUBLISH();
+        fash->bucket[maj] = fmap;
+     }
+   FASH_PUBLISH();
    fash->bucket[maj]->item[min] = glyph;
 }
 
+/* glyph arenas. every glyph of a font int lives in one of its slabs,
+ * together with a copy of its bitmap, so glyphs drawn together sit close
+ * in memory and the whole cache goes with a single walk of the slab list.
+ * call with fi->src->glyph_lock held */
+#define GLYPH_ARENA_SIZE 16384
+#define GLYPH_ARENA_ALIGN(x) (((x) + 15) & ~15)
+
+static void *
+_glyph_arena_alloc(RGBA_Font_Int *fi, int size)
+{
+   Font_Glyph_Arena *ar;
+   int head = GLYPH_ARENA_ALIGN(sizeof(Font_Glyph_Arena));
+   void *p;
 
+   size = GLYPH_ARENA_ALIGN(size);
+   ar = fi->arena;
+   if ((ar) && ((ar->used + size) <= ar->size))
+     {
+        p = ((unsigned char *)ar) + ar->used;
+        ar->used += size;
+        return p;
+     }
+   if (size > (GLYPH_ARENA_SIZE / 4))
+     {
+        /* big glyphs get a slab of their own behind the current one so
+         * its free space is not wasted */
+        ar = malloc(head + size);
+        if (!ar) return NULL;
+        ar->size = ar->used = head + size;
+        if (fi->arena)
+          {
+             ar->next = fi->arena->next;
+             fi->arena->next = ar;
+          }
+        else
+          {
+             ar->next = NULL;
+             fi->arena = ar;
+          }
+        return ((unsigned char *)ar) + head;
+     }
+   ar = malloc(GLYPH_ARENA_SIZE);
+   if (!ar) return NULL;
+   ar->size = GLYPH_ARENA_SIZE;
+   ar->used = head + size;
+   ar->next = fi->arena;
+   fi->arena = ar;
+   return ((unsigned char *)ar) + head;
+}
 
+static void
+_glyph_arena_list_free(Font_Glyph_Arena *ar)
+{
+   while (ar)
+     {
+        Font_Glyph_Arena *next = ar->next;
 
+        free(ar);
+        ar = next;
+     }
+}
 
+/* glyphs are looked up without a lock, so a thread may still be drawing
+ * from the fash and arenas of a font int that just got cleared. they are
+ * put aside here and only freed by the next font flush. main thread only */
+typedef struct _Font_Glyph_Retired Font_Glyph_Retired;
+struct _Font_Glyph_Retired
+{
+   Font_Glyph_Retired *next;
+   Fash_Glyph *fash;
+   Font_Glyph_Arena *arena;
+};
+
+static Font_Glyph_Retired *glyphs_retired = NULL;
+
+/* call with fi->src->glyph_lock held */
+EAPI void
+evas_common_font_int_glyphs_retire(RGBA_Font_Int *fi)
+{
+   Font_Glyph_Retired *gr;
+
+   gr = malloc(sizeof(Font_Glyph_Retired));
+   if (!gr)
+     {
+        /* nowhere to park them - better a late reader than a leak */
+        if (fi->fash) fi->fash->freeme(fi->fash);
+        fi->fash = NULL;
+        _glyph_arena_list_free(fi->arena);
+        fi->arena = NULL;
+        return;
+     }
+   gr->fash = fi->fash;
+   gr->arena = fi->arena;
+   fi->fash = NULL;
+   fi->arena = NULL;
+   FASH_PUBLISH();
+   gr->next = glyphs_retired;
+   glyphs_retired = gr;
+}
+
+EAPI void
+evas_common_font_glyph_retired_flush(void)
+{
+   while (glyphs_retired)
+     {
+        Font_Glyph_Retired *gr = glyphs_retired;
+
+        glyphs_retired = gr->next;
+        if (gr->fash) gr->fash->freeme(gr->fash);
+        _glyph_arena_list_free(gr->arena);
+        free(gr);
+     }
+}
+
+
+
+
+
+/* looking up a glyph that is already cached takes no lock at all. only a
+ * miss takes the lock of the font source, as freetype can only render one
+ * glyph of a face at a time, and renders it into the font int's arena */
 EAPI RGBA_Font_Glyph *
 evas_common_font_int_cache_glyph_get(RGBA_Font_Int *fi, FT_UInt index)
 {
    RGBA_Font_Glyph *fg;
+   FT_Glyph glyph;
+   FT_BitmapGlyph bg;
    FT_UInt hindex;
    FT_Error error;
+   int pitch, bsize;
    const FT_Int32 hintflags[3] =
      { FT_LOAD_NO_HINTING, FT_LOAD_FORCE_AUTOHINT, FT_LOAD_NO_AUTOHINT };
 
@@ -172,63 +267,90 @@ evas_common_font_int_cache_glyph_get(RGBA_Font_Int *fi, FT_UInt index)
         if (fg == (void *)(-1)) return NULL;
         else if (fg) return fg;
      }
-   
+
    hindex = index + (fi->hinting * 500000000);
-   
-//   fg = eina_hash_find(fi->glyphs, &hindex);
-//   if (fg) return fg;
 
-   FTLOCK();
-//   error = FT_Load_Glyph(fi->src->ft.face, index, FT_LOAD_NO_BITMAP);
-   error = FT_Load_Glyph(fi->src->ft.face, index,
-			 FT_LOAD_RENDER | hintflags[fi->hinting]);
-   FTUNLOCK();
-   if (error)
+   LKL(fi->src->glyph_lock);
+   /* someone else may have rendered it while we waited */
+   if (fi->fash)
      {
-        if (!fi->fash) fi->fash = _fash_gl_new();
-        if (fi->fash) _fash_gl_add(fi->fash, index, (void *)(-1));
-        return NULL;
+        fg = _fash_gl_find(fi->fash, index);
+        if (fg)
+          {
+             LKU(fi->src->glyph_lock);
+             if (fg == (void *)(-1)) return NULL;
+             return fg;
+          }
      }
+   if (!fi->fash)
+     {
+        Fash_Glyph *fash = _fash_gl_new();
 
-   fg = malloc(sizeof(struct _RGBA_Font_Glyph));
-   if (!fg) return NULL;
-   memset(fg, 0, (sizeof(struct _RGBA_Font_Glyph)));
-
-   FTLOCK();
-   error = FT_Get_Glyph(fi->src->ft.face->glyph, &(fg->glyph));
-   FTUNLOCK();
-   if (error)
+        if (!fash)
+          {
+             LKU(fi->src->glyph_lock);
+             return NULL;
+          }
+        /* lookups read fi->fash without the lock */
+        FASH_PUBLISH();
+        fi->fash = fash;
+     }
+   if (fi->src->current_size != fi->size)
      {
-	free(fg);
-        if (!fi->fash) fi->fash = _fash_gl_new();
-        if (fi->fash) _fash_gl_add(fi->fash, index, (void *)(-1));
-	return NULL;
+        FT_Activate_Size(fi->ft.size);
+        fi->src->current_size = fi->size;
      }
-   if (fg->glyph->format != FT_GLYPH_FORMAT_BITMAP)
+
+   error = FT_Load_Glyph(fi->src->ft.face, index,
+			 FT_LOAD_RENDER | hintflags[fi->hinting]);
+   if (!error)
+     error = FT_Get_Glyph(fi->src->ft.face->glyph, &glyph);
+   if (error) goto error;
+   if (glyph->format != FT_GLYPH_FORMAT_BITMAP)
      {
-        FTLOCK();
-	error = FT_Glyph_To_Bitmap(&(fg->glyph), FT_RENDER_MODE_NORMAL, 0, 1);
+	error = FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, 0, 1);
 	if (error)
 	  {
-	     FT_Done_Glyph(fg->glyph);
-        FTUNLOCK();
-	     free(fg);
-             if (!fi->fash) fi->fash = _fash_gl_new();
-             if (fi->fash) _fash_gl_add(fi->fash, index, (void *)(-1));
-	     return NULL;
+	     FT_Done_Glyph(glyph);
+	     goto error;
 	  }
-   FTUNLOCK();
      }
-   fg->glyph_out = (FT_BitmapGlyph)fg->glyph;
+   bg = (FT_BitmapGlyph)glyph;
+   pitch = bg->bitmap.pitch;
+   if (pitch < 0) pitch = -pitch;
+   bsize = pitch * bg->bitmap.rows;
+
+   /* the glyph, its bitmap glyph record and the bitmap itself go into the
+    * arena in one piece. freetype's copy is not kept */
+   fg = _glyph_arena_alloc(fi, GLYPH_ARENA_ALIGN(sizeof(RGBA_Font_Glyph)) +
+                           GLYPH_ARENA_ALIGN(sizeof(FT_BitmapGlyphRec)) +
+                           bsize);
+   if (!fg)
+     {
+        FT_Done_Glyph(glyph);
+        LKU(fi->src->glyph_lock);
+        return NULL;
+     }
+   memset(fg, 0, sizeof(RGBA_Font_Glyph));
+   fg->glyph_out = (FT_BitmapGlyph)(((unsigned char *)fg) +
+                                    GLYPH_ARENA_ALIGN(sizeof(RGBA_Font_Glyph)));
+   *(fg->glyph_out) = *bg;
+   fg->glyph_out->bitmap.buffer = ((unsigned char *)fg->glyph_out) +
+     GLYPH_ARENA_ALIGN(sizeof(FT_BitmapGlyphRec));
+   if (bsize > 0) memcpy(fg->glyph_out->bitmap.buffer, bg->bitmap.buffer, bsize);
+   FT_Done_Glyph(glyph);
+   fg->glyph = (FT_Glyph)fg->glyph_out;
    fg->index = hindex;
-
    fg->fi = fi;
-  
-   if (!fi->fash) fi->fash = _fash_gl_new();
-   if (fi->fash) _fash_gl_add(fi->fash, index, fg);
-   
-//   eina_hash_direct_add(fi->glyphs, &fg->index, fg);
+
+   _fash_gl_add(fi->fash, index, fg);
+   LKU(fi->src->glyph_lock);
    return fg;
+
+error:
+   _fash_gl_add(fi->fash, index, (void *)(-1));
+   LKU(fi->src->glyph_lock);
+   return NULL;
 }
 
 typedef struct _Font_Char_Index Font_Char_Index;
@@ -408,76 +530,6 @@ evas_common_font_draw_internal(RGBA_Image *dst, RGBA_Draw_Context *dc, RGBA_Font
    
 #endif
 
-#if defined(METRIC_CACHE) || defined(WORD_CACHE)
-   /* A fast strNlen would be nice (there is a wcsnlen strangely) */
-   for (len = 0 ; text[len] && len < WORD_CACHE_MAXLEN ; len ++)
-     ;
-
-
-   if (len < WORD_CACHE_MAXLEN){
-     struct prword *word = evas_font_word_prerender(dc, text, len, fn, fi,
-	   use_kerning);
-     if (word){
-	  int j,rowstart,rowend,xstart,xrun;
-	  im = dst->image.data;
-	  xrun = word->width;
-	  y -= word->baseline;
-	  xstart = 0;
-	  rowstart = 0;
-	  rowend = word->height;
-	  /* Clip to extent */
-	  if (x + xrun > ext_x + ext_w){
-	       xrun -= x + xrun - ext_x - ext_w;
-	  }
-	  if (x < ext_x) {
-	       int excess = ext_x - x;
-	       xstart = excess - 1;
-	       xrun -= excess;
-	       x = ext_x;
-	  }
-	  if (y + rowend > ext_y + ext_h){
-	      rowend -= (y - ext_y + rowend - ext_h);
-	  }
-	  if (y < ext_y){
-	      int excess = ext_y - y;
-	      rowstart += excess;
-	      //rowend -= excess;
-	//      y = ext_y;
-	  }
-
-#ifdef WORD_CACHE
-	  for (j = rowstart ; j < rowend ; j ++){
-	       func(NULL, word->im + (word->roww * j) + xstart, dc->col.col,
-		     im + ((y + j) * im_w) + x, xrun);
-	  }
-#elif defined(METRIC_CACHE)
-	  int ind;
-	  y += word->baseline;
-	  for (ind = 0 ; ind < len ; ind ++){
-	     // FIXME Do we need to draw?
-	     struct cinfo *ci = word->cinfo + ind;
-		 if ((ci->fg->ext_dat) && (dc->font_ext.func.gl_draw))
-			   {
-			      /* ext glyph draw */
-			      dc->font_ext.func.gl_draw(dc->font_ext.data,
-				    (void *)dst,
-				    dc, ci->fg,
-				    x + ci->pos.x,
-				    y - ci->bm.h
-				    );
-			   }
-	        else {
-		     func(NULL, word->im + (word->roww * j) + xstart, dc->col.col, im + ((y + j) * im_w) + x, xrun);
-	}
-	  }
-#endif
-	  return;
-     }
-
-}
-#endif
-
-
    pen_x = x;
    pen_y = y;
    prev_index = 0;
@@ -493,18 +545,20 @@ evas_common_font_draw_internal(RGBA_Image *dst, RGBA_Draw_Context *dc, RGBA_Font
 
 	if (gl == 0) break;
 	index = evas_common_font_glyph_search(fn, &fi, gl);
-	LKL(fi->ft_mutex);
-        if (fi->src->current_size != fi->size)
-          {
-             FT_Activate_Size(fi->ft.size);
-             fi->src->current_size = fi->size;
-          }
 	/* hmmm kerning means i can't sanely do my own cached metric tables! */
 	/* grrr - this means font face sharing is kinda... not an option if */
 	/* you want performance */
 	  if ((use_kerning) && (prev_index) && (index) &&
 	     (pface == fi->src->ft.face))
 	    {
+	       LKL(fi->ft_mutex);
+	       /* the face is shared with the glyph renderer of every size */
+	       LKL(fi->src->glyph_lock);
+	       if (fi->src->current_size != fi->size)
+		 {
+		    FT_Activate_Size(fi->ft.size);
+		    fi->src->current_size = fi->size;
+		 }
 #ifdef INTERNATIONAL_SUPPORT
 	       /* if it's rtl, the kerning matching should be reversed, i.e prev
 		* index is now the index and the other way around. */
@@ -520,11 +574,13 @@ evas_common_font_draw_internal(RGBA_Image *dst, RGBA_Draw_Context *dc, RGBA_Font
 		    if (evas_common_font_query_kerning(fi, prev_index, index, &kern))
 		      pen_x += kern;
 		 }
+	       LKU(fi->src->glyph_lock);
+	       LKU(fi->ft_mutex);
 	    }
 
 	  pface = fi->src->ft.face;
+	  /* glyphs already cached are found without taking any lock */
 	  fg = evas_common_font_int_cache_glyph_get(fi, index);
-	  LKU(fi->ft_mutex);
 	  if (!fg) continue;
 
 	  if (dc->font_ext.func.gl_new)
@@ -683,6 +739,7 @@ evas_common_font_draw(RGBA_Image *dst, RGBA_Draw_Context *dc, RGBA_Font *fn, int
    int use_kerning;
    RGBA_Gfx_Func func;
    RGBA_Font_Int *fi;
+   Font_Run *run = NULL;
    Cutout_Rects *rects;
    Cutout_Rect  *r;
    int          c, cx, cy, cw, ch;
@@ -724,13 +781,20 @@ evas_common_font_draw(RGBA_Image *dst, RGBA_Draw_Context *dc, RGBA_Font *fn, int
 //   evas_common_font_size_use(fn);
    use_kerning = FT_HAS_KERNING(fi->src->ft.face);
    func = evas_common_gfx_func_composite_mask_color_span_get(dc->col.col, dst, 1, dc->render_op);
+   /* engines that draw glyphs themselves need them one by one */
+   if (!dc->font_ext.func.gl_new)
+     run = evas_common_font_run_get(fn, text);
 
    if (!dc->cutout.rects)
      {
-        evas_common_font_draw_internal(dst, dc, fn, x, y, text,
-                                       func, ext_x, ext_y, ext_w, ext_h, fi,
-                                       im_w, im_h, use_kerning
-                                       );
+        if (run)
+          evas_common_font_run_draw(run, dst, dc, func, x, y,
+                                    ext_x, ext_y, ext_w, ext_h);
+        else
+          evas_common_font_draw_internal(dst, dc, fn, x, y, text,
+                                         func, ext_x, ext_y, ext_w, ext_h, fi,
+                                         im_w, im_h, use_kerning
+                                         );
      }
    else
      {
@@ -744,15 +808,20 @@ evas_common_font_draw(RGBA_Image *dst, RGBA_Draw_Context *dc, RGBA_Font *fn, int
                {
                   r = rects->rects + i;
                   evas_common_draw_context_set_clip(dc, r->x, r->y, r->w, r->h);
-                  evas_common_font_draw_internal(dst, dc, fn, x, y, text,
-                                                 func, r->x, r->y, r->w, r->h, fi,
-                                                 im_w, im_h, use_kerning
-                                                 );
+                  if (run)
+                    evas_common_font_run_draw(run, dst, dc, func, x, y,
+                                              r->x, r->y, r->w, r->h);
+                  else
+                    evas_common_font_draw_internal(dst, dc, fn, x, y, text,
+                                                   func, r->x, r->y, r->w, r->h, fi,
+                                                   im_w, im_h, use_kerning
+                                                   );
                }
              evas_common_draw_context_apply_clear_cutouts(rects);
           }
         dc->clip.use = c; dc->clip.x = cx; dc->clip.y = cy; dc->clip.w = cw; dc->clip.h = ch;
      }
+   if (run) evas_common_font_run_release(run);
 #ifndef EVAS_FRAME_QUEUING
    LKU(fn->lock);
 #endif
@@ -760,121 +829,3 @@ evas_common_font_draw(RGBA_Image *dst, RGBA_Draw_Context *dc, RGBA_Font *fn, int
 
 
 
-struct prword *
-evas_font_word_prerender(RGBA_Draw_Context *dc, const char *text, int len, RGBA_Font *fn, RGBA_Font_Int *fi,int use_kerning){
-   int pen_x, pen_y;
-   struct cinfo *metrics;
-   int chr;
-   FT_Face pface = NULL;
-   FT_UInt prev_index;
-   unsigned char *im;
-   int width;
-   int height, above, below, baseline, descent;
-   int c;
-   int i,j;
-   int char_index = 0; /* the index of the current char */
-   struct prword *w;
-   int gl;
-
-   EINA_INLIST_FOREACH(words,w){
-	if (w->len == len && w->font == fn && fi->size == w->size &&
-	      (w->str == text || strcmp(w->str, text) == 0)){
-	  words = eina_inlist_promote(words, EINA_INLIST_GET(w));
-	  return w;
-	}
-   }
-
-   gl = dc->font_ext.func.gl_new ? 1: 0;
-
-   pen_x = pen_y = 0;
-   above = 0; below = 0; baseline = 0; height = 0; descent = 0;
-   metrics = malloc(sizeof(struct cinfo) * len);
-   /* First pass: Work out how big */
-   for (char_index = 0, c = 0, chr = 0 ; text[chr] ; char_index ++){
-	struct cinfo *ci = metrics + char_index;
-	ci->chr = text[chr];
-	ci->gl = evas_common_font_utf8_get_next((unsigned char *)text, &chr);
-	if (ci->gl == 0) break;
-	ci->index = evas_common_font_glyph_search(fn, &fi, ci->gl);
-	if (fi->src->current_size != fi->size)
-	  {
-	     FT_Activate_Size(fi->ft.size);
-             fi->src->current_size = fi->size;
-          }
-	if (use_kerning && char_index && (pface == fi->src->ft.face))
-	  {
-	     int kern;
-	     if (evas_common_font_query_kerning(fi, prev_index,ci->index,&kern))
-		 ci->pos.x += kern;
-	  }
-       pface = fi->src->ft.face;
-       ci->fg = evas_common_font_int_cache_glyph_get(fi, ci->index);
-       if (!ci->fg) continue;
-       if (gl){
-	    ci->fg->ext_dat =dc->font_ext.func.gl_new(dc->font_ext.data,ci->fg);
-	    ci->fg->ext_dat_free = dc->font_ext.func.gl_free;
-       }
-       ci->bm.data = ci->fg->glyph_out->bitmap.buffer;
-       ci->bm.w = MAX(ci->fg->glyph_out->bitmap.pitch,
-		      ci->fg->glyph_out->bitmap.width);
-       ci->bm.rows = ci->fg->glyph_out->bitmap.rows;
-       ci->bm.h = ci->fg->glyph_out->top;
-       above = ci->bm.rows - (ci->bm.rows - ci->bm.h);
-       below = ci->bm.rows - ci->bm.h;
-       if (below > descent) descent = below;
-       if (above > baseline) baseline = above;
-       ci->pos.x = pen_x + ci->fg->glyph_out->left;
-       ci->pos.y = pen_y + ci->fg->glyph_out->top;
-       pen_x += ci->fg->glyph->advance.x >> 16;
-       prev_index = ci->index;
-  }
-
-  /* First loop done */
-  width = pen_x;
-  width = (width & 0x7) ? width + (8 - (width & 0x7)) : width;
-
-  height = baseline + descent;
-  if (!gl){
-     im = calloc(height, width);
-     for (i = 0 ; i  < char_index ; i ++){
-	  struct cinfo *ci = metrics + i;
-	  for (j = 0 ; j < ci->bm.rows ; j ++){
-	    memcpy(im + ci->pos.x + (j + baseline - ci->bm.h) * width, ci->bm.data + j * ci->bm.w, ci->bm.w);
-	  }
-
-     }
-  } else {
-       im = NULL;
-  }
-   /* Save it */
-   struct prword *save;
-
-
-   save = malloc(sizeof(struct prword));
-   save->cinfo = metrics;
-   save->str = eina_stringshare_add(text);
-   save->font = fn;
-   save->size = fi->size;
-   save->len = len;
-   save->im = im;
-   save->width = pen_x;
-   save->roww = width;
-   save->height = height;
-   save->baseline = baseline;
-   words = eina_inlist_prepend(words, EINA_INLIST_GET(save));
-
-   /* Clean up if too long */
-   if (0 && eina_inlist_count(words) > 20){
-	struct prword *last = (struct prword *)(words->last);
-	if (last->im) free(last->im);
-	if (last->cinfo) free(last->cinfo);
-	eina_stringshare_del(last->str);
-	words = eina_inlist_remove(words,EINA_INLIST_GET(last));
-	free(last);
-   }
-
-   return save;
-}
-
-
-
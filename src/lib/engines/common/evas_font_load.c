@@ -50,6 +50,7 @@ _evas_common_font_source_free(RGBA_Font_Source *fs)
    FTLOCK();
    FT_Done_Face(fs->ft.face);
    FTUNLOCK();
+   LKD(fs->glyph_lock);
 #if 0 /* FIXME: Disable as it is only used by dead code using deprecated datatype. */
 //   if (fs->charmap) evas_array_hash_free(fs->charmap);
 #endif
@@ -151,6 +152,7 @@ evas_common_font_source_memory_load(const char *name, const void *data, int data
 	free(fs);
 	return NULL;
      }
+   LKI(fs->glyph_lock);
    fs->name = eina_stringshare_add(name);
    fs->file = NULL;
    FTLOCK();
@@ -181,6 +183,7 @@ evas_common_font_source_load(const char *name)
    fs->file = fs->name;
 
    fs->ft.orig_upem = 0;
+   LKI(fs->glyph_lock);
 
    fs->references = 1;
 
@@ -248,6 +251,7 @@ evas_common_font_size_use(RGBA_Font *fn)
 
    EINA_LIST_FOREACH(fn->fonts, l, fi)
      {
+	LKL(fi->src->glyph_lock);
 	if (fi->src->current_size != fi->size)
 	  {
         FTLOCK();
@@ -255,6 +259,7 @@ evas_common_font_size_use(RGBA_Font *fn)
         FTUNLOCK();
 	     fi->src->current_size = fi->size;
 	  }
+	LKU(fi->src->glyph_lock);
      }
 }
 
@@ -551,6 +556,8 @@ evas_common_font_add(RGBA_Font *fn, const char *name, int size)
      {
 	fn->fonts = eina_list_append(fn->fonts, fi);
 	fi->hinting = fn->hinting;
+	/* glyphs missing so far may come from the new font */
+	evas_common_font_run_cache_flush(fn);
 	return fn;
      }
    return NULL;
@@ -568,6 +575,8 @@ evas_common_font_memory_add(RGBA_Font *fn, const char *name, int size, const voi
      {
 	fn->fonts = eina_list_append(fn->fonts, fi);
 	fi->hinting = fn->hinting;
+	/* glyphs missing so far may come from the new font */
+	evas_common_font_run_cache_flush(fn);
 	return fn;
      }
    return NULL;
@@ -605,6 +614,7 @@ evas_common_font_free(RGBA_Font *fn)
 	  }
      }
    evas_common_font_flush();
+   evas_common_font_run_cache_flush(fn);
    eina_list_free(fn->fonts);
    if (fn->fash) fn->fash->freeme(fn->fash);
    LKD(fn->lock);
@@ -715,6 +725,7 @@ _evas_common_font_int_clear(RGBA_Font_Int *fi)
    
    evas_common_font_int_modify_cache_by(fi, -1);
    
+   LKL(fi->src->glyph_lock);
    for (j = 0; j <= 0xff; j++) // fixme: to do > 65k
      {
         Fash_Glyph_Map *fmap = fi->fash->bucket[j];
@@ -725,17 +736,16 @@ _evas_common_font_int_clear(RGBA_Font_Int *fi)
                   RGBA_Font_Glyph *fg = fmap->item[i];
                   if ((fg) && (fg != (void *)(-1)))
                     {
-                       FT_Done_Glyph(fg->glyph);
                        /* extension calls */
                        if (fg->ext_dat_free) fg->ext_dat_free(fg->ext_dat);
-                       free(fg);
                        fmap->item[i] = NULL;
                     }
                }
           }
      }
-   fi->fash->freeme(fi->fash);
-   fi->fash = NULL;
+   /* the fash and the arenas the glyphs live in go at the next flush */
+   evas_common_font_int_glyphs_retire(fi);
+   LKU(fi->src->glyph_lock);
    LKU(fi->ft_mutex);
 }
 
@@ -750,6 +760,7 @@ _evas_common_font_all_clear_cb(const Eina_Hash *hash, const void *key, void *dat
 EAPI void
 evas_common_font_all_clear(void)
 {
+   evas_common_font_run_cache_flush(NULL);
    eina_hash_foreach(fonts, _evas_common_font_all_clear_cb, NULL);
 }
 
@@ -822,6 +833,7 @@ evas_common_font_cache_set(int size)
 EAPI void
 evas_common_font_flush(void)
 {
+   evas_common_font_glyph_retired_flush();
    if (font_cache_usage < font_cache) return;
    while (font_cache_usage > font_cache)
      {
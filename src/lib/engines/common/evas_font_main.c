@@ -20,6 +20,7 @@ evas_common_font_init(void)
    error = FT_Init_FreeType(&evas_ft_lib);
    if (error) return;
    evas_common_font_load_init();
+   evas_common_font_run_cache_init();
 #ifdef EVAS_FRAME_QUEUING
    evas_common_font_draw_init();
 #endif
@@ -39,9 +40,11 @@ evas_common_font_shutdown(void)
    LKD(lock_font_draw);
    LKD(lock_fribidi);
    
+   evas_common_font_run_cache_shutdown();
    evas_common_font_load_shutdown();
    evas_common_font_cache_set(0);
    evas_common_font_flush();
+   evas_common_font_glyph_retired_flush();
 
    error = FT_Done_FreeType(evas_ft_lib);
 #ifdef EVAS_FRAME_QUEUING
@@ -86,6 +89,8 @@ evas_common_font_ascent_get(RGBA_Font *fn)
      }
 #endif
    fi = fn->fonts->data;
+   /* the size metrics are those of whichever size is active on the face */
+   LKL(fi->src->glyph_lock);
    if (fi->src->current_size != fi->size)
      {
         FT_Activate_Size(fi->ft.size);
@@ -96,6 +101,7 @@ evas_common_font_ascent_get(RGBA_Font *fn)
         printf("NOT SCALABLE!\n");
      }
    val = (int)fi->src->ft.face->size->metrics.ascender;
+   LKU(fi->src->glyph_lock);
    return val >> 6;
 //   printf("%i | %i\n", val, val >> 6);
 //   if (fi->src->ft.face->units_per_EM == 0)
@@ -114,12 +120,14 @@ evas_common_font_descent_get(RGBA_Font *fn)
 
 //   evas_common_font_size_use(fn);
    fi = fn->fonts->data;
+   LKL(fi->src->glyph_lock);
    if (fi->src->current_size != fi->size)
      {
         FT_Activate_Size(fi->ft.size);
         fi->src->current_size = fi->size;
      }
    val = -(int)fi->src->ft.face->size->metrics.descender;
+   LKU(fi->src->glyph_lock);
    return val >> 6;
 //   if (fi->src->ft.face->units_per_EM == 0)
 //     return val;
@@ -137,6 +145,7 @@ evas_common_font_max_ascent_get(RGBA_Font *fn)
 
 //   evas_common_font_size_use(fn);
    fi = fn->fonts->data;
+   LKL(fi->src->glyph_lock);
    if (fi->src->current_size != fi->size)
      {
         FT_Activate_Size(fi->ft.size);
@@ -144,9 +153,13 @@ evas_common_font_max_ascent_get(RGBA_Font *fn)
      }
    val = (int)fi->src->ft.face->bbox.yMax;
    if (fi->src->ft.face->units_per_EM == 0)
-     return val;
+     {
+        LKU(fi->src->glyph_lock);
+        return val;
+     }
    dv = (fi->src->ft.orig_upem * 2048) / fi->src->ft.face->units_per_EM;
    ret = (val * fi->src->ft.face->size->metrics.y_scale) / (dv * dv);
+   LKU(fi->src->glyph_lock);
    return ret;
 }
 
@@ -159,6 +172,7 @@ evas_common_font_max_descent_get(RGBA_Font *fn)
 
 //   evas_common_font_size_use(fn);
    fi = fn->fonts->data;
+   LKL(fi->src->glyph_lock);
    if (fi->src->current_size != fi->size)
      {
         FT_Activate_Size(fi->ft.size);
@@ -166,9 +180,13 @@ evas_common_font_max_descent_get(RGBA_Font *fn)
      }
    val = -(int)fi->src->ft.face->bbox.yMin;
    if (fi->src->ft.face->units_per_EM == 0)
-     return val;
+     {
+        LKU(fi->src->glyph_lock);
+        return val;
+     }
    dv = (fi->src->ft.orig_upem * 2048) / fi->src->ft.face->units_per_EM;
    ret = (val * fi->src->ft.face->size->metrics.y_scale) / (dv * dv);
+   LKU(fi->src->glyph_lock);
    return ret;
 }
 
@@ -181,6 +199,7 @@ evas_common_font_get_line_advance(RGBA_Font *fn)
 
 //   evas_common_font_size_use(fn);
    fi = fn->fonts->data;
+   LKL(fi->src->glyph_lock);
    if (fi->src->current_size != fi->size)
      {
         FT_Activate_Size(fi->ft.size);
@@ -188,7 +207,11 @@ evas_common_font_get_line_advance(RGBA_Font *fn)
      }
    val = (int)fi->src->ft.face->size->metrics.height;
    if (fi->src->ft.face->units_per_EM == 0)
-     return val;
+     {
+        LKU(fi->src->glyph_lock);
+        return val;
+     }
+   LKU(fi->src->glyph_lock);
    return val >> 6;
 //   dv = (fi->src->ft.orig_upem * 2048) / fi->src->ft.face->units_per_EM;
 //   ret = (val * fi->src->ft.face->size->metrics.y_scale) / (dv * dv);
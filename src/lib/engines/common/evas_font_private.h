@@ -20,4 +20,12 @@ extern LK(lock_fribidi); // for fribidi API calls
 #  define FBDUNLOCK() 
 # endif
 
+/* fash lookups take no lock, so whatever is added to a fash table must be
+ * completely filled in before the pointer to it is stored */
+# ifdef __GNUC__
+#  define FASH_PUBLISH() __sync_synchronize()
+# else
+#  define FASH_PUBLISH()
+# endif
+
 #endif /* !_EVAS_FONT_PRIVATE_H */
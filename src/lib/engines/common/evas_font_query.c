@@ -78,11 +78,6 @@ evas_common_font_query_size(RGBA_Font *fn, const char *text, int *w, int *h)
 
         FT_UInt index = evas_common_font_glyph_search(fn, &fi, gl);
         LKL(fi->ft_mutex);
-        if (fi->src->current_size != fi->size)
-        {
-            FT_Activate_Size(fi->ft.size);
-            fi->src->current_size = fi->size;
-        }
         RGBA_Font_Glyph *fg = evas_common_font_int_cache_glyph_get(fi, index);
         int chr_w = fg->glyph->advance.x >> 16;
 
@@ -96,12 +91,20 @@ evas_common_font_query_size(RGBA_Font *fn, const char *text, int *w, int *h)
             /* If there is previous glyph, use kerning. */
             if (use_kerning) {
                 int kern;
+                /* the face is shared with the glyph renderer of every size */
+                LKL(fi->src->glyph_lock);
+                if (fi->src->current_size != fi->size)
+                {
+                    FT_Activate_Size(fi->ft.size);
+                    fi->src->current_size = fi->size;
+                }
                 if (evas_common_font_query_kerning(fi, prev_index, index, &kern)) {
 #ifdef DEBUG_TEXTBLOCK
                     fprintf(stderr, " -> Adjusting width for %d pixels, kerning\n", kern);
 #endif
                     chr_w += kern;
                 }
+                LKU(fi->src->glyph_lock);
             }
         } else {
             /* It's a first glyph, so subtract left-side bearing from the
@@ -114,19 +117,21 @@ evas_common_font_query_size(RGBA_Font *fn, const char *text, int *w, int *h)
 
         end_x += chr_w;
         prev_index = index;
+        LKU(fi->ft_mutex);
     }
 
     if (prev_index) {
         /* string is not empty. Adjust it */
         RGBA_Font_Glyph *fg;
+        LKL(fi->ft_mutex);
         fg = evas_common_font_int_cache_glyph_get(fi, prev_index);
         int right_bearing = (fg->glyph->advance.x >> 16) - fg->glyph_out->bitmap.width - fg->glyph_out->left;
         end_x -= right_bearing;
 #ifdef DEBUG_TEXTBLOCK
         fprintf(stderr, " -> Adjusting width for %d pixels, right bearing of last glyph\n", right_bearing);
 #endif
+        LKU(fi->ft_mutex);
     }
-    LKU(fi->ft_mutex);
 
     if (w)
         *w = end_x;
@@ -151,11 +156,6 @@ evas_common_font_query_inset(RGBA_Font *fn, const char *text)
    if (gl == 0) return 0;
 //   evas_common_font_size_use(fn);
    index = evas_common_font_glyph_search(fn, &fi, gl);
-   if (fi->src->current_size != fi->size)
-     {
-        FT_Activate_Size(fi->ft.size);
-        fi->src->current_size = fi->size;
-     }
    fg = evas_common_font_int_cache_glyph_get(fi, index);
    if (!fg) return 0;
 /*
@@ -208,18 +208,22 @@ evas_common_font_query_advance(RGBA_Font *fn, const char *text, int *h_adv, int
 	if (gl == 0) break;
 	index = evas_common_font_glyph_search(fn, &fi, gl);
 	LKL(fi->ft_mutex);
-        if (fi->src->current_size != fi->size)
-          {
-             FT_Activate_Size(fi->ft.size);
-             fi->src->current_size = fi->size;
-          }
       /* hmmm kerning means i can't sanely do my own cached metric tables! */
 	/* grrr - this means font face sharing is kinda... not an option if */
 	/* you want performance */
 	if ((use_kerning) && (prev_index) && (index) &&
 	    (pface == fi->src->ft.face))
-	  if (evas_common_font_query_kerning(fi, prev_index, index, &kern))
-	    pen_x += kern;
+	  {
+	     LKL(fi->src->glyph_lock);
+	     if (fi->src->current_size != fi->size)
+	       {
+		  FT_Activate_Size(fi->ft.size);
+		  fi->src->current_size = fi->size;
+	       }
+	     if (evas_common_font_query_kerning(fi, prev_index, index, &kern))
+	       pen_x += kern;
+	     LKU(fi->src->glyph_lock);
+	  }
 
 	pface = fi->src->ft.face;
 	fg = evas_common_font_int_cache_glyph_get(fi, index);
@@ -268,11 +272,6 @@ evas_common_font_query_char_coords(RGBA_Font *fn, const char *in_text, int pos,
    pen_x = 0;
    pen_y = 0;
 //   evas_common_font_size_use(fn);
-   if (fi->src->current_size != fi->size)
-     {
-        FT_Activate_Size(fi->ft.size);
-        fi->src->current_size = fi->size;
-     }
    use_kerning = FT_HAS_KERNING(fi->src->ft.face);
    prev_index = 0;
    prev_chr_end = 0;
@@ -310,7 +309,6 @@ evas_common_font_query_char_coords(RGBA_Font *fn, const char *in_text, int pos,
 	if (gl == 0) break;
 	index = evas_common_font_glyph_search(fn, &fi, gl);
 	LKL(fi->ft_mutex);
-	// FIXME: Why no FT_Activate_Size here ?
 	kern = 0;
         /* hmmm kerning means i can't sanely do my own cached metric tables! */
 	/* grrr - this means font face sharing is kinda... not an option if */
@@ -318,6 +316,12 @@ evas_common_font_query_char_coords(RGBA_Font *fn, const char *in_text, int pos,
 	if ((use_kerning) && (prev_index) && (index) &&
 	     (pface == fi->src->ft.face))
 	   {
+	      LKL(fi->src->glyph_lock);
+	      if (fi->src->current_size != fi->size)
+		{
+		   FT_Activate_Size(fi->ft.size);
+		   fi->src->current_size = fi->size;
+		}
 #ifdef INTERNATIONAL_SUPPORT
 	      /* if it's rtl, the kerning matching should be reversed, i.e prev
 	       * index is now the index and the other way around. */
@@ -333,6 +337,7 @@ evas_common_font_query_char_coords(RGBA_Font *fn, const char *in_text, int pos,
 	           if (evas_common_font_query_kerning(fi, prev_index, index, &kern))
 	              pen_x += kern;
 	      }
+	      LKU(fi->src->glyph_lock);
            }
 
 	pface = fi->src->ft.face;
@@ -411,11 +416,6 @@ evas_common_font_query_text_at_pos(RGBA_Font *fn, const char *in_text, int x, in
    pen_x = 0;
    pen_y = 0;
 //   evas_common_font_size_use(fn);
-   if (fi->src->current_size != fi->size)
-     {
-        FT_Activate_Size(fi->ft.size);
-        fi->src->current_size = fi->size;
-     }
    use_kerning = FT_HAS_KERNING(fi->src->ft.face);
    prev_index = 0;
    prev_chr_end = 0;
@@ -435,7 +435,6 @@ evas_common_font_query_text_at_pos(RGBA_Font *fn, const char *in_text, int x, in
 	if (gl == 0) break;
 	index = evas_common_font_glyph_search(fn, &fi, gl);
 	LKL(fi->ft_mutex);
-	// FIXME: Why not FT_Activate_Size here ?
 	kern = 0;
         /* hmmm kerning means i can't sanely do my own cached metric tables! */
 	/* grrr - this means font face sharing is kinda... not an option if */
@@ -443,6 +442,12 @@ evas_common_font_query_text_at_pos(RGBA_Font *fn, const char *in_text, int x, in
 	if ((use_kerning) && (prev_index) && (index) &&
 	     (pface == fi->src->ft.face))
 	   {
+	      LKL(fi->src->glyph_lock);
+	      if (fi->src->current_size != fi->size)
+		{
+		   FT_Activate_Size(fi->ft.size);
+		   fi->src->current_size = fi->size;
+		}
 #ifdef INTERNATIONAL_SUPPORT
 	      /* if it's rtl, the kerning matching should be reversed, i.e prev
 	       * index is now the index and the other way around. */
@@ -458,6 +463,7 @@ evas_common_font_query_text_at_pos(RGBA_Font *fn, const char *in_text, int x, in
 	           if (evas_common_font_query_kerning(fi, prev_index, index, &kern))
 	              pen_x += kern;
 	        }
+	      LKU(fi->src->glyph_lock);
            }
 
 	pface = fi->src->ft.face;
@@ -558,19 +564,23 @@ evas_common_font_query_last_up_to_pos(RGBA_Font *fn, const char *text, int x, in
 	if (gl == 0) break;
 	index = evas_common_font_glyph_search(fn, &fi, gl);
 	LKL(fi->ft_mutex);
-        if (fi->src->current_size != fi->size)
-          {
-             FT_Activate_Size(fi->ft.size);
-             fi->src->current_size = fi->size;
-          }
 	kern = 0;
         /* hmmm kerning means i can't sanely do my own cached metric tables! */
 	/* grrr - this means font face sharing is kinda... not an option if */
 	/* you want performance */
 	if ((use_kerning) && (prev_index) && (index) &&
 	    (pface == fi->src->ft.face))
-	  if (evas_common_font_query_kerning(fi, prev_index, index, &kern))
-	    pen_x += kern;
+	  {
+	     LKL(fi->src->glyph_lock);
+	     if (fi->src->current_size != fi->size)
+	       {
+		  FT_Activate_Size(fi->ft.size);
+		  fi->src->current_size = fi->size;
+	       }
+	     if (evas_common_font_query_kerning(fi, prev_index, index, &kern))
+	       pen_x += kern;
+	     LKU(fi->src->glyph_lock);
+	  }
 
 	pface = fi->src->ft.face;
 	fg = evas_common_font_int_cache_glyph_get(fi, index);
@@ -654,9 +664,18 @@ evas_common_font_query_suffix_needed_width(RGBA_Font *fn, const char *text, int
         if (prev_index != -1) {
             if (use_kerning) {
                 int kern;
+                LKL(fi->ft_mutex);
+                LKL(fi->src->glyph_lock);
+                if (fi->src->current_size != fi->size)
+                {
+                    FT_Activate_Size(fi->ft.size);
+                    fi->src->current_size = fi->size;
+                }
                 if (evas_common_font_query_kerning(fi, index, prev_index, &kern)) {
                     chr_w += kern;
                 }
+                LKU(fi->src->glyph_lock);
+                LKU(fi->ft_mutex);
             }
         } else {
             /*
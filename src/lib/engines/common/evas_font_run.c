@@ -0,0 +1,415 @@
+/*
+ * vim:ts=8:sw=3:sts=8:noexpandtab:cino=>5n-3f0^-2{2
+ */
+
+#include "evas_common.h"
+#include "evas_private.h"
+
+#include "evas_intl_utils.h" /*defines INTERNATIONAL_SUPPORT if possible */
+#include "evas_font_private.h"
+
+/* run cache. a short run of text is laid out once - glyph indices, pen
+ * positions, advances and kerning - and all its glyphs are composited into
+ * a single A8 mask, so drawing the same label again is one masked span per
+ * row instead of utf8 decoding, glyph searches and a blit per glyph. runs
+ * are keyed by font set, size, hinting and text, so every text and
+ * textblock object drawing the same string in the same font shares one.
+ * once the cache holds more than its byte budget (EVAS_FONT_RUN_CACHE, in
+ * Kb) the least recently drawn runs are dropped */
+
+#define RUN_CACHE_MAXLEN 256 /* bytes of text */
+#define RUN_CACHE_DEFAULT 512 /* Kb */
+
+typedef struct _Font_Run_Glyph Font_Run_Glyph;
+
+struct _Font_Run_Glyph
+{
+   FT_UInt index;
+   int     pen_x; /* kerning included */
+   int     advance;
+   int     kern;
+};
+
+struct _Font_Run
+{
+   EINA_INLIST;
+   RGBA_Font      *fn;
+   Font_Hint_Flags hinting;
+   int             size;
+   const char     *text;
+   int             glyphs_num;
+   Font_Run_Glyph *glyphs;
+   int             x, top; /* mask position relative to pen start, baseline */
+   int             w, h;
+   DATA8          *mask;
+   int             bytes;
+   int             ref;
+   unsigned char   dead : 1;
+   unsigned char   too_big : 1; /* only remembers not to build it again */
+};
+
+static Eina_Hash *runs = NULL;
+static Eina_Inlist *runs_lru = NULL; /* least recently drawn first */
+static int runs_usage = 0;
+static int runs_max = RUN_CACHE_DEFAULT * 1024;
+LK(runs_lock);
+
+static int
+_evas_font_run_cmp(const Font_Run *k1, int k1_length __UNUSED__,
+		   const Font_Run *k2, int k2_length __UNUSED__)
+{
+   if (k1->fn != k2->fn) return (k1->fn < k2->fn) ? -1 : 1;
+   if (k1->size != k2->size) return k1->size - k2->size;
+   if (k1->hinting != k2->hinting) return k1->hinting - k2->hinting;
+   return strcmp(k1->text, k2->text);
+}
+
+static int
+_evas_font_run_hash(const Font_Run *key, int key_length __UNUSED__)
+{
+   int hash;
+
+   hash = eina_hash_superfast(key->text, strlen(key->text));
+   hash ^= eina_hash_int32(&key->size, sizeof (int));
+   hash ^= (int)(((unsigned long)key->fn) >> 4);
+   return hash;
+}
+
+static void
+_evas_font_run_free(Font_Run *run)
+{
+   free(run);
+}
+
+/* call with runs_lock held */
+static void
+_evas_font_run_del(Font_Run *run)
+{
+   eina_hash_del(runs, run, run);
+   runs_lru = eina_inlist_remove(runs_lru, EINA_INLIST_GET(run));
+   runs_usage -= run->bytes;
+   if (run->ref > 0) run->dead = 1;
+   else _evas_font_run_free(run);
+}
+
+/* call with runs_lock held */
+static void
+_evas_font_run_cache_clean(void)
+{
+   while ((runs_lru) && (runs_usage > runs_max))
+     _evas_font_run_del(EINA_INLIST_CONTAINER_GET(runs_lru, Font_Run));
+}
+
+EAPI void
+evas_common_font_run_cache_init(void)
+{
+   const char *s;
+
+   s = getenv("EVAS_FONT_RUN_CACHE");
+   if (s) runs_max = atoi(s) * 1024;
+   if (runs_max < 0) runs_max = 0;
+   runs = eina_hash_new(NULL,
+			EINA_KEY_CMP(_evas_font_run_cmp),
+			EINA_KEY_HASH(_evas_font_run_hash),
+			NULL,
+			8);
+   LKI(runs_lock);
+}
+
+EAPI void
+evas_common_font_run_cache_shutdown(void)
+{
+   evas_common_font_run_cache_flush(NULL);
+   if (runs) eina_hash_free(runs);
+   runs = NULL;
+   LKD(runs_lock);
+}
+
+/* drop the runs of fn, or all runs if fn is NULL. call whenever what fn
+ * would draw changes or fn goes away */
+EAPI void
+evas_common_font_run_cache_flush(RGBA_Font *fn)
+{
+   Eina_Inlist *l;
+
+   if (!runs) return;
+   LKL(runs_lock);
+   for (l = runs_lru; l;)
+     {
+        Font_Run *run = EINA_INLIST_CONTAINER_GET(l, Font_Run);
+
+        l = l->next;
+        if ((!fn) || (run->fn == fn)) _evas_font_run_del(run);
+     }
+   LKU(runs_lock);
+}
+
+static void
+_evas_font_run_glyph_composite(Font_Run *run, RGBA_Font_Glyph *fg, int gx, int gy)
+{
+   FT_Bitmap *bm = &(fg->glyph_out->bitmap);
+   DATA8 *s, *d;
+   int i, j, w, h;
+
+   w = bm->width;
+   h = bm->rows;
+   for (i = 0; i < h; i++)
+     {
+        s = bm->buffer + (i * bm->pitch);
+        d = run->mask + ((gy + i) * run->w) + gx;
+        if ((bm->num_grays == 256) && (bm->pixel_mode == ft_pixel_mode_grays))
+          {
+             for (j = 0; j < w; j++, d++)
+               {
+                  /* glyphs that touch are combined as if blended one on
+                   * top of the other, as drawing them one by one does */
+                  if (s[j]) *d = *d + (((255 - *d) * s[j]) / 255);
+               }
+          }
+        else
+          {
+             for (j = 0; j < w; j++, d++)
+               {
+                  if (s[j >> 3] & (0x80 >> (j & 0x7))) *d = 0xff;
+               }
+          }
+     }
+}
+
+/* lay text out as the per glyph draw does and render it into a new run.
+ * call with fn->lock held, as glyph searches fill in fn's index cache */
+static Font_Run *
+_evas_font_run_build(RGBA_Font *fn, const char *in_text)
+{
+   Font_Run_Glyph glyphs[RUN_CACHE_MAXLEN];
+   RGBA_Font_Glyph *fgs[RUN_CACHE_MAXLEN];
+   RGBA_Font_Int *fi;
+   Font_Run *run;
+   const char *text = in_text;
+   FT_Face pface = NULL;
+   FT_UInt prev_index = 0;
+   int pen_x = 0, chr, char_index, n = 0, len;
+   int x1 = 0, x2 = 0, top = 0, bottom = 0;
+   int use_kerning, textlen, bytes, i;
+#ifdef INTERNATIONAL_SUPPORT
+   EvasIntlParType direction = FRIBIDI_TYPE_ON;
+   EvasIntlLevel *level_list;
+   char *visual_text;
+
+   visual_text = evas_intl_utf8_to_visual(in_text, &len, &direction, NULL, NULL, &level_list);
+   text = (visual_text) ? visual_text : in_text;
+#endif
+
+   fi = fn->fonts->data;
+   use_kerning = FT_HAS_KERNING(fi->src->ft.face);
+   for (char_index = 0, chr = 0; (text[chr]) && (n < RUN_CACHE_MAXLEN); char_index++)
+     {
+	FT_UInt index;
+	RGBA_Font_Glyph *fg;
+	int gl, kern = 0, gx, gw, gh;
+
+	gl = evas_common_font_utf8_get_next((unsigned char *)text, &chr);
+	if (gl == 0) break;
+	index = evas_common_font_glyph_search(fn, &fi, gl);
+	if ((use_kerning) && (prev_index) && (index) &&
+	    (pface == fi->src->ft.face))
+	  {
+	     LKL(fi->ft_mutex);
+	     LKL(fi->src->glyph_lock);
+	     if (fi->src->current_size != fi->size)
+	       {
+		  FT_Activate_Size(fi->ft.size);
+		  fi->src->current_size = fi->size;
+	       }
+#ifdef INTERNATIONAL_SUPPORT
+	     if (evas_intl_is_rtl_char(level_list, char_index))
+	       {
+		  if (!evas_common_font_query_kerning(fi, index, prev_index, &kern))
+		    kern = 0;
+	       }
+	     else
+#endif
+	       {
+		  if (!evas_common_font_query_kerning(fi, prev_index, index, &kern))
+		    kern = 0;
+	       }
+	     LKU(fi->src->glyph_lock);
+	     LKU(fi->ft_mutex);
+	     pen_x += kern;
+	  }
+	pface = fi->src->ft.face;
+	fg = evas_common_font_int_cache_glyph_get(fi, index);
+	if (!fg) continue;
+
+	glyphs[n].index = index;
+	glyphs[n].pen_x = pen_x;
+	glyphs[n].advance = fg->glyph->advance.x >> 16;
+	glyphs[n].kern = kern;
+	fgs[n] = fg;
+	gx = pen_x + fg->glyph_out->left;
+	gw = fg->glyph_out->bitmap.width;
+	gh = fg->glyph_out->bitmap.rows;
+	if ((n == 0) || (gx < x1)) x1 = gx;
+	if ((n == 0) || ((gx + gw) > x2)) x2 = gx + gw;
+	if (fg->glyph_out->top > top) top = fg->glyph_out->top;
+	if ((gh - fg->glyph_out->top) > bottom) bottom = gh - fg->glyph_out->top;
+	n++;
+	pen_x += glyphs[n - 1].advance;
+	prev_index = index;
+     }
+#ifdef INTERNATIONAL_SUPPORT
+   if (level_list) free(level_list);
+   if (visual_text) free(visual_text);
+#endif
+
+   textlen = strlen(in_text) + 1;
+   len = sizeof(Font_Run) + (n * sizeof(Font_Run_Glyph)) + textlen;
+   bytes = (x2 - x1) * (top + bottom);
+   if ((len + bytes) > (runs_max / 8))
+     {
+	/* too big to cache. keep just the key, so the text isn't laid out
+	 * for nothing every time it's drawn */
+	run = calloc(1, sizeof(Font_Run) + textlen);
+	if (!run) return NULL;
+	run->fn = fn;
+	run->hinting = fn->hinting;
+	run->size = fi->size;
+	run->text = (const char *)(run + 1);
+	memcpy((char *)run->text, in_text, textlen);
+	run->bytes = sizeof(Font_Run) + textlen;
+	run->too_big = 1;
+	return run;
+     }
+   run = calloc(1, len + bytes);
+   if (!run) return NULL;
+   run->fn = fn;
+   run->hinting = fn->hinting;
+   run->size = fi->size;
+   run->glyphs = (Font_Run_Glyph *)(run + 1);
+   run->glyphs_num = n;
+   memcpy(run->glyphs, glyphs, n * sizeof(Font_Run_Glyph));
+   run->text = (const char *)(run->glyphs + n);
+   memcpy((char *)run->text, in_text, textlen);
+   run->bytes = len + bytes;
+   if (bytes > 0)
+     {
+	run->mask = ((DATA8 *)run) + len;
+	run->x = x1;
+	run->top = top;
+	run->w = x2 - x1;
+	run->h = top + bottom;
+	for (i = 0; i < n; i++)
+	  _evas_font_run_glyph_composite(run, fgs[i],
+					 glyphs[i].pen_x + fgs[i]->glyph_out->left - x1,
+					 top - fgs[i]->glyph_out->top);
+     }
+   return run;
+}
+
+/* find or make the run for text drawn with fn. returns NULL if text is not
+ * worth caching, otherwise the run has to be given back with
+ * evas_common_font_run_release(). call with fn->lock held */
+EAPI Font_Run *
+evas_common_font_run_get(RGBA_Font *fn, const char *text)
+{
+   Font_Run tmp, *run, *run2;
+   int len;
+
+   if ((!runs) || (runs_max <= 0)) return NULL;
+   for (len = 0; (text[len]) && (len < RUN_CACHE_MAXLEN); len++);
+   if (len >= RUN_CACHE_MAXLEN) return NULL;
+
+   tmp.fn = fn;
+   tmp.hinting = fn->hinting;
+   tmp.size = ((RGBA_Font_Int *)fn->fonts->data)->size;
+   tmp.text = text;
+   LKL(runs_lock);
+   run = eina_hash_find(runs, &tmp);
+   if (run)
+     {
+	runs_lru = eina_inlist_demote(runs_lru, EINA_INLIST_GET(run));
+	if (run->too_big)
+	  {
+	     LKU(runs_lock);
+	     return NULL;
+	  }
+	run->ref++;
+	LKU(runs_lock);
+	return run;
+     }
+   LKU(runs_lock);
+
+   run = _evas_font_run_build(fn, text);
+   if (!run) return NULL;
+   LKL(runs_lock);
+   /* another thread may have built it meanwhile */
+   run2 = eina_hash_find(runs, run);
+   if (run2)
+     {
+	_evas_font_run_free(run);
+	run = run2;
+	runs_lru = eina_inlist_demote(runs_lru, EINA_INLIST_GET(run));
+     }
+   else
+     {
+	eina_hash_direct_add(runs, run, run);
+	runs_lru = eina_inlist_append(runs_lru, EINA_INLIST_GET(run));
+	runs_usage += run->bytes;
+     }
+   if (run->too_big)
+     {
+	_evas_font_run_cache_clean();
+	LKU(runs_lock);
+	return NULL;
+     }
+   run->ref++;
+   _evas_font_run_cache_clean();
+   LKU(runs_lock);
+   return run;
+}
+
+EAPI void
+evas_common_font_run_release(Font_Run *run)
+{
+   LKL(runs_lock);
+   run->ref--;
+   if ((run->ref == 0) && (run->dead)) _evas_font_run_free(run);
+   LKU(runs_lock);
+}
+
+/* draw a run with its pen starting at x, y clipped to the ext rect, as
+ * evas_common_font_draw() would draw its text */
+EAPI void
+evas_common_font_run_draw(Font_Run *run, RGBA_Image *dst, RGBA_Draw_Context *dc, RGBA_Gfx_Func func,
+			  int x, int y, int ext_x, int ext_y, int ext_w, int ext_h)
+{
+   DATA32 *im;
+   int im_w, i, dx, in_x, w;
+
+   if (!run->mask) return;
+   im = dst->image.data;
+   im_w = dst->cache_entry.w;
+   dx = x + run->x;
+   w = run->w;
+   in_x = 0;
+   if (dx < ext_x)
+     {
+	in_x = ext_x - dx;
+	w -= in_x;
+	dx = ext_x;
+     }
+   if ((dx + w) > (ext_x + ext_w)) w = ext_x + ext_w - dx;
+   if (w <= 0) return;
+   for (i = 0; i < run->h; i++)
+     {
+	int dy;
+
+	dy = y - run->top + i;
+	if ((dy < ext_y) || (dy >= (ext_y + ext_h))) continue;
+#ifdef EVAS_SLI
+	if (((dy) % dc->sli.h) != dc->sli.y) continue;
+#endif
+	func(NULL, run->mask + (i * run->w) + in_x, dc->col.col,
+	     im + (dy * im_w) + dx, w);
+     }
+}
@@ -32,9 +32,23 @@ EAPI void              evas_common_image_alpha_line_buffer_free    (RGBA_Image *
 EAPI RGBA_Image       *evas_common_load_image_from_file            (const char *file, const char *key, RGBA_Image_Loadopts *lo, int *error);
 EAPI int               evas_common_save_image_to_file              (RGBA_Image *im, const char *file, const char *key, int quality, int compress);
 
+typedef struct _RGBA_Image_Scalecache_Stats RGBA_Image_Scalecache_Stats;
+
+struct _RGBA_Image_Scalecache_Stats
+{
+   int size; // bytes of scaled copies currently held
+   int max_size;
+   int count; // number of scaled copies currently held
+   unsigned long long hits; // draws served from a cached copy
+   unsigned long long misses; // scaled draws done without a cached copy
+   unsigned long long populates;
+   unsigned long long evictions;
+};
+
 EAPI void evas_common_rgba_image_scalecache_size_set(int size);
 EAPI int evas_common_rgba_image_scalecache_size_get(void);
 EAPI void evas_common_rgba_image_scalecache_flush(void);
+EAPI void evas_common_rgba_image_scalecache_stats_get(RGBA_Image_Scalecache_Stats *stats);
     
 EAPI void
   evas_common_rgba_image_scalecache_prepare(Image_Entry *ie, RGBA_Image *dst,
@@ -50,6 +64,44 @@ EAPI void
                                        int src_region_w, int src_region_h,
                                        int dst_region_x, int dst_region_y,
                                        int dst_region_w, int dst_region_h);
+EAPI void
+  evas_common_rgba_image_border_draw(RGBA_Image *im, RGBA_Image *dst,
+                                     RGBA_Draw_Context *dc, int smooth,
+                                     int l, int r, int t, int b,
+                                     int sl, int sr, int st, int sb, int fill,
+                                     int x, int y, int w, int h);
+EAPI void *
+  evas_common_rgba_image_border_get(RGBA_Image *im, int smooth,
+                                    int l, int r, int t, int b,
+                                    int sl, int sr, int st, int sb,
+                                    int w, int h);
+EAPI void
+  evas_common_rgba_image_border_release(RGBA_Image *im, void *border);
+EAPI void
+  evas_common_rgba_image_border_prepare(RGBA_Image *im, void *border,
+                                        RGBA_Image *dst, RGBA_Draw_Context *dc,
+                                        int smooth, int l, int r, int t, int b,
+                                        int sl, int sr, int st, int sb, int fill,
+                                        int x, int y, int w, int h);
+EAPI void
+  evas_common_rgba_image_border_fill(RGBA_Image *im, void *border,
+                                     RGBA_Image *dst, RGBA_Draw_Context *dc,
+                                     int smooth, int l, int r, int t, int b,
+                                     int sl, int sr, int st, int sb, int fill,
+                                     int x, int y, int w, int h);
+EAPI void
+  evas_common_rgba_image_tile_draw(RGBA_Image *im, RGBA_Image *dst,
+                                   RGBA_Draw_Context *dc, int smooth,
+                                   int tile_w, int tile_h,
+                                   int x, int y, int w, int h);
+EAPI RGBA_Image *
+  evas_common_rgba_image_tile_get(RGBA_Image *im, int smooth,
+                                  int tile_w, int tile_h);
+EAPI void
+  evas_common_rgba_image_tile_fill(RGBA_Image *tile, RGBA_Image *dst,
+                                   RGBA_Draw_Context *dc,
+                                   int tile_w, int tile_h,
+                                   int x, int y, int w, int h);
 
 
 EAPI int evas_common_load_rgba_image_module_from_file (Image_Entry *im);
@@ -0,0 +1,531 @@
+/*
+ * vim:ts=8:sw=3:sts=8:noexpandtab:cino=>5n-3f0^-2{2
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "evas_common.h"
+#include "evas_private.h"
+#include "evas_blend_private.h"
+#include "evas_image_private.h"
+
+/* bordered (9 slice) image draws.
+ *
+ * a bordered image is drawn as its 4 corners, 4 edges and (unless the fill
+ * mode says not to) the middle. the 8 border slices of a given draw only
+ * depend on the image, the border, the border on screen and the size on
+ * screen, so once the same draw has been seen a few times they are scaled
+ * once into 2 bands kept with the image:
+ *
+ *   hband: top and bottom rows, corners included  - w x (st + sb)
+ *   vband: left and right edges between them      - (sl + sr) x (h - st - sb)
+ *
+ * and later draws blit the bands row by row with a single span function.
+ * the middle is left to the scale cache like any other scaled draw, it's
+ * usually most of the area and caching a copy of it here too would double
+ * up. until a draw is cached (or when it can't be) the slices are drawn
+ * one by one through the scale cache, same as they always were.
+ *
+ * a draw holds a ref on the bands it uses, so the pipe can look them up
+ * once when the op is queued and its threads blit them without locking. */
+
+#define MAX_BORDERITEMS 8
+#define MIN_BORDER_USES 2
+#define BORDER_CACHE_SIZE 2 * 1024 * 1024
+
+typedef struct _Borderitem Borderitem;
+
+struct _Borderitem
+{
+   int l, r, t, b; // border in the image
+   int sl, sr, st, sb; // border on screen
+   int w, h; // size on screen
+   int smooth;
+   int uses;
+   int ref; // the image's list and every draw using the bands
+   int size;
+   RGBA_Image *hband, *vband;
+   Eina_Bool ready : 1;
+};
+
+static int init = 0;
+static RGBA_Draw_Context *ct = NULL; // copy op for scaling into the bands
+static int max_cache_size = BORDER_CACHE_SIZE;
+static int min_border_uses = MIN_BORDER_USES;
+static int cache_size = 0;
+#ifdef BUILD_PTHREAD
+static LK(cache_lock) = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+void
+evas_common_bordercache_init(void)
+{
+   const char *s;
+
+   init++;
+   if (init > 1) return;
+   // made here, not on first use, as pipe threads populate concurrently
+   ct = evas_common_draw_context_new();
+   if (ct) evas_common_draw_context_set_render_op(ct, _EVAS_RENDER_COPY);
+   s = getenv("EVAS_BORDERCACHE_SIZE");
+   if (s) max_cache_size = atoi(s) * 1024;
+   s = getenv("EVAS_BORDERCACHE_MIN_USES");
+   if (s) min_border_uses = atoi(s);
+}
+
+void
+evas_common_bordercache_shutdown(void)
+{
+   init--;
+   if (init > 0) return;
+   if (ct) evas_common_draw_context_free(ct);
+   ct = NULL;
+}
+
+static void
+_bi_unref(Borderitem *bi)
+{
+   bi->ref--;
+   if (bi->ref > 0) return;
+   if (bi->ready)
+     {
+        LKL(cache_lock);
+        cache_size -= bi->size;
+        LKU(cache_lock);
+     }
+   if (bi->hband) evas_common_rgba_image_free(&bi->hband->cache_entry);
+   if (bi->vband) evas_common_rgba_image_free(&bi->vband->cache_entry);
+   free(bi);
+}
+
+/* im->cache.lock must be held */
+void
+evas_common_rgba_image_border_dirty(RGBA_Image *im)
+{
+   Borderitem *bi;
+
+   EINA_LIST_FREE(im->cache.borders, bi)
+     _bi_unref(bi);
+}
+
+/* im->cache.lock must be held */
+static Borderitem *
+_bi_find(RGBA_Image *im, int smooth,
+         int l, int r, int t, int b, int sl, int sr, int st, int sb,
+         int w, int h)
+{
+   Eina_List *ll;
+   Borderitem *bi;
+
+   EINA_LIST_FOREACH(im->cache.borders, ll, bi)
+     {
+        if ((bi->w == w) && (bi->h == h) && (bi->smooth == smooth) &&
+            (bi->l == l) && (bi->r == r) && (bi->t == t) && (bi->b == b) &&
+            (bi->sl == sl) && (bi->sr == sr) && (bi->st == st) && (bi->sb == sb))
+          {
+             if (ll != im->cache.borders)
+               im->cache.borders = eina_list_promote_list(im->cache.borders, ll);
+             return bi;
+          }
+     }
+   if (eina_list_count(im->cache.borders) >= MAX_BORDERITEMS)
+     {
+        ll = eina_list_last(im->cache.borders);
+        _bi_unref(ll->data);
+        im->cache.borders = eina_list_remove_list(im->cache.borders, ll);
+     }
+   bi = calloc(1, sizeof(Borderitem));
+   if (!bi) return NULL;
+   bi->ref = 1;
+   bi->l = l; bi->r = r; bi->t = t; bi->b = b;
+   bi->sl = sl; bi->sr = sr; bi->st = st; bi->sb = sb;
+   bi->w = w; bi->h = h;
+   bi->smooth = smooth;
+   im->cache.borders = eina_list_prepend(im->cache.borders, bi);
+   return bi;
+}
+
+static void
+_bi_scale(RGBA_Image *src, RGBA_Image *dst, RGBA_Draw_Context *ct, int smooth,
+          int sx, int sy, int sw, int sh, int dx, int dy, int dw, int dh)
+{
+   if (smooth)
+     evas_common_scale_rgba_in_to_out_clip_smooth(src, dst, ct,
+                                                  sx, sy, sw, sh,
+                                                  dx, dy, dw, dh);
+   else
+     evas_common_scale_rgba_in_to_out_clip_sample(src, dst, ct,
+                                                  sx, sy, sw, sh,
+                                                  dx, dy, dw, dh);
+}
+
+/* scale the 8 border slices of im into bi's bands. im->cache.lock must be
+ * held and im's data loaded */
+static Eina_Bool
+_bi_populate(RGBA_Image *im, Borderitem *bi)
+{
+   int imw, imh, mw, mh, alpha;
+
+   imw = im->cache_entry.w;
+   imh = im->cache_entry.h;
+   mw = bi->w - bi->sl - bi->sr;
+   mh = bi->h - bi->st - bi->sb;
+   alpha = im->cache_entry.flags.alpha;
+   if (!ct) return EINA_FALSE;
+   if ((bi->st + bi->sb) > 0)
+     {
+        bi->hband = evas_common_image_new(bi->w, bi->st + bi->sb, alpha);
+        if (!bi->hband) return EINA_FALSE;
+        memset(bi->hband->image.data, 0,
+               bi->w * (bi->st + bi->sb) * sizeof(DATA32));
+        _bi_scale(im, bi->hband, ct, bi->smooth,
+                  0, 0, bi->l, bi->t,
+                  0, 0, bi->sl, bi->st);
+        _bi_scale(im, bi->hband, ct, bi->smooth,
+                  bi->l, 0, imw - bi->l - bi->r, bi->t,
+                  bi->sl, 0, mw, bi->st);
+        _bi_scale(im, bi->hband, ct, bi->smooth,
+                  imw - bi->r, 0, bi->r, bi->t,
+                  bi->w - bi->sr, 0, bi->sr, bi->st);
+        _bi_scale(im, bi->hband, ct, bi->smooth,
+                  0, imh - bi->b, bi->l, bi->b,
+                  0, bi->st, bi->sl, bi->sb);
+        _bi_scale(im, bi->hband, ct, bi->smooth,
+                  bi->l, imh - bi->b, imw - bi->l - bi->r, bi->b,
+                  bi->sl, bi->st, mw, bi->sb);
+        _bi_scale(im, bi->hband, ct, bi->smooth,
+                  imw - bi->r, imh - bi->b, bi->r, bi->b,
+                  bi->w - bi->sr, bi->st, bi->sr, bi->sb);
+     }
+   if (((bi->sl + bi->sr) > 0) && (mh > 0))
+     {
+        bi->vband = evas_common_image_new(bi->sl + bi->sr, mh, alpha);
+        if (!bi->vband) return EINA_FALSE;
+        memset(bi->vband->image.data, 0,
+               (bi->sl + bi->sr) * mh * sizeof(DATA32));
+        _bi_scale(im, bi->vband, ct, bi->smooth,
+                  0, bi->t, bi->l, imh - bi->t - bi->b,
+                  0, 0, bi->sl, mh);
+        _bi_scale(im, bi->vband, ct, bi->smooth,
+                  imw - bi->r, bi->t, bi->r, imh - bi->t - bi->b,
+                  bi->sl, 0, bi->sr, mh);
+     }
+   evas_common_cpu_end_opt();
+   return EINA_TRUE;
+}
+
+/* the bands only stand in for the slice draws if every slice that covers
+ * some of the screen has something to scale from - otherwise the slice
+ * draw is a no-op while the band would have transparent pixels there */
+static Eina_Bool
+_border_cacheable(RGBA_Image *im, int l, int r, int t, int b,
+                  int sl, int sr, int st, int sb, int w, int h)
+{
+   int mw = w - sl - sr, mh = h - st - sb;
+
+   if ((mw < 0) || (mh < 0)) return EINA_FALSE;
+   if ((sl > 0) && (l <= 0)) return EINA_FALSE;
+   if ((sr > 0) && (r <= 0)) return EINA_FALSE;
+   if ((st > 0) && (t <= 0)) return EINA_FALSE;
+   if ((sb > 0) && (b <= 0)) return EINA_FALSE;
+   if ((mw > 0) && ((im->cache_entry.w - l - r) <= 0)) return EINA_FALSE;
+   if ((mh > 0) && ((im->cache_entry.h - t - b) <= 0)) return EINA_FALSE;
+   return EINA_TRUE;
+}
+
+static void
+_border_span(RGBA_Gfx_Func func, DATA32 *row, int rx, int rw,
+             DATA32 *dp, int cx, int cw, DATA32 col)
+{
+   int x1 = rx, x2 = rx + rw;
+
+   if (x1 < cx) x1 = cx;
+   if (x2 > (cx + cw)) x2 = cx + cw;
+   if (x2 <= x1) return;
+   func(row + (x1 - rx), NULL, col, dp + x1, x2 - x1);
+}
+
+/* blit the bands of bi at x, y within dc's clip, one row at a time */
+static void
+_border_bands_draw(Borderitem *bi, RGBA_Image *dst, RGBA_Draw_Context *dc,
+                   int x, int y)
+{
+   RGBA_Gfx_Func func;
+   RGBA_Image *band;
+   DATA32 *dp;
+   int cx, cy, cw, ch, yy, ry, dst_w, vw;
+
+   cx = x; cy = y; cw = bi->w; ch = bi->h;
+   RECTS_CLIP_TO_RECT(cx, cy, cw, ch,
+                      0, 0, dst->cache_entry.w, dst->cache_entry.h);
+   if (dc->clip.use)
+     RECTS_CLIP_TO_RECT(cx, cy, cw, ch,
+                        dc->clip.x, dc->clip.y, dc->clip.w, dc->clip.h);
+   if ((cw <= 0) || (ch <= 0)) return;
+
+   band = bi->hband ? bi->hband : bi->vband;
+   if (dc->mul.use)
+     func = evas_common_gfx_func_composite_pixel_color_span_get(band, dc->mul.col, dst, cw, dc->render_op);
+   else
+     func = evas_common_gfx_func_composite_pixel_span_get(band, dst, cw, dc->render_op);
+
+   dst_w = dst->cache_entry.w;
+   vw = bi->sl + bi->sr;
+   dp = dst->image.data + (cy * dst_w);
+   for (yy = cy; yy < (cy + ch); yy++, dp += dst_w)
+     {
+#ifdef EVAS_SLI
+        if ((yy % dc->sli.h) != dc->sli.y) continue;
+#endif
+        ry = yy - y;
+        if (ry < bi->st)
+          _border_span(func, bi->hband->image.data + (ry * bi->w), x, bi->w,
+                       dp, cx, cw, dc->mul.col);
+        else if (ry >= (bi->h - bi->sb))
+          _border_span(func, bi->hband->image.data +
+                       ((ry - bi->h + bi->sb + bi->st) * bi->w), x, bi->w,
+                       dp, cx, cw, dc->mul.col);
+        else if (bi->vband)
+          {
+             DATA32 *row = bi->vband->image.data + ((ry - bi->st) * vw);
+
+             _border_span(func, row, x, bi->sl, dp, cx, cw, dc->mul.col);
+             _border_span(func, row + bi->sl, x + bi->w - bi->sr, bi->sr,
+                          dp, cx, cw, dc->mul.col);
+          }
+     }
+}
+
+#define BORDER_PREPARE 1 // tell the scale cache about the slice draws
+#define BORDER_DRAW    2 // and/or draw them
+
+static void
+_border_slice_draw(RGBA_Image *im, RGBA_Image *dst, RGBA_Draw_Context *dc,
+                   int mode, int smooth, int sx, int sy, int sw, int sh,
+                   int dx, int dy, int dw, int dh)
+{
+   if (mode & BORDER_PREPARE)
+     evas_common_rgba_image_scalecache_prepare(&im->cache_entry, dst, dc, smooth,
+                                               sx, sy, sw, sh, dx, dy, dw, dh);
+   if (mode & BORDER_DRAW)
+     evas_common_rgba_image_scalecache_do(&im->cache_entry, dst, dc, smooth,
+                                          sx, sy, sw, sh, dx, dy, dw, dh);
+}
+
+/* the bands for a border draw of im, made once the same draw has been seen
+ * min_border_uses times, loading im's data for that. NULL means the
+ * slices are drawn. the ref returned is dropped with
+ * evas_common_rgba_image_border_release() */
+EAPI void *
+evas_common_rgba_image_border_get(RGBA_Image *im, int smooth,
+                                  int l, int r, int t, int b,
+                                  int sl, int sr, int st, int sb,
+                                  int w, int h)
+{
+   Borderitem *bi;
+
+   if ((!init) || (im->cache_entry.scale_hint == EVAS_IMAGE_SCALE_HINT_DYNAMIC) ||
+       (!_border_cacheable(im, l, r, t, b, sl, sr, st, sb, w, h)))
+     return NULL;
+   LKL(im->cache.lock);
+   bi = _bi_find(im, smooth, l, r, t, b, sl, sr, st, sb, w, h);
+   if ((bi) && (!bi->ready) && (++bi->uses >= min_border_uses))
+     {
+        int size;
+
+        size = ((w * (st + sb)) + ((sl + sr) * (h - st - sb))) * sizeof(DATA32);
+        LKL(cache_lock);
+        if ((cache_size + size) <= max_cache_size)
+          cache_size += size;
+        else
+          size = 0;
+        LKU(cache_lock);
+        if (size > 0)
+          {
+             if (im->cache_entry.space == EVAS_COLORSPACE_ARGB8888)
+               evas_cache_image_load_data(&im->cache_entry);
+             evas_common_image_colorspace_normalize(im);
+             bi->size = size;
+             bi->ready = 1;
+             if ((!im->image.data) || (!_bi_populate(im, bi)))
+               {
+                  im->cache.borders = eina_list_remove(im->cache.borders, bi);
+                  _bi_unref(bi);
+                  bi = NULL;
+               }
+          }
+     }
+   if ((bi) && (!bi->ready)) bi = NULL;
+   if (bi) bi->ref++;
+   LKU(im->cache.lock);
+   return bi;
+}
+
+EAPI void
+evas_common_rgba_image_border_release(RGBA_Image *im, void *border)
+{
+   if (!border) return;
+   LKL(im->cache.lock);
+   _bi_unref(border);
+   LKU(im->cache.lock);
+}
+
+static void
+_border_draw(RGBA_Image *im, Borderitem *bi, RGBA_Image *dst,
+             RGBA_Draw_Context *dc, int mode, int smooth,
+             int l, int r, int t, int b,
+             int sl, int sr, int st, int sb, int fill,
+             int x, int y, int w, int h)
+{
+   Cutout_Rects *rects;
+   Cutout_Rect *rr;
+   int imw, imh, i, c, cx, cy, cw, ch;
+
+   if ((w <= 0) || (h <= 0)) return;
+   if (!(RECTS_INTERSECT(x, y, w, h,
+                         0, 0, dst->cache_entry.w, dst->cache_entry.h)))
+     return;
+   imw = im->cache_entry.w;
+   imh = im->cache_entry.h;
+
+   if (!bi)
+     {
+        // #--
+        // |
+        _border_slice_draw(im, dst, dc, mode, smooth,
+                           0, 0, l, t,
+                           x, y, sl, st);
+        // .##
+        // |
+        _border_slice_draw(im, dst, dc, mode, smooth,
+                           l, 0, imw - l - r, t,
+                           x + sl, y, w - sl - sr, st);
+        // --#
+        //   |
+        _border_slice_draw(im, dst, dc, mode, smooth,
+                           imw - r, 0, r, t,
+                           x + w - sr, y, sr, st);
+        // .--
+        // #
+        _border_slice_draw(im, dst, dc, mode, smooth,
+                           0, t, l, imh - t - b,
+                           x, y + st, sl, h - st - sb);
+     }
+   else if (mode & BORDER_DRAW)
+     {
+        c = dc->clip.use; cx = dc->clip.x; cy = dc->clip.y; cw = dc->clip.w; ch = dc->clip.h;
+        if (!dc->cutout.rects)
+          _border_bands_draw(bi, dst, dc, x, y);
+        else
+          {
+             evas_common_draw_context_clip_clip(dc, 0, 0, dst->cache_entry.w, dst->cache_entry.h);
+             evas_common_draw_context_clip_clip(dc, x, y, w, h);
+             if ((dc->clip.w > 0) && (dc->clip.h > 0))
+               {
+                  rects = evas_common_draw_context_apply_cutouts(dc);
+                  for (i = 0; i < rects->active; ++i)
+                    {
+                       rr = rects->rects + i;
+                       evas_common_draw_context_set_clip(dc, rr->x, rr->y, rr->w, rr->h);
+                       _border_bands_draw(bi, dst, dc, x, y);
+                    }
+                  evas_common_draw_context_apply_clear_cutouts(rects);
+               }
+          }
+        dc->clip.use = c; dc->clip.x = cx; dc->clip.y = cy; dc->clip.w = cw; dc->clip.h = ch;
+     }
+   // .--.
+   // |##|
+   if (fill > EVAS_BORDER_FILL_NONE)
+     {
+        if (fill == EVAS_BORDER_FILL_SOLID)
+          {
+             int op = dc->render_op;
+
+             evas_common_draw_context_set_render_op(dc, _EVAS_RENDER_COPY);
+             _border_slice_draw(im, dst, dc, mode, smooth,
+                                l, t, imw - l - r, imh - t - b,
+                                x + sl, y + st, w - sl - sr, h - st - sb);
+             evas_common_draw_context_set_render_op(dc, op);
+          }
+        else
+          _border_slice_draw(im, dst, dc, mode, smooth,
+                             l, t, imw - l - r, imh - t - b,
+                             x + sl, y + st, w - sl - sr, h - st - sb);
+     }
+   if (!bi)
+     {
+        // --.
+        //   #
+        _border_slice_draw(im, dst, dc, mode, smooth,
+                           imw - r, t, r, imh - t - b,
+                           x + w - sr, y + st, sr, h - st - sb);
+        // |
+        // #--
+        _border_slice_draw(im, dst, dc, mode, smooth,
+                           0, imh - b, l, b,
+                           x, y + h - sb, sl, sb);
+        // |
+        // .##
+        _border_slice_draw(im, dst, dc, mode, smooth,
+                           l, imh - b, imw - l - r, b,
+                           x + sl, y + h - sb, w - sl - sr, sb);
+        //   |
+        // --#
+        _border_slice_draw(im, dst, dc, mode, smooth,
+                           imw - r, imh - b, r, b,
+                           x + w - sr, y + h - sb, sr, sb);
+     }
+   evas_common_cpu_end_opt();
+}
+
+/* draw im with border l, r, t, b into x, y, w, h, the border taking sl,
+ * sr, st and sb on screen. fill is an Evas_Border_Fill_Mode - the middle
+ * is copied rather than blended for EVAS_BORDER_FILL_SOLID */
+EAPI void
+evas_common_rgba_image_border_draw(RGBA_Image *im, RGBA_Image *dst,
+                                   RGBA_Draw_Context *dc, int smooth,
+                                   int l, int r, int t, int b,
+                                   int sl, int sr, int st, int sb, int fill,
+                                   int x, int y, int w, int h)
+{
+   void *bi;
+
+   if ((w <= 0) || (h <= 0)) return;
+   if (!(RECTS_INTERSECT(x, y, w, h,
+                         0, 0, dst->cache_entry.w, dst->cache_entry.h)))
+     return;
+   bi = evas_common_rgba_image_border_get(im, smooth, l, r, t, b,
+                                          sl, sr, st, sb, w, h);
+   _border_draw(im, bi, dst, dc, BORDER_PREPARE | BORDER_DRAW, smooth,
+                l, r, t, b, sl, sr, st, sb, fill, x, y, w, h);
+   evas_common_rgba_image_border_release(im, bi);
+}
+
+/* the scale cache bookkeeping of a border draw with border (from
+ * evas_common_rgba_image_border_get()), without drawing anything. with
+ * this done once, evas_common_rgba_image_border_fill() can draw it from
+ * any number of threads */
+EAPI void
+evas_common_rgba_image_border_prepare(RGBA_Image *im, void *border,
+                                      RGBA_Image *dst, RGBA_Draw_Context *dc,
+                                      int smooth, int l, int r, int t, int b,
+                                      int sl, int sr, int st, int sb, int fill,
+                                      int x, int y, int w, int h)
+{
+   _border_draw(im, border, dst, dc, BORDER_PREPARE, smooth,
+                l, r, t, b, sl, sr, st, sb, fill, x, y, w, h);
+}
+
+EAPI void
+evas_common_rgba_image_border_fill(RGBA_Image *im, void *border,
+                                   RGBA_Image *dst, RGBA_Draw_Context *dc,
+                                   int smooth, int l, int r, int t, int b,
+                                   int sl, int sr, int st, int sb, int fill,
+                                   int x, int y, int w, int h)
+{
+   _border_draw(im, border, dst, dc, BORDER_DRAW, smooth,
+                l, r, t, b, sl, sr, st, sb, fill, x, y, w, h);
+}
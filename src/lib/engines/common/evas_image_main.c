@@ -92,6 +92,8 @@ evas_common_image_init(void)
    eet_init();
 #endif
    evas_common_scalecache_init();
+   evas_common_bordercache_init();
+   evas_common_image_tile_init();
 }
 
 EAPI void
@@ -122,6 +124,8 @@ evas_common_image_shutdown(void)
 #ifdef BUILD_LOADER_EET
    eet_shutdown();
 #endif
+   evas_common_image_tile_shutdown();
+   evas_common_bordercache_shutdown();
    evas_common_scalecache_shutdown();
 }
 
@@ -13,5 +13,12 @@ void evas_common_rgba_image_scalecache_shutdown(Image_Entry *ie);
 void evas_common_rgba_image_scalecache_dirty(Image_Entry *ie);
 void evas_common_rgba_image_scalecache_orig_use(Image_Entry *ie);
 int evas_common_rgba_image_scalecache_usage_get(Image_Entry *ie);
+
+void evas_common_bordercache_init(void);
+void evas_common_bordercache_shutdown(void);
+void evas_common_rgba_image_border_dirty(RGBA_Image *im);
+
+void evas_common_image_tile_init(void);
+void evas_common_image_tile_shutdown(void);
     
 #endif /* _EVAS_IMAGE_PRIVATE_H */
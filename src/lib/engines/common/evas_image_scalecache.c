@@ -27,12 +27,15 @@
 #define FLOP_DEL 1
 #define SCALE_CACHE_SIZE 4 * 1024 * 1024
 //#define SCALE_CACHE_SIZE 0
+#define SCALE_CACHE_SHARDS 8
 
 typedef struct _Scaleitem Scaleitem;
+typedef struct _Scaleshard Scaleshard;
 
 struct _Scaleitem
 {
    EINA_INLIST;
+   Eina_List *node; // our node in parent_im->cache.list
    unsigned long long usage;
    unsigned long long usage_count;
    RGBA_Image *im, *parent_im;
@@ -44,18 +47,33 @@ struct _Scaleitem
    RWLK(lock);
 #endif
    Eina_Bool forced_unload : 1;
-   Eina_Bool smooth : 1;
+   unsigned int smooth : 2; // 0, 1 or EVAS_SMOOTH_SCALE_MIPMAP
    Eina_Bool populate_me : 1;
 };
 
+/* the cache is split into shards to keep threads rendering different images
+ * off each other's locks. all scale items of one image live in the same
+ * shard (picked from the image pointer), so a shard lock nests inside the
+ * image cache lock exactly like the single global lock used to. each shard
+ * has its own lru of populated items and a hash of all its items keyed by
+ * (image, src region, dst size, smooth). the size budget is shared - a
+ * shard may grow past its share while the others are small. */
+struct _Scaleshard
+{
+#ifdef BUILD_PTHREAD
+   LK(lock);
+#endif
+   Eina_Inlist *lru; // populated items, least recently used first
+   Eina_Hash *items;
+   int size;
+   int count; // populated items
+   unsigned long long hits, misses, populates, evictions;
+};
+
 #ifdef SCALECACHE
 static unsigned long long use_counter = 0;
 
-#ifdef BUILD_PTHREAD
-static LK(cache_lock);
-#endif
-static Eina_Inlist *cache_list = NULL;
-static int cache_size = 0;
+static Scaleshard shards[SCALE_CACHE_SHARDS];
 static int init = 0;
 
 static int max_cache_size = SCALE_CACHE_SIZE;
@@ -63,6 +81,149 @@ static int max_dimension = MAX_SCALECACHE_DIM;
 static int max_flop_count = MAX_FLOP_COUNT;
 static int max_scale_items = MAX_SCALEITEMS;
 static int min_scale_uses = MIN_SCALE_USES;
+
+static int
+_sci_key_cmp(const Scaleitem *k1, int k1_length __UNUSED__,
+             const Scaleitem *k2, int k2_length __UNUSED__)
+{
+   if (k1->parent_im != k2->parent_im)
+     return (k1->parent_im < k2->parent_im) ? -1 : 1;
+   if (k1->src_x != k2->src_x) return k1->src_x - k2->src_x;
+   if (k1->src_y != k2->src_y) return k1->src_y - k2->src_y;
+   if (k1->src_w != k2->src_w) return k1->src_w - k2->src_w;
+   if (k1->src_h != k2->src_h) return k1->src_h - k2->src_h;
+   if (k1->dst_w != k2->dst_w) return k1->dst_w - k2->dst_w;
+   if (k1->dst_h != k2->dst_h) return k1->dst_h - k2->dst_h;
+   return (int)k1->smooth - (int)k2->smooth;
+}
+
+static int
+_sci_key_hash(const Scaleitem *key, int key_length __UNUSED__)
+{
+   unsigned long p = (unsigned long)key->parent_im;
+   int k[8];
+
+   k[0] = (int)p;
+   k[1] = (int)(p >> 16) ^ key->smooth;
+   k[2] = key->src_x;
+   k[3] = key->src_y;
+   k[4] = key->src_w;
+   k[5] = key->src_h;
+   k[6] = key->dst_w;
+   k[7] = key->dst_h;
+   return eina_hash_superfast((const char *)k, sizeof(k));
+}
+
+static Scaleshard *
+_shard_get(RGBA_Image *im)
+{
+   unsigned long p = (unsigned long)im;
+
+   return &(shards[((p >> 4) ^ (p >> 12)) % SCALE_CACHE_SHARDS]);
+}
+
+/* sizes of the other shards are read without their locks held - the
+ * budget is a soft limit anyway */
+static int
+_cache_size_get(void)
+{
+   int i, size = 0;
+
+   for (i = 0; i < SCALE_CACHE_SHARDS; i++) size += shards[i].size;
+   return size;
+}
+
+static int
+_sci_size(const Scaleitem *sci)
+{
+   if (!sci->forced_unload) return sci->dst_w * sci->dst_h * 4;
+   return sci->size_adjust;
+}
+
+/* mipmaps for EVAS_SMOOTH_SCALE_MIPMAP draws. im->cache.mipmap is im at
+ * half size (2x2 area average), its own cache.mipmap is im at a quarter
+ * and so on. a level is only made when a draw first needs it, and the
+ * chain goes with the scale items when im is dirtied or unloaded. levels
+ * count against the cache budget in im's shard, and lru items of that
+ * shard are evicted to make room for a new one. a level is still made if
+ * that isn't enough - it goes when im does, and until then its size keeps
+ * the cache from populating more than the budget allows */
+static void
+_mipmap_down(RGBA_Image *src, RGBA_Image *dst)
+{
+#ifdef BUILD_MMX
+   int mmx, sse, sse2;
+
+   evas_common_cpu_can_do(&mmx, &sse, &sse2);
+   if (mmx)
+     {
+        evas_common_scale_rgba_mipmap_down_2x2_mmx(src->image.data, dst->image.data,
+                                                   src->cache_entry.w, src->cache_entry.h);
+        evas_common_cpu_end_opt();
+        return;
+     }
+#endif
+#ifdef BUILD_C
+   evas_common_scale_rgba_mipmap_down_2x2_c(src->image.data, dst->image.data,
+                                            src->cache_entry.w, src->cache_entry.h);
+#endif
+}
+
+static Eina_Bool _cache_prune(Scaleshard *sh, Scaleitem *notsci, Eina_Bool copies_only, int max_size);
+
+/* the smallest level of im that is still at least dst size, with the src
+ * region moved onto it - so the smooth scaler has at most 2:1 left to do.
+ * im->cache.lock must be held, and im's shard lock too if sh_held */
+static RGBA_Image *
+_mipmap_find(RGBA_Image *im, int smooth,
+             int *src_region_x, int *src_region_y,
+             int *src_region_w, int *src_region_h,
+             int dst_region_w, int dst_region_h, Eina_Bool sh_held)
+{
+   RGBA_Image *lv = im, *nlv;
+   Scaleshard *shard;
+   int sw, sh, size;
+
+   if ((smooth != EVAS_SMOOTH_SCALE_MIPMAP) || (!im->image.data)) return im;
+   shard = _shard_get(im);
+   sw = *src_region_w;
+   sh = *src_region_h;
+   while (((sw >> 1) >= dst_region_w) && ((sh >> 1) >= dst_region_h) &&
+          (lv->cache_entry.w >= 2) && (lv->cache_entry.h >= 2))
+     {
+        if (!lv->cache.mipmap)
+          {
+             size = (lv->cache_entry.w >> 1) * (lv->cache_entry.h >> 1) * 4;
+             if (!sh_held) LKL(shard->lock);
+             _cache_prune(shard, NULL, 0, max_cache_size - size);
+             shard->size += size;
+             if (!sh_held) LKU(shard->lock);
+             nlv = evas_common_image_new(lv->cache_entry.w >> 1,
+                                         lv->cache_entry.h >> 1,
+                                         lv->cache_entry.flags.alpha);
+             if (!nlv)
+               {
+                  if (!sh_held) LKL(shard->lock);
+                  shard->size -= size;
+                  if (!sh_held) LKU(shard->lock);
+                  break;
+               }
+             _mipmap_down(lv, nlv);
+             lv->cache.mipmap = nlv;
+          }
+        lv = lv->cache.mipmap;
+        sw >>= 1;
+        sh >>= 1;
+     }
+   if (lv == im) return im;
+   *src_region_x = (*src_region_x * lv->cache_entry.w) / im->cache_entry.w;
+   *src_region_y = (*src_region_y * lv->cache_entry.h) / im->cache_entry.h;
+   *src_region_w = (*src_region_w * lv->cache_entry.w) / im->cache_entry.w;
+   *src_region_h = (*src_region_h * lv->cache_entry.h) / im->cache_entry.h;
+   if (*src_region_w < 1) *src_region_w = 1;
+   if (*src_region_h < 1) *src_region_h = 1;
+   return lv;
+}
 #endif
 
 void
@@ -70,11 +231,20 @@ evas_common_scalecache_init(void)
 {
 #ifdef SCALECACHE
    const char *s;
+   int i;
 
    init++;
    if (init > 1) return;
    use_counter = 0;
-   LKI(cache_lock);
+   for (i = 0; i < SCALE_CACHE_SHARDS; i++)
+     {
+        LKI(shards[i].lock);
+        shards[i].items = eina_hash_new(NULL,
+                                        EINA_KEY_CMP(_sci_key_cmp),
+                                        EINA_KEY_HASH(_sci_key_hash),
+                                        NULL,
+                                        6);
+     }
    s = getenv("EVAS_SCALECACHE_SIZE");
    if (s) max_cache_size = atoi(s) * 1024;
    s = getenv("EVAS_SCALECACHE_MAX_DIMENSION");
@@ -92,9 +262,18 @@ void
 evas_common_scalecache_shutdown(void)
 {
 #ifdef SCALECACHE
+   int i;
+
    init--;
-   if (init ==0)
-      LKD(cache_lock);
+   if (init == 0)
+     {
+        for (i = 0; i < SCALE_CACHE_SHARDS; i++)
+          {
+             eina_hash_free(shards[i].items);
+             shards[i].items = NULL;
+             LKD(shards[i].lock);
+          }
+     }
 #endif
 }
 
@@ -122,6 +301,7 @@ evas_common_rgba_image_scalecache_dirty(Image_Entry *ie)
 {
 #ifdef SCALECACHE
    RGBA_Image *im = (RGBA_Image *)ie;
+   Scaleshard *sh = _shard_get(im);
    LKL(im->cache.lock);
    while (im->cache.list)
      {
@@ -130,25 +310,46 @@ evas_common_rgba_image_scalecache_dirty(Image_Entry *ie)
 #ifdef EVAS_FRAME_QUEUING
         WRLKL(sci->lock);
 #endif
-        im->cache.list = eina_list_remove(im->cache.list, sci);
+        im->cache.list = eina_list_remove_list(im->cache.list, im->cache.list);
+        LKL(sh->lock);
+        eina_hash_del(sh->items, sci, sci);
         if (sci->im)
           {
 //             INF(" 0- %i", sci->dst_w * sci->dst_h * 4);
-             LKL(cache_lock);
              evas_common_rgba_image_free(&sci->im->cache_entry);
-             if (!sci->forced_unload)
-               cache_size -= sci->dst_w * sci->dst_h * 4;
-             else
-               cache_size -= sci->size_adjust;
-             cache_list = eina_inlist_remove(cache_list, (Eina_Inlist *)sci);
-             LKU(cache_lock);
+             sh->size -= _sci_size(sci);
+             sh->count--;
+             sh->lru = eina_inlist_remove(sh->lru, (Eina_Inlist *)sci);
           }
+        LKU(sh->lock);
 #ifdef EVAS_FRAME_QUEUING
          RWLKU(sci->lock);
          RWLKD(sci->lock);
 #endif
         free(sci);
      }
+   if (im->cache.mipmap)
+     {
+        RGBA_Image *lv, *nlv;
+        int size = 0;
+
+        // the whole chain is accounted to im's shard, so unhook each level
+        // before freeing it - its own dirty then has nothing to do
+        lv = im->cache.mipmap;
+        im->cache.mipmap = NULL;
+        while (lv)
+          {
+             nlv = lv->cache.mipmap;
+             lv->cache.mipmap = NULL;
+             size += lv->cache_entry.w * lv->cache_entry.h * 4;
+             evas_common_rgba_image_free(&lv->cache_entry);
+             lv = nlv;
+          }
+        LKL(sh->lock);
+        sh->size -= size;
+        LKU(sh->lock);
+     }
+   evas_common_rgba_image_border_dirty(im);
    LKU(im->cache.lock);
 #endif
 }
@@ -172,7 +373,7 @@ int
 evas_common_rgba_image_scalecache_usage_get(Image_Entry *ie)
 {
 #ifdef SCALECACHE
-   RGBA_Image *im = (RGBA_Image *)ie;
+   RGBA_Image *im = (RGBA_Image *)ie, *lv;
    int size = 0;
    Eina_List *l;
    Scaleitem *sci;
@@ -181,6 +382,8 @@ evas_common_rgba_image_scalecache_usage_get(Image_Entry *ie)
      {
         if (sci->im) size += sci->dst_w * sci->dst_h * 4;
      }
+   for (lv = im->cache.mipmap; lv; lv = lv->cache.mipmap)
+     size += lv->cache_entry.w * lv->cache_entry.h * 4;
    LKU(im->cache.lock);
    return size;
 #else
@@ -208,7 +411,7 @@ _sci_fix_newest(RGBA_Image *im)
 }
 
 static Scaleitem *
-_sci_find(RGBA_Image *im,
+_sci_find(Scaleshard *sh, RGBA_Image *im,
           RGBA_Draw_Context *dc __UNUSED__, int smooth,
           int src_region_x, int src_region_y,
           int src_region_w, int src_region_h,
@@ -216,26 +419,26 @@ _sci_find(RGBA_Image *im,
 {
    Eina_List *l;
    Scaleitem *sci;
+   Scaleitem key;
 
-   EINA_LIST_FOREACH(im->cache.list, l, sci)
+   key.parent_im = im;
+   key.smooth = smooth;
+   key.src_x = src_region_x;
+   key.src_y = src_region_y;
+   key.src_w = src_region_w;
+   key.src_h = src_region_h;
+   key.dst_w = dst_region_w;
+   key.dst_h = dst_region_h;
+   sci = eina_hash_find(sh->items, &key);
+   if (sci)
      {
-        if (
-            (sci->src_w == src_region_w) &&
-            (sci->src_h == src_region_h) &&
-            (sci->dst_w == dst_region_w) &&
-            (sci->dst_h == dst_region_h) &&
-            (sci->src_x == src_region_x) &&
-            (sci->src_y == src_region_y) &&
-            (sci->smooth == smooth)
-            )
+        if (im->cache.list != sci->node)
           {
-             if (im->cache.list != l)
-               {
-                  im->cache.list = eina_list_remove_list(im->cache.list, l);
-                  im->cache.list = eina_list_prepend(im->cache.list, sci);
-               }
-             return sci;
+             im->cache.list = eina_list_remove_list(im->cache.list, sci->node);
+             im->cache.list = eina_list_prepend(im->cache.list, sci);
+             sci->node = im->cache.list;
           }
+        return sci;
      }
    if (eina_list_count(im->cache.list) > max_scale_items)
      {
@@ -245,23 +448,30 @@ _sci_find(RGBA_Image *im,
         WRLKL(sci->lock);
 #endif
         im->cache.list = eina_list_remove_list(im->cache.list, l);
+        eina_hash_del(sh->items, sci, sci);
         if ((sci->usage == im->cache.newest_usage) ||
             (sci->usage_count == im->cache.newest_usage_count))
           _sci_fix_newest(im);
         if (sci->im)
           {
              evas_common_rgba_image_free(&sci->im->cache_entry);
-             if (!sci->forced_unload)
-               cache_size -= sci->dst_w * sci->dst_h * 4;
-             else
-               cache_size -= sci->size_adjust;
+             sh->size -= _sci_size(sci);
+             sh->count--;
+             sh->evictions++;
 //             INF(" 1- %i", sci->dst_w * sci->dst_h * 4);
-             cache_list = eina_inlist_remove(cache_list, (Eina_Inlist *)sci);
+             sh->lru = eina_inlist_remove(sh->lru, (Eina_Inlist *)sci);
           }
 #ifdef EVAS_FRAME_QUEUING
         RWLKU(sci->lock);
 #endif
-        if (max_scale_items < 1) return NULL;
+        if (max_scale_items < 1)
+          {
+#ifdef EVAS_FRAME_QUEUING
+             RWLKD(sci->lock);
+#endif
+             free(sci);
+             return NULL;
+          }
      }
    else
      {
@@ -290,24 +500,29 @@ _sci_find(RGBA_Image *im,
    sci->dst_w = dst_region_w;
    sci->dst_h = dst_region_h;
    im->cache.list = eina_list_prepend(im->cache.list, sci);
+   sci->node = im->cache.list;
+   eina_hash_direct_add(sh->items, sci, sci);
    return sci;
 }
 
-static void
-_cache_prune(Scaleitem *notsci, Eina_Bool copies_only)
+/* evict from the lru of shard sh (locked by the caller) until the whole
+ * cache is within max_size. returns EINA_FALSE if the shard ran out of
+ * items it may evict before that */
+static Eina_Bool
+_cache_prune(Scaleshard *sh, Scaleitem *notsci, Eina_Bool copies_only, int max_size)
 {
    Scaleitem *sci;
-   while (cache_size > max_cache_size)
+   while (_cache_size_get() > max_size)
      {
-        if (!cache_list) break;
-        sci = (Scaleitem *)(cache_list);
+        if (!sh->lru) return EINA_FALSE;
+        sci = (Scaleitem *)(sh->lru);
         if (copies_only)
           {
              while ((sci) && (!sci->parent_im->image.data))
                sci = (Scaleitem *)(((Eina_Inlist *)sci)->next);
-             if (!sci) return;
+             if (!sci) return EINA_FALSE;
           }
-        if (sci == notsci) return;
+        if (sci == notsci) return EINA_FALSE;
 #ifdef EVAS_FRAME_QUEUING
         WRLKL(sci->lock);
 #endif
@@ -318,20 +533,59 @@ _cache_prune(Scaleitem *notsci, Eina_Bool copies_only)
              sci->usage = 0;
              sci->usage_count = 0;
              sci->flop += FLOP_ADD;
-             if (!sci->forced_unload)
-               cache_size -= sci->dst_w * sci->dst_h * 4;
-             else
-               cache_size -= sci->size_adjust;
+             sh->size -= _sci_size(sci);
+             sh->count--;
+             sh->evictions++;
 //             INF(" 2- %i", sci->dst_w * sci->dst_h * 4);
-             cache_list = eina_inlist_remove(cache_list, (Eina_Inlist *)sci);
+             sh->lru = eina_inlist_remove(sh->lru, (Eina_Inlist *)sci);
              memset(sci, 0, sizeof(Eina_Inlist));
           }
 #ifdef EVAS_FRAME_QUEUING
         RWLKU(sci->lock);
 #endif
 
-//        INF("FLUSH %i > %i", cache_size, max_cache_size);
+//        INF("FLUSH %i > %i", _cache_size_get(), max_size);
       }
+   return EINA_TRUE;
+}
+
+/* the shard sh (locked by the caller) could not get the cache back within
+ * budget on its own, so take from the others. they are only try-locked -
+ * we already hold a shard lock and must not wait on another */
+static void
+_cache_prune_others(Scaleshard *sh)
+{
+   int i;
+
+   for (i = 0; i < SCALE_CACHE_SHARDS; i++)
+     {
+        Scaleshard *sh2 = &(shards[i]);
+        Eina_Bool done;
+        int busy = 0;
+
+        if (sh2 == sh) continue;
+        if (!sh2->lru) continue;
+#ifdef BUILD_PTHREAD
+        busy = LKT(sh2->lock);
+#endif
+        if (busy) continue;
+        done = _cache_prune(sh2, NULL, 0, max_cache_size);
+        LKU(sh2->lock);
+        if (done) return;
+     }
+}
+
+static void
+_cache_prune_all(Eina_Bool copies_only, int max_size)
+{
+   int i;
+
+   for (i = 0; i < SCALE_CACHE_SHARDS; i++)
+     {
+        LKL(shards[i].lock);
+        _cache_prune(&(shards[i]), NULL, copies_only, max_size);
+        LKU(shards[i].lock);
+     }
 }
 #endif
 
@@ -339,13 +593,11 @@ EAPI void
 evas_common_rgba_image_scalecache_size_set(int size)
 {
 #ifdef SCALECACHE
-   LKL(cache_lock);
    if (size != max_cache_size)
      {
         max_cache_size = size;
-        _cache_prune(NULL, 1);
+        _cache_prune_all(1, size);
      }
-   LKU(cache_lock);
 #endif   
 }
 
@@ -353,11 +605,7 @@ EAPI int
 evas_common_rgba_image_scalecache_size_get(void)
 {
 #ifdef SCALECACHE
-   int t;
-   LKL(cache_lock);
-   t = max_cache_size;
-   LKU(cache_lock);
-   return t;
+   return max_cache_size;
 #else
    return 0;
 #endif   
@@ -367,16 +615,36 @@ EAPI void
 evas_common_rgba_image_scalecache_flush(void)
 {
 #ifdef SCALECACHE
-   int t;
-   LKL(cache_lock);
-   t = max_cache_size;
-   max_cache_size = 0;
-   _cache_prune(NULL, 1);
-   max_cache_size = t;
-   LKU(cache_lock);
+   _cache_prune_all(1, 0);
 #endif   
 }
 
+EAPI void
+evas_common_rgba_image_scalecache_stats_get(RGBA_Image_Scalecache_Stats *stats)
+{
+#ifdef SCALECACHE
+   int i;
+#endif
+
+   memset(stats, 0, sizeof(RGBA_Image_Scalecache_Stats));
+#ifdef SCALECACHE
+   stats->max_size = max_cache_size;
+   for (i = 0; i < SCALE_CACHE_SHARDS; i++)
+     {
+        Scaleshard *sh = &(shards[i]);
+
+        LKL(sh->lock);
+        stats->size += sh->size;
+        stats->count += sh->count;
+        stats->hits += sh->hits;
+        stats->misses += sh->misses;
+        stats->populates += sh->populates;
+        stats->evictions += sh->evictions;
+        LKU(sh->lock);
+     }
+#endif
+}
+
 EAPI void
 evas_common_rgba_image_scalecache_prepare(Image_Entry *ie, RGBA_Image *dst __UNUSED__,
                                           RGBA_Draw_Context *dc, int smooth,
@@ -387,6 +655,7 @@ evas_common_rgba_image_scalecache_prepare(Image_Entry *ie, RGBA_Image *dst __UNU
 {
 #ifdef SCALECACHE
    RGBA_Image *im = (RGBA_Image *)ie;
+   Scaleshard *sh = _shard_get(im);
    Scaleitem *sci;
    if (!im->image.data) return;
    if ((dst_region_w == 0) || (dst_region_h == 0) ||
@@ -410,13 +679,13 @@ evas_common_rgba_image_scalecache_prepare(Image_Entry *ie, RGBA_Image *dst __UNU
         LKU(im->cache.lock);
         return;
      }
-   LKL(cache_lock);
-   sci = _sci_find(im, dc, smooth, 
+   LKL(sh->lock);
+   sci = _sci_find(sh, im, dc, smooth, 
                    src_region_x, src_region_y, src_region_w, src_region_h, 
                    dst_region_w, dst_region_h);
    if (!sci)
      {
-        LKU(cache_lock);
+        LKU(sh->lock);
         LKU(im->cache.lock);
         return;
      }
@@ -445,7 +714,7 @@ evas_common_rgba_image_scalecache_prepare(Image_Entry *ie, RGBA_Image *dst __UNU
      }
    sci->usage++;
    sci->usage_count = use_counter;
-   LKU(cache_lock);
+   LKU(sh->lock);
    if (sci->usage > im->cache.newest_usage) 
      im->cache.newest_usage = sci->usage;
 //   INF("newset? %p %i > %i", im, 
@@ -475,9 +744,12 @@ evas_common_rgba_image_scalecache_do(Image_Entry *ie, RGBA_Image *dst,
 {
 #ifdef SCALECACHE
    RGBA_Image *im = (RGBA_Image *)ie;
+   RGBA_Image *lv;
+   Scaleshard *sh = _shard_get(im);
    Scaleitem *sci;
    int didpop = 0;
    int dounload = 0;
+   int lx, ly, lw, lh;
 /*
    static int i = 0;
 
@@ -521,11 +793,12 @@ evas_common_rgba_image_scalecache_do(Image_Entry *ie, RGBA_Image *dst,
           }
         return;
      }
-   LKL(cache_lock);
-   sci = _sci_find(im, dc, smooth,
+   LKL(sh->lock);
+   sci = _sci_find(sh, im, dc, smooth,
                    src_region_x, src_region_y, src_region_w, src_region_h,
                    dst_region_w, dst_region_h);
-   LKU(cache_lock);
+   if (!sci) sh->misses++;
+   LKU(sh->lock);
    if (!sci)
      {
 #ifdef EVAS_FRAME_QUEUING
@@ -537,13 +810,16 @@ evas_common_rgba_image_scalecache_do(Image_Entry *ie, RGBA_Image *dst,
              evas_common_image_colorspace_normalize(im);
           }
 //        misses++;
+        lx = src_region_x;  ly = src_region_y;
+        lw = src_region_w;  lh = src_region_h;
+        lv = _mipmap_find(im, smooth, &lx, &ly, &lw, &lh,
+                          dst_region_w, dst_region_h, EINA_FALSE);
         LKU(im->cache.lock);
         if (im->image.data)
           {
              if (smooth)
-               evas_common_scale_rgba_in_to_out_clip_smooth(im, dst, dc,
-                                                            src_region_x, src_region_y, 
-                                                            src_region_w, src_region_h,
+               evas_common_scale_rgba_in_to_out_clip_smooth(lv, dst, dc,
+                                                            lx, ly, lw, lh,
                                                             dst_region_x, dst_region_y, 
                                                             dst_region_w, dst_region_h);
              else
@@ -588,7 +864,7 @@ evas_common_rgba_image_scalecache_do(Image_Entry *ie, RGBA_Image *dst,
         else
           {
              size *= sizeof(DATA32);
-             if ((cache_size + size) > max_cache_size)
+             if ((_cache_size_get() + size) > max_cache_size)
                {
                   sci->populate_me = 0;
                   im->cache.populate_count--;
@@ -604,7 +880,7 @@ evas_common_rgba_image_scalecache_do(Image_Entry *ie, RGBA_Image *dst,
           {
              static RGBA_Draw_Context *ct = NULL;
         
-             LKL(cache_lock);
+             LKL(sh->lock);
              im->cache.orig_usage++;
              im->cache.usage_count = use_counter;
              im->cache.populate_count--;
@@ -621,11 +897,14 @@ evas_common_rgba_image_scalecache_do(Image_Entry *ie, RGBA_Image *dst,
              evas_common_image_colorspace_normalize(im);
              if (im->image.data)
                {
+                  lx = src_region_x;  ly = src_region_y;
+                  lw = src_region_w;  lh = src_region_h;
+                  lv = _mipmap_find(im, smooth, &lx, &ly, &lw, &lh,
+                                    dst_region_w, dst_region_h, EINA_TRUE);
                   if (smooth)
                     evas_common_scale_rgba_in_to_out_clip_smooth
-                    (im, sci->im, ct,
-                     src_region_x, src_region_y, 
-                     src_region_w, src_region_h,
+                    (lv, sci->im, ct,
+                     lx, ly, lw, lh,
                      0, 0,
                      dst_region_w, dst_region_h);
                   else
@@ -661,21 +940,17 @@ evas_common_rgba_image_scalecache_do(Image_Entry *ie, RGBA_Image *dst,
                     }
 #endif                  
                }
-             if (dounload)
-               {
-                  sci->forced_unload = 1;
-                  cache_size += sci->size_adjust;
-               }
-             else
-               {
-                  cache_size += sci->dst_w * sci->dst_h * 4;
-               }
+             if (dounload) sci->forced_unload = 1;
+             sh->size += _sci_size(sci);
+             sh->count++;
+             sh->populates++;
 //             INF(" + %i @ flop: %i (%ix%i)", 
 //                    sci->dst_w * sci->dst_h * 4, sci->flop, 
 //                    sci->dst_w, sci->dst_h);
-             cache_list = eina_inlist_append(cache_list, (Eina_Inlist *)sci);
-             _cache_prune(sci, 0);
-             LKU(cache_lock);
+             sh->lru = eina_inlist_append(sh->lru, (Eina_Inlist *)sci);
+             if (!_cache_prune(sh, sci, 0, max_cache_size))
+               _cache_prune_others(sh);
+             LKU(sh->lock);
              didpop = 1;
           }
      }
@@ -683,10 +958,10 @@ evas_common_rgba_image_scalecache_do(Image_Entry *ie, RGBA_Image *dst,
      {
         if (!didpop)
           {
-	     LKL(cache_lock);
-             cache_list = eina_inlist_remove(cache_list, (Eina_Inlist *)sci);
-             cache_list = eina_inlist_append(cache_list, (Eina_Inlist *)sci);
-	     LKU(cache_lock);
+	     LKL(sh->lock);
+             sh->lru = eina_inlist_demote(sh->lru, (Eina_Inlist *)sci);
+             sh->hits++;
+	     LKU(sh->lock);
           }
         else
           {
@@ -738,6 +1013,9 @@ evas_common_rgba_image_scalecache_do(Image_Entry *ie, RGBA_Image *dst,
      }
    else
      {
+        LKL(sh->lock);
+        sh->misses++;
+        LKU(sh->lock);
 #ifdef EVAS_FRAME_QUEUING
         if (!evas_common_frameq_enabled())
 #endif
@@ -747,13 +1025,16 @@ evas_common_rgba_image_scalecache_do(Image_Entry *ie, RGBA_Image *dst,
              evas_common_image_colorspace_normalize(im);
           }
 //        misses++;
+        lx = src_region_x;  ly = src_region_y;
+        lw = src_region_w;  lh = src_region_h;
+        lv = _mipmap_find(im, smooth, &lx, &ly, &lw, &lh,
+                          dst_region_w, dst_region_h, EINA_FALSE);
         LKU(im->cache.lock);
         if (im->image.data)
           {
              if (smooth)
-               evas_common_scale_rgba_in_to_out_clip_smooth(im, dst, dc,
-                                                            src_region_x, src_region_y, 
-                                                            src_region_w, src_region_h,
+               evas_common_scale_rgba_in_to_out_clip_smooth(lv, dst, dc,
+                                                            lx, ly, lw, lh,
                                                             dst_region_x, dst_region_y, 
                                                             dst_region_w, dst_region_h);
              else
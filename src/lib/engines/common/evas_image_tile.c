@@ -0,0 +1,215 @@
+/*
+ * vim:ts=8:sw=3:sts=8:noexpandtab:cino=>5n-3f0^-2{2
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "evas_common.h"
+#include "evas_private.h"
+#include "evas_blend_private.h"
+#include "evas_image_private.h"
+
+/* repeating (tiled) image fills.
+ *
+ * the image is scaled to the tile size once per draw - through the scale
+ * cache, so a fill that stays the same size is a copy out of the cache -
+ * and then every dst row is filled from one tile row, left to right, with
+ * the span function picked once for the whole draw. narrow tiles are
+ * first repeated across a wider buffer so a row isn't dozens of tiny
+ * span calls. the pipe builds the tile once per op, before its threads
+ * start, and has them all fill from it. */
+
+/* tiles narrower than this are widened to a multiple of their width at
+ * least this wide, if that stays under TILE_WIDE_MAX pixels */
+#define TILE_MIN_SPAN 256
+#define TILE_WIDE_MAX (256 * 1024)
+
+static int init = 0;
+static RGBA_Draw_Context *ct = NULL; // copy op for scaling into tiles
+
+void
+evas_common_image_tile_init(void)
+{
+   init++;
+   if (init > 1) return;
+   ct = evas_common_draw_context_new();
+   if (ct) evas_common_draw_context_set_render_op(ct, _EVAS_RENDER_COPY);
+}
+
+void
+evas_common_image_tile_shutdown(void)
+{
+   init--;
+   if (init > 0) return;
+   if (ct) evas_common_draw_context_free(ct);
+   ct = NULL;
+}
+
+/* fill x, y, w, h (within dc's clip) with tile, repeated every tw x th
+ * pixels from x, y. tile may be wider than tw - whole repeats of it */
+static void
+_tile_draw_internal(RGBA_Image *tile, int tw, int th, RGBA_Image *dst,
+                    RGBA_Draw_Context *dc, int x, int y, int w, int h)
+{
+   RGBA_Gfx_Func func;
+   DATA32 *dp, *sp;
+   int cx, cy, cw, ch, yy, ty, tx, ww, len, n, dst_w;
+
+   cx = x; cy = y; cw = w; ch = h;
+   RECTS_CLIP_TO_RECT(cx, cy, cw, ch,
+                      0, 0, dst->cache_entry.w, dst->cache_entry.h);
+   if (dc->clip.use)
+     RECTS_CLIP_TO_RECT(cx, cy, cw, ch,
+                        dc->clip.x, dc->clip.y, dc->clip.w, dc->clip.h);
+   if ((cw <= 0) || (ch <= 0)) return;
+
+   if (dc->mul.use)
+     func = evas_common_gfx_func_composite_pixel_color_span_get(tile, dc->mul.col, dst, cw, dc->render_op);
+   else
+     func = evas_common_gfx_func_composite_pixel_span_get(tile, dst, cw, dc->render_op);
+
+   ww = tile->cache_entry.w;
+   dst_w = dst->cache_entry.w;
+   tx = (cx - x) % tw;
+   ty = (cy - y) % th;
+   dp = dst->image.data + (cy * dst_w) + cx;
+   for (yy = cy; yy < (cy + ch); yy++, dp += dst_w)
+     {
+#ifdef EVAS_SLI
+        if ((yy % dc->sli.h) == dc->sli.y)
+#endif
+          {
+             sp = tile->image.data + (ty * ww);
+             // first (partial) run from tx, then whole runs of ww
+             len = ww - tx;
+             if (len > cw) len = cw;
+             func(sp + tx, NULL, dc->mul.col, dp, len);
+             for (n = len; n < cw; n += len)
+               {
+                  len = cw - n;
+                  if (len > ww) len = ww;
+                  func(sp, NULL, dc->mul.col, dp + n, len);
+               }
+          }
+        if (++ty == th) ty = 0;
+     }
+}
+
+/* im at tw x th, repeated across to at least TILE_MIN_SPAN pixels if it's
+ * narrower. returns im itself when it's usable as is, otherwise a new
+ * image the caller frees. im's data has to be loaded already when this
+ * runs on a pipe thread */
+EAPI RGBA_Image *
+evas_common_rgba_image_tile_get(RGBA_Image *im, int smooth, int tw, int th)
+{
+   RGBA_Image *tile;
+   DATA32 *row;
+   int ww, y, n;
+
+   ww = tw;
+   if (tw < TILE_MIN_SPAN)
+     {
+        ww = tw * ((TILE_MIN_SPAN + tw - 1) / tw);
+        if ((ww * th) > TILE_WIDE_MAX) ww = tw;
+     }
+   if ((ww == tw) &&
+       (tw == im->cache_entry.w) && (th == im->cache_entry.h))
+     {
+        if (im->cache_entry.space == EVAS_COLORSPACE_ARGB8888)
+          evas_cache_image_load_data(&im->cache_entry);
+        evas_common_image_colorspace_normalize(im);
+        return im->image.data ? im : NULL;
+     }
+
+   if (!ct) return NULL;
+   tile = evas_common_image_new(ww, th, im->cache_entry.flags.alpha);
+   if (!tile) return NULL;
+   memset(tile->image.data, 0, ww * th * sizeof(DATA32));
+   evas_common_rgba_image_scalecache_prepare(&im->cache_entry, tile, ct, smooth,
+                                             0, 0, im->cache_entry.w, im->cache_entry.h,
+                                             0, 0, tw, th);
+   evas_common_rgba_image_scalecache_do(&im->cache_entry, tile, ct, smooth,
+                                        0, 0, im->cache_entry.w, im->cache_entry.h,
+                                        0, 0, tw, th);
+   for (y = 0, row = tile->image.data; y < th; y++, row += ww)
+     {
+        for (n = tw; n < ww; n += tw)
+          memcpy(row + n, row, tw * sizeof(DATA32));
+     }
+   return tile;
+}
+
+/* fill x, y, w, h with tile (from evas_common_rgba_image_tile_get() for
+ * tile_w x tile_h) repeated, the first tile at x, y */
+EAPI void
+evas_common_rgba_image_tile_fill(RGBA_Image *tile, RGBA_Image *dst,
+                                 RGBA_Draw_Context *dc,
+                                 int tile_w, int tile_h,
+                                 int x, int y, int w, int h)
+{
+   Cutout_Rects *rects;
+   Cutout_Rect *r;
+   int i, c, cx, cy, cw, ch;
+
+   if ((w <= 0) || (h <= 0) || (tile_w <= 0) || (tile_h <= 0)) return;
+   if (!(RECTS_INTERSECT(x, y, w, h,
+                         0, 0, dst->cache_entry.w, dst->cache_entry.h)))
+     return;
+   if (dc->clip.use)
+     {
+        if (!(RECTS_INTERSECT(x, y, w, h,
+                              dc->clip.x, dc->clip.y, dc->clip.w, dc->clip.h)))
+          return;
+     }
+
+   if (!dc->cutout.rects)
+     _tile_draw_internal(tile, tile_w, tile_h, dst, dc, x, y, w, h);
+   else
+     {
+        c = dc->clip.use; cx = dc->clip.x; cy = dc->clip.y; cw = dc->clip.w; ch = dc->clip.h;
+        evas_common_draw_context_clip_clip(dc, 0, 0, dst->cache_entry.w, dst->cache_entry.h);
+        evas_common_draw_context_clip_clip(dc, x, y, w, h);
+        if ((dc->clip.w > 0) && (dc->clip.h > 0))
+          {
+             rects = evas_common_draw_context_apply_cutouts(dc);
+             for (i = 0; i < rects->active; ++i)
+               {
+                  r = rects->rects + i;
+                  evas_common_draw_context_set_clip(dc, r->x, r->y, r->w, r->h);
+                  _tile_draw_internal(tile, tile_w, tile_h, dst, dc, x, y, w, h);
+               }
+             evas_common_draw_context_apply_clear_cutouts(rects);
+          }
+        dc->clip.use = c; dc->clip.x = cx; dc->clip.y = cy; dc->clip.w = cw; dc->clip.h = ch;
+     }
+   evas_common_cpu_end_opt();
+}
+
+/* fill x, y, w, h with im scaled to tile_w x tile_h and repeated, the
+ * first tile at x, y */
+EAPI void
+evas_common_rgba_image_tile_draw(RGBA_Image *im, RGBA_Image *dst,
+                                 RGBA_Draw_Context *dc, int smooth,
+                                 int tile_w, int tile_h,
+                                 int x, int y, int w, int h)
+{
+   RGBA_Image *tile;
+
+   if ((w <= 0) || (h <= 0) || (tile_w <= 0) || (tile_h <= 0)) return;
+   if (!(RECTS_INTERSECT(x, y, w, h,
+                         0, 0, dst->cache_entry.w, dst->cache_entry.h)))
+     return;
+   if (dc->clip.use)
+     {
+        if (!(RECTS_INTERSECT(x, y, w, h,
+                              dc->clip.x, dc->clip.y, dc->clip.w, dc->clip.h)))
+          return;
+     }
+
+   tile = evas_common_rgba_image_tile_get(im, smooth, tile_w, tile_h);
+   if (!tile) return;
+   evas_common_rgba_image_tile_fill(tile, dst, dc, tile_w, tile_h, x, y, w, h);
+   if (tile != im) evas_common_rgba_image_free(&tile->cache_entry);
+}
@@ -89,7 +89,8 @@ _calc_spans(RGBA_Map_Point *p, Line *spans, int ystart, int yend, int cx, int cy
    int i, y, yp;
    int py[4];
    int edge[4][4], edge_num, swapped, order[4];
-   FPc uv[4][2], u, v, x, h, t;
+   int nocol = 1, left, right;
+   FPc uv[4][2], eh[4], et[4], u, v, x, h, t;
    DATA32 col[4];
    
 #if 1 // maybe faster on x86?
@@ -142,10 +143,12 @@ _calc_spans(RGBA_Map_Point *p, Line *spans, int ystart, int yend, int cx, int cy
           }
         return;
      }
+   for (i = 0; i < 4; i++)
+     {
+        if (p[i].col != 0xffffffff) nocol = 0;
+     }
    for (y = ystart; y <= yend; y++)
      {
-        int nocol = 1;
-        
         yp = y - ystart;
         edge_num = 0;
         for (i = 0; i < 4; i++)
@@ -162,19 +165,47 @@ _calc_spans(RGBA_Map_Point *p, Line *spans, int ystart, int yend, int cx, int cy
                   edge[edge_num][1] = i;
                   edge_num++;
                }
-             if (p[i].col != 0xffffffff) nocol = 0;
+          }
+        if ((edge_num != 2) && (edge_num != 4))
+          {
+             spans[yp].span[0].x1 = -1;
+             continue;
           }
         // calculate line x points for each edge
+        left = cx + cw;
+        right = cx - 1;
         for (i = 0; i < edge_num; i++)
           {
              int e1 = edge[i][0];
              int e2 = edge[i][1];
-             FPc t256;
              
              h = (p[e2].y - p[e1].y) >> FP; // height of edge
              t = (((y << FP) + (FP1 - 1)) - p[e1].y) >> FP;
              x = p[e2].x - p[e1].x;
              x = p[e1].x + ((x * t) / h);
+             eh[i] = h;
+             et[i] = t;
+             edge[i][2] = x >> FP;
+             edge[i][3] = x;
+             if (edge[i][2] < left) left = edge[i][2];
+             if (edge[i][2] > right) right = edge[i][2];
+          }
+        // the whole line is left or right of the clip - skip the uv and
+        // color interpolation, no span of it would survive
+        if ((left >= (cx + cw)) || (right < cx))
+          {
+             spans[yp].span[0].x1 = -1;
+             continue;
+          }
+        // calculate line uv and color for each edge
+        for (i = 0; i < edge_num; i++)
+          {
+             int e1 = edge[i][0];
+             int e2 = edge[i][1];
+             FPc t256;
+             
+             h = eh[i];
+             t = et[i];
 
 /*             
              // FIXME: 3d accuracy here
@@ -235,8 +266,6 @@ _calc_spans(RGBA_Map_Point *p, Line *spans, int ystart, int yend, int cx, int cy
              // FIXME: store z persp
              uv[i][1] = v;
              uv[i][0] = u;
-             edge[i][2] = x >> FP;
-             edge[i][3] = x;
              // also fill in order
              order[i] = i;
           }
@@ -325,7 +354,89 @@ _calc_spans(RGBA_Map_Point *p, Line *spans, int ystart, int yend, int cx, int cy
      }
 }
 
+#ifdef BUILD_SSE2
+/* per pixel weights w[0..3] -> lo has w[0] in the 4 channels of pixel 0
+ * and w[1] in those of pixel 1, hi the same for pixels 2 and 3 */
+static inline EVAS_SSE2_FN void
+_map_weights_sse2(const int *w, __m128i *lo, __m128i *hi)
+{
+   __m128i x;
+
+   x = SSE2_LOAD(w);
+   x = _mm_packs_epi32(x, x);
+   x = _mm_unpacklo_epi16(x, x);
+   *lo = _mm_unpacklo_epi32(x, x);
+   *hi = _mm_unpackhi_epi32(x, x);
+}
+
+/* 4 bilinear samples at once. the span loop fetches the 2x2 texels of
+ * each (val[0..3] are top left, top right, bottom left, bottom right) and
+ * works out the weights the same way the C loop does, this does the
+ * interpolation and the optional color multiply. the last 0-3 pixels of
+ * a span go through the C loop, so the math is the C loop's: one
+ * horizontal and one vertical INTERP_256, then MUL4_SYM for color. the
+ * mmx loop's MUL4_SYM_R2R also rounds green, so with a color set green
+ * can be 1 off from the mmx output */
+static void EVAS_SSE2_FN
+_map_smooth4_sse2(DATA32 val[4][4], int *ru, int *rv, int *cw,
+                  DATA32 c1, DATA32 c2, DATA32 *d)
+{
+   __m128i p, l1, h1, l2, h2, l3, h3, l4, h4, al, ah;
+
+   p = SSE2_LOAD(val[0]);
+   SSE2_UNPACK(p, l1, h1)
+   p = SSE2_LOAD(val[1]);
+   SSE2_UNPACK(p, l2, h2)
+   p = SSE2_LOAD(val[2]);
+   SSE2_UNPACK(p, l3, h3)
+   p = SSE2_LOAD(val[3]);
+   SSE2_UNPACK(p, l4, h4)
+
+   _map_weights_sse2(ru, &al, &ah);
+   l1 = _evas_sse2_interp_256(al, l2, l1);
+   h1 = _evas_sse2_interp_256(ah, h2, h1);
+   l3 = _evas_sse2_interp_256(al, l4, l3);
+   h3 = _evas_sse2_interp_256(ah, h4, h3);
+   _map_weights_sse2(rv, &al, &ah);
+   l1 = _evas_sse2_interp_256(al, l3, l1);
+   h1 = _evas_sse2_interp_256(ah, h3, h1);
+   if (cw)
+     {
+        l2 = _mm_unpacklo_epi8(_mm_set1_epi32(c1), _mm_setzero_si128());
+        l4 = _mm_unpacklo_epi8(_mm_set1_epi32(c2), _mm_setzero_si128());
+        _map_weights_sse2(cw, &al, &ah);
+        l1 = _evas_sse2_mul4_sym(_evas_sse2_interp_256(al, l4, l2), l1);
+        h1 = _evas_sse2_mul4_sym(_evas_sse2_interp_256(ah, l4, l2), h1);
+     }
+   SSE2_STORE(d, SSE2_PACK(l1, h1));
+}
+
+/* 4 nearest samples times the color interpolated along the span */
+static void EVAS_SSE2_FN
+_map_col4_sse2(DATA32 *val, int *cw, DATA32 c1, DATA32 c2, DATA32 *d)
+{
+   __m128i p, l, h, vc1, vc2, al, ah;
+
+   p = SSE2_LOAD(val);
+   SSE2_UNPACK(p, l, h)
+   vc1 = _mm_unpacklo_epi8(_mm_set1_epi32(c1), _mm_setzero_si128());
+   vc2 = _mm_unpacklo_epi8(_mm_set1_epi32(c2), _mm_setzero_si128());
+   _map_weights_sse2(cw, &al, &ah);
+   l = _evas_sse2_mul4_sym(_evas_sse2_interp_256(al, vc2, vc1), l);
+   h = _evas_sse2_mul4_sym(_evas_sse2_interp_256(ah, vc2, vc1), h);
+   SSE2_STORE(d, SSE2_PACK(l, h));
+}
+#endif
+
 #ifdef BUILD_SCALE_SMOOTH
+# ifdef BUILD_SSE2
+#  undef FUNC_NAME
+#  define FUNC_NAME evas_common_map4_rgba_internal_sse2
+#  undef SCALE_USING_MMX
+#  define SCALE_USING_SSE2
+#  include "evas_map_image_internal.c"
+#  undef SCALE_USING_SSE2
+# endif
 # ifdef BUILD_MMX
 #  undef FUNC_NAME
 #  define FUNC_NAME evas_common_map4_rgba_internal_mmx
@@ -347,7 +458,7 @@ evas_common_map4_rgba(RGBA_Image *src, RGBA_Image *dst,
                       RGBA_Map_Point *p, 
                       int smooth, int level)
 {
-#ifdef BUILD_MMX
+#if defined(BUILD_MMX) || defined(BUILD_SSE2)
    int mmx, sse, sse2;
 #endif
    Cutout_Rects *rects;
@@ -359,11 +470,16 @@ evas_common_map4_rgba(RGBA_Image *src, RGBA_Image *dst,
      evas_cache_image_load_data(&src->cache_entry);
    evas_common_image_colorspace_normalize(src);
    if (!src->image.data) return;
-#ifdef BUILD_MMX
+#if defined(BUILD_MMX) || defined(BUILD_SSE2)
    evas_common_cpu_can_do(&mmx, &sse, &sse2);
 #endif   
    if ((!dc->cutout.rects) && (!dc->clip.use))
      {
+#ifdef BUILD_SSE2
+        if (sse2)
+          evas_common_map4_rgba_internal_sse2(src, dst, dc, p, smooth, level);
+        else
+#endif
 #ifdef BUILD_MMX
         if (mmx)
           evas_common_map4_rgba_internal_mmx(src, dst, dc, p, smooth, level);
@@ -388,6 +504,11 @@ evas_common_map4_rgba(RGBA_Image *src, RGBA_Image *dst,
      {
         r = rects->rects + i;
         evas_common_draw_context_set_clip(dc, r->x, r->y, r->w, r->h);
+#ifdef BUILD_SSE2
+        if (sse2)
+          evas_common_map4_rgba_internal_sse2(src, dst, dc, p, smooth, level);
+        else
+#endif
 #ifdef BUILD_MMX
         if (mmx)
           evas_common_map4_rgba_internal_mmx(src, dst, dc, p, smooth, level);
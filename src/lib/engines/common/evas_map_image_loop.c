@@ -3,6 +3,58 @@
  */
 #ifdef SMOOTH
 {
+# if defined(SCALE_USING_SSE2) && !defined(COLBLACK)
+   while (ww >= 4)
+     {
+        DATA32 val[4][4];
+        int ru4[4], rv4[4], k;
+#  ifdef COLMUL
+        int cv4[4]; // col
+#  endif
+
+        for (k = 0; k < 4; k++)
+          {
+             FPc u1, v1, u2, v2;
+
+             u1 = u;
+             if (u1 < 0) u1 = 0;
+             else if (u1 >= swp) u1 = swp - 1;
+
+             v1 = v;
+             if (v1 < 0) v1 = 0;
+             else if (v1 >= shp) v1 = shp - 1;
+
+             u2 = u1 + FPFPI1;
+             if (u2 >= swp) u2 = swp - 1;
+
+             v2 = v1 + FPFPI1;
+             if (v2 >= shp) v2 = shp - 1;
+
+             ru4[k] = (u >> (FP + FPI - 8)) & 0xff;
+             rv4[k] = (v >> (FP + FPI - 8)) & 0xff;
+
+             s = sp + ((v1 >> (FP + FPI)) * sw);
+             val[0][k] = *(s + (u1 >> (FP + FPI)));
+             val[1][k] = *(s + (u2 >> (FP + FPI)));
+             s = sp + ((v2 >> (FP + FPI)) * sw);
+             val[2][k] = *(s + (u1 >> (FP + FPI)));
+             val[3][k] = *(s + (u2 >> (FP + FPI)));
+#  ifdef COLMUL
+             cv4[k] = cv >> 16; // col
+             cv += cd; // col
+#  endif
+             u += ud;
+             v += vd;
+          }
+#  ifdef COLMUL
+        _map_smooth4_sse2(val, ru4, rv4, cv4, c1, c2, d); // col
+#  else
+        _map_smooth4_sse2(val, ru4, rv4, NULL, 0, 0, d);
+#  endif
+        d += 4;
+        ww -= 4;
+     }
+# endif
    while (ww > 0)
      {
 # ifdef COLBLACK
@@ -77,7 +129,7 @@
         *d   = MUL4_SYM(val2, val1); // col
         cv += cd; // col
 #   else                            
-        *d   = INTERP_256(rv, val3, val1);
+        *d   = val1;
 #   endif
 #  endif
         u += ud;
@@ -89,6 +141,27 @@
 }
 #else
 {
+# if defined(SCALE_USING_SSE2) && defined(COLMUL) && !defined(COLBLACK)
+   while (ww >= 4)
+     {
+        DATA32 val[4];
+        int cv4[4], k;
+
+        for (k = 0; k < 4; k++)
+          {
+             s = sp + ((v >> (FP + FPI)) * sw) + 
+               (u >> (FP + FPI));
+             val[k] = *s;
+             cv4[k] = cv >> 16; // col
+             cv += cd; // col
+             u += ud;
+             v += vd;
+          }
+        _map_col4_sse2(val, cv4, c1, c2, d); // col
+        d += 4;
+        ww -= 4;
+     }
+# endif
    while (ww > 0)
      {
 # ifdef COLMUL
@@ -0,0 +1,84 @@
+
+/* blend color --> dst */
+
+#ifdef BUILD_SSE2
+static void EVAS_SSE2_FN
+_op_blend_c_dp_sse2(DATA32 *s __UNUSED__, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3), a = 256 - (c >> 24);
+   __m128i vc, va, vd, dl, dh;
+
+   vc = _mm_unpacklo_epi8(_mm_set1_epi32(c), _mm_setzero_si128());
+   va = _mm_set1_epi16(a);
+   while (d < e)
+     {
+	vd = SSE2_LOAD(d);
+	SSE2_UNPACK(vd, dl, dh)
+	dl = _mm_add_epi16(vc, _evas_sse2_mul_256(va, dl));
+	dh = _mm_add_epi16(vc, _evas_sse2_mul_256(va, dh));
+	SSE2_STORE(d, SSE2_PACK(dl, dh));
+	d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     {
+	*d = c + MUL_256(a, *d);
+	d++;
+     }
+}
+
+#define _op_blend_caa_dp_sse2 _op_blend_c_dp_sse2
+
+#define _op_blend_c_dpan_sse2 _op_blend_c_dp_sse2
+#define _op_blend_caa_dpan_sse2 _op_blend_c_dpan_sse2
+
+static void
+init_blend_color_span_funcs_sse2(void)
+{
+   op_blend_span_funcs[SP_N][SM_N][SC][DP][CPU_SSE2] = _op_blend_c_dp_sse2;
+   op_blend_span_funcs[SP_N][SM_N][SC_AA][DP][CPU_SSE2] = _op_blend_caa_dp_sse2;
+
+   op_blend_span_funcs[SP_N][SM_N][SC][DP_AN][CPU_SSE2] = _op_blend_c_dpan_sse2;
+   op_blend_span_funcs[SP_N][SM_N][SC_AA][DP_AN][CPU_SSE2] = _op_blend_caa_dpan_sse2;
+}
+#endif
+
+#ifdef BUILD_AVX2
+static void EVAS_AVX2_FN
+_op_blend_c_dp_avx2(DATA32 *s __UNUSED__, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7), a = 256 - (c >> 24);
+   __m256i vc, va, vd, dl, dh;
+
+   vc = _mm256_unpacklo_epi8(_mm256_set1_epi32(c), _mm256_setzero_si256());
+   va = _mm256_set1_epi16(a);
+   while (d < e)
+     {
+	vd = AVX2_LOAD(d);
+	AVX2_UNPACK(vd, dl, dh)
+	dl = _mm256_add_epi16(vc, _evas_avx2_mul_256(va, dl));
+	dh = _mm256_add_epi16(vc, _evas_avx2_mul_256(va, dh));
+	AVX2_STORE(d, AVX2_PACK(dl, dh));
+	d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     {
+	*d = c + MUL_256(a, *d);
+	d++;
+     }
+}
+
+#define _op_blend_caa_dp_avx2 _op_blend_c_dp_avx2
+
+#define _op_blend_c_dpan_avx2 _op_blend_c_dp_avx2
+#define _op_blend_caa_dpan_avx2 _op_blend_c_dpan_avx2
+
+static void
+init_blend_color_span_funcs_avx2(void)
+{
+   op_blend_span_funcs[SP_N][SM_N][SC][DP][CPU_AVX2] = _op_blend_c_dp_avx2;
+   op_blend_span_funcs[SP_N][SM_N][SC_AA][DP][CPU_AVX2] = _op_blend_caa_dp_avx2;
+
+   op_blend_span_funcs[SP_N][SM_N][SC][DP_AN][CPU_AVX2] = _op_blend_c_dpan_avx2;
+   op_blend_span_funcs[SP_N][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_blend_caa_dpan_avx2;
+}
+#endif
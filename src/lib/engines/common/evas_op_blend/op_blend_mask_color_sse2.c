@@ -0,0 +1,203 @@
+
+/* blend mask x color -> dst */
+
+#ifdef BUILD_SSE2
+static void EVAS_SSE2_FN
+_op_blend_mas_c_dp_sse2(DATA32 *s __UNUSED__, DATA8 *m, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vc, vm, vd, ml, mh, dl, dh;
+   int alpha;
+
+   vc = _mm_unpacklo_epi8(_mm_set1_epi32(c), _mm_setzero_si128());
+   while (d < e)
+     {
+	vm = _evas_sse2_mask_load(m);
+	/* MUL_SYM(0, c) is 0, so fully masked runs can be skipped */
+	if (_mm_movemask_epi8(_mm_cmpeq_epi8(vm, _mm_setzero_si128())) != 0xffff)
+	  {
+	     vd = SSE2_LOAD(d);
+	     SSE2_UNPACK(vm, ml, mh)
+	     SSE2_UNPACK(vd, dl, dh)
+	     ml = _evas_sse2_mul_sym(ml, vc);
+	     mh = _evas_sse2_mul_sym(mh, vc);
+	     SSE2_STORE(d, SSE2_PACK(_evas_sse2_blend(ml, dl),
+	                             _evas_sse2_blend(mh, dh)));
+	  }
+	m += 4;  d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     {
+	DATA32 mc = MUL_SYM(*m, c);
+	alpha = 256 - (mc >> 24);
+	*d = mc + MUL_256(alpha, *d);
+	m++;  d++;
+     }
+}
+
+static void EVAS_SSE2_FN
+_op_blend_mas_can_dp_sse2(DATA32 *s __UNUSED__, DATA8 *m, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vc, vm, vz, vd, ml, mh, dl, dh, one;
+   int alpha;
+
+   vc = _mm_unpacklo_epi8(_mm_set1_epi32(c), _mm_setzero_si128());
+   one = _mm_set1_epi16(1);
+   while (d < e)
+     {
+	vm = _evas_sse2_mask_load(m);
+	vz = _mm_cmpeq_epi8(vm, _mm_setzero_si128());
+	if (_mm_movemask_epi8(vz) != 0xffff)
+	  {
+	     vd = SSE2_LOAD(d);
+	     SSE2_UNPACK(vm, ml, mh)
+	     SSE2_UNPACK(vd, dl, dh)
+	     ml = _evas_sse2_interp_256(_mm_add_epi16(ml, one), vc, dl);
+	     mh = _evas_sse2_interp_256(_mm_add_epi16(mh, one), vc, dh);
+	     /* a 0 mask leaves dst alone rather than interpolating by 1 */
+	     SSE2_STORE(d, _mm_or_si128(_mm_and_si128(vz, vd),
+	                                _mm_andnot_si128(vz, SSE2_PACK(ml, mh))));
+	  }
+	m += 4;  d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     {
+	alpha = *m;
+	switch(alpha)
+	  {
+	  case 0:
+	     break;
+	  case 255:
+	     *d = c;
+	     break;
+	  default:
+	     alpha++;
+	     *d = INTERP_256(alpha, c, *d);
+	     break;
+	  }
+	m++;  d++;
+     }
+}
+
+#define _op_blend_mas_cn_dp_sse2 _op_blend_mas_can_dp_sse2
+#define _op_blend_mas_caa_dp_sse2 _op_blend_mas_c_dp_sse2
+
+#define _op_blend_mas_c_dpan_sse2 _op_blend_mas_c_dp_sse2
+#define _op_blend_mas_cn_dpan_sse2 _op_blend_mas_cn_dp_sse2
+#define _op_blend_mas_can_dpan_sse2 _op_blend_mas_can_dp_sse2
+#define _op_blend_mas_caa_dpan_sse2 _op_blend_mas_caa_dp_sse2
+
+static void
+init_blend_mask_color_span_funcs_sse2(void)
+{
+   op_blend_span_funcs[SP_N][SM_AS][SC][DP][CPU_SSE2] = _op_blend_mas_c_dp_sse2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_N][DP][CPU_SSE2] = _op_blend_mas_cn_dp_sse2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AN][DP][CPU_SSE2] = _op_blend_mas_can_dp_sse2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AA][DP][CPU_SSE2] = _op_blend_mas_caa_dp_sse2;
+
+   op_blend_span_funcs[SP_N][SM_AS][SC][DP_AN][CPU_SSE2] = _op_blend_mas_c_dpan_sse2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_N][DP_AN][CPU_SSE2] = _op_blend_mas_cn_dpan_sse2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AN][DP_AN][CPU_SSE2] = _op_blend_mas_can_dpan_sse2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AA][DP_AN][CPU_SSE2] = _op_blend_mas_caa_dpan_sse2;
+}
+#endif
+
+#ifdef BUILD_AVX2
+static void EVAS_AVX2_FN
+_op_blend_mas_c_dp_avx2(DATA32 *s __UNUSED__, DATA8 *m, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vc, vm, vd, ml, mh, dl, dh;
+   int alpha;
+
+   vc = _mm256_unpacklo_epi8(_mm256_set1_epi32(c), _mm256_setzero_si256());
+   while (d < e)
+     {
+	vm = _evas_avx2_mask_load(m);
+	if (!_mm256_testz_si256(vm, vm))
+	  {
+	     vd = AVX2_LOAD(d);
+	     AVX2_UNPACK(vm, ml, mh)
+	     AVX2_UNPACK(vd, dl, dh)
+	     ml = _evas_avx2_mul_sym(ml, vc);
+	     mh = _evas_avx2_mul_sym(mh, vc);
+	     AVX2_STORE(d, AVX2_PACK(_evas_avx2_blend(ml, dl),
+	                             _evas_avx2_blend(mh, dh)));
+	  }
+	m += 8;  d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     {
+	DATA32 mc = MUL_SYM(*m, c);
+	alpha = 256 - (mc >> 24);
+	*d = mc + MUL_256(alpha, *d);
+	m++;  d++;
+     }
+}
+
+static void EVAS_AVX2_FN
+_op_blend_mas_can_dp_avx2(DATA32 *s __UNUSED__, DATA8 *m, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vc, vm, vz, vd, ml, mh, dl, dh, one;
+   int alpha;
+
+   vc = _mm256_unpacklo_epi8(_mm256_set1_epi32(c), _mm256_setzero_si256());
+   one = _mm256_set1_epi16(1);
+   while (d < e)
+     {
+	vm = _evas_avx2_mask_load(m);
+	if (!_mm256_testz_si256(vm, vm))
+	  {
+	     vz = _mm256_cmpeq_epi8(vm, _mm256_setzero_si256());
+	     vd = AVX2_LOAD(d);
+	     AVX2_UNPACK(vm, ml, mh)
+	     AVX2_UNPACK(vd, dl, dh)
+	     ml = _evas_avx2_interp_256(_mm256_add_epi16(ml, one), vc, dl);
+	     mh = _evas_avx2_interp_256(_mm256_add_epi16(mh, one), vc, dh);
+	     AVX2_STORE(d, _mm256_blendv_epi8(AVX2_PACK(ml, mh), vd, vz));
+	  }
+	m += 8;  d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     {
+	alpha = *m;
+	switch(alpha)
+	  {
+	  case 0:
+	     break;
+	  case 255:
+	     *d = c;
+	     break;
+	  default:
+	     alpha++;
+	     *d = INTERP_256(alpha, c, *d);
+	     break;
+	  }
+	m++;  d++;
+     }
+}
+
+#define _op_blend_mas_cn_dp_avx2 _op_blend_mas_can_dp_avx2
+#define _op_blend_mas_caa_dp_avx2 _op_blend_mas_c_dp_avx2
+
+#define _op_blend_mas_c_dpan_avx2 _op_blend_mas_c_dp_avx2
+#define _op_blend_mas_cn_dpan_avx2 _op_blend_mas_cn_dp_avx2
+#define _op_blend_mas_can_dpan_avx2 _op_blend_mas_can_dp_avx2
+#define _op_blend_mas_caa_dpan_avx2 _op_blend_mas_caa_dp_avx2
+
+static void
+init_blend_mask_color_span_funcs_avx2(void)
+{
+   op_blend_span_funcs[SP_N][SM_AS][SC][DP][CPU_AVX2] = _op_blend_mas_c_dp_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_N][DP][CPU_AVX2] = _op_blend_mas_cn_dp_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AN][DP][CPU_AVX2] = _op_blend_mas_can_dp_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AA][DP][CPU_AVX2] = _op_blend_mas_caa_dp_avx2;
+
+   op_blend_span_funcs[SP_N][SM_AS][SC][DP_AN][CPU_AVX2] = _op_blend_mas_c_dpan_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_N][DP_AN][CPU_AVX2] = _op_blend_mas_cn_dpan_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AN][DP_AN][CPU_AVX2] = _op_blend_mas_can_dpan_avx2;
+   op_blend_span_funcs[SP_N][SM_AS][SC_AA][DP_AN][CPU_AVX2] = _op_blend_mas_caa_dpan_avx2;
+}
+#endif
@@ -0,0 +1,283 @@
+
+/* blend pixel x color --> dst */
+
+#ifdef BUILD_SSE2
+/* sa is or'ed into the source so the pan variants can share this */
+static inline EVAS_SSE2_FN void
+_op_blend_p_c_dp_sse2_do(DATA32 *s, DATA32 c, DATA32 *d, int l, DATA32 sa) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vc, vsa, vs, vd, sl, sh, dl, dh;
+   int alpha;
+
+   vc = _mm_unpacklo_epi8(_mm_set1_epi32(c), _mm_setzero_si128());
+   vsa = _mm_set1_epi32(sa);
+   while (d < e)
+     {
+	vs = _mm_or_si128(SSE2_LOAD(s), vsa);
+	vd = SSE2_LOAD(d);
+	SSE2_UNPACK(vs, sl, sh)
+	SSE2_UNPACK(vd, dl, dh)
+	sl = _evas_sse2_mul4_sym(vc, sl);
+	sh = _evas_sse2_mul4_sym(vc, sh);
+	SSE2_STORE(d, SSE2_PACK(_evas_sse2_blend(sl, dl),
+	                        _evas_sse2_blend(sh, dh)));
+	s += 4;  d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     {
+	DATA32 sc = MUL4_SYM(c, *s | sa);
+	alpha = 256 - (sc >> 24);
+	*d = sc + MUL_256(alpha, *d);
+	d++;
+	s++;
+     }
+}
+
+static void EVAS_SSE2_FN
+_op_blend_p_c_dp_sse2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   _op_blend_p_c_dp_sse2_do(s, c, d, l, 0);
+}
+
+static void EVAS_SSE2_FN
+_op_blend_pan_c_dp_sse2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   _op_blend_p_c_dp_sse2_do(s, c, d, l, 0xff000000);
+}
+
+static void EVAS_SSE2_FN
+_op_blend_p_caa_dp_sse2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vc, vs, vd, sl, sh, dl, dh;
+   int alpha;
+
+   c = 1 + (c & 0xff);
+   vc = _mm_set1_epi16(c);
+   while (d < e)
+     {
+	vs = SSE2_LOAD(s);
+	vd = SSE2_LOAD(d);
+	SSE2_UNPACK(vs, sl, sh)
+	SSE2_UNPACK(vd, dl, dh)
+	sl = _evas_sse2_mul_256(vc, sl);
+	sh = _evas_sse2_mul_256(vc, sh);
+	SSE2_STORE(d, SSE2_PACK(_evas_sse2_blend(sl, dl),
+	                        _evas_sse2_blend(sh, dh)));
+	s += 4;  d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     {
+	DATA32 sc = MUL_256(c, *s);
+	alpha = 256 - (sc >> 24);
+	*d = sc + MUL_256(alpha, *d);
+	d++;
+	s++;
+     }
+}
+
+static void EVAS_SSE2_FN
+_op_blend_pan_caa_dp_sse2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vc, vs, vd, sl, sh, dl, dh;
+
+   c = 1 + (c & 0xff);
+   vc = _mm_set1_epi16(c);
+   while (d < e)
+     {
+	vs = SSE2_LOAD(s);
+	vd = SSE2_LOAD(d);
+	SSE2_UNPACK(vs, sl, sh)
+	SSE2_UNPACK(vd, dl, dh)
+	SSE2_STORE(d, SSE2_PACK(_evas_sse2_interp_256(vc, sl, dl),
+	                        _evas_sse2_interp_256(vc, sh, dh)));
+	s += 4;  d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     {
+	*d = INTERP_256(c, *s, *d);
+	d++;
+	s++;
+     }
+}
+
+#define _op_blend_pas_c_dp_sse2 _op_blend_p_c_dp_sse2
+#define _op_blend_p_can_dp_sse2 _op_blend_p_c_dp_sse2
+#define _op_blend_pas_can_dp_sse2 _op_blend_p_c_dp_sse2
+#define _op_blend_pan_can_dp_sse2 _op_blend_pan_c_dp_sse2
+#define _op_blend_pas_caa_dp_sse2 _op_blend_p_caa_dp_sse2
+
+#define _op_blend_p_c_dpan_sse2 _op_blend_p_c_dp_sse2
+#define _op_blend_pas_c_dpan_sse2 _op_blend_pas_c_dp_sse2
+#define _op_blend_pan_c_dpan_sse2 _op_blend_pan_c_dp_sse2
+#define _op_blend_p_can_dpan_sse2 _op_blend_p_can_dp_sse2
+#define _op_blend_pas_can_dpan_sse2 _op_blend_pas_can_dp_sse2
+#define _op_blend_pan_can_dpan_sse2 _op_blend_pan_can_dp_sse2
+#define _op_blend_p_caa_dpan_sse2 _op_blend_p_caa_dp_sse2
+#define _op_blend_pas_caa_dpan_sse2 _op_blend_pas_caa_dp_sse2
+#define _op_blend_pan_caa_dpan_sse2 _op_blend_pan_caa_dp_sse2
+
+static void
+init_blend_pixel_color_span_funcs_sse2(void)
+{
+   op_blend_span_funcs[SP][SM_N][SC][DP][CPU_SSE2] = _op_blend_p_c_dp_sse2;
+   op_blend_span_funcs[SP_AS][SM_N][SC][DP][CPU_SSE2] = _op_blend_pas_c_dp_sse2;
+   op_blend_span_funcs[SP_AN][SM_N][SC][DP][CPU_SSE2] = _op_blend_pan_c_dp_sse2;
+   op_blend_span_funcs[SP][SM_N][SC_AN][DP][CPU_SSE2] = _op_blend_p_can_dp_sse2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_AN][DP][CPU_SSE2] = _op_blend_pas_can_dp_sse2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_AN][DP][CPU_SSE2] = _op_blend_pan_can_dp_sse2;
+   op_blend_span_funcs[SP][SM_N][SC_AA][DP][CPU_SSE2] = _op_blend_p_caa_dp_sse2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_AA][DP][CPU_SSE2] = _op_blend_pas_caa_dp_sse2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_AA][DP][CPU_SSE2] = _op_blend_pan_caa_dp_sse2;
+
+   op_blend_span_funcs[SP][SM_N][SC][DP_AN][CPU_SSE2] = _op_blend_p_c_dpan_sse2;
+   op_blend_span_funcs[SP_AS][SM_N][SC][DP_AN][CPU_SSE2] = _op_blend_pas_c_dpan_sse2;
+   op_blend_span_funcs[SP_AN][SM_N][SC][DP_AN][CPU_SSE2] = _op_blend_pan_c_dpan_sse2;
+   op_blend_span_funcs[SP][SM_N][SC_AN][DP_AN][CPU_SSE2] = _op_blend_p_can_dpan_sse2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_AN][DP_AN][CPU_SSE2] = _op_blend_pas_can_dpan_sse2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_AN][DP_AN][CPU_SSE2] = _op_blend_pan_can_dpan_sse2;
+   op_blend_span_funcs[SP][SM_N][SC_AA][DP_AN][CPU_SSE2] = _op_blend_p_caa_dpan_sse2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_AA][DP_AN][CPU_SSE2] = _op_blend_pas_caa_dpan_sse2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_AA][DP_AN][CPU_SSE2] = _op_blend_pan_caa_dpan_sse2;
+}
+#endif
+
+#ifdef BUILD_AVX2
+static inline EVAS_AVX2_FN void
+_op_blend_p_c_dp_avx2_do(DATA32 *s, DATA32 c, DATA32 *d, int l, DATA32 sa) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vc, vsa, vs, vd, sl, sh, dl, dh;
+   int alpha;
+
+   vc = _mm256_unpacklo_epi8(_mm256_set1_epi32(c), _mm256_setzero_si256());
+   vsa = _mm256_set1_epi32(sa);
+   while (d < e)
+     {
+	vs = _mm256_or_si256(AVX2_LOAD(s), vsa);
+	vd = AVX2_LOAD(d);
+	AVX2_UNPACK(vs, sl, sh)
+	AVX2_UNPACK(vd, dl, dh)
+	sl = _evas_avx2_mul4_sym(vc, sl);
+	sh = _evas_avx2_mul4_sym(vc, sh);
+	AVX2_STORE(d, AVX2_PACK(_evas_avx2_blend(sl, dl),
+	                        _evas_avx2_blend(sh, dh)));
+	s += 8;  d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     {
+	DATA32 sc = MUL4_SYM(c, *s | sa);
+	alpha = 256 - (sc >> 24);
+	*d = sc + MUL_256(alpha, *d);
+	d++;
+	s++;
+     }
+}
+
+static void EVAS_AVX2_FN
+_op_blend_p_c_dp_avx2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   _op_blend_p_c_dp_avx2_do(s, c, d, l, 0);
+}
+
+static void EVAS_AVX2_FN
+_op_blend_pan_c_dp_avx2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   _op_blend_p_c_dp_avx2_do(s, c, d, l, 0xff000000);
+}
+
+static void EVAS_AVX2_FN
+_op_blend_p_caa_dp_avx2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vc, vs, vd, sl, sh, dl, dh;
+   int alpha;
+
+   c = 1 + (c & 0xff);
+   vc = _mm256_set1_epi16(c);
+   while (d < e)
+     {
+	vs = AVX2_LOAD(s);
+	vd = AVX2_LOAD(d);
+	AVX2_UNPACK(vs, sl, sh)
+	AVX2_UNPACK(vd, dl, dh)
+	sl = _evas_avx2_mul_256(vc, sl);
+	sh = _evas_avx2_mul_256(vc, sh);
+	AVX2_STORE(d, AVX2_PACK(_evas_avx2_blend(sl, dl),
+	                        _evas_avx2_blend(sh, dh)));
+	s += 8;  d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     {
+	DATA32 sc = MUL_256(c, *s);
+	alpha = 256 - (sc >> 24);
+	*d = sc + MUL_256(alpha, *d);
+	d++;
+	s++;
+     }
+}
+
+static void EVAS_AVX2_FN
+_op_blend_pan_caa_dp_avx2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vc, vs, vd, sl, sh, dl, dh;
+
+   c = 1 + (c & 0xff);
+   vc = _mm256_set1_epi16(c);
+   while (d < e)
+     {
+	vs = AVX2_LOAD(s);
+	vd = AVX2_LOAD(d);
+	AVX2_UNPACK(vs, sl, sh)
+	AVX2_UNPACK(vd, dl, dh)
+	AVX2_STORE(d, AVX2_PACK(_evas_avx2_interp_256(vc, sl, dl),
+	                        _evas_avx2_interp_256(vc, sh, dh)));
+	s += 8;  d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     {
+	*d = INTERP_256(c, *s, *d);
+	d++;
+	s++;
+     }
+}
+
+#define _op_blend_pas_c_dp_avx2 _op_blend_p_c_dp_avx2
+#define _op_blend_p_can_dp_avx2 _op_blend_p_c_dp_avx2
+#define _op_blend_pas_can_dp_avx2 _op_blend_p_c_dp_avx2
+#define _op_blend_pan_can_dp_avx2 _op_blend_pan_c_dp_avx2
+#define _op_blend_pas_caa_dp_avx2 _op_blend_p_caa_dp_avx2
+
+#define _op_blend_p_c_dpan_avx2 _op_blend_p_c_dp_avx2
+#define _op_blend_pas_c_dpan_avx2 _op_blend_pas_c_dp_avx2
+#define _op_blend_pan_c_dpan_avx2 _op_blend_pan_c_dp_avx2
+#define _op_blend_p_can_dpan_avx2 _op_blend_p_can_dp_avx2
+#define _op_blend_pas_can_dpan_avx2 _op_blend_pas_can_dp_avx2
+#define _op_blend_pan_can_dpan_avx2 _op_blend_pan_can_dp_avx2
+#define _op_blend_p_caa_dpan_avx2 _op_blend_p_caa_dp_avx2
+#define _op_blend_pas_caa_dpan_avx2 _op_blend_pas_caa_dp_avx2
+#define _op_blend_pan_caa_dpan_avx2 _op_blend_pan_caa_dp_avx2
+
+static void
+init_blend_pixel_color_span_funcs_avx2(void)
+{
+   op_blend_span_funcs[SP][SM_N][SC][DP][CPU_AVX2] = _op_blend_p_c_dp_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC][DP][CPU_AVX2] = _op_blend_pas_c_dp_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC][DP][CPU_AVX2] = _op_blend_pan_c_dp_avx2;
+   op_blend_span_funcs[SP][SM_N][SC_AN][DP][CPU_AVX2] = _op_blend_p_can_dp_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_AN][DP][CPU_AVX2] = _op_blend_pas_can_dp_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_AN][DP][CPU_AVX2] = _op_blend_pan_can_dp_avx2;
+   op_blend_span_funcs[SP][SM_N][SC_AA][DP][CPU_AVX2] = _op_blend_p_caa_dp_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_AA][DP][CPU_AVX2] = _op_blend_pas_caa_dp_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_AA][DP][CPU_AVX2] = _op_blend_pan_caa_dp_avx2;
+
+   op_blend_span_funcs[SP][SM_N][SC][DP_AN][CPU_AVX2] = _op_blend_p_c_dpan_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC][DP_AN][CPU_AVX2] = _op_blend_pas_c_dpan_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC][DP_AN][CPU_AVX2] = _op_blend_pan_c_dpan_avx2;
+   op_blend_span_funcs[SP][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_blend_p_can_dpan_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_blend_pas_can_dpan_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_blend_pan_can_dpan_avx2;
+   op_blend_span_funcs[SP][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_blend_p_caa_dpan_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_blend_pas_caa_dpan_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_blend_pan_caa_dpan_avx2;
+}
+#endif
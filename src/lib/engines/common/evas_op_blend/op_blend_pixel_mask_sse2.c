@@ -0,0 +1,197 @@
+
+/* blend pixel x mask --> dst */
+
+#ifdef BUILD_SSE2
+static void EVAS_SSE2_FN
+_op_blend_p_mas_dp_sse2(DATA32 *s, DATA8 *m, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vm, vs, vd, ml, mh, sl, sh, dl, dh;
+   int alpha;
+
+   while (d < e)
+     {
+	vm = _evas_sse2_mask_load(m);
+	if (_mm_movemask_epi8(_mm_cmpeq_epi8(vm, _mm_setzero_si128())) != 0xffff)
+	  {
+	     vs = SSE2_LOAD(s);
+	     vd = SSE2_LOAD(d);
+	     SSE2_UNPACK(vm, ml, mh)
+	     SSE2_UNPACK(vs, sl, sh)
+	     SSE2_UNPACK(vd, dl, dh)
+	     sl = _evas_sse2_mul_sym(ml, sl);
+	     sh = _evas_sse2_mul_sym(mh, sh);
+	     SSE2_STORE(d, SSE2_PACK(_evas_sse2_blend(sl, dl),
+	                             _evas_sse2_blend(sh, dh)));
+	  }
+	m += 4;  s += 4;  d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     {
+	c = MUL_SYM(*m, *s);
+	alpha = 256 - (c >> 24);
+	*d = c + MUL_256(alpha, *d);
+	m++;  s++;  d++;
+     }
+}
+
+static void EVAS_SSE2_FN
+_op_blend_pan_mas_dp_sse2(DATA32 *s, DATA8 *m, DATA32 c __UNUSED__, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vm, vz, vs, vd, ml, mh, sl, sh, dl, dh, one;
+   int alpha;
+
+   one = _mm_set1_epi16(1);
+   while (d < e)
+     {
+	vm = _evas_sse2_mask_load(m);
+	vz = _mm_cmpeq_epi8(vm, _mm_setzero_si128());
+	if (_mm_movemask_epi8(vz) != 0xffff)
+	  {
+	     vs = SSE2_LOAD(s);
+	     vd = SSE2_LOAD(d);
+	     SSE2_UNPACK(vm, ml, mh)
+	     SSE2_UNPACK(vs, sl, sh)
+	     SSE2_UNPACK(vd, dl, dh)
+	     sl = _evas_sse2_interp_256(_mm_add_epi16(ml, one), sl, dl);
+	     sh = _evas_sse2_interp_256(_mm_add_epi16(mh, one), sh, dh);
+	     SSE2_STORE(d, _mm_or_si128(_mm_and_si128(vz, vd),
+	                                _mm_andnot_si128(vz, SSE2_PACK(sl, sh))));
+	  }
+	m += 4;  s += 4;  d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     {
+	alpha = *m;
+	switch(alpha)
+	  {
+	  case 0:
+	     break;
+	  case 255:
+	     *d = *s;
+	     break;
+	  default:
+	     alpha++;
+	     *d = INTERP_256(alpha, *s, *d);
+	     break;
+	  }
+	m++;  s++;  d++;
+     }
+}
+
+#define _op_blend_pas_mas_dp_sse2 _op_blend_p_mas_dp_sse2
+
+#define _op_blend_p_mas_dpan_sse2 _op_blend_p_mas_dp_sse2
+#define _op_blend_pas_mas_dpan_sse2 _op_blend_pas_mas_dp_sse2
+#define _op_blend_pan_mas_dpan_sse2 _op_blend_pan_mas_dp_sse2
+
+static void
+init_blend_pixel_mask_span_funcs_sse2(void)
+{
+   op_blend_span_funcs[SP][SM_AS][SC_N][DP][CPU_SSE2] = _op_blend_p_mas_dp_sse2;
+   op_blend_span_funcs[SP_AS][SM_AS][SC_N][DP][CPU_SSE2] = _op_blend_pas_mas_dp_sse2;
+   op_blend_span_funcs[SP_AN][SM_AS][SC_N][DP][CPU_SSE2] = _op_blend_pan_mas_dp_sse2;
+
+   op_blend_span_funcs[SP][SM_AS][SC_N][DP_AN][CPU_SSE2] = _op_blend_p_mas_dpan_sse2;
+   op_blend_span_funcs[SP_AS][SM_AS][SC_N][DP_AN][CPU_SSE2] = _op_blend_pas_mas_dpan_sse2;
+   op_blend_span_funcs[SP_AN][SM_AS][SC_N][DP_AN][CPU_SSE2] = _op_blend_pan_mas_dpan_sse2;
+}
+#endif
+
+#ifdef BUILD_AVX2
+static void EVAS_AVX2_FN
+_op_blend_p_mas_dp_avx2(DATA32 *s, DATA8 *m, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vm, vs, vd, ml, mh, sl, sh, dl, dh;
+   int alpha;
+
+   while (d < e)
+     {
+	vm = _evas_avx2_mask_load(m);
+	if (!_mm256_testz_si256(vm, vm))
+	  {
+	     vs = AVX2_LOAD(s);
+	     vd = AVX2_LOAD(d);
+	     AVX2_UNPACK(vm, ml, mh)
+	     AVX2_UNPACK(vs, sl, sh)
+	     AVX2_UNPACK(vd, dl, dh)
+	     sl = _evas_avx2_mul_sym(ml, sl);
+	     sh = _evas_avx2_mul_sym(mh, sh);
+	     AVX2_STORE(d, AVX2_PACK(_evas_avx2_blend(sl, dl),
+	                             _evas_avx2_blend(sh, dh)));
+	  }
+	m += 8;  s += 8;  d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     {
+	c = MUL_SYM(*m, *s);
+	alpha = 256 - (c >> 24);
+	*d = c + MUL_256(alpha, *d);
+	m++;  s++;  d++;
+     }
+}
+
+static void EVAS_AVX2_FN
+_op_blend_pan_mas_dp_avx2(DATA32 *s, DATA8 *m, DATA32 c __UNUSED__, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vm, vz, vs, vd, ml, mh, sl, sh, dl, dh, one;
+   int alpha;
+
+   one = _mm256_set1_epi16(1);
+   while (d < e)
+     {
+	vm = _evas_avx2_mask_load(m);
+	if (!_mm256_testz_si256(vm, vm))
+	  {
+	     vz = _mm256_cmpeq_epi8(vm, _mm256_setzero_si256());
+	     vs = AVX2_LOAD(s);
+	     vd = AVX2_LOAD(d);
+	     AVX2_UNPACK(vm, ml, mh)
+	     AVX2_UNPACK(vs, sl, sh)
+	     AVX2_UNPACK(vd, dl, dh)
+	     sl = _evas_avx2_interp_256(_mm256_add_epi16(ml, one), sl, dl);
+	     sh = _evas_avx2_interp_256(_mm256_add_epi16(mh, one), sh, dh);
+	     AVX2_STORE(d, _mm256_blendv_epi8(AVX2_PACK(sl, sh), vd, vz));
+	  }
+	m += 8;  s += 8;  d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     {
+	alpha = *m;
+	switch(alpha)
+	  {
+	  case 0:
+	     break;
+	  case 255:
+	     *d = *s;
+	     break;
+	  default:
+	     alpha++;
+	     *d = INTERP_256(alpha, *s, *d);
+	     break;
+	  }
+	m++;  s++;  d++;
+     }
+}
+
+#define _op_blend_pas_mas_dp_avx2 _op_blend_p_mas_dp_avx2
+
+#define _op_blend_p_mas_dpan_avx2 _op_blend_p_mas_dp_avx2
+#define _op_blend_pas_mas_dpan_avx2 _op_blend_pas_mas_dp_avx2
+#define _op_blend_pan_mas_dpan_avx2 _op_blend_pan_mas_dp_avx2
+
+static void
+init_blend_pixel_mask_span_funcs_avx2(void)
+{
+   op_blend_span_funcs[SP][SM_AS][SC_N][DP][CPU_AVX2] = _op_blend_p_mas_dp_avx2;
+   op_blend_span_funcs[SP_AS][SM_AS][SC_N][DP][CPU_AVX2] = _op_blend_pas_mas_dp_avx2;
+   op_blend_span_funcs[SP_AN][SM_AS][SC_N][DP][CPU_AVX2] = _op_blend_pan_mas_dp_avx2;
+
+   op_blend_span_funcs[SP][SM_AS][SC_N][DP_AN][CPU_AVX2] = _op_blend_p_mas_dpan_avx2;
+   op_blend_span_funcs[SP_AS][SM_AS][SC_N][DP_AN][CPU_AVX2] = _op_blend_pas_mas_dpan_avx2;
+   op_blend_span_funcs[SP_AN][SM_AS][SC_N][DP_AN][CPU_AVX2] = _op_blend_pan_mas_dpan_avx2;
+}
+#endif
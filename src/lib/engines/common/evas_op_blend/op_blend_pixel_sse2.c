@@ -0,0 +1,181 @@
+
+/* blend pixel --> dst */
+
+#ifdef BUILD_SSE2
+static void EVAS_SSE2_FN
+_op_blend_p_dp_sse2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c __UNUSED__, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vs, vd, sl, sh, dl, dh;
+   int alpha;
+
+   while (d < e)
+     {
+	vs = SSE2_LOAD(s);
+	vd = SSE2_LOAD(d);
+	SSE2_UNPACK(vs, sl, sh)
+	SSE2_UNPACK(vd, dl, dh)
+	SSE2_STORE(d, SSE2_PACK(_evas_sse2_blend(sl, dl),
+	                        _evas_sse2_blend(sh, dh)));
+	s += 4;  d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     {
+	alpha = 256 - (*s >> 24);
+	*d = *s++ + MUL_256(alpha, *d);
+	d++;
+     }
+}
+
+static void EVAS_SSE2_FN
+_op_blend_pas_dp_sse2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c __UNUSED__, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i amask = _mm_set1_epi32(0xff000000);
+   __m128i vs, vd, va, sl, sh, dl, dh;
+   int alpha;
+
+   while (d < e)
+     {
+	vs = SSE2_LOAD(s);
+	va = _mm_and_si128(vs, amask);
+	/* sparse alpha: whole runs of 4 are usually all clear or all solid */
+	if (_mm_movemask_epi8(_mm_cmpeq_epi32(va, _mm_setzero_si128())) == 0xffff)
+	  ;
+	else if (_mm_movemask_epi8(_mm_cmpeq_epi32(va, amask)) == 0xffff)
+	  SSE2_STORE(d, vs);
+	else
+	  {
+	     vd = SSE2_LOAD(d);
+	     SSE2_UNPACK(vs, sl, sh)
+	     SSE2_UNPACK(vd, dl, dh)
+	     SSE2_STORE(d, SSE2_PACK(_evas_sse2_blend(sl, dl),
+	                             _evas_sse2_blend(sh, dh)));
+	  }
+	s += 4;  d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     {
+	switch (*s & 0xff000000)
+	  {
+	  case 0:
+	     break;
+	  case 0xff000000:
+	     *d = *s;
+	     break;
+	  default:
+	     alpha = 256 - (*s >> 24);
+	     *d = *s + MUL_256(alpha, *d);
+	     break;
+	  }
+	s++;  d++;
+     }
+}
+
+#define _op_blend_pan_dp_sse2 NULL
+
+#define _op_blend_p_dpan_sse2 _op_blend_p_dp_sse2
+#define _op_blend_pas_dpan_sse2 _op_blend_pas_dp_sse2
+#define _op_blend_pan_dpan_sse2 _op_blend_pan_dp_sse2
+
+static void
+init_blend_pixel_span_funcs_sse2(void)
+{
+   op_blend_span_funcs[SP][SM_N][SC_N][DP][CPU_SSE2] = _op_blend_p_dp_sse2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_N][DP][CPU_SSE2] = _op_blend_pas_dp_sse2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_N][DP][CPU_SSE2] = _op_blend_pan_dp_sse2;
+
+   op_blend_span_funcs[SP][SM_N][SC_N][DP_AN][CPU_SSE2] = _op_blend_p_dpan_sse2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_N][DP_AN][CPU_SSE2] = _op_blend_pas_dpan_sse2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_N][DP_AN][CPU_SSE2] = _op_blend_pan_dpan_sse2;
+}
+#endif
+
+#ifdef BUILD_AVX2
+static void EVAS_AVX2_FN
+_op_blend_p_dp_avx2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c __UNUSED__, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vs, vd, sl, sh, dl, dh;
+   int alpha;
+
+   while (d < e)
+     {
+	vs = AVX2_LOAD(s);
+	vd = AVX2_LOAD(d);
+	AVX2_UNPACK(vs, sl, sh)
+	AVX2_UNPACK(vd, dl, dh)
+	AVX2_STORE(d, AVX2_PACK(_evas_avx2_blend(sl, dl),
+	                        _evas_avx2_blend(sh, dh)));
+	s += 8;  d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     {
+	alpha = 256 - (*s >> 24);
+	*d = *s++ + MUL_256(alpha, *d);
+	d++;
+     }
+}
+
+static void EVAS_AVX2_FN
+_op_blend_pas_dp_avx2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c __UNUSED__, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i amask = _mm256_set1_epi32(0xff000000);
+   __m256i vs, vd, va, sl, sh, dl, dh;
+   int alpha;
+
+   while (d < e)
+     {
+	vs = AVX2_LOAD(s);
+	va = _mm256_and_si256(vs, amask);
+	if (_mm256_testz_si256(va, va))
+	  ;
+	else if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(va, amask)) == -1)
+	  AVX2_STORE(d, vs);
+	else
+	  {
+	     vd = AVX2_LOAD(d);
+	     AVX2_UNPACK(vs, sl, sh)
+	     AVX2_UNPACK(vd, dl, dh)
+	     AVX2_STORE(d, AVX2_PACK(_evas_avx2_blend(sl, dl),
+	                             _evas_avx2_blend(sh, dh)));
+	  }
+	s += 8;  d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     {
+	switch (*s & 0xff000000)
+	  {
+	  case 0:
+	     break;
+	  case 0xff000000:
+	     *d = *s;
+	     break;
+	  default:
+	     alpha = 256 - (*s >> 24);
+	     *d = *s + MUL_256(alpha, *d);
+	     break;
+	  }
+	s++;  d++;
+     }
+}
+
+#define _op_blend_pan_dp_avx2 NULL
+
+#define _op_blend_p_dpan_avx2 _op_blend_p_dp_avx2
+#define _op_blend_pas_dpan_avx2 _op_blend_pas_dp_avx2
+#define _op_blend_pan_dpan_avx2 _op_blend_pan_dp_avx2
+
+static void
+init_blend_pixel_span_funcs_avx2(void)
+{
+   op_blend_span_funcs[SP][SM_N][SC_N][DP][CPU_AVX2] = _op_blend_p_dp_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_N][DP][CPU_AVX2] = _op_blend_pas_dp_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_N][DP][CPU_AVX2] = _op_blend_pan_dp_avx2;
+
+   op_blend_span_funcs[SP][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_blend_p_dpan_avx2;
+   op_blend_span_funcs[SP_AS][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_blend_pas_dpan_avx2;
+   op_blend_span_funcs[SP_AN][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_blend_pan_dpan_avx2;
+}
+#endif
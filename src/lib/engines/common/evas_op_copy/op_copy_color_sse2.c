@@ -0,0 +1,82 @@
+
+/* copy color --> dst */
+
+#ifdef BUILD_SSE2
+static void EVAS_SSE2_FN
+_op_copy_c_dp_sse2(DATA32 *s __UNUSED__, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vc = _mm_set1_epi32(c);
+
+   while (d < e)
+     {
+	SSE2_STORE(d, vc);
+	d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     *d++ = c;
+}
+
+#define _op_copy_cn_dp_sse2 _op_copy_c_dp_sse2
+#define _op_copy_can_dp_sse2 _op_copy_c_dp_sse2
+#define _op_copy_caa_dp_sse2 _op_copy_c_dp_sse2
+
+#define _op_copy_c_dpan_sse2 _op_copy_c_dp_sse2
+#define _op_copy_cn_dpan_sse2 _op_copy_c_dp_sse2
+#define _op_copy_can_dpan_sse2 _op_copy_c_dp_sse2
+#define _op_copy_caa_dpan_sse2 _op_copy_c_dp_sse2
+
+static void
+init_copy_color_span_funcs_sse2(void)
+{
+   op_copy_span_funcs[SP_N][SM_N][SC_N][DP][CPU_SSE2] = _op_copy_cn_dp_sse2;
+   op_copy_span_funcs[SP_N][SM_N][SC][DP][CPU_SSE2] = _op_copy_c_dp_sse2;
+   op_copy_span_funcs[SP_N][SM_N][SC_AN][DP][CPU_SSE2] = _op_copy_can_dp_sse2;
+   op_copy_span_funcs[SP_N][SM_N][SC_AA][DP][CPU_SSE2] = _op_copy_caa_dp_sse2;
+
+   op_copy_span_funcs[SP_N][SM_N][SC_N][DP_AN][CPU_SSE2] = _op_copy_cn_dpan_sse2;
+   op_copy_span_funcs[SP_N][SM_N][SC][DP_AN][CPU_SSE2] = _op_copy_c_dpan_sse2;
+   op_copy_span_funcs[SP_N][SM_N][SC_AN][DP_AN][CPU_SSE2] = _op_copy_can_dpan_sse2;
+   op_copy_span_funcs[SP_N][SM_N][SC_AA][DP_AN][CPU_SSE2] = _op_copy_caa_dpan_sse2;
+}
+#endif
+
+#ifdef BUILD_AVX2
+static void EVAS_AVX2_FN
+_op_copy_c_dp_avx2(DATA32 *s __UNUSED__, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vc = _mm256_set1_epi32(c);
+
+   while (d < e)
+     {
+	AVX2_STORE(d, vc);
+	d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     *d++ = c;
+}
+
+#define _op_copy_cn_dp_avx2 _op_copy_c_dp_avx2
+#define _op_copy_can_dp_avx2 _op_copy_c_dp_avx2
+#define _op_copy_caa_dp_avx2 _op_copy_c_dp_avx2
+
+#define _op_copy_c_dpan_avx2 _op_copy_c_dp_avx2
+#define _op_copy_cn_dpan_avx2 _op_copy_c_dp_avx2
+#define _op_copy_can_dpan_avx2 _op_copy_c_dp_avx2
+#define _op_copy_caa_dpan_avx2 _op_copy_c_dp_avx2
+
+static void
+init_copy_color_span_funcs_avx2(void)
+{
+   op_copy_span_funcs[SP_N][SM_N][SC_N][DP][CPU_AVX2] = _op_copy_cn_dp_avx2;
+   op_copy_span_funcs[SP_N][SM_N][SC][DP][CPU_AVX2] = _op_copy_c_dp_avx2;
+   op_copy_span_funcs[SP_N][SM_N][SC_AN][DP][CPU_AVX2] = _op_copy_can_dp_avx2;
+   op_copy_span_funcs[SP_N][SM_N][SC_AA][DP][CPU_AVX2] = _op_copy_caa_dp_avx2;
+
+   op_copy_span_funcs[SP_N][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_copy_cn_dpan_avx2;
+   op_copy_span_funcs[SP_N][SM_N][SC][DP_AN][CPU_AVX2] = _op_copy_c_dpan_avx2;
+   op_copy_span_funcs[SP_N][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_copy_can_dpan_avx2;
+   op_copy_span_funcs[SP_N][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_copy_caa_dpan_avx2;
+}
+#endif
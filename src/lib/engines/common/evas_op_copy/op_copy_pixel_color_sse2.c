@@ -0,0 +1,188 @@
+
+/* copy pixel x color --> dst */
+
+#ifdef BUILD_SSE2
+static void EVAS_SSE2_FN
+_op_copy_p_c_dp_sse2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vc, vs, sl, sh;
+
+   vc = _mm_unpacklo_epi8(_mm_set1_epi32(c), _mm_setzero_si128());
+   while (d < e)
+     {
+	vs = SSE2_LOAD(s);
+	SSE2_UNPACK(vs, sl, sh)
+	sl = _evas_sse2_mul4_sym(vc, sl);
+	sh = _evas_sse2_mul4_sym(vc, sh);
+	SSE2_STORE(d, SSE2_PACK(sl, sh));
+	s += 4;  d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     {
+	*d = MUL4_SYM(c, *s);
+	d++;
+	s++;
+     }
+}
+
+static void EVAS_SSE2_FN
+_op_copy_p_caa_dp_sse2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vc, vs, sl, sh;
+
+   c = 1 + (c >> 24);
+   vc = _mm_set1_epi16(c);
+   while (d < e)
+     {
+	vs = SSE2_LOAD(s);
+	SSE2_UNPACK(vs, sl, sh)
+	sl = _evas_sse2_mul_256(vc, sl);
+	sh = _evas_sse2_mul_256(vc, sh);
+	SSE2_STORE(d, SSE2_PACK(sl, sh));
+	s += 4;  d += 4;
+     }
+   e += l & 3;
+   while (d < e)
+     {
+	*d = MUL_256(c, *s);
+	d++;
+	s++;
+     }
+}
+
+#define _op_copy_pas_c_dp_sse2 _op_copy_p_c_dp_sse2
+#define _op_copy_pan_c_dp_sse2 _op_copy_p_c_dp_sse2
+#define _op_copy_p_can_dp_sse2 _op_copy_p_c_dp_sse2
+#define _op_copy_pas_can_dp_sse2 _op_copy_p_can_dp_sse2
+#define _op_copy_pan_can_dp_sse2 _op_copy_p_c_dp_sse2
+#define _op_copy_pas_caa_dp_sse2 _op_copy_p_caa_dp_sse2
+#define _op_copy_pan_caa_dp_sse2 _op_copy_p_caa_dp_sse2
+
+#define _op_copy_p_c_dpan_sse2 _op_copy_p_c_dp_sse2
+#define _op_copy_pas_c_dpan_sse2 _op_copy_pas_c_dp_sse2
+#define _op_copy_pan_c_dpan_sse2 _op_copy_pan_c_dp_sse2
+#define _op_copy_p_can_dpan_sse2 _op_copy_p_can_dp_sse2
+#define _op_copy_pas_can_dpan_sse2 _op_copy_pas_can_dp_sse2
+#define _op_copy_pan_can_dpan_sse2 _op_copy_pan_can_dp_sse2
+#define _op_copy_p_caa_dpan_sse2 _op_copy_p_caa_dp_sse2
+#define _op_copy_pas_caa_dpan_sse2 _op_copy_pas_caa_dp_sse2
+#define _op_copy_pan_caa_dpan_sse2 _op_copy_pan_caa_dp_sse2
+
+static void
+init_copy_pixel_color_span_funcs_sse2(void)
+{
+   op_copy_span_funcs[SP][SM_N][SC][DP][CPU_SSE2] = _op_copy_p_c_dp_sse2;
+   op_copy_span_funcs[SP_AS][SM_N][SC][DP][CPU_SSE2] = _op_copy_pas_c_dp_sse2;
+   op_copy_span_funcs[SP_AN][SM_N][SC][DP][CPU_SSE2] = _op_copy_pan_c_dp_sse2;
+   op_copy_span_funcs[SP][SM_N][SC_AN][DP][CPU_SSE2] = _op_copy_p_can_dp_sse2;
+   op_copy_span_funcs[SP_AS][SM_N][SC_AN][DP][CPU_SSE2] = _op_copy_pas_can_dp_sse2;
+   op_copy_span_funcs[SP_AN][SM_N][SC_AN][DP][CPU_SSE2] = _op_copy_pan_can_dp_sse2;
+   op_copy_span_funcs[SP][SM_N][SC_AA][DP][CPU_SSE2] = _op_copy_p_caa_dp_sse2;
+   op_copy_span_funcs[SP_AS][SM_N][SC_AA][DP][CPU_SSE2] = _op_copy_pas_caa_dp_sse2;
+   op_copy_span_funcs[SP_AN][SM_N][SC_AA][DP][CPU_SSE2] = _op_copy_pan_caa_dp_sse2;
+
+   op_copy_span_funcs[SP][SM_N][SC][DP_AN][CPU_SSE2] = _op_copy_p_c_dpan_sse2;
+   op_copy_span_funcs[SP_AS][SM_N][SC][DP_AN][CPU_SSE2] = _op_copy_pas_c_dpan_sse2;
+   op_copy_span_funcs[SP_AN][SM_N][SC][DP_AN][CPU_SSE2] = _op_copy_pan_c_dpan_sse2;
+   op_copy_span_funcs[SP][SM_N][SC_AN][DP_AN][CPU_SSE2] = _op_copy_p_can_dpan_sse2;
+   op_copy_span_funcs[SP_AS][SM_N][SC_AN][DP_AN][CPU_SSE2] = _op_copy_pas_can_dpan_sse2;
+   op_copy_span_funcs[SP_AN][SM_N][SC_AN][DP_AN][CPU_SSE2] = _op_copy_pan_can_dpan_sse2;
+   op_copy_span_funcs[SP][SM_N][SC_AA][DP_AN][CPU_SSE2] = _op_copy_p_caa_dpan_sse2;
+   op_copy_span_funcs[SP_AS][SM_N][SC_AA][DP_AN][CPU_SSE2] = _op_copy_pas_caa_dpan_sse2;
+   op_copy_span_funcs[SP_AN][SM_N][SC_AA][DP_AN][CPU_SSE2] = _op_copy_pan_caa_dpan_sse2;
+}
+#endif
+
+#ifdef BUILD_AVX2
+static void EVAS_AVX2_FN
+_op_copy_p_c_dp_avx2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vc, vs, sl, sh;
+
+   vc = _mm256_unpacklo_epi8(_mm256_set1_epi32(c), _mm256_setzero_si256());
+   while (d < e)
+     {
+	vs = AVX2_LOAD(s);
+	AVX2_UNPACK(vs, sl, sh)
+	sl = _evas_avx2_mul4_sym(vc, sl);
+	sh = _evas_avx2_mul4_sym(vc, sh);
+	AVX2_STORE(d, AVX2_PACK(sl, sh));
+	s += 8;  d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     {
+	*d = MUL4_SYM(c, *s);
+	d++;
+	s++;
+     }
+}
+
+static void EVAS_AVX2_FN
+_op_copy_p_caa_dp_avx2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vc, vs, sl, sh;
+
+   c = 1 + (c >> 24);
+   vc = _mm256_set1_epi16(c);
+   while (d < e)
+     {
+	vs = AVX2_LOAD(s);
+	AVX2_UNPACK(vs, sl, sh)
+	sl = _evas_avx2_mul_256(vc, sl);
+	sh = _evas_avx2_mul_256(vc, sh);
+	AVX2_STORE(d, AVX2_PACK(sl, sh));
+	s += 8;  d += 8;
+     }
+   e += l & 7;
+   while (d < e)
+     {
+	*d = MUL_256(c, *s);
+	d++;
+	s++;
+     }
+}
+
+#define _op_copy_pas_c_dp_avx2 _op_copy_p_c_dp_avx2
+#define _op_copy_pan_c_dp_avx2 _op_copy_p_c_dp_avx2
+#define _op_copy_p_can_dp_avx2 _op_copy_p_c_dp_avx2
+#define _op_copy_pas_can_dp_avx2 _op_copy_p_can_dp_avx2
+#define _op_copy_pan_can_dp_avx2 _op_copy_p_c_dp_avx2
+#define _op_copy_pas_caa_dp_avx2 _op_copy_p_caa_dp_avx2
+#define _op_copy_pan_caa_dp_avx2 _op_copy_p_caa_dp_avx2
+
+#define _op_copy_p_c_dpan_avx2 _op_copy_p_c_dp_avx2
+#define _op_copy_pas_c_dpan_avx2 _op_copy_pas_c_dp_avx2
+#define _op_copy_pan_c_dpan_avx2 _op_copy_pan_c_dp_avx2
+#define _op_copy_p_can_dpan_avx2 _op_copy_p_can_dp_avx2
+#define _op_copy_pas_can_dpan_avx2 _op_copy_pas_can_dp_avx2
+#define _op_copy_pan_can_dpan_avx2 _op_copy_pan_can_dp_avx2
+#define _op_copy_p_caa_dpan_avx2 _op_copy_p_caa_dp_avx2
+#define _op_copy_pas_caa_dpan_avx2 _op_copy_pas_caa_dp_avx2
+#define _op_copy_pan_caa_dpan_avx2 _op_copy_pan_caa_dp_avx2
+
+static void
+init_copy_pixel_color_span_funcs_avx2(void)
+{
+   op_copy_span_funcs[SP][SM_N][SC][DP][CPU_AVX2] = _op_copy_p_c_dp_avx2;
+   op_copy_span_funcs[SP_AS][SM_N][SC][DP][CPU_AVX2] = _op_copy_pas_c_dp_avx2;
+   op_copy_span_funcs[SP_AN][SM_N][SC][DP][CPU_AVX2] = _op_copy_pan_c_dp_avx2;
+   op_copy_span_funcs[SP][SM_N][SC_AN][DP][CPU_AVX2] = _op_copy_p_can_dp_avx2;
+   op_copy_span_funcs[SP_AS][SM_N][SC_AN][DP][CPU_AVX2] = _op_copy_pas_can_dp_avx2;
+   op_copy_span_funcs[SP_AN][SM_N][SC_AN][DP][CPU_AVX2] = _op_copy_pan_can_dp_avx2;
+   op_copy_span_funcs[SP][SM_N][SC_AA][DP][CPU_AVX2] = _op_copy_p_caa_dp_avx2;
+   op_copy_span_funcs[SP_AS][SM_N][SC_AA][DP][CPU_AVX2] = _op_copy_pas_caa_dp_avx2;
+   op_copy_span_funcs[SP_AN][SM_N][SC_AA][DP][CPU_AVX2] = _op_copy_pan_caa_dp_avx2;
+
+   op_copy_span_funcs[SP][SM_N][SC][DP_AN][CPU_AVX2] = _op_copy_p_c_dpan_avx2;
+   op_copy_span_funcs[SP_AS][SM_N][SC][DP_AN][CPU_AVX2] = _op_copy_pas_c_dpan_avx2;
+   op_copy_span_funcs[SP_AN][SM_N][SC][DP_AN][CPU_AVX2] = _op_copy_pan_c_dpan_avx2;
+   op_copy_span_funcs[SP][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_copy_p_can_dpan_avx2;
+   op_copy_span_funcs[SP_AS][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_copy_pas_can_dpan_avx2;
+   op_copy_span_funcs[SP_AN][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_copy_pan_can_dpan_avx2;
+   op_copy_span_funcs[SP][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_copy_p_caa_dpan_avx2;
+   op_copy_span_funcs[SP_AS][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_copy_pas_caa_dpan_avx2;
+   op_copy_span_funcs[SP_AN][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_copy_pan_caa_dpan_avx2;
+}
+#endif
@@ -96,12 +96,23 @@ evas_common_gfx_compositor_copy_rel_get(void)
 # include "./evas_op_copy/op_copy_mask_color_neon.c"
 //# include "./evas_op_copy/op_copy_pixel_mask_color_neon.c"
 
+# include "./evas_op_copy/op_copy_color_sse2.c"
+# include "./evas_op_copy/op_copy_pixel_color_sse2.c"
+
 
 static void
 op_copy_init(void)
 {
    memset(op_copy_span_funcs, 0, sizeof(op_copy_span_funcs));
    memset(op_copy_pt_funcs, 0, sizeof(op_copy_pt_funcs));
+#ifdef BUILD_AVX2
+   init_copy_color_span_funcs_avx2();
+   init_copy_pixel_color_span_funcs_avx2();
+#endif
+#ifdef BUILD_SSE2
+   init_copy_color_span_funcs_sse2();
+   init_copy_pixel_color_span_funcs_sse2();
+#endif
 #ifdef BUILD_MMX
    init_copy_pixel_span_funcs_mmx();
    init_copy_pixel_color_span_funcs_mmx();
@@ -153,6 +164,22 @@ copy_gfx_span_func_cpu(int s, int m, int c, int d)
 {
    RGBA_Gfx_Func  func = NULL;
    int cpu = CPU_N;
+#ifdef BUILD_AVX2
+   if (evas_common_cpu_has_feature(CPU_FEATURE_AVX2))
+     {
+	cpu = CPU_AVX2;
+	func = op_copy_span_funcs[s][m][c][d][cpu];
+	if (func) return func;
+     }
+#endif
+#ifdef BUILD_SSE2
+   if (evas_common_cpu_has_feature(CPU_FEATURE_SSE2))
+     {
+	cpu = CPU_SSE2;
+	func = op_copy_span_funcs[s][m][c][d][cpu];
+	if (func) return func;
+     }
+#endif
 #ifdef BUILD_MMX
    if (evas_common_cpu_has_feature(CPU_FEATURE_MMX))
     {
@@ -0,0 +1,124 @@
+
+/* mul color --> dst */
+
+#ifdef BUILD_SSE2
+static void EVAS_SSE2_FN
+_op_mul_c_dp_sse2(DATA32 *s __UNUSED__, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vc, vd, dl, dh;
+
+   vc = _mm_unpacklo_epi8(_mm_set1_epi32(c), _mm_setzero_si128());
+   while (d < e)
+     {
+	vd = SSE2_LOAD(d);
+	SSE2_UNPACK(vd, dl, dh)
+	SSE2_STORE(d, SSE2_PACK(_evas_sse2_mul4_sym(vc, dl),
+	                        _evas_sse2_mul4_sym(vc, dh)));
+	d += 4;
+     }
+   e += l & 3;
+   for (; d < e; d++) {
+      *d = MUL4_SYM(c, *d);
+   }
+}
+
+static void EVAS_SSE2_FN
+_op_mul_caa_dp_sse2(DATA32 *s __UNUSED__, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vc, vd, dl, dh;
+
+   c = 1 + (c >> 24);
+   vc = _mm_set1_epi16(c);
+   while (d < e)
+     {
+	vd = SSE2_LOAD(d);
+	SSE2_UNPACK(vd, dl, dh)
+	SSE2_STORE(d, SSE2_PACK(_evas_sse2_mul_256(vc, dl),
+	                        _evas_sse2_mul_256(vc, dh)));
+	d += 4;
+     }
+   e += l & 3;
+   for (; d < e; d++) {
+      *d = MUL_256(c, *d);
+   }
+}
+
+#define _op_mul_can_dp_sse2 _op_mul_c_dp_sse2
+
+#define _op_mul_c_dpan_sse2 _op_mul_c_dp_sse2
+#define _op_mul_can_dpan_sse2 _op_mul_can_dp_sse2
+#define _op_mul_caa_dpan_sse2 _op_mul_caa_dp_sse2
+
+static void
+init_mul_color_span_funcs_sse2(void)
+{
+   op_mul_span_funcs[SP_N][SM_N][SC][DP][CPU_SSE2] = _op_mul_c_dp_sse2;
+   op_mul_span_funcs[SP_N][SM_N][SC_AN][DP][CPU_SSE2] = _op_mul_can_dp_sse2;
+   op_mul_span_funcs[SP_N][SM_N][SC_AA][DP][CPU_SSE2] = _op_mul_caa_dp_sse2;
+
+   op_mul_span_funcs[SP_N][SM_N][SC][DP_AN][CPU_SSE2] = _op_mul_c_dpan_sse2;
+   op_mul_span_funcs[SP_N][SM_N][SC_AN][DP_AN][CPU_SSE2] = _op_mul_can_dpan_sse2;
+   op_mul_span_funcs[SP_N][SM_N][SC_AA][DP_AN][CPU_SSE2] = _op_mul_caa_dpan_sse2;
+}
+#endif
+
+#ifdef BUILD_AVX2
+static void EVAS_AVX2_FN
+_op_mul_c_dp_avx2(DATA32 *s __UNUSED__, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vc, vd, dl, dh;
+
+   vc = _mm256_unpacklo_epi8(_mm256_set1_epi32(c), _mm256_setzero_si256());
+   while (d < e)
+     {
+	vd = AVX2_LOAD(d);
+	AVX2_UNPACK(vd, dl, dh)
+	AVX2_STORE(d, AVX2_PACK(_evas_avx2_mul4_sym(vc, dl),
+	                        _evas_avx2_mul4_sym(vc, dh)));
+	d += 8;
+     }
+   e += l & 7;
+   for (; d < e; d++) {
+      *d = MUL4_SYM(c, *d);
+   }
+}
+
+static void EVAS_AVX2_FN
+_op_mul_caa_dp_avx2(DATA32 *s __UNUSED__, DATA8 *m __UNUSED__, DATA32 c, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vc, vd, dl, dh;
+
+   c = 1 + (c >> 24);
+   vc = _mm256_set1_epi16(c);
+   while (d < e)
+     {
+	vd = AVX2_LOAD(d);
+	AVX2_UNPACK(vd, dl, dh)
+	AVX2_STORE(d, AVX2_PACK(_evas_avx2_mul_256(vc, dl),
+	                        _evas_avx2_mul_256(vc, dh)));
+	d += 8;
+     }
+   e += l & 7;
+   for (; d < e; d++) {
+      *d = MUL_256(c, *d);
+   }
+}
+
+#define _op_mul_can_dp_avx2 _op_mul_c_dp_avx2
+
+#define _op_mul_c_dpan_avx2 _op_mul_c_dp_avx2
+#define _op_mul_can_dpan_avx2 _op_mul_can_dp_avx2
+#define _op_mul_caa_dpan_avx2 _op_mul_caa_dp_avx2
+
+static void
+init_mul_color_span_funcs_avx2(void)
+{
+   op_mul_span_funcs[SP_N][SM_N][SC][DP][CPU_AVX2] = _op_mul_c_dp_avx2;
+   op_mul_span_funcs[SP_N][SM_N][SC_AN][DP][CPU_AVX2] = _op_mul_can_dp_avx2;
+   op_mul_span_funcs[SP_N][SM_N][SC_AA][DP][CPU_AVX2] = _op_mul_caa_dp_avx2;
+
+   op_mul_span_funcs[SP_N][SM_N][SC][DP_AN][CPU_AVX2] = _op_mul_c_dpan_avx2;
+   op_mul_span_funcs[SP_N][SM_N][SC_AN][DP_AN][CPU_AVX2] = _op_mul_can_dpan_avx2;
+   op_mul_span_funcs[SP_N][SM_N][SC_AA][DP_AN][CPU_AVX2] = _op_mul_caa_dpan_avx2;
+}
+#endif
@@ -0,0 +1,86 @@
+
+/* mul pixel --> dst */
+
+#ifdef BUILD_SSE2
+static void EVAS_SSE2_FN
+_op_mul_p_dp_sse2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c __UNUSED__, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~3);
+   __m128i vs, vd, sl, sh, dl, dh;
+
+   while (d < e)
+     {
+	vs = SSE2_LOAD(s);
+	vd = SSE2_LOAD(d);
+	SSE2_UNPACK(vs, sl, sh)
+	SSE2_UNPACK(vd, dl, dh)
+	SSE2_STORE(d, SSE2_PACK(_evas_sse2_mul4_sym(sl, dl),
+	                        _evas_sse2_mul4_sym(sh, dh)));
+	s += 4;  d += 4;
+     }
+   e += l & 3;
+   for (; d < e; d++, s++) {
+      *d = MUL4_SYM(*s, *d);
+   }
+}
+
+#define _op_mul_pas_dp_sse2 _op_mul_p_dp_sse2
+#define _op_mul_pan_dp_sse2 _op_mul_p_dp_sse2
+
+#define _op_mul_p_dpan_sse2 _op_mul_p_dp_sse2
+#define _op_mul_pas_dpan_sse2 _op_mul_pas_dp_sse2
+#define _op_mul_pan_dpan_sse2 _op_mul_pan_dp_sse2
+
+static void
+init_mul_pixel_span_funcs_sse2(void)
+{
+   op_mul_span_funcs[SP][SM_N][SC_N][DP][CPU_SSE2] = _op_mul_p_dp_sse2;
+   op_mul_span_funcs[SP_AS][SM_N][SC_N][DP][CPU_SSE2] = _op_mul_pas_dp_sse2;
+   op_mul_span_funcs[SP_AN][SM_N][SC_N][DP][CPU_SSE2] = _op_mul_pan_dp_sse2;
+
+   op_mul_span_funcs[SP][SM_N][SC_N][DP_AN][CPU_SSE2] = _op_mul_p_dpan_sse2;
+   op_mul_span_funcs[SP_AS][SM_N][SC_N][DP_AN][CPU_SSE2] = _op_mul_pas_dpan_sse2;
+   op_mul_span_funcs[SP_AN][SM_N][SC_N][DP_AN][CPU_SSE2] = _op_mul_pan_dpan_sse2;
+}
+#endif
+
+#ifdef BUILD_AVX2
+static void EVAS_AVX2_FN
+_op_mul_p_dp_avx2(DATA32 *s, DATA8 *m __UNUSED__, DATA32 c __UNUSED__, DATA32 *d, int l) {
+   DATA32 *e = d + (l & ~7);
+   __m256i vs, vd, sl, sh, dl, dh;
+
+   while (d < e)
+     {
+	vs = AVX2_LOAD(s);
+	vd = AVX2_LOAD(d);
+	AVX2_UNPACK(vs, sl, sh)
+	AVX2_UNPACK(vd, dl, dh)
+	AVX2_STORE(d, AVX2_PACK(_evas_avx2_mul4_sym(sl, dl),
+	                        _evas_avx2_mul4_sym(sh, dh)));
+	s += 8;  d += 8;
+     }
+   e += l & 7;
+   for (; d < e; d++, s++) {
+      *d = MUL4_SYM(*s, *d);
+   }
+}
+
+#define _op_mul_pas_dp_avx2 _op_mul_p_dp_avx2
+#define _op_mul_pan_dp_avx2 _op_mul_p_dp_avx2
+
+#define _op_mul_p_dpan_avx2 _op_mul_p_dp_avx2
+#define _op_mul_pas_dpan_avx2 _op_mul_pas_dp_avx2
+#define _op_mul_pan_dpan_avx2 _op_mul_pan_dp_avx2
+
+static void
+init_mul_pixel_span_funcs_avx2(void)
+{
+   op_mul_span_funcs[SP][SM_N][SC_N][DP][CPU_AVX2] = _op_mul_p_dp_avx2;
+   op_mul_span_funcs[SP_AS][SM_N][SC_N][DP][CPU_AVX2] = _op_mul_pas_dp_avx2;
+   op_mul_span_funcs[SP_AN][SM_N][SC_N][DP][CPU_AVX2] = _op_mul_pan_dp_avx2;
+
+   op_mul_span_funcs[SP][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_mul_p_dpan_avx2;
+   op_mul_span_funcs[SP_AS][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_mul_pas_dpan_avx2;
+   op_mul_span_funcs[SP_AN][SM_N][SC_N][DP_AN][CPU_AVX2] = _op_mul_pan_dpan_avx2;
+}
+#endif
@@ -2,7 +2,13 @@
  * vim:ts=8:sw=3:sts=8:noexpandtab:cino=>5n-3f0^-2{2
  */
 
-// THIS IS DEPRECATED. WILL GO EVENTUALLTY. NO NEED TO SUPPORT ANYMORE
+/* draw ops are recorded per destination image and replayed at flush time.
+ * with more than 1 cpu the destination is cut into tiles, every op is
+ * binned into the tiles its bounds touch and worker threads render tiles,
+ * stealing work off each other when their own queue runs dry. each tile
+ * replays its ops in recorded order clipped to the tile, so the output is
+ * identical to rendering the pipe on one thread.
+ */
 
 #include "evas_common.h"
 
@@ -212,6 +218,7 @@ evas_common_frameq_enabled()
 
 static RGBA_Pipe *evas_common_pipe_add(RGBA_Pipe *pipe, RGBA_Pipe_Op **op);
 static void evas_common_pipe_draw_context_copy(RGBA_Draw_Context *dc, RGBA_Pipe_Op *op);
+static void evas_common_pipe_op_bounds_set(RGBA_Image *dst, RGBA_Pipe_Op *op, int x, int y, int w, int h);
 static void evas_common_pipe_op_free(RGBA_Pipe_Op *op);
 
 /* utils */
@@ -248,6 +255,8 @@ static void
 evas_common_pipe_draw_context_copy(RGBA_Draw_Context *dc, RGBA_Pipe_Op *op)
 {
    memcpy(&(op->context), dc, sizeof(RGBA_Draw_Context));
+   op->context.cutout_cache.region = NULL;
+   op->context.cutout_cache.owner = NULL;
    if (op->context.cutout.active > 0)
      {
         op->context.cutout.rects = malloc(sizeof(Cutout_Rect) * op->context.cutout.active);
@@ -259,6 +268,27 @@ evas_common_pipe_draw_context_copy(RGBA_Draw_Context *dc, RGBA_Pipe_Op *op)
      }
 }
 
+static void
+evas_common_pipe_op_bounds_set(RGBA_Image *dst, RGBA_Pipe_Op *op, int x, int y, int w, int h)
+{
+   /* must be called after the context has been copied into the op */
+   RECTS_CLIP_TO_RECT(x, y, w, h, 0, 0,
+                      dst->cache_entry.w, dst->cache_entry.h);
+   if (op->context.clip.use)
+     RECTS_CLIP_TO_RECT(x, y, w, h,
+                        op->context.clip.x, op->context.clip.y,
+                        op->context.clip.w, op->context.clip.h);
+   if ((w < 1) || (h < 1))
+     {
+        w = 0;
+        h = 0;
+     }
+   op->bounds.x = x;
+   op->bounds.y = y;
+   op->bounds.w = w;
+   op->bounds.h = h;
+}
+
 static void
 evas_common_pipe_op_free(RGBA_Pipe_Op *op)
 {
@@ -266,40 +296,233 @@ evas_common_pipe_op_free(RGBA_Pipe_Op *op)
 }
 
 #ifdef BUILD_PTHREAD
+/* tile scheduler */
+#define PIPE_TILE_SIZE 64
+#define PIPE_TILE_OPS_STEP 32
+
+typedef struct _RGBA_Pipe_Tile       RGBA_Pipe_Tile;
+typedef struct _RGBA_Pipe_Tile_Queue RGBA_Pipe_Tile_Queue;
+
+struct _RGBA_Pipe_Tile
+{
+   RGBA_Pipe_Thread_Info   info;
+   RGBA_Pipe_Op          **ops;
+   int                     op_num, op_max;
+};
+
+struct _RGBA_Pipe_Tile_Queue
+{
+   LK(lock);
+   int                     head, tail; /* [head, tail) of tile_work */
+};
+
+static RGBA_Pipe_Tile        *tiles = NULL;
+static int                    tiles_num = 0, tiles_max = 0;
+static RGBA_Pipe_Tile       **tile_work = NULL;
+static int                    tile_work_num = 0;
+static RGBA_Pipe_Tile_Queue   tile_queue[TH_MAX];
+static int                    tile_size = 0;
+static Eina_Bool              tile_running = EINA_FALSE;
+
+static int               thread_num = 0;
+
+static Eina_Bool
+evas_common_pipe_tile_op_add(RGBA_Pipe_Tile *tile, RGBA_Pipe_Op *op)
+{
+   if (tile->op_num == tile->op_max)
+     {
+        RGBA_Pipe_Op **ops;
+
+        ops = realloc(tile->ops, sizeof(RGBA_Pipe_Op *) *
+                      (tile->op_max + PIPE_TILE_OPS_STEP));
+        if (!ops) return EINA_FALSE;
+        tile->ops = ops;
+        tile->op_max += PIPE_TILE_OPS_STEP;
+     }
+   tile->ops[tile->op_num++] = op;
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+evas_common_pipe_tiles_bin(RGBA_Image *im)
+{
+   RGBA_Pipe *p;
+   int tw, th, tx, ty, i, num;
+
+   tiles_num = 0;
+   tile_work_num = 0;
+   if (!tile_size)
+     {
+        const char *s;
+
+        tile_size = PIPE_TILE_SIZE;
+        s = getenv("EVAS_PIPE_TILE_SIZE");
+        if (s) tile_size = atoi(s);
+        if (tile_size < 16) tile_size = 16;
+     }
+#ifdef EVAS_SLI
+   /* every thread gets all the ops and renders every Nth line */
+   tw = 1;
+   th = thread_num;
+#else
+   tw = (im->cache_entry.w + tile_size - 1) / tile_size;
+   th = (im->cache_entry.h + tile_size - 1) / tile_size;
+#endif
+   num = tw * th;
+   if (num > tiles_max)
+     {
+        RGBA_Pipe_Tile *t;
+        RGBA_Pipe_Tile **w;
+
+        t = realloc(tiles, num * sizeof(RGBA_Pipe_Tile));
+        if (!t) return EINA_FALSE;
+        memset(t + tiles_max, 0, (num - tiles_max) * sizeof(RGBA_Pipe_Tile));
+        tiles = t;
+        w = realloc(tile_work, num * sizeof(RGBA_Pipe_Tile *));
+        if (!w) return EINA_FALSE;
+        tile_work = w;
+        tiles_max = num;
+     }
+   tiles_num = num;
+   for (ty = 0; ty < th; ty++)
+     {
+        for (tx = 0; tx < tw; tx++)
+          {
+             RGBA_Pipe_Tile *tile;
+
+             tile = &(tiles[(ty * tw) + tx]);
+             tile->info.im = im;
+#ifdef EVAS_SLI
+             tile->info.x = 0;
+             tile->info.w = im->cache_entry.w;
+             tile->info.y = ty;
+             tile->info.h = thread_num;
+#else
+             tile->info.x = tx * tile_size;
+             tile->info.y = ty * tile_size;
+             tile->info.w = tile_size;
+             tile->info.h = tile_size;
+             if ((tile->info.x + tile->info.w) > im->cache_entry.w)
+               tile->info.w = im->cache_entry.w - tile->info.x;
+             if ((tile->info.y + tile->info.h) > im->cache_entry.h)
+               tile->info.h = im->cache_entry.h - tile->info.y;
+#endif
+             tile->op_num = 0;
+          }
+     }
+
+   /* bin ops in recorded order so every tile replays them in that order */
+   EINA_INLIST_FOREACH(EINA_INLIST_GET(im->pipe), p)
+     {
+        for (i = 0; i < p->op_num; i++)
+          {
+             RGBA_Pipe_Op *op;
+             int x1, y1, x2, y2;
+
+             op = &(p->op[i]);
+             if ((!op->op_func) || (op->bounds.w < 1) || (op->bounds.h < 1))
+               continue;
+#ifdef EVAS_SLI
+             x1 = 0; x2 = 0;
+             y1 = 0; y2 = th - 1;
+#else
+             x1 = op->bounds.x / tile_size;
+             y1 = op->bounds.y / tile_size;
+             x2 = (op->bounds.x + op->bounds.w - 1) / tile_size;
+             y2 = (op->bounds.y + op->bounds.h - 1) / tile_size;
+#endif
+             for (ty = y1; ty <= y2; ty++)
+               {
+                  for (tx = x1; tx <= x2; tx++)
+                    {
+                       if (!evas_common_pipe_tile_op_add(&(tiles[(ty * tw) + tx]), op))
+                         return EINA_FALSE;
+                    }
+               }
+          }
+     }
+
+   /* only tiles that got ops are worth scheduling */
+   tile_work_num = 0;
+   for (i = 0; i < tiles_num; i++)
+     {
+        if (tiles[i].op_num > 0)
+          tile_work[tile_work_num++] = &(tiles[i]);
+     }
+   return EINA_TRUE;
+}
+
+static void
+evas_common_pipe_tiles_distribute(void)
+{
+   int i, n, start;
+
+   /* hand out contiguous runs of tiles so neighbouring tiles (that tend to
+    * share source pixels) stay on one cpu until stealing kicks in */
+   start = 0;
+   for (i = 0; i < thread_num; i++)
+     {
+        n = tile_work_num / thread_num;
+        if (i < (tile_work_num % thread_num)) n++;
+        LKL(tile_queue[i].lock);
+        tile_queue[i].head = start;
+        tile_queue[i].tail = start + n;
+        LKU(tile_queue[i].lock);
+        start += n;
+     }
+}
+
+static RGBA_Pipe_Tile *
+evas_common_pipe_tile_get(int self)
+{
+   RGBA_Pipe_Tile *tile = NULL;
+   RGBA_Pipe_Tile_Queue *q;
+   int i;
+
+   /* own queue from the front */
+   q = &(tile_queue[self]);
+   LKL(q->lock);
+   if (q->head < q->tail) tile = tile_work[q->head++];
+   LKU(q->lock);
+   if (tile) return tile;
+
+   /* steal from the back of everyone else */
+   for (i = 1; i < thread_num; i++)
+     {
+        q = &(tile_queue[(self + i) % thread_num]);
+        LKL(q->lock);
+        if (q->head < q->tail) tile = tile_work[--q->tail];
+        LKU(q->lock);
+        if (tile) return tile;
+     }
+   return NULL;
+}
+
+static void
+evas_common_pipe_tile_render(RGBA_Pipe_Tile *tile)
+{
+   int i;
+
+   for (i = 0; i < tile->op_num; i++)
+     tile->ops[i]->op_func(tile->info.im, tile->ops[i], &(tile->info));
+}
+
 /* main api calls */
 static void *
 evas_common_pipe_thread(void *data)
 {
    Thinfo *thinfo;
 
-// INF("TH [...........");
    thinfo = data;
    for (;;)
      {
-        RGBA_Pipe_Thread_Info *info;
-        RGBA_Pipe *p;
+        RGBA_Pipe_Tile *tile;
 
         /* wait for start signal */
-// INF(" TH %i START...", thinfo->thread_num);
         pthread_barrier_wait(&(thinfo->barrier[0]));
-        info = thinfo->info;
-// if (info)
-//   {
-//      thinfo->info = NULL;
-//      INF(" TH %i GO", thinfo->thread_num);
-        EINA_INLIST_FOREACH(EINA_INLIST_GET(info->im->pipe), p)
-          {
-             int i;
-
-             for (i = 0; i < p->op_num; i++)
-               {
-                  if (p->op[i].op_func)
-                  p->op[i].op_func(info->im, &(p->op[i]), info);
-               }
-          }
-        free(info);
-//   }
-// INF(" TH %i DONE", thinfo->thread_num);
+        while ((tile = evas_common_pipe_tile_get(thinfo->thread_num)))
+          evas_common_pipe_tile_render(tile);
+        evas_common_cpu_end_opt();
         /* send finished signal */
         pthread_barrier_wait(&(thinfo->barrier[1]));
      }
@@ -805,7 +1028,6 @@ evas_common_frameq_thread_post(void *data)
 #endif
 
 #ifdef BUILD_PTHREAD
-static int               thread_num = 0;
 static Thinfo            thinfo[TH_MAX];
 static pthread_barrier_t thbarrier[2];
 #endif
@@ -814,45 +1036,18 @@ static void
 evas_common_pipe_begin(RGBA_Image *im)
 {
 #ifdef BUILD_PTHREAD
-   int i, y, h;
 
 #ifdef EVAS_FRAME_QUEUING
    return;
 #endif
 
+   tile_running = EINA_FALSE;
    if (!im->pipe) return;
-   if (thread_num == 1) return;
-   y = 0;
-   h = im->cache_entry.h / thread_num;
-   if (h < 1) h = 1;
-   for (i = 0; i < thread_num; i++)
-     {
-        RGBA_Pipe_Thread_Info *info;
-
-//      if (y >= im->cache_entry.h) break;
-        info = calloc(1, sizeof(RGBA_Pipe_Thread_Info));
-        info->im = im;
-#ifdef EVAS_SLI
-        info->x = 0;
-        info->w = im->cache_entry.w;
-        info->y = i;
-        info->h = thread_num;
-#else
-        info->x = 0;
-        info->y = y;
-        info->w = im->cache_entry.w;
-        if (i == (thread_num - 1))
-          {
-             info->h = im->cache_entry.h - y;
-          }
-        else
-          {
-             info->h = h;
-          }
-        y += info->h;
-#endif
-        thinfo[i].info = info;
-     }
+   if (thread_num <= 1) return;
+   /* if binning fails (out of mem) flush falls back to 1 thread */
+   if (!evas_common_pipe_tiles_bin(im)) return;
+   evas_common_pipe_tiles_distribute();
+   tile_running = EINA_TRUE;
    /* tell worker threads to start */
    pthread_barrier_wait(&(thbarrier[0]));
 #endif
@@ -970,10 +1165,11 @@ evas_common_pipe_flush(RGBA_Image *im)
 #ifndef EVAS_FRAME_QUEUING
 
 #ifdef BUILD_PTHREAD
-   if (thread_num > 1)
+   if (tile_running)
      {
-	     /* sync worker threads */
+	/* sync worker threads */
         pthread_barrier_wait(&(thbarrier[1]));
+        tile_running = EINA_FALSE;
      }
    else
 #endif
@@ -1066,6 +1262,7 @@ evas_common_pipe_rectangle_draw(RGBA_Image *dst, RGBA_Draw_Context *dc,
    op->op_func = evas_common_pipe_rectangle_draw_do;
    op->free_func = evas_common_pipe_op_free;
    evas_common_pipe_draw_context_copy(dc, op);
+   evas_common_pipe_op_bounds_set(dst, op, x, y, w, h);
 }
 
 /**************** LINE ******************/
@@ -1109,6 +1306,9 @@ evas_common_pipe_line_draw(RGBA_Image *dst, RGBA_Draw_Context *dc,
    op->op_func = evas_common_pipe_line_draw_do;
    op->free_func = evas_common_pipe_op_free;
    evas_common_pipe_draw_context_copy(dc, op);
+   evas_common_pipe_op_bounds_set(dst, op,
+                                  MIN(x0, x1) - 1, MIN(y0, y1) - 1,
+                                  abs(x1 - x0) + 3, abs(y1 - y0) + 3);
 }
 
 /**************** POLY ******************/
@@ -1175,6 +1375,24 @@ evas_common_pipe_poly_draw(RGBA_Image *dst, RGBA_Draw_Context *dc,
    op->op_func = evas_common_pipe_poly_draw_do;
    op->free_func = evas_common_pipe_op_poly_free;
    evas_common_pipe_draw_context_copy(dc, op);
+   if (pts)
+     {
+        int x1, y1, x2, y2;
+
+        x1 = x2 = pts->x;
+        y1 = y2 = pts->y;
+        for (p = pts; p; p = (RGBA_Polygon_Point *)(EINA_INLIST_GET(p))->next)
+          {
+             if (p->x < x1) x1 = p->x;
+             if (p->x > x2) x2 = p->x;
+             if (p->y < y1) y1 = p->y;
+             if (p->y > y2) y2 = p->y;
+          }
+        evas_common_pipe_op_bounds_set(dst, op, x1, y1,
+                                       x2 - x1 + 1, y2 - y1 + 1);
+     }
+   else
+     evas_common_pipe_op_bounds_set(dst, op, 0, 0, 0, 0);
 }
 
 /**************** GRAD ******************/
@@ -1261,6 +1479,7 @@ evas_common_pipe_grad_draw(RGBA_Image *dst, RGBA_Draw_Context *dc,
    op->op_func = evas_common_pipe_grad_draw_do;
    op->free_func = evas_common_pipe_op_grad_free;
    evas_common_pipe_draw_context_copy(dc, op);
+   evas_common_pipe_op_bounds_set(dst, op, x, y, w, h);
 }
 
 /**************** GRAD2 ******************/
@@ -1347,6 +1566,7 @@ evas_common_pipe_grad2_draw(RGBA_Image *dst, RGBA_Draw_Context *dc,
    op->op_func = evas_common_pipe_grad2_draw_do;
    op->free_func = evas_common_pipe_op_grad2_free;
    evas_common_pipe_draw_context_copy(dc, op);
+   evas_common_pipe_op_bounds_set(dst, op, x, y, w, h);
 }
 
 /**************** TEXT ******************/
@@ -1409,10 +1629,47 @@ evas_common_pipe_text_draw_do(RGBA_Image *dst, RGBA_Pipe_Op *op, RGBA_Pipe_Threa
      }
 }
 
+/* the area text drawn with its pen at x, y (on the baseline) can touch:
+ * the advance of the text, widened by the furthest any glyph of any of
+ * the fonts can reach past its pen position, from their bounding boxes */
+static void
+evas_common_pipe_text_bounds_get(RGBA_Font *fn, const char *text, int x, int y,
+                                 int *bx, int *by, int *bw, int *bh)
+{
+   RGBA_Font_Int *fi;
+   FT_Face face;
+   FT_Fixed xs, ys;
+   Eina_List *l;
+   int adv = 0, x1 = 0, x2 = 0, y1 = 0, y2 = 0, v;
+
+   evas_common_font_query_advance(fn, text, &adv, NULL);
+   EINA_LIST_FOREACH(fn->fonts, l, fi)
+     {
+        face = fi->src->ft.face;
+        xs = fi->ft.size->metrics.x_scale;
+        ys = fi->ft.size->metrics.y_scale;
+        v = FT_MulFix(face->bbox.xMin, xs) >> 6;
+        if (v < x1) x1 = v;
+        v = (FT_MulFix(face->bbox.xMax, xs) + 63) >> 6;
+        if (v > x2) x2 = v;
+        v = -((FT_MulFix(face->bbox.yMax, ys) + 63) >> 6);
+        if (v < y1) y1 = v;
+        v = -(FT_MulFix(face->bbox.yMin, ys) >> 6);
+        if (v > y2) y2 = v;
+     }
+   if (adv < 0) adv = 0;
+   *bx = x + x1 - 1;
+   *by = y + y1 - 1;
+   *bw = adv + x2 - x1 + 2;
+   *bh = y2 - y1 + 2;
+}
+
 EAPI void
 evas_common_pipe_text_draw(RGBA_Image *dst, RGBA_Draw_Context *dc,
                RGBA_Font *fn, int x, int y, const char *text)
 {
+   int bx, by, bw, bh;
+
    RGBA_Pipe_Op *op;
 
    if ((!fn) || (!text)) return;
@@ -1432,6 +1689,8 @@ evas_common_pipe_text_draw(RGBA_Image *dst, RGBA_Draw_Context *dc,
    op->op_func = evas_common_pipe_text_draw_do;
    op->free_func = evas_common_pipe_op_text_free;
    evas_common_pipe_draw_context_copy(dc, op);
+   evas_common_pipe_text_bounds_get(fn, text, x, y, &bx, &by, &bw, &bh);
+   evas_common_pipe_op_bounds_set(dst, op, bx, by, bw, bh);
 }
 
 /**************** IMAGE *****************/
@@ -1605,6 +1864,9 @@ evas_common_pipe_image_draw(RGBA_Image *src, RGBA_Image *dst,
    op->op_func = evas_common_pipe_image_draw_do;
    op->free_func = evas_common_pipe_op_image_free;
    evas_common_pipe_draw_context_copy(dc, op);
+   evas_common_pipe_op_bounds_set(dst, op,
+                                  dst_region_x, dst_region_y,
+                                  dst_region_w, dst_region_h);
 
 #ifdef EVAS_FRAME_QUEUING
    /* laod every src image here.
@@ -1620,6 +1882,251 @@ evas_common_pipe_image_draw(RGBA_Image *src, RGBA_Image *dst,
 #endif
 }
 
+static void
+evas_common_pipe_op_image_border_free(RGBA_Pipe_Op *op)
+{
+   evas_common_rgba_image_border_release(op->op.border.src, op->op.border.bands);
+#ifdef EVAS_FRAME_QUEUING
+   LKL(op->op.border.src->ref_fq_del);
+   op->op.border.src->ref_fq[1]++;
+   LKU(op->op.border.src->ref_fq_del);
+   pthread_cond_signal(&(op->op.border.src->cond_fq_del));
+#else
+   op->op.border.src->ref--;
+   if (op->op.border.src->ref == 0)
+     evas_cache_image_drop(&op->op.border.src->cache_entry);
+#endif
+   evas_common_pipe_op_free(op);
+}
+
+static void
+evas_common_pipe_image_border_draw_do(RGBA_Image *dst, RGBA_Pipe_Op *op, RGBA_Pipe_Thread_Info *info)
+{
+   RGBA_Draw_Context context;
+
+   memcpy(&(context), &(op->context), sizeof(RGBA_Draw_Context));
+   if (info)
+     {
+#ifdef EVAS_SLI
+	evas_common_draw_context_set_sli(&(context), info->y, info->h);
+#else
+	evas_common_draw_context_clip_clip(&(context), info->x, info->y, info->w, info->h);
+#endif
+     }
+   /* the border draw changes the render op for a solid middle, so it
+    * always gets its own copy of the context */
+   if (op->op.border.prepared)
+     evas_common_rgba_image_border_fill(op->op.border.src, op->op.border.bands,
+					dst, &(context),
+					op->op.border.smooth,
+					op->op.border.l, op->op.border.r,
+					op->op.border.t, op->op.border.b,
+					op->op.border.sl, op->op.border.sr,
+					op->op.border.st, op->op.border.sb,
+					op->op.border.fill,
+					op->op.border.x, op->op.border.y,
+					op->op.border.w, op->op.border.h);
+   else
+     evas_common_rgba_image_border_draw(op->op.border.src, dst, &(context),
+					op->op.border.smooth,
+					op->op.border.l, op->op.border.r,
+					op->op.border.t, op->op.border.b,
+					op->op.border.sl, op->op.border.sr,
+					op->op.border.st, op->op.border.sb,
+					op->op.border.fill,
+					op->op.border.x, op->op.border.y,
+					op->op.border.w, op->op.border.h);
+}
+
+/* src is loaded - get the bands (which counts a use of them) and tell the
+ * scale cache about the slices once here, not once per thread */
+static void
+evas_common_pipe_image_border_prepare(RGBA_Image *dst, RGBA_Pipe_Op *op)
+{
+   if (op->op.border.prepared) return;
+   op->op.border.prepared = 1;
+   if ((op->op.border.w <= 0) || (op->op.border.h <= 0)) return;
+   if (!(RECTS_INTERSECT(op->op.border.x, op->op.border.y,
+			 op->op.border.w, op->op.border.h,
+			 0, 0, dst->cache_entry.w, dst->cache_entry.h)))
+     return;
+   op->op.border.bands =
+     evas_common_rgba_image_border_get(op->op.border.src, op->op.border.smooth,
+				       op->op.border.l, op->op.border.r,
+				       op->op.border.t, op->op.border.b,
+				       op->op.border.sl, op->op.border.sr,
+				       op->op.border.st, op->op.border.sb,
+				       op->op.border.w, op->op.border.h);
+   evas_common_rgba_image_border_prepare(op->op.border.src, op->op.border.bands,
+					 dst, &(op->context),
+					 op->op.border.smooth,
+					 op->op.border.l, op->op.border.r,
+					 op->op.border.t, op->op.border.b,
+					 op->op.border.sl, op->op.border.sr,
+					 op->op.border.st, op->op.border.sb,
+					 op->op.border.fill,
+					 op->op.border.x, op->op.border.y,
+					 op->op.border.w, op->op.border.h);
+}
+
+/* all 9 slices of a bordered image as one op, so they are binned into
+ * tiles and handed to the threads once rather than 9 times */
+EAPI void
+evas_common_pipe_image_border_draw(RGBA_Image *src, RGBA_Image *dst,
+				   RGBA_Draw_Context *dc, int smooth,
+				   int l, int r, int t, int b,
+				   int sl, int sr, int st, int sb, int fill,
+				   int x, int y, int w, int h)
+{
+   RGBA_Pipe_Op *op;
+
+   if (!src) return;
+   dst->pipe = evas_common_pipe_add(dst->pipe, &op);
+   if (!dst->pipe) return;
+   op->op.border.smooth = smooth;
+   op->op.border.l = l;
+   op->op.border.r = r;
+   op->op.border.t = t;
+   op->op.border.b = b;
+   op->op.border.sl = sl;
+   op->op.border.sr = sr;
+   op->op.border.st = st;
+   op->op.border.sb = sb;
+   op->op.border.fill = fill;
+   op->op.border.x = x;
+   op->op.border.y = y;
+   op->op.border.w = w;
+   op->op.border.h = h;
+   op->op.border.bands = NULL;
+   op->op.border.prepared = 0;
+#ifdef EVAS_FRAME_QUEUING
+   LKL(src->ref_fq_add);
+   src->ref_fq[0]++;
+   LKU(src->ref_fq_add);
+#else
+   src->ref++;
+#endif
+   op->op.border.src = src;
+   op->op_func = evas_common_pipe_image_border_draw_do;
+   op->free_func = evas_common_pipe_op_image_border_free;
+   evas_common_pipe_draw_context_copy(dc, op);
+   evas_common_pipe_op_bounds_set(dst, op, x, y, w, h);
+
+#ifdef EVAS_FRAME_QUEUING
+   if (src->cache_entry.space == EVAS_COLORSPACE_ARGB8888)
+      evas_cache_image_load_data(&src->cache_entry);
+   evas_common_image_colorspace_normalize(src);
+   evas_common_pipe_image_border_prepare(dst, op);
+#else
+   /* src isn't loaded yet - the op is prepared in
+    * evas_common_pipe_map4_render() */
+   evas_common_pipe_image_load(src);
+#endif
+}
+
+static void
+evas_common_pipe_op_image_tile_free(RGBA_Pipe_Op *op)
+{
+   if ((op->op.tile.tile) && (op->op.tile.tile != op->op.tile.src))
+     evas_common_rgba_image_free(&op->op.tile.tile->cache_entry);
+#ifdef EVAS_FRAME_QUEUING
+   LKL(op->op.tile.src->ref_fq_del);
+   op->op.tile.src->ref_fq[1]++;
+   LKU(op->op.tile.src->ref_fq_del);
+   pthread_cond_signal(&(op->op.tile.src->cond_fq_del));
+#else
+   op->op.tile.src->ref--;
+   if (op->op.tile.src->ref == 0)
+     evas_cache_image_drop(&op->op.tile.src->cache_entry);
+#endif
+   evas_common_pipe_op_free(op);
+}
+
+/* the tile is normally built before the threads start. if it couldn't be
+ * each thread does its own */
+static void
+evas_common_pipe_image_tile_fill_do(RGBA_Image *dst, RGBA_Pipe_Op *op, RGBA_Draw_Context *dc)
+{
+   if (op->op.tile.tile)
+     evas_common_rgba_image_tile_fill(op->op.tile.tile, dst, dc,
+				      op->op.tile.tw, op->op.tile.th,
+				      op->op.tile.x, op->op.tile.y,
+				      op->op.tile.w, op->op.tile.h);
+   else
+     evas_common_rgba_image_tile_draw(op->op.tile.src, dst, dc,
+				      op->op.tile.smooth,
+				      op->op.tile.tw, op->op.tile.th,
+				      op->op.tile.x, op->op.tile.y,
+				      op->op.tile.w, op->op.tile.h);
+}
+
+static void
+evas_common_pipe_image_tile_draw_do(RGBA_Image *dst, RGBA_Pipe_Op *op, RGBA_Pipe_Thread_Info *info)
+{
+   if (info)
+     {
+	RGBA_Draw_Context context;
+
+	memcpy(&(context), &(op->context), sizeof(RGBA_Draw_Context));
+#ifdef EVAS_SLI
+	evas_common_draw_context_set_sli(&(context), info->y, info->h);
+#else
+	evas_common_draw_context_clip_clip(&(context), info->x, info->y, info->w, info->h);
+#endif
+	evas_common_pipe_image_tile_fill_do(dst, op, &(context));
+     }
+   else
+     evas_common_pipe_image_tile_fill_do(dst, op, &(op->context));
+}
+
+/* a whole tiled fill as one op - each tile the fill touches gets one
+ * scanline pass over its part, not one op per repeat of the image */
+EAPI void
+evas_common_pipe_image_tile_draw(RGBA_Image *src, RGBA_Image *dst,
+				 RGBA_Draw_Context *dc, int smooth,
+				 int tile_w, int tile_h,
+				 int x, int y, int w, int h)
+{
+   RGBA_Pipe_Op *op;
+
+   if (!src) return;
+   dst->pipe = evas_common_pipe_add(dst->pipe, &op);
+   if (!dst->pipe) return;
+   op->op.tile.smooth = smooth;
+   op->op.tile.tw = tile_w;
+   op->op.tile.th = tile_h;
+   op->op.tile.x = x;
+   op->op.tile.y = y;
+   op->op.tile.w = w;
+   op->op.tile.h = h;
+   op->op.tile.tile = NULL;
+#ifdef EVAS_FRAME_QUEUING
+   LKL(src->ref_fq_add);
+   src->ref_fq[0]++;
+   LKU(src->ref_fq_add);
+#else
+   src->ref++;
+#endif
+   op->op.tile.src = src;
+   op->op_func = evas_common_pipe_image_tile_draw_do;
+   op->free_func = evas_common_pipe_op_image_tile_free;
+   evas_common_pipe_draw_context_copy(dc, op);
+   evas_common_pipe_op_bounds_set(dst, op, x, y, w, h);
+
+#ifdef EVAS_FRAME_QUEUING
+   if (src->cache_entry.space == EVAS_COLORSPACE_ARGB8888)
+      evas_cache_image_load_data(&src->cache_entry);
+   evas_common_image_colorspace_normalize(src);
+   /* src is loaded now, so the tile can be made right away */
+   op->op.tile.tile = evas_common_rgba_image_tile_get(src, smooth,
+						      tile_w, tile_h);
+#else
+   /* src isn't loaded yet - the tile is made in
+    * evas_common_pipe_map4_render() */
+   evas_common_pipe_image_load(src);
+#endif
+}
+
 static void
 evas_common_pipe_op_map4_free(RGBA_Pipe_Op *op)
 {
@@ -1698,6 +2205,23 @@ evas_common_pipe_map4_draw(RGBA_Image *src, RGBA_Image *dst,
    op->op_func = evas_common_pipe_map4_draw_do;
    op->free_func = evas_common_pipe_op_map4_free;
    evas_common_pipe_draw_context_copy(dc, op);
+   {
+      FPc x1, y1, x2, y2;
+
+      x1 = x2 = p[0].x;
+      y1 = y2 = p[0].y;
+      for (i = 1; i < 4; i++)
+        {
+           if (p[i].x < x1) x1 = p[i].x;
+           if (p[i].x > x2) x2 = p[i].x;
+           if (p[i].y < y1) y1 = p[i].y;
+           if (p[i].y > y2) y2 = p[i].y;
+        }
+      evas_common_pipe_op_bounds_set(dst, op,
+                                     (x1 >> FP) - 1, (y1 >> FP) - 1,
+                                     ((x2 - x1) >> FP) + 3,
+                                     ((y2 - y1) >> FP) + 3);
+   }
 
 #ifdef EVAS_FRAME_QUEUING
    /* laod every src image here.
@@ -1734,6 +2258,26 @@ evas_common_pipe_map4_render(RGBA_Image *root)
 	      if (p->op[i].op.image.src->pipe)
 		evas_common_pipe_map4_render(p->op[i].op.image.src);
 	    }
+	  else if (p->op[i].op_func == evas_common_pipe_image_border_draw_do)
+	    {
+	      if (p->op[i].op.border.src->pipe)
+		evas_common_pipe_map4_render(p->op[i].op.border.src);
+	      evas_common_pipe_image_border_prepare(root, &(p->op[i]));
+	    }
+	  else if (p->op[i].op_func == evas_common_pipe_image_tile_draw_do)
+	    {
+	      RGBA_Pipe_Op *op = &(p->op[i]);
+
+	      if (op->op.tile.src->pipe)
+		evas_common_pipe_map4_render(op->op.tile.src);
+	      /* src is loaded and drawn by now - scale it to the tile once
+	       * here rather than once per thread */
+	      if (!op->op.tile.tile)
+		op->op.tile.tile = evas_common_rgba_image_tile_get(op->op.tile.src,
+								   op->op.tile.smooth,
+								   op->op.tile.tw,
+								   op->op.tile.th);
+	    }
 	}
     }
 
@@ -1810,8 +2354,11 @@ evas_common_pipe_init(void)
 
 	cpunum = eina_cpu_count();
 	thread_num = cpunum;
+	if (thread_num > TH_MAX) thread_num = TH_MAX;
 	if (thread_num == 1) return EINA_FALSE;
 
+	for (i = 0; i < thread_num; i++)
+	  LKI(tile_queue[i].lock);
 	pthread_barrier_init(&(thbarrier[0]), NULL, thread_num + 1);
 	pthread_barrier_init(&(thbarrier[1]), NULL, thread_num + 1);
 	for (i = 0; i < thread_num; i++)
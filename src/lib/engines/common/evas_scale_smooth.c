@@ -428,6 +428,15 @@ evas_common_scale_rgba_mipmap_down_1x2_mmx(DATA32 *src, DATA32 *dst, int src_w,
 #endif
 
 #ifdef BUILD_SCALE_SMOOTH
+# ifdef BUILD_SSE2
+#  include "evas_scale_smooth_scaler_sse2.c"
+#  undef SCALE_FUNC
+#  define SCALE_FUNC evas_common_scale_rgba_in_to_out_clip_smooth_sse2
+#  undef SCALE_USING_MMX
+#  define SCALE_USING_SSE2
+#  include "evas_scale_smooth_scaler.c"
+#  undef SCALE_USING_SSE2
+# endif
 # ifdef BUILD_MMX
 #  undef SCALE_FUNC
 #  define SCALE_FUNC evas_common_scale_rgba_in_to_out_clip_smooth_mmx
@@ -449,7 +458,7 @@ evas_common_scale_rgba_in_to_out_clip_smooth(RGBA_Image *src, RGBA_Image *dst,
 				 int dst_region_x, int dst_region_y,
 				 int dst_region_w, int dst_region_h)
 {
-# ifdef BUILD_MMX
+# if defined(BUILD_MMX) || defined(BUILD_SSE2)
    int mmx, sse, sse2;
 # endif
    Cutout_Rects *rects;
@@ -461,12 +470,21 @@ evas_common_scale_rgba_in_to_out_clip_smooth(RGBA_Image *src, RGBA_Image *dst,
    if ((dst_region_w <= 0) || (dst_region_h <= 0)) return;
    if (!(RECTS_INTERSECT(dst_region_x, dst_region_y, dst_region_w, dst_region_h, 0, 0, dst->cache_entry.w, dst->cache_entry.h)))
      return;
-# ifdef BUILD_MMX
+# if defined(BUILD_MMX) || defined(BUILD_SSE2)
    evas_common_cpu_can_do(&mmx, &sse, &sse2);
 # endif
    /* no cutouts - cut right to the chase */
    if (!dc->cutout.rects)
      {
+# ifdef BUILD_SSE2
+	if (sse2)
+	  evas_common_scale_rgba_in_to_out_clip_smooth_sse2(src, dst, dc,
+					       src_region_x, src_region_y,
+					       src_region_w, src_region_h,
+					       dst_region_x, dst_region_y,
+					       dst_region_w, dst_region_h);
+	else
+# endif
 # ifdef BUILD_MMX
 	if (mmx)
 	  evas_common_scale_rgba_in_to_out_clip_smooth_mmx(src, dst, dc,
@@ -500,6 +518,15 @@ evas_common_scale_rgba_in_to_out_clip_smooth(RGBA_Image *src, RGBA_Image *dst,
      {
 	r = rects->rects + i;
 	evas_common_draw_context_set_clip(dc, r->x, r->y, r->w, r->h);
+# ifdef BUILD_SSE2
+	if (sse2)
+	  evas_common_scale_rgba_in_to_out_clip_smooth_sse2(src, dst, dc,
+					       src_region_x, src_region_y,
+					       src_region_w, src_region_h,
+					       dst_region_x, dst_region_y,
+					       dst_region_w, dst_region_h);
+	else
+# endif
 # ifdef BUILD_MMX
 	if (mmx)
 	  evas_common_scale_rgba_in_to_out_clip_smooth_mmx(src, dst, dc,
@@ -24,7 +24,64 @@
    pbuf = buf;
 /*#ifndef SCALE_USING_MMX */
 /* for now there's no mmx down scaling - so C only */
-#if 1
+#ifdef SCALE_USING_SSE2
+     {
+	Scale_Down_Ring  ring;
+	int     *acc, direct = 0;
+	DATA32  or_mask = 0xff000000;
+
+#ifdef DIRECT_SCALE
+	if ((!src->cache_entry.flags.alpha) &&
+	    (!dst->cache_entry.flags.alpha) &&
+	    (!dc->mul.use))
+	  direct = 1;
+#endif
+	if (src->cache_entry.flags.alpha) or_mask = 0;
+	ring.cols = alloca(w * sizeof(Scale_Down_Col));
+	ring.row[0] = alloca(w * 4 * sizeof(int));
+	ring.row[1] = alloca(w * 4 * sizeof(int));
+	ring.y[0] = ring.y[1] = NULL;
+	ring.next = 0;
+	ring.w = w;
+	acc = alloca(w * 4 * sizeof(int));
+	_evas_scale_down_cols_calc(ring.cols, xp, xapp, w);
+
+	while (dst_clip_h--)
+	  {
+#ifdef EVAS_SLI
+	     if (((ysli) % dc->sli.h) == dc->sli.y)
+#endif
+	       {
+		  Cy = *yapp >> 16;
+		  yap = *yapp & 0xffff;
+
+		  memset(acc, 0, w * 4 * sizeof(int));
+		  sptr = *yp + pos;
+		  _evas_scale_down_row_add(&ring, sptr, yap, acc);
+		  for (j = (1 << 14) - yap; j > Cy; j -= Cy)
+		    {
+		       sptr += src_w;
+		       _evas_scale_down_row_add(&ring, sptr, Cy, acc);
+		    }
+		  if (j > 0)
+		    _evas_scale_down_row_add(&ring, sptr + src_w, j, acc);
+
+		  if (direct)
+		    _evas_scale_down_store_sse2(acc, dptr, or_mask, w);
+		  else
+		    {
+		       _evas_scale_down_store_sse2(acc, buf, or_mask, w);
+		       func(buf, NULL, dc->mul.col, dptr, w);
+		    }
+	       }
+#ifdef EVAS_SLI
+	     ysli++;
+#endif
+	     dptr += dst_w;
+	     yp++;  yapp++;
+	  }
+     }
+#else
    if (src->cache_entry.flags.alpha)
      {
 	while (dst_clip_h--)
@@ -372,7 +429,5 @@
 	       }
 	  }
      }
-#else
-   /* MMX scaling down would go here */
 #endif
 }
@@ -0,0 +1,238 @@
+/*
+ * vim:ts=8:sw=3:sts=8:noexpandtab:cino=>5n-3f0^-2{2
+ */
+
+/* sse2 passes for the smooth scaler.
+ *
+ * scaling up is split into a horizontal pass that filters a whole source
+ * row at once, using per column offset and weight tables worked out once
+ * per scale, and a vertical pass that interpolates 2 filtered rows. the
+ * filtered rows are kept in a 2 row ring, so the dst rows that land
+ * between the same 2 source rows (all of them, when zooming in) don't
+ * filter them again. it's the same INTERP_256, in the same order, as the
+ * C code so the output is identical.
+ *
+ * scaling down keeps the C box filter arithmetic, but does all 4 channels
+ * at once (32 bits each) and goes source row by source row: each row is
+ * summed horizontally into a row of accumulators and that is added to the
+ * dst row with the row's vertical weight. the source row that straddles 2
+ * dst rows is only summed once. */
+
+typedef struct _Scale_Up_Ring    Scale_Up_Ring;
+typedef struct _Scale_Down_Col   Scale_Down_Col;
+typedef struct _Scale_Down_Ring  Scale_Down_Ring;
+
+struct _Scale_Up_Ring
+{
+   DATA32 *src;
+   int     src_w;
+   int    *xo0, *xo1;
+   DATA16 *xa;
+   DATA32 *row[2];
+   int     y[2];
+   int     w;
+};
+
+struct _Scale_Down_Col
+{
+   int off;
+   int xap, cx;
+   int n, rem;
+};
+
+struct _Scale_Down_Ring
+{
+   Scale_Down_Col *cols;
+   int            *row[2];
+   DATA32         *y[2];
+   int             next;
+   int             w;
+};
+
+/* 1 pixel -> its 4 channels in 32 bit lanes, ready for _mm_madd_epi16 */
+#define SSE2_PIX32(p) \
+   _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(p), \
+                                        _mm_setzero_si128()), \
+                      _mm_setzero_si128())
+
+static void
+_evas_scale_up_cols_calc(int *xo0, int *xo1, DATA16 *xa,
+			 int sxx, int dsxx, int srw, int w)
+{
+   int i, sx, ax;
+
+   for (i = 0; i < w; i++)
+     {
+	sx = sxx >> 16;
+	ax = 1 + ((sxx - (sx << 16)) >> 8);
+	xo0[i] = sx;
+	xo1[i] = ((sx + 1) < srw) ? sx + 1 : sx;
+	/* one weight per channel so 2 columns load as 1 unpacked register */
+	xa[(i * 4) + 0] = xa[(i * 4) + 1] = ax;
+	xa[(i * 4) + 2] = xa[(i * 4) + 3] = ax;
+	sxx += dsxx;
+     }
+}
+
+static void EVAS_SSE2_FN
+_evas_scale_up_x_sse2(DATA32 *src, int *xo0, int *xo1, DATA16 *xa,
+		      DATA32 *dst, int w)
+{
+   DATA32 *e = dst + (w & ~3);
+   __m128i p0, p1, l0, h0, l1, h1;
+
+   while (dst < e)
+     {
+	p0 = _mm_set_epi32(src[xo0[3]], src[xo0[2]], src[xo0[1]], src[xo0[0]]);
+	p1 = _mm_set_epi32(src[xo1[3]], src[xo1[2]], src[xo1[1]], src[xo1[0]]);
+	SSE2_UNPACK(p0, l0, h0)
+	SSE2_UNPACK(p1, l1, h1)
+	l0 = _evas_sse2_interp_256(SSE2_LOAD(xa), l1, l0);
+	h0 = _evas_sse2_interp_256(SSE2_LOAD(xa + 8), h1, h0);
+	SSE2_STORE(dst, SSE2_PACK(l0, h0));
+	xo0 += 4;  xo1 += 4;  xa += 16;  dst += 4;
+     }
+   e += w & 3;
+   while (dst < e)
+     {
+	DATA32 q0 = src[*xo0], q1 = src[*xo1];
+
+	if (q0 | q1)
+	  q0 = INTERP_256(*xa, q1, q0);
+	*dst++ = q0;
+	xo0++;  xo1++;  xa += 4;
+     }
+}
+
+static void EVAS_SSE2_FN
+_evas_scale_up_y_sse2(DATA32 *s0, DATA32 *s1, int ay, DATA32 *dst, int w)
+{
+   DATA32 *e = dst + (w & ~3);
+   __m128i va, p0, p1, l0, h0, l1, h1;
+
+   va = _mm_set1_epi16(ay);
+   while (dst < e)
+     {
+	p0 = SSE2_LOAD(s0);
+	p1 = SSE2_LOAD(s1);
+	SSE2_UNPACK(p0, l0, h0)
+	SSE2_UNPACK(p1, l1, h1)
+	l0 = _evas_sse2_interp_256(va, l1, l0);
+	h0 = _evas_sse2_interp_256(va, h1, h0);
+	SSE2_STORE(dst, SSE2_PACK(l0, h0));
+	s0 += 4;  s1 += 4;  dst += 4;
+     }
+   e += w & 3;
+   while (dst < e)
+     {
+	DATA32 q0 = *s0, q1 = *s1;
+
+	if (q0 | q1)
+	  q0 = INTERP_256(ay, q1, q0);
+	*dst++ = q0;
+	s0++;  s1++;
+     }
+}
+
+/* horizontally filtered source row sy, from the ring if it's there. the
+ * slot holding row keep is never the one reused */
+static DATA32 *
+_evas_scale_up_row_get(Scale_Up_Ring *r, int sy, int keep)
+{
+   int i;
+
+   if (r->y[0] == sy) return r->row[0];
+   if (r->y[1] == sy) return r->row[1];
+   i = (r->y[0] == keep) ? 1 : 0;
+   _evas_scale_up_x_sse2(r->src + (sy * r->src_w), r->xo0, r->xo1, r->xa,
+			 r->row[i], r->w);
+   r->y[i] = sy;
+   return r->row[i];
+}
+
+static void
+_evas_scale_down_cols_calc(Scale_Down_Col *cols, int *xp, int *xapp, int w)
+{
+   int i;
+
+   for (; w > 0; w--, cols++, xp++, xapp++)
+     {
+	cols->off = *xp;
+	cols->cx = *xapp >> 16;
+	cols->xap = *xapp & 0xffff;
+	cols->n = 0;
+	for (i = (1 << 14) - cols->xap; i > cols->cx; i -= cols->cx)
+	  cols->n++;
+	cols->rem = (i > 0) ? i : 0;
+     }
+}
+
+/* sum source row sp into a row of accumulators, 4 ints per dst column */
+static void EVAS_SSE2_FN
+_evas_scale_down_x_sse2(DATA32 *sp, Scale_Down_Col *col, int *acc, int w)
+{
+   DATA32 *pix;
+   __m128i h, vc;
+   int k;
+
+   for (; w > 0; w--, col++, acc += 4)
+     {
+	pix = sp + col->off;
+	h = _mm_srli_epi32(_mm_madd_epi16(SSE2_PIX32(*pix),
+					  _mm_set1_epi32(col->xap)), 9);
+	pix++;
+	vc = _mm_set1_epi32(col->cx);
+	for (k = col->n; k > 0; k--)
+	  {
+	     h = _mm_add_epi32(h, _mm_srli_epi32(_mm_madd_epi16(SSE2_PIX32(*pix),
+							        vc), 9));
+	     pix++;
+	  }
+	if (col->rem > 0)
+	  h = _mm_add_epi32(h, _mm_srli_epi32(_mm_madd_epi16(SSE2_PIX32(*pix),
+							     _mm_set1_epi32(col->rem)), 9));
+	SSE2_STORE(acc, h);
+     }
+}
+
+/* the sums are < 1 << 13 and the weights <= 1 << 14, so both fit the low
+ * half of each lane and _mm_madd_epi16 does the 32 bit multiply */
+static void EVAS_SSE2_FN
+_evas_scale_down_y_sse2(int *h, int wy, int *acc, int w)
+{
+   __m128i vy = _mm_set1_epi32(wy);
+
+   for (; w > 0; w--, h += 4, acc += 4)
+     SSE2_STORE(acc, _mm_add_epi32(SSE2_LOAD(acc),
+				   _mm_srli_epi32(_mm_madd_epi16(SSE2_LOAD(h), vy), 14)));
+}
+
+static void
+_evas_scale_down_row_add(Scale_Down_Ring *r, DATA32 *sp, int wy, int *acc)
+{
+   int *h;
+
+   if (r->y[0] == sp) h = r->row[0];
+   else if (r->y[1] == sp) h = r->row[1];
+   else
+     {
+	h = r->row[r->next];
+	_evas_scale_down_x_sse2(sp, r->cols, h, r->w);
+	r->y[r->next] = sp;
+	r->next ^= 1;
+     }
+   _evas_scale_down_y_sse2(h, wy, acc, r->w);
+}
+
+static void EVAS_SSE2_FN
+_evas_scale_down_store_sse2(int *acc, DATA32 *dst, DATA32 or_mask, int w)
+{
+   __m128i v;
+
+   for (; w > 0; w--, acc += 4, dst++)
+     {
+	v = _mm_srli_epi32(SSE2_LOAD(acc), 5);
+	v = _mm_packs_epi32(v, v);
+	*dst = _mm_cvtsi128_si32(_mm_packus_epi16(v, v)) | or_mask;
+     }
+}
@@ -11,6 +11,10 @@
    DATA32      *psrc, *pdst, *pdst_end;
    DATA32      *buf, *pbuf, *pbuf_end;
    RGBA_Gfx_Func  func = NULL;
+#ifdef SCALE_USING_SSE2
+   int         *xo0 = NULL, *xo1 = NULL;
+   DATA16      *xa = NULL;
+#endif
 
    /* a scanline buffer */
    pdst = dst_ptr;  // it's been set at (dst_clip_x, dst_clip_y)
@@ -55,6 +59,16 @@
    sx = sxx >> 16;
    sy = syy >> 16;
 
+#ifdef SCALE_USING_SSE2
+   if (drw != srw)
+     {
+	xo0 = alloca(dst_clip_w * sizeof(int));
+	xo1 = alloca(dst_clip_w * sizeof(int));
+	xa = alloca(dst_clip_w * 4 * sizeof(DATA16));
+	_evas_scale_up_cols_calc(xo0, xo1, xa, sxx, dsxx, srw, dst_clip_w);
+     }
+#endif
+
    if (drh == srh)
      {
 	int  sxx0 = sxx;
@@ -68,6 +82,9 @@
 	     if (((ysli) % dc->sli.h) == dc->sli.y)
 #endif
 	       {
+#ifdef SCALE_USING_SSE2
+		  _evas_scale_up_x_sse2(psrc, xo0, xo1, xa, buf, dst_clip_w);
+#else
 		  pbuf = buf;  pbuf_end = buf + dst_clip_w;
 		  sxx = sxx0;
 #ifdef SCALE_USING_MMX
@@ -101,6 +118,7 @@
 #endif
 			 sxx += dsxx;
 		      }
+#endif
 		  /* * blend here [clip_w *] buf -> dptr * */
 		  if (!direct_scale)
 		    func(buf, NULL, dc->mul.col, pdst, dst_clip_w);
@@ -133,6 +151,10 @@
 		  sy = syy >> 16;
 		  psrc = ps + (sy * src_w);
 		  ay = 1 + ((syy - (sy << 16)) >> 8);
+#ifdef SCALE_USING_SSE2
+		  _evas_scale_up_y_sse2(psrc, ((sy + 1) < srh) ? psrc + src_w : psrc,
+					ay, buf, dst_clip_w);
+#else
 #ifdef SCALE_USING_MMX
 		  pxor_r2r(mm0, mm0);
 		  MOV_A2R(ALPHA_255, mm5)
@@ -161,6 +183,7 @@
 #endif
 		       psrc++;
 		    }
+#endif
 		  /* * blend here [clip_w *] buf -> dptr * */
 		  if (!direct_scale)
 		    func(buf, NULL, dc->mul.col, pdst, dst_clip_w);
@@ -181,6 +204,19 @@
 #ifdef EVAS_SLI
 	int ysli = dst_clip_y;
 #endif
+#ifdef SCALE_USING_SSE2
+	Scale_Up_Ring  ring;
+	DATA32  *row0, *row1, *near;
+	int     near_y = -1, i;
+
+	ring.src = ps;  ring.src_w = src_w;
+	ring.xo0 = xo0;  ring.xo1 = xo1;  ring.xa = xa;
+	ring.row[0] = alloca(dst_clip_w * sizeof(DATA32));
+	ring.row[1] = alloca(dst_clip_w * sizeof(DATA32));
+	ring.y[0] = ring.y[1] = -1;
+	ring.w = dst_clip_w;
+	near = alloca(dst_clip_w * sizeof(DATA32));
+#endif
 
 	while (pdst < pdst_end)
 	  {
@@ -193,6 +229,24 @@
 		  sy = syy >> 16;
 		  psrc = ps + (sy * src_w);
 		  ay = 1 + ((syy - (sy << 16)) >> 8);
+#ifdef SCALE_USING_SSE2
+		  row0 = _evas_scale_up_row_get(&ring, sy, sy + 1);
+		  if ((sy + 1) < srh)
+		    row1 = _evas_scale_up_row_get(&ring, sy + 1, sy);
+		  else
+		    {
+		       /* past the last row the C code pairs the filtered row
+			* with the unfiltered left pixels */
+		       if (near_y != sy)
+			 {
+			    for (i = 0; i < dst_clip_w; i++)
+			      near[i] = psrc[xo0[i]];
+			    near_y = sy;
+			 }
+		       row1 = near;
+		    }
+		  _evas_scale_up_y_sse2(row0, row1, ay, buf, dst_clip_w);
+#else
 #ifdef SCALE_USING_MMX
 		  MOV_A2R(ay, mm4)
 		    pxor_r2r(mm0, mm0);
@@ -246,6 +300,7 @@
 #endif
 		       sxx += dsxx;
 		    }
+#endif
 		  /* * blend here [clip_w *] buf -> dptr * */
 		  if (!direct_scale)
 		    func(buf, NULL, dc->mul.col, pdst, dst_clip_w);
@@ -849,6 +849,255 @@ static int  tilebuf_intersect(int tsize, int tlen, int tnum, int x, int w, int *
 #endif
 static void tilebuf_setup(Tilebuf *tb);
 
+/* region strategy: damage is kept as a bitmap of tiles, so adding a rect
+ * costs the same whatever else is pending (it just sets the bits it
+ * covers) instead of being split against every rect already in the list.
+ * the render rects are the runs of set tiles on each tile row, with runs
+ * that are the same on consecutive rows coalesced into 1 rect */
+
+#ifndef REGION_FUZZ
+# define REGION_FUZZ (32 * 32)
+#endif
+
+static void
+_region_free(Tilebuf *tb)
+{
+   if (tb->region.bits) free(tb->region.bits);
+   if (tb->region.open[0]) free(tb->region.open[0]);
+   if (tb->region.open[1]) free(tb->region.open[1]);
+   tb->region.bits = NULL;
+   tb->region.open[0] = NULL;
+   tb->region.open[1] = NULL;
+   tb->region.w = 0;
+   tb->region.h = 0;
+}
+
+static void
+_region_setup(Tilebuf *tb)
+{
+   int runs;
+
+   _region_free(tb);
+   if ((tb->outbuf_w <= 0) || (tb->outbuf_h <= 0)) return;
+   tb->region.w = (tb->outbuf_w + (tb->tile_size.w - 1)) / tb->tile_size.w;
+   tb->region.h = (tb->outbuf_h + (tb->tile_size.h - 1)) / tb->tile_size.h;
+   tb->region.stride = (tb->region.w + 31) >> 5;
+   /* a tile row has at most 1 run for every 2 tiles */
+   runs = (tb->region.w + 1) / 2;
+   tb->region.bits = calloc(tb->region.stride * tb->region.h, sizeof(DATA32));
+   tb->region.open[0] = malloc(runs * sizeof(Tilebuf_Band));
+   tb->region.open[1] = malloc(runs * sizeof(Tilebuf_Band));
+   if ((!tb->region.bits) || (!tb->region.open[0]) || (!tb->region.open[1]))
+     _region_free(tb);
+   tb->region.y1 = tb->region.h;
+   tb->region.y2 = -1;
+}
+
+static void
+_region_span_set(DATA32 *row, int x1, int x2, int on)
+{
+   DATA32 m1, m2;
+   int w1, w2, i;
+
+   w1 = x1 >> 5;
+   w2 = x2 >> 5;
+   m1 = 0xffffffff << (x1 & 31);
+   m2 = 0xffffffff >> (31 - (x2 & 31));
+   if (w1 == w2)
+     {
+        m1 &= m2;
+        if (on) row[w1] |= m1;
+        else row[w1] &= ~m1;
+        return;
+     }
+   if (on)
+     {
+        row[w1] |= m1;
+        for (i = w1 + 1; i < w2; i++) row[i] = 0xffffffff;
+        row[w2] |= m2;
+     }
+   else
+     {
+        row[w1] &= ~m1;
+        for (i = w1 + 1; i < w2; i++) row[i] = 0;
+        row[w2] &= ~m2;
+     }
+}
+
+/* first tile from x on that is set (or clear), w if there is none */
+static int
+_region_bit_next(const DATA32 *row, int x, int w, int set)
+{
+   DATA32 v;
+   int i;
+
+   if (x >= w) return w;
+   i = x >> 5;
+   v = set ? row[i] : ~row[i];
+   v &= 0xffffffff << (x & 31);
+   while (!v)
+     {
+        i++;
+        if ((i << 5) >= w) return w;
+        v = set ? row[i] : ~row[i];
+     }
+   x = i << 5;
+   while (!(v & 1))
+     {
+        v >>= 1;
+        x++;
+     }
+   return (x < w) ? x : w;
+}
+
+static int
+_region_add(Tilebuf *tb, int x, int y, int w, int h)
+{
+   DATA32 *row;
+   int tx1, ty1, tx2, ty2, ty;
+
+   if (!tb->region.bits) _region_setup(tb);
+   if (!tb->region.bits) return 0;
+   if ((w <= 0) || (h <= 0)) return 0;
+   RECTS_CLIP_TO_RECT(x, y, w, h, 0, 0, tb->outbuf_w, tb->outbuf_h);
+   if ((w <= 0) || (h <= 0)) return 0;
+
+   tx1 = x / tb->tile_size.w;
+   ty1 = y / tb->tile_size.h;
+   tx2 = (x + w - 1) / tb->tile_size.w;
+   ty2 = (y + h - 1) / tb->tile_size.h;
+   row = tb->region.bits + (ty1 * tb->region.stride);
+   for (ty = ty1; ty <= ty2; ty++, row += tb->region.stride)
+     _region_span_set(row, tx1, tx2, 1);
+   if (ty1 < tb->region.y1) tb->region.y1 = ty1;
+   if (ty2 > tb->region.y2) tb->region.y2 = ty2;
+   return (tx2 - tx1 + 1) * (ty2 - ty1 + 1);
+}
+
+static int
+_region_del(Tilebuf *tb, int x, int y, int w, int h)
+{
+   DATA32 *row;
+   int tx1, ty1, tx2, ty2, ty;
+
+   if (!tb->region.bits) return 0;
+   if ((w <= 0) || (h <= 0)) return 0;
+   RECTS_CLIP_TO_RECT(x, y, w, h, 0, 0, tb->outbuf_w, tb->outbuf_h);
+   if ((w <= 0) || (h <= 0)) return 0;
+
+   /* only tiles the rect covers completely. the last column and row of
+    * tiles may be cut short by the edge of the buffer */
+   tx1 = (x + (tb->tile_size.w - 1)) / tb->tile_size.w;
+   ty1 = (y + (tb->tile_size.h - 1)) / tb->tile_size.h;
+   if ((x + w) >= tb->outbuf_w) tx2 = tb->region.w - 1;
+   else tx2 = ((x + w) / tb->tile_size.w) - 1;
+   if ((y + h) >= tb->outbuf_h) ty2 = tb->region.h - 1;
+   else ty2 = ((y + h) / tb->tile_size.h) - 1;
+   if ((tx1 > tx2) || (ty1 > ty2)) return 0;
+
+   row = tb->region.bits + (ty1 * tb->region.stride);
+   for (ty = ty1; ty <= ty2; ty++, row += tb->region.stride)
+     _region_span_set(row, tx1, tx2, 0);
+   return (tx2 - tx1 + 1) * (ty2 - ty1 + 1);
+}
+
+static void
+_region_clear(Tilebuf *tb)
+{
+   if (!tb->region.bits) return;
+   if (tb->region.y2 >= tb->region.y1)
+     memset(tb->region.bits + (tb->region.y1 * tb->region.stride), 0,
+            (tb->region.y2 - tb->region.y1 + 1) * tb->region.stride *
+            sizeof(DATA32));
+   tb->region.y1 = tb->region.h;
+   tb->region.y2 = -1;
+}
+
+static Tilebuf_Rect *
+_region_rect_close(Tilebuf *tb, Tilebuf_Rect *rects, Tilebuf_Rect *r)
+{
+   if ((r->x + r->w) > tb->outbuf_w) r->w = tb->outbuf_w - r->x;
+   if ((r->y + r->h) > tb->outbuf_h) r->h = tb->outbuf_h - r->y;
+   return (Tilebuf_Rect *)eina_inlist_append(EINA_INLIST_GET(rects),
+                                             EINA_INLIST_GET(r));
+}
+
+static Tilebuf_Rect *
+_region_rects_get(Tilebuf *tb)
+{
+   Tilebuf_Rect *rects = NULL, *r;
+   Tilebuf_Band *prev, *cur, *tmp;
+   const DATA32 *row;
+   int nprev = 0, ncur, i, ty, x1, x2, rx, rw, ux1, ux2, waste;
+
+   if (!tb->region.bits) return NULL;
+   prev = tb->region.open[0];
+   cur = tb->region.open[1];
+   /* 1 more row than there is, with no runs, closes what's still open */
+   for (ty = tb->region.y1; ty <= (tb->region.y2 + 1); ty++)
+     {
+        ncur = 0;
+        i = 0;
+        if (ty <= tb->region.y2)
+          {
+             row = tb->region.bits + (ty * tb->region.stride);
+             for (x1 = _region_bit_next(row, 0, tb->region.w, 1);
+                  x1 < tb->region.w;
+                  x1 = _region_bit_next(row, x2, tb->region.w, 1))
+               {
+                  x2 = _region_bit_next(row, x1, tb->region.w, 0);
+                  rx = x1 * tb->tile_size.w;
+                  rw = (x2 - x1) * tb->tile_size.w;
+                  /* both rows' runs are in x order */
+                  while ((i < nprev) &&
+                         ((prev[i].rect->x + prev[i].rect->w) <= rx))
+                    rects = _region_rect_close(tb, rects, prev[i++].rect);
+                  /* grow the rect above to take this run too if that
+                   * doesn't mean drawing much that isn't damaged, and it
+                   * stays clear of its neighbours */
+                  if ((i < nprev) && (prev[i].rect->x < (rx + rw)))
+                    {
+                       r = prev[i].rect;
+                       ux1 = (r->x < rx) ? r->x : rx;
+                       ux2 = ((r->x + r->w) > (rx + rw)) ? r->x + r->w : rx + rw;
+                       waste = ((ux2 - ux1) * (r->h + tb->tile_size.h)) -
+                         (prev[i].area + (rw * tb->tile_size.h));
+                       if ((waste <= REGION_FUZZ) &&
+                           (((i + 1) >= nprev) || (prev[i + 1].rect->x >= ux2)) &&
+                           ((ncur == 0) ||
+                            ((cur[ncur - 1].rect->x + cur[ncur - 1].rect->w) <= ux1)))
+                         {
+                            r->x = ux1;
+                            r->w = ux2 - ux1;
+                            r->h += tb->tile_size.h;
+                            cur[ncur].rect = r;
+                            cur[ncur].area = prev[i].area + (rw * tb->tile_size.h);
+                            ncur++;
+                            i++;
+                            continue;
+                         }
+                    }
+                  r = malloc(sizeof(Tilebuf_Rect));
+                  if (!r) continue;
+                  r->x = rx;
+                  r->y = ty * tb->tile_size.h;
+                  r->w = rw;
+                  r->h = tb->tile_size.h;
+                  cur[ncur].rect = r;
+                  cur[ncur].area = rw * tb->tile_size.h;
+                  ncur++;
+               }
+          }
+        while (i < nprev)
+          rects = _region_rect_close(tb, rects, prev[i++].rect);
+        tmp = prev;
+        prev = cur;
+        cur = tmp;
+        nprev = ncur;
+     }
+   return rects;
+}
+
 EAPI void
 evas_common_tilebuf_init(void)
 {
@@ -866,6 +1115,8 @@ evas_common_tilebuf_new(int w, int h)
    tb->tile_size.h = 8;
    tb->outbuf_w = w;
    tb->outbuf_h = h;
+   if (getenv("EVAS_TILER_REGION"))
+     tb->strategy = TILEBUF_STRATEGY_REGION;
 
    return tb;
 }
@@ -873,6 +1124,7 @@ evas_common_tilebuf_new(int w, int h)
 EAPI void
 evas_common_tilebuf_free(Tilebuf *tb)
 {
+   _region_free(tb);
 #ifdef RECTUPDATE
    evas_common_regionbuf_free(tb->rb);
 #elif defined(EVAS_RECT_SPLIT)
@@ -899,6 +1151,16 @@ evas_common_tilebuf_get_tile_size(Tilebuf *tb, int *tw, int *th)
    if (th) *th = tb->tile_size.h;
 }
 
+EAPI void
+evas_common_tilebuf_strategy_set(Tilebuf *tb, Tilebuf_Strategy strategy)
+{
+   if (tb->strategy == strategy) return;
+   evas_common_tilebuf_clear(tb);
+   tb->strategy = strategy;
+   if (strategy == TILEBUF_STRATEGY_REGION) _region_setup(tb);
+   else _region_free(tb);
+}
+
 #ifdef EVAS_RECT_SPLIT
 static inline int
 _add_redraw(list_t *rects, int max_w, int max_h, int x, int y, int w, int h)
@@ -931,6 +1193,8 @@ _add_redraw(list_t *rects, int max_w, int max_h, int x, int y, int w, int h)
 EAPI int
 evas_common_tilebuf_add_redraw(Tilebuf *tb, int x, int y, int w, int h)
 {
+   if (tb->strategy == TILEBUF_STRATEGY_REGION)
+     return _region_add(tb, x, y, w, h);
 #ifdef RECTUPDATE
    int i;
 
@@ -982,6 +1246,8 @@ evas_common_tilebuf_add_redraw(Tilebuf *tb, int x, int y, int w, int h)
 EAPI int
 evas_common_tilebuf_del_redraw(Tilebuf *tb, int x, int y, int w, int h)
 {
+   if (tb->strategy == TILEBUF_STRATEGY_REGION)
+     return _region_del(tb, x, y, w, h);
 #ifdef RECTUPDATE
    int i;
 
@@ -1054,6 +1320,8 @@ evas_common_tilebuf_del_redraw(Tilebuf *tb, int x, int y, int w, int h)
 EAPI int
 evas_common_tilebuf_add_motion_vector(Tilebuf *tb, int x, int y, int w, int h, int dx, int dy, int alpha __UNUSED__)
 {
+   if (tb->strategy == TILEBUF_STRATEGY_REGION)
+     return _region_add(tb, x, y, w, h) + _region_add(tb, x + dx, y + dy, w, h);
 #ifdef EVAS_RECT_SPLIT
    list_t lr = list_zeroed;
    int num;
@@ -1081,6 +1349,11 @@ evas_common_tilebuf_add_motion_vector(Tilebuf *tb, int x, int y, int w, int h, i
 EAPI void
 evas_common_tilebuf_clear(Tilebuf *tb)
 {
+   if (tb->strategy == TILEBUF_STRATEGY_REGION)
+     {
+        _region_clear(tb);
+        return;
+     }
 #ifdef RECTUPDATE
    evas_common_regionbuf_clear(tb->rb);
 #elif defined(EVAS_RECT_SPLIT)
@@ -1095,6 +1368,8 @@ evas_common_tilebuf_clear(Tilebuf *tb)
 EAPI Tilebuf_Rect *
 evas_common_tilebuf_get_render_rects(Tilebuf *tb)
 {
+   if (tb->strategy == TILEBUF_STRATEGY_REGION)
+     return _region_rects_get(tb);
 #ifdef RECTUPDATE
    return evas_common_regionbuf_rects_get(tb->rb);
 #elif defined(EVAS_RECT_SPLIT)
@@ -1247,6 +1522,7 @@ static void
 tilebuf_setup(Tilebuf *tb)
 {
    if ((tb->outbuf_w <= 0) || (tb->outbuf_h <= 0)) return;
+   if (tb->strategy == TILEBUF_STRATEGY_REGION) _region_setup(tb);
 #ifdef RECTUPDATE
    tb->rb = evas_common_regionbuf_new(tb->outbuf_w, tb->outbuf_h);
 #elif defined(EVAS_RECT_SPLIT)
@@ -4,6 +4,9 @@
 #if defined BUILD_MMX || defined BUILD_SSE
 #include "evas_mmx.h"
 #endif
+#if defined BUILD_SSE2 || defined BUILD_AVX2
+#include "evas_sse2.h"
+#endif
 
 /* src pixel flags: */
 
@@ -65,10 +68,12 @@
 #define CPU_SSE 3
 /* cpu SSE2 */
 #define CPU_SSE2 4
-/* cpu flags count */
+/* cpu NEON */
 #define CPU_NEON 5
+/* cpu AVX2 */
+#define CPU_AVX2 6
 /* cpu flags count */
-#define CPU_LAST 6
+#define CPU_LAST 7
 
 
 /* some useful constants */
@@ -396,12 +396,14 @@ typedef struct _RGBA_Gfx_Compositor   RGBA_Gfx_Compositor;
 
 typedef struct _Cutout_Rect           Cutout_Rect;
 typedef struct _Cutout_Rects            Cutout_Rects;
+typedef struct _Cutout_Region           Cutout_Region;
 
 typedef struct _Convert_Pal             Convert_Pal;
 
 typedef struct _Tilebuf                 Tilebuf;
 typedef struct _Tilebuf_Tile            Tilebuf_Tile;
 typedef struct _Tilebuf_Rect		Tilebuf_Rect;
+typedef struct _Tilebuf_Band            Tilebuf_Band;
 
 typedef struct _Evas_Common_Transform        Evas_Common_Transform;
 
@@ -482,9 +484,17 @@ typedef enum _CPU_Features
    CPU_FEATURE_ALTIVEC = (1 << 3),
    CPU_FEATURE_VIS     = (1 << 4),
    CPU_FEATURE_VIS2    = (1 << 5),
-   CPU_FEATURE_NEON    = (1 << 6)
+   CPU_FEATURE_NEON    = (1 << 6),
+   CPU_FEATURE_SSE2    = (1 << 7),
+   CPU_FEATURE_AVX2    = (1 << 8)
 } CPU_Features;
 
+typedef enum _Tilebuf_Strategy
+{
+   TILEBUF_STRATEGY_DEFAULT, /* what the build picked: rect split and merge */
+   TILEBUF_STRATEGY_REGION /* tile bitmap, coalesced into bands */
+} Tilebuf_Strategy;
+
 typedef enum _Font_Hint_Flags
 {
    FONT_NO_HINT,
@@ -640,6 +650,10 @@ struct _RGBA_Draw_Context
       Eina_Bool use : 1;
    } clip;
    Cutout_Rects cutout;
+   struct {
+      Cutout_Region     *region; /* what cutout leaves visible - built on first use */
+      RGBA_Draw_Context *owner;  /* the context region belongs to - not a copy of it */
+   } cutout_cache;
    struct {
       struct {
 	 void *(*gl_new)  (void *data, RGBA_Font_Glyph *fg);
@@ -664,6 +678,9 @@ struct _RGBA_Draw_Context
 struct _RGBA_Pipe_Op
 {
    RGBA_Draw_Context         context;
+   struct {
+      int                    x, y, w, h;
+   } bounds; /* dest area this op can touch - used to bin it into tiles */
    void                    (*op_func) (RGBA_Image *dst, RGBA_Pipe_Op *op, RGBA_Pipe_Thread_Info *info);
    void                    (*free_func) (RGBA_Pipe_Op *op);
 
@@ -702,6 +719,21 @@ struct _RGBA_Pipe_Op
 	 int                 smooth;
 	 int                 level;
       } map4;
+      struct {
+	 RGBA_Image         *src;
+	 void               *bands; /* from evas_common_rgba_image_border_get() */
+	 int                 l, r, t, b, sl, sr, st, sb, fill;
+	 int                 x, y, w, h;
+	 int                 smooth;
+	 Eina_Bool           prepared : 1;
+      } border;
+      struct {
+	 RGBA_Image         *src;
+	 RGBA_Image         *tile; /* src at tw x th, shared by all threads */
+	 int                 tw, th;
+	 int                 x, y, w, h;
+	 int                 smooth;
+      } tile;
    } op;
 };
 
@@ -770,6 +802,8 @@ struct _RGBA_Image
       int populate_count;
       unsigned long long newest_usage;
       unsigned long long newest_usage_count;
+      RGBA_Image *mipmap; // this image at half size, made on demand
+      Eina_List *borders; // scaled border bands, see evas_image_border.c
    } cache;
 };
 
@@ -963,6 +997,14 @@ struct _Fash_Glyph
    Fash_Glyph_Map *bucket[256];
    void (*freeme) (Fash_Glyph *fash);
 };
+
+/* glyphs and their bitmaps are packed into slabs owned by the font int */
+typedef struct _Font_Glyph_Arena Font_Glyph_Arena;
+struct _Font_Glyph_Arena
+{
+   Font_Glyph_Arena *next;
+   int               size, used;
+};
 /////
 
 struct _RGBA_Font
@@ -1006,6 +1048,7 @@ struct _RGBA_Font_Int
    int              references;
 
    Fash_Glyph *fash;
+   Font_Glyph_Arena *arena;
    unsigned char sizeok : 1;
 };
 
@@ -1023,6 +1066,8 @@ struct _RGBA_Font_Source
       FT_Face       face;
    } ft;
 
+   LK(glyph_lock); // rendering glyphs of ft.face, for all sizes
+
    int              references;
 };
 
@@ -1123,6 +1168,14 @@ struct _Tilebuf
       int           w, h;
    } tile_size;
 
+   Tilebuf_Strategy strategy;
+   struct {
+      DATA32        *bits; /* 1 bit per tile, rows padded to 32 tiles */
+      Tilebuf_Band  *open[2]; /* rects still growing down */
+      int            w, h, stride;
+      int            y1, y2; /* tile rows that may have bits set */
+   } region;
+
 #ifdef RECTUPDATE
    Regionbuf *rb;
 #elif defined(EVAS_RECT_SPLIT)
@@ -1156,6 +1209,12 @@ struct _Tilebuf_Rect
    EINA_INLIST;
    int               x, y, w, h;
 };
+
+struct _Tilebuf_Band
+{
+   Tilebuf_Rect     *rect;
+   int               area; /* how much of rect is really damaged */
+};
 /*
 struct _Regionbuf
 {
@@ -1290,6 +1349,7 @@ EAPI Tilebuf      *evas_common_tilebuf_new               (int w, int h);
 EAPI void          evas_common_tilebuf_free              (Tilebuf *tb);
 EAPI void          evas_common_tilebuf_set_tile_size     (Tilebuf *tb, int tw, int th);
 EAPI void          evas_common_tilebuf_get_tile_size     (Tilebuf *tb, int *tw, int *th);
+EAPI void          evas_common_tilebuf_strategy_set      (Tilebuf *tb, Tilebuf_Strategy strategy);
 EAPI int           evas_common_tilebuf_add_redraw        (Tilebuf *tb, int x, int y, int w, int h);
 EAPI int           evas_common_tilebuf_del_redraw        (Tilebuf *tb, int x, int y, int w, int h);
 EAPI int           evas_common_tilebuf_add_motion_vector (Tilebuf *tb, int x, int y, int w, int h, int dx, int dy, int alpha);
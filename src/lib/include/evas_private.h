@@ -92,6 +92,10 @@ MAGIC_CHECK_FAILED(o, t, m)
 #define MERR_FATAL() _evas_alloc_error = EVAS_ALLOC_ERROR_FATAL
 #define MERR_BAD() _evas_alloc_error = EVAS_ALLOC_ERROR_RECOVERED
 
+/* the smooth value image_draw gets for EVAS_IMAGE_SMOOTH_SCALE_MODE_MIPMAP.
+ * engines without mipmaps just see smooth scaling on */
+#define EVAS_SMOOTH_SCALE_MIPMAP 2
+
 #define EVAS_OBJECT_IMAGE_FREE_FILE_AND_KEY(o)                              \
    if ((o)->cur.file)                                                       \
      {                                                                      \
@@ -323,6 +327,19 @@ struct _Evas
 
    Eina_List     *font_path;
 
+   struct {
+      Eina_List    **cells;
+      Eina_List     *big;
+      int            cells_w, cells_h;
+      Evas_Coord     x, y, w, h;
+      Evas_Coord     cell_w, cell_h;
+      int            maps;
+      Evas_Object  **found;
+      int            found_max;
+      unsigned char  dirty : 1;
+      unsigned char  order_dirty : 1;
+   } spatial;
+
    Evas_Object   *focused;
    void          *attach_data;
    Evas_Modifier  modifiers;
@@ -330,6 +347,7 @@ struct _Evas
    unsigned int   last_timestamp;
    int            last_mouse_down_counter;
    int            last_mouse_up_counter;
+   unsigned int   render_frame;
    Evas_Font_Hinting_Flags hinting;
    unsigned char  changed : 1;
    unsigned char  delete_me : 1;
@@ -395,6 +413,15 @@ struct _Evas_Map
    void *surface; // surface holding map if needed
    int surface_w, surface_h; // current surface w & h alloc
    Evas_Coord mx, my; // mouse x, y after conversion to map space
+   struct {
+      void *surface; // surface holding the mapped output if it is static
+      int x, y, w, h; // where the cached output goes on the canvas
+      unsigned int frame; // render frame the points last changed in
+      Evas_Map_Point points[4]; // points the cached output was made from
+      Eina_Bool alpha : 1;
+      Eina_Bool smooth : 1;
+      Eina_Bool valid : 1;
+   } cache;
    Eina_Bool alpha : 1;
    Eina_Bool smooth : 1;
    Evas_Map_Point points[]; // actual points
@@ -466,6 +493,14 @@ struct _Evas_Object
       Evas_Object      *parent;
    } smart;
 
+   struct {
+      int               x1, y1, x2, y2;
+      int               order;
+      Eina_Bool         indexed : 1;
+      Eina_Bool         big : 1;
+      Eina_Bool         mapped : 1;
+   } spatial;
+
    Evas_Size_Hints            *size_hints;
 
    int                         last_mouse_down_counter;
@@ -729,6 +764,11 @@ struct _Evas_Func
    void (*image_map4_draw)                 (void *data, void *context, void *surface, void *image, RGBA_Map_Point *p, int smooth, int level);
    void *(*image_map_surface_new)          (void *data, int w, int h, int alpha);
    void (*image_map_surface_free)          (void *data, void *surface);
+
+   /* optional - without it a bordered image is drawn as 9 image_draw calls */
+   void (*image_border_draw)               (void *data, void *context, void *surface, void *image, int l, int r, int t, int b, int sl, int sr, int st, int sb, int fill, int x, int y, int w, int h, int smooth);
+   /* optional - without it a tiled fill is drawn as 1 image_draw per tile */
+   void (*image_tile_draw)                 (void *data, void *context, void *surface, void *image, int tile_w, int tile_h, int x, int y, int w, int h, int smooth);
 };
 
 struct _Evas_Image_Load_Func
@@ -761,6 +801,12 @@ void evas_rects_return_difference_rects(Eina_Array *rects, int x, int y, int w,
 
 void evas_object_clip_dirty(Evas_Object *obj);
 void evas_object_recalc_clippees(Evas_Object *obj);
+void evas_spatial_init(Evas *e);
+void evas_spatial_shutdown(Evas *e);
+void evas_object_spatial_update(Evas_Object *obj);
+void evas_object_spatial_map_update(Evas_Object *obj);
+void evas_object_spatial_del(Evas_Object *obj);
+Eina_Bool evas_spatial_objects_at_xy_get(Evas *e, Evas_Coord x, Evas_Coord y, Evas_Object ***objs, int *num);
 Evas_Layer *evas_layer_new(Evas *e);
 void evas_layer_pre_free(Evas_Layer *lay);
 void evas_layer_free_objects(Evas_Layer *lay);
@@ -794,6 +840,7 @@ const Evas_Smart_Cb_Description *evas_smart_cb_description_find(const Evas_Smart
 
 void evas_object_smart_del(Evas_Object *obj);
 void evas_object_smart_cleanup(Evas_Object *obj);
+void evas_smart_event_ids_shutdown(void);
 void evas_object_smart_member_raise(Evas_Object *member);
 void evas_object_smart_member_lower(Evas_Object *member);
 void evas_object_smart_member_stack_above(Evas_Object *member, Evas_Object *other);
@@ -815,6 +862,7 @@ void evas_object_inform_call_resize(Evas_Object *obj);
 void evas_object_inform_call_restack(Evas_Object *obj);
 void evas_object_inform_call_changed_size_hints(Evas_Object *obj);
 void evas_object_inform_call_image_preloaded(Evas_Object *obj);
+int _evas_object_image_preload_priority_get(Evas_Object *obj);
 void evas_object_intercept_cleanup(Evas_Object *obj);
 int evas_object_intercept_call_show(Evas_Object *obj);
 int evas_object_intercept_call_hide(Evas_Object *obj);
@@ -866,8 +914,10 @@ void _evas_preload_thread_shutdown(void);
 Evas_Preload_Pthread *evas_preload_thread_run(void (*func_heavy)(void *data),
 					     void (*func_end)(void *data),
 					     void (*func_cancel)(void *data),
-					     const void *data);
+					     const void *data,
+					     int priority);
 Eina_Bool evas_preload_thread_cancel(Evas_Preload_Pthread *thread);
+void evas_preload_thread_priority_raise(Evas_Preload_Pthread *thread, int priority);
 
 void _evas_walk(Evas *e);
 void _evas_unwalk(Evas *e);
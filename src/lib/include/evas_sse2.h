@@ -0,0 +1,153 @@
+#ifndef EVAS_SSE2_H
+#define EVAS_SSE2_H
+
+/* sse2 and avx2 helpers for the span functions.
+ *
+ * pixels are loaded 4 (sse2) or 8 (avx2) at a time and unpacked to 16 bits
+ * per channel, lo/hi halves, so all the arithmetic below works on 16 bit
+ * lanes and every helper gives exactly the same result as the C macro of
+ * the same name in evas_blend_ops.h.
+ *
+ * the code is built with per function target attributes rather than
+ * -msse2/-mavx2 so the rest of evas stays runnable on anything, and the
+ * span getters only hand these out if evas_cpu.c found the feature. */
+
+#ifdef BUILD_SSE2
+#include <emmintrin.h>
+
+#define EVAS_SSE2_FN __attribute__((target("sse2")))
+
+#define SSE2_ALPHA(x) \
+   _mm_shufflehi_epi16(_mm_shufflelo_epi16((x), 0xff), 0xff)
+
+#define SSE2_LOAD(p) _mm_loadu_si128((__m128i *)(p))
+#define SSE2_STORE(p, x) _mm_storeu_si128((__m128i *)(p), (x))
+
+/* 4 mask values -> 4 pixels with every channel set to the mask value */
+static inline EVAS_SSE2_FN __m128i
+_evas_sse2_mask_load(const DATA8 *m)
+{
+   __m128i x;
+   int v;
+
+   memcpy(&v, m, sizeof(v));
+   x = _mm_cvtsi32_si128(v);
+   x = _mm_unpacklo_epi8(x, x);
+   return _mm_unpacklo_epi16(x, x);
+}
+
+/* MUL_256 */
+static inline EVAS_SSE2_FN __m128i
+_evas_sse2_mul_256(__m128i a, __m128i c)
+{
+   return _mm_srli_epi16(_mm_mullo_epi16(c, a), 8);
+}
+
+/* MUL_SYM */
+static inline EVAS_SSE2_FN __m128i
+_evas_sse2_mul_sym(__m128i a, __m128i c)
+{
+   return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(c, a),
+                                       _mm_set1_epi16(0xff)), 8);
+}
+
+/* MUL4_SYM - the C macro doesn't round the green channel */
+static inline EVAS_SSE2_FN __m128i
+_evas_sse2_mul4_sym(__m128i x, __m128i y)
+{
+   return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(x, y),
+                                       _mm_set_epi16(0xff, 0xff, 0, 0xff,
+                                                     0xff, 0xff, 0, 0xff)), 8);
+}
+
+/* INTERP_256 */
+static inline EVAS_SSE2_FN __m128i
+_evas_sse2_interp_256(__m128i a, __m128i c0, __m128i c1)
+{
+   c0 = _mm_srli_epi16(_mm_mullo_epi16(_mm_sub_epi16(c0, c1), a), 8);
+   return _mm_and_si128(_mm_add_epi16(c0, c1), _mm_set1_epi16(0xff));
+}
+
+/* s + MUL_256(256 - (s >> 24), d) */
+static inline EVAS_SSE2_FN __m128i
+_evas_sse2_blend(__m128i s, __m128i d)
+{
+   __m128i a = _mm_sub_epi16(_mm_set1_epi16(256), SSE2_ALPHA(s));
+
+   return _mm_add_epi16(s, _evas_sse2_mul_256(a, d));
+}
+
+/* unpack 4 pixels into lo/hi, apply op to each half, pack them back */
+#define SSE2_UNPACK(x, xl, xh) \
+   xl = _mm_unpacklo_epi8((x), _mm_setzero_si128()); \
+   xh = _mm_unpackhi_epi8((x), _mm_setzero_si128());
+
+#define SSE2_PACK(xl, xh) _mm_packus_epi16((xl), (xh))
+#endif
+
+#ifdef BUILD_AVX2
+#include <immintrin.h>
+
+#define EVAS_AVX2_FN __attribute__((target("avx2")))
+
+#define AVX2_ALPHA(x) \
+   _mm256_shufflehi_epi16(_mm256_shufflelo_epi16((x), 0xff), 0xff)
+
+#define AVX2_LOAD(p) _mm256_loadu_si256((__m256i *)(p))
+#define AVX2_STORE(p, x) _mm256_storeu_si256((__m256i *)(p), (x))
+
+static inline EVAS_AVX2_FN __m256i
+_evas_avx2_mask_load(const DATA8 *m)
+{
+   long long v;
+
+   memcpy(&v, m, sizeof(v));
+   return _mm256_mullo_epi32(_mm256_cvtepu8_epi32(_mm_cvtsi64_si128(v)),
+                             _mm256_set1_epi32(0x01010101));
+}
+
+static inline EVAS_AVX2_FN __m256i
+_evas_avx2_mul_256(__m256i a, __m256i c)
+{
+   return _mm256_srli_epi16(_mm256_mullo_epi16(c, a), 8);
+}
+
+static inline EVAS_AVX2_FN __m256i
+_evas_avx2_mul_sym(__m256i a, __m256i c)
+{
+   return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(c, a),
+                                             _mm256_set1_epi16(0xff)), 8);
+}
+
+static inline EVAS_AVX2_FN __m256i
+_evas_avx2_mul4_sym(__m256i x, __m256i y)
+{
+   return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(x, y),
+                                             _mm256_set1_epi64x(0x00ff00ff000000ffLL)), 8);
+}
+
+static inline EVAS_AVX2_FN __m256i
+_evas_avx2_interp_256(__m256i a, __m256i c0, __m256i c1)
+{
+   c0 = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(c0, c1), a), 8);
+   return _mm256_and_si256(_mm256_add_epi16(c0, c1), _mm256_set1_epi16(0xff));
+}
+
+static inline EVAS_AVX2_FN __m256i
+_evas_avx2_blend(__m256i s, __m256i d)
+{
+   __m256i a = _mm256_sub_epi16(_mm256_set1_epi16(256), AVX2_ALPHA(s));
+
+   return _mm256_add_epi16(s, _evas_avx2_mul_256(a, d));
+}
+
+/* unpack/pack work within each 128 bit lane, so they undo each other and
+ * pixel order is kept */
+#define AVX2_UNPACK(x, xl, xh) \
+   xl = _mm256_unpacklo_epi8((x), _mm256_setzero_si256()); \
+   xh = _mm256_unpackhi_epi8((x), _mm256_setzero_si256());
+
+#define AVX2_PACK(xl, xh) _mm256_packus_epi16((xl), (xh))
+#endif
+
+#endif
@@ -570,6 +570,8 @@ module_open(Evas_Module *em)
    ORD(image_dirty_region);
    ORD(image_data_get);
    ORD(image_draw);
+   func.image_border_draw = NULL; // ours don't take software images
+   func.image_tile_draw = NULL;
    ORD(image_size_get);
    ORD(image_alpha_get);
    ORD(image_colorspace_get);
@@ -1733,6 +1733,8 @@ module_open(Evas_Module *em)
    ORD(image_alpha_set);
    ORD(image_alpha_get);
    ORD(image_draw);
+   func.image_border_draw = NULL; // ours don't take software images
+   func.image_tile_draw = NULL;
    ORD(image_comment_get);
    ORD(image_cache_flush);
    ORD(image_cache_set);
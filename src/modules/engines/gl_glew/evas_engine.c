@@ -1118,6 +1118,8 @@ module_open(Evas_Module *em)
    ORD(image_border_set);
    ORD(image_border_get);
    ORD(image_draw);
+   func.image_border_draw = NULL; // ours don't take software images
+   func.image_tile_draw = NULL;
    ORD(image_comment_get);
    ORD(image_format_get);
    ORD(image_colorspace_set);
@@ -1509,6 +1509,8 @@ module_open(Evas_Module *em)
    ORD(image_data_preload_cancel);
    ORD(image_dirty_region);
    ORD(image_draw);
+   func.image_border_draw = NULL; // ours don't take software images
+   func.image_tile_draw = NULL;
    ORD(image_format_get);
    ORD(image_free);
    ORD(image_load);
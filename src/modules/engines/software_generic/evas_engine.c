@@ -866,6 +866,52 @@ eng_image_map4_draw(void *data __UNUSED__, void *context, void *surface, void *i
 
 }
 
+static void
+eng_image_border_draw(void *data __UNUSED__, void *context, void *surface, void *image, int l, int r, int t, int b, int sl, int sr, int st, int sb, int fill, int x, int y, int w, int h, int smooth)
+{
+   RGBA_Image *im;
+
+   if (!image) return;
+   im = image;
+#ifdef BUILD_PIPE_RENDER
+   if ((cpunum > 1)
+#ifdef EVAS_FRAME_QUEUING
+        && evas_common_frameq_enabled()
+#endif
+        )
+     evas_common_pipe_image_border_draw(im, surface, context, smooth,
+                                        l, r, t, b, sl, sr, st, sb, fill,
+                                        x, y, w, h);
+   else
+#endif
+     evas_common_rgba_image_border_draw(im, surface, context, smooth,
+                                        l, r, t, b, sl, sr, st, sb, fill,
+                                        x, y, w, h);
+   evas_common_cpu_end_opt();
+}
+
+static void
+eng_image_tile_draw(void *data __UNUSED__, void *context, void *surface, void *image, int tile_w, int tile_h, int x, int y, int w, int h, int smooth)
+{
+   RGBA_Image *im;
+
+   if (!image) return;
+   im = image;
+#ifdef BUILD_PIPE_RENDER
+   if ((cpunum > 1)
+#ifdef EVAS_FRAME_QUEUING
+        && evas_common_frameq_enabled()
+#endif
+        )
+     evas_common_pipe_image_tile_draw(im, surface, context, smooth,
+                                      tile_w, tile_h, x, y, w, h);
+   else
+#endif
+     evas_common_rgba_image_tile_draw(im, surface, context, smooth,
+                                      tile_w, tile_h, x, y, w, h);
+   evas_common_cpu_end_opt();
+}
+
 static void *
 eng_image_map_surface_new(void *data __UNUSED__, int w, int h, int alpha)
 {
@@ -1239,7 +1285,9 @@ static Evas_Func func =
      /* FUTURE software generic calls go here (done) */
      eng_image_map4_draw,
      eng_image_map_surface_new,
-     eng_image_map_surface_free
+     eng_image_map_surface_free,
+     eng_image_border_draw,
+     eng_image_tile_draw
      /* FUTURE software generic calls go here */
 };
 
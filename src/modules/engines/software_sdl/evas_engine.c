@@ -923,6 +923,8 @@ static int module_open(Evas_Module *em)
    ORD(image_border_set);
    ORD(image_border_get);
    ORD(image_draw);
+   func.image_border_draw = NULL; // ours don't take software images
+   func.image_tile_draw = NULL;
    ORD(image_map4_draw);
    ORD(image_map_surface_new);
    ORD(image_map_surface_free);